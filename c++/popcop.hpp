@@ -33,13 +33,16 @@
 #include <type_traits>
 #include <functional>
 #include <algorithm>
+#include <string_view>
 #include <optional>
 #include <iterator>
+#include <utility>
 #include <variant>
 #include <cstring>
 #include <cassert>
 #include <cstdint>
 #include <cstddef>
+#include <atomic>
 #include <chrono>
 #include <array>
 
@@ -51,6 +54,44 @@
 #include <senoval/string.hpp>
 #include <senoval/vector.hpp>
 
+/*
+ * Selection of the CPU-specific backends; see the configuration macros documented in the transport namespace.
+ * The system headers must be included outside of the namespaces.
+ */
+#if !defined(POPCOP_CRC_USER_HOOK) && !defined(POPCOP_CRC_NO_HARDWARE_ACCELERATION)
+# if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#  define POPCOP_CRC_ARM_ACLE_ 1
+# elif defined(__x86_64__) && defined(__SSE4_2__)
+#  define POPCOP_CRC_SSE42_ 1
+# elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define POPCOP_CRC_SSE42_ 1
+#  define POPCOP_CRC_SSE42_RUNTIME_DISPATCH_ 1
+# endif
+#endif
+
+#ifdef POPCOP_CRC_ARM_ACLE_
+# include <arm_acle.h>
+#endif
+
+#ifndef POPCOP_NO_SIMD
+# if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define POPCOP_SIMD_SSE2_ 1
+#  ifndef __AVX2__
+#   define POPCOP_SIMD_AVX2_RUNTIME_DISPATCH_ 1
+#  endif
+# elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN) && \
+       (defined(__GNUC__) || defined(__clang__))
+#  define POPCOP_SIMD_NEON_ 1
+# endif
+#endif
+
+#ifdef POPCOP_SIMD_SSE2_
+# include <immintrin.h>
+#endif
+#ifdef POPCOP_SIMD_NEON_
+# include <arm_neon.h>
+#endif
+
 
 namespace popcop
 {
@@ -75,6 +116,180 @@ static constexpr std::uint8_t EscapeCharacter = 0x9E;
  */
 static constexpr std::size_t ParserBufferAlignment = std::max<std::size_t>(64U, alignof(std::max_align_t)); // NOLINT
 
+/**
+ * The multi-byte CRC update function (@ref CRCComputer::add(const void*, std::size_t)) can use different backends.
+ * The backend is chosen at compile time using the following optional macros:
+ *
+ *  - POPCOP_CRC_USER_HOOK - if defined, it must name a function that updates the CRC register in software or using
+ *    some hardware peripheral, e.g. the STM32 CRC unit configured for the CRC-32C polynomial with bit reversal.
+ *    The function signature is std::uint32_t (std::uint32_t state, const std::uint8_t* data, std::size_t size).
+ *    The state is the raw CRC register value, i.e. it is not inverted. This option overrides all other backends.
+ *
+ *  - POPCOP_CRC_SLICING_FACTOR - number of bytes processed per iteration by the table-driven software backend.
+ *    Valid values are 1 (1 KiB of tables), 4 (4 KiB) and 8 (8 KiB). The tables are generated at compile time.
+ *    Defaults to 8 on 64-bit targets (the host side) and to 1 on other targets (embedded systems).
+ *
+ *  - POPCOP_CRC_NO_HARDWARE_ACCELERATION - if defined, the CRC instructions of the CPU will not be used.
+ *    Otherwise, the ARMv8 CRC32 instructions are used if they are available at compile time (__ARM_FEATURE_CRC32),
+ *    and the SSE4.2 instructions are used on AMD64 if they are available at compile time or, when built with
+ *    GCC or Clang, if the CPU reports their availability at runtime.
+ *
+ * The search for special characters in the bulk parsing and emitting paths (@ref ParserBase::processBytes(),
+ * @ref BufferedEmitter::emitInto() and others) is vectorized where possible:
+ *
+ *  - POPCOP_NO_SIMD - if defined, only the portable word-at-a-time implementation is used. Otherwise, SSE2 is used
+ *    on AMD64 (AVX2 if it is available at compile time or, when built with GCC or Clang, if the CPU reports its
+ *    availability at runtime), and NEON is used on AArch64. Embedded targets use the portable implementation.
+ */
+#ifndef POPCOP_CRC_SLICING_FACTOR
+# if UINTPTR_MAX > 0xFFFFFFFFU
+#  define POPCOP_CRC_SLICING_FACTOR 8
+# else
+#  define POPCOP_CRC_SLICING_FACTOR 1
+# endif
+#endif
+
+static_assert((POPCOP_CRC_SLICING_FACTOR == 1) || (POPCOP_CRC_SLICING_FACTOR == 4) || (POPCOP_CRC_SLICING_FACTOR == 8),
+              "Invalid CRC slicing factor");
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Generates the tables for the slicing-by-N CRC-32C algorithm at compile time.
+ * The first table is the classic byte-wise lookup table; each next table advances the CRC by one more zero byte.
+ */
+template <std::size_t NumTables>
+constexpr std::array<std::array<std::uint32_t, 256>, NumTables> makeCRC32CTables()
+{
+    std::array<std::array<std::uint32_t, 256>, NumTables> out{};
+
+    for (std::uint32_t i = 0; i < 256; i++)
+    {
+        std::uint32_t x = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            x = ((x & 1U) != 0) ? ((x >> 1U) ^ 0x82F63B78U) : (x >> 1U);   // Reflected Castagnoli polynomial
+        }
+        out[0][i] = x;
+    }
+
+    for (std::size_t k = 1; k < NumTables; k++)
+    {
+        for (std::size_t i = 0; i < 256; i++)
+        {
+            out[k][i] = (out[k - 1][i] >> 8U) ^ out[0][out[k - 1][i] & 0xFFU];
+        }
+    }
+
+    return out;
+}
+
+template <std::size_t NumTables>
+static constexpr auto CRC32CTables = makeCRC32CTables<NumTables>();
+
+/**
+ * Table-driven software CRC-32C update; processes SlicingFactor bytes per iteration.
+ * The result does not depend on the endianness of the target.
+ */
+template <std::size_t SlicingFactor>
+inline std::uint32_t updateCRC32CSoftware(std::uint32_t crc, const std::uint8_t* p, std::size_t size)
+{
+    static_assert((SlicingFactor == 1) || (SlicingFactor == 4) || (SlicingFactor == 8));
+    const auto& t = CRC32CTables<SlicingFactor>;
+
+    if constexpr (SlicingFactor > 1)
+    {
+        while (size >= SlicingFactor)
+        {
+            const std::uint32_t a = crc ^ (std::uint32_t(p[0]) <<  0U) ^ (std::uint32_t(p[1]) <<  8U) ^
+                                          (std::uint32_t(p[2]) << 16U) ^ (std::uint32_t(p[3]) << 24U);
+            crc = t[SlicingFactor - 1][(a >>  0U) & 0xFFU] ^
+                  t[SlicingFactor - 2][(a >>  8U) & 0xFFU] ^
+                  t[SlicingFactor - 3][(a >> 16U) & 0xFFU] ^
+                  t[SlicingFactor - 4][(a >> 24U) & 0xFFU];
+            if constexpr (SlicingFactor == 8)
+            {
+                crc ^= t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+            }
+            p += SlicingFactor;
+            size -= SlicingFactor;
+        }
+    }
+
+    while (size --> 0)
+    {
+        crc = t[0][(crc ^ *p++) & 0xFFU] ^ (crc >> 8U);
+    }
+
+    return crc;
+}
+
+#ifdef POPCOP_CRC_ARM_ACLE_
+inline std::uint32_t updateCRC32CHardware(std::uint32_t crc, const std::uint8_t* p, std::size_t size)
+{
+    while (size >= 4)
+    {
+        std::uint32_t w = 0;
+        std::memcpy(&w, p, 4);
+        crc = __crc32cw(crc, w);
+        p += 4;
+        size -= 4;
+    }
+
+    while (size --> 0)
+    {
+        crc = __crc32cb(crc, *p++);
+    }
+
+    return crc;
+}
+#endif
+
+#ifdef POPCOP_CRC_SSE42_
+__attribute__((target("sse4.2")))
+inline std::uint32_t updateCRC32CHardware(std::uint32_t crc, const std::uint8_t* p, std::size_t size)
+{
+    std::uint64_t acc = crc;
+    while (size >= 8)
+    {
+        std::uint64_t w = 0;
+        std::memcpy(&w, p, 8);
+        acc = __builtin_ia32_crc32di(acc, w);
+        p += 8;
+        size -= 8;
+    }
+
+    crc = std::uint32_t(acc);
+    while (size --> 0)
+    {
+        crc = __builtin_ia32_crc32qi(crc, *p++);
+    }
+
+    return crc;
+}
+#endif
+
+/**
+ * Updates the raw CRC-32C register value using the best backend available.
+ */
+inline std::uint32_t updateCRC32C(std::uint32_t crc, const std::uint8_t* p, std::size_t size)
+{
+#if defined(POPCOP_CRC_USER_HOOK)
+    return POPCOP_CRC_USER_HOOK(crc, p, size);
+#elif defined(POPCOP_CRC_SSE42_RUNTIME_DISPATCH_)
+    static const bool hardware_available = __builtin_cpu_supports("sse4.2");
+    return hardware_available ? updateCRC32CHardware(crc, p, size) :
+                                updateCRC32CSoftware<POPCOP_CRC_SLICING_FACTOR>(crc, p, size);
+#elif defined(POPCOP_CRC_ARM_ACLE_) || defined(POPCOP_CRC_SSE42_)
+    return updateCRC32CHardware(crc, p, size);
+#else
+    return updateCRC32CSoftware<POPCOP_CRC_SLICING_FACTOR>(crc, p, size);
+#endif
+}
+
+} // namespace detail_
+
 /**
  * Implementation of the CRC-32C (Castagnoli) algorithm.
  */
@@ -82,6 +297,18 @@ class CRCComputer
 {
     std::uint32_t value_ = 0xFFFFFFFFU;
 
+    static constexpr bool isSameAsGeneratedTable(const std::uint32_t (&table)[256])
+    {
+        for (std::size_t i = 0; i < 256; i++)
+        {
+            if (table[i] != detail_::CRC32CTables<1>[0][i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
 public:
     void add(std::uint8_t byte)
     {
@@ -121,10 +348,20 @@ public:
             0x79B737BAU, 0x8BDCB4B9U, 0x988C474DU, 0x6AE7C44EU, 0xBE2DA0A5U, 0x4C4623A6U, 0x5F16D052U, 0xAD7D5351U,
         };
         static_assert(sizeof(table) == 1024, "Invalid CRC table");
+        static_assert(isSameAsGeneratedTable(table), "Invalid CRC table");
 
         value_ = table[byte ^ (value_ & 0xFF)] ^ (value_ >> 8);
     }
 
+    /**
+     * Adds a block of bytes. This is faster than adding the data byte-by-byte, especially on large blocks.
+     * See the available backend options at @ref POPCOP_CRC_SLICING_FACTOR.
+     */
+    void add(const void* data, std::size_t size)
+    {
+        value_ = detail_::updateCRC32C(value_, static_cast<const std::uint8_t*>(data), size);
+    }
+
     [[nodiscard]] std::uint32_t get() const { return value_ ^ 0xFFFFFFFFU; }
 
     /**
@@ -170,20 +407,29 @@ public:
     {
         std::size_t size_;
         const std::uint8_t* ptr_;
+        std::size_t alignment_;
 
     public:
         AlignedBufferView() :
             size_(0),
-            ptr_(nullptr)
+            ptr_(nullptr),
+            alignment_(ParserBufferAlignment)
         { }
 
-        AlignedBufferView(const std::uint8_t* data_ptr, std::size_t data_size) :
+        /**
+         * The alignment can be less than @ref ParserBufferAlignment only if the parser is configured so explicitly,
+         * see @ref ExternalBufferParser.
+         */
+        AlignedBufferView(const std::uint8_t* data_ptr,
+                          std::size_t data_size,
+                          std::size_t alignment = ParserBufferAlignment) :
             size_(data_size),
-            ptr_(data_ptr)
+            ptr_(data_ptr),
+            alignment_(alignment)
         {
             assert(data_ptr != nullptr);
             // We GUARANTEE proper alignment for the application, checking it here at runtime.
-            assert((reinterpret_cast<std::uintptr_t>(data_ptr) % ParserBufferAlignment) == 0);
+            assert((reinterpret_cast<std::uintptr_t>(data_ptr) % alignment) == 0);
         }
 
         // The API is modeled after STL containers
@@ -194,14 +440,16 @@ public:
         bool empty() const { return size_ == 0; }
 
         /**
-         * The buffer pointer is guaranteed to be aligned at least at std::max_align_t (or even larger).
+         * The buffer pointer is guaranteed to be aligned at least at std::max_align_t (or even larger),
+         * unless a lower alignment is chosen explicitly (see @ref ExternalBufferParser).
          * This guarantee allows the application to directly alias the buffer pointer to a POD structure.
          */
-        const std::uint8_t* data() const
-        {
-            assert((reinterpret_cast<std::uintptr_t>(ptr_) % ParserBufferAlignment) == 0);
-            return ptr_;
-        }
+        const std::uint8_t* data() const { return ptr_; }
+
+        /**
+         * The alignment guaranteed for @ref data(); it must be passed on when the buffer is wrapped again.
+         */
+        std::size_t getAlignment() const { return alignment_; }
 
         std::uint8_t at(const std::size_t index) const
         {
@@ -211,7 +459,9 @@ public:
 
         /**
          * This helper function performs safe aliasing of the specified type to the underlying buffer.
-         * Alignment requirements are checked at compile time.
+         * Alignment requirements are checked against @ref ParserBufferAlignment at compile time. If the buffer
+         * alignment is chosen explicitly (see @ref ExternalBufferParser), it can be lower, which is only checked
+         * at runtime in debug builds; it is the responsibility of the application to not exceed it.
          * Be careful using this function, remember that type punning is never safe.
          */
         template <typename T>
@@ -221,7 +471,8 @@ public:
             static_assert(alignof(T) <= ParserBufferAlignment,
                           "Aliasing the buffer to a type with stricter alignment requirements is unsafe.");
 
-            // Super paranoid check, debug builds only
+            // Super paranoid checks, debug builds only
+            assert(alignof(T) <= alignment_);
             assert((reinterpret_cast<std::uintptr_t>(ptr_) % alignof(T)) == 0);
 
             return *static_cast<const T*>(static_cast<const void*>(ptr_));
@@ -250,17 +501,20 @@ public:
         contents_(Contents::None)
     { }
 
-    ParserOutput(std::uint8_t type_code, const std::uint8_t* data_ptr, std::size_t data_size) :
+    ParserOutput(std::uint8_t type_code,
+                 const std::uint8_t* data_ptr,
+                 std::size_t data_size,
+                 std::size_t alignment = ParserBufferAlignment) :
         contents_(Contents::Frame)
     {
         frame_.type_code = type_code;
-        frame_.payload = AlignedBufferView(data_ptr, data_size);
+        frame_.payload = AlignedBufferView(data_ptr, data_size, alignment);
     }
 
-    ParserOutput(const std::uint8_t* data_ptr, std::size_t data_size) :
+    ParserOutput(const std::uint8_t* data_ptr, std::size_t data_size, std::size_t alignment = ParserBufferAlignment) :
         contents_(Contents::ExtraneousData)
     {
-        frame_.payload = AlignedBufferView(data_ptr, data_size);
+        frame_.payload = AlignedBufferView(data_ptr, data_size, alignment);
     }
 
     const Frame* getReceivedFrame() const
@@ -275,27 +529,369 @@ public:
 };
 
 /**
- * Simple and robust parser.
- * TODO: add support for timestamping in the future.
- * @tparam MaxPayloadSize   The maximum length of payload this parser will be able to receive.
- *                          This value should not be less than 1024 bytes.
+ * The default parser instrumentation policy that does nothing; it is optimized out completely.
+ * A custom instrumentation policy must provide the same set of methods, which are invoked by the parser
+ * as the data is being received (see @ref ParserStatistics for an example). The size argument is the number of
+ * unescaped bytes received since the beginning of the frame, including the frame type code and the CRC.
  */
-template <std::size_t MaxPayloadSize = 2048>
-class Parser
+struct NullParserInstrumentation
 {
-    static_assert(MaxPayloadSize >= 1024, "Maximum payload size should be larger");
+    void onFrameStart() { }                                     ///< The first byte after a delimiter
+    void onEscapeCharacter() { }                                ///< An escape character removed from the stream
+    void onFrameReceived(std::size_t /* size */) { }            ///< A valid frame is received
+    void onCRCError(std::size_t /* size */) { }                 ///< Reported as extraneous data
+    void onExtraneousData(std::size_t /* size */) { }           ///< Too short to be a frame
+    void onOverflow(std::size_t /* size */) { }                 ///< The buffer overflowed; extraneous data
+};
+
+/**
+ * Fixed-size histogram with logarithmic buckets.
+ * Bucket 0 counts zero values, and bucket N>0 counts the values in [2^(N-1), 2^N).
+ * The last bucket also counts all values that are larger. Bucket counters saturate instead of overflowing.
+ */
+template <std::size_t NumBuckets = 16>
+class LatencyHistogram
+{
+    static_assert((NumBuckets >= 2) && (NumBuckets <= 64), "Invalid number of buckets");
+
+    std::array<std::uint32_t, NumBuckets> buckets_{};
+
+public:
+    static constexpr std::size_t getBucketIndex(std::uint64_t value)
+    {
+        std::size_t index = 0;
+        while ((value != 0) && (index < (NumBuckets - 1U)))
+        {
+            value >>= 1U;
+            index++;
+        }
+        return index;
+    }
+
+    /// The smallest value that is counted in the specified bucket.
+    static constexpr std::uint64_t getBucketLowerBound(const std::size_t index)
+    {
+        return (index == 0) ? 0 : (std::uint64_t(1) << (index - 1U));
+    }
+
+    void add(const std::uint64_t value)
+    {
+        auto& b = buckets_[getBucketIndex(value)];
+        if (b < 0xFFFFFFFFU)
+        {
+            b++;
+        }
+    }
+
+    const std::array<std::uint32_t, NumBuckets>& getBuckets() const { return buckets_; }
+
+    std::uint64_t getTotalCount() const
+    {
+        std::uint64_t out = 0;
+        for (auto x : buckets_)
+        {
+            out += x;
+        }
+        return out;
+    }
+
+    void clear() { buckets_.fill(0); }
+
+    static constexpr std::size_t size() { return NumBuckets; }
+};
+
+/**
+ * Parser instrumentation policy that collects the reception statistics and timestamps the received frames.
+ * The timestamps are sampled from the user-provided clock, which must provide the same interface as the
+ * standard clocks, i.e. the member types time_point and duration, and the static method now().
+ * On a bare-metal target it can be as simple as:
+ *
+ *      struct MicrosecondClock
+ *      {
+ *          using duration = std::chrono::microseconds;
+ *          using time_point = std::chrono::time_point<MicrosecondClock>;
+ *          static time_point now() { return time_point(duration(TIM2->CNT)); }
+ *      };
+ *
+ *      Parser<2048, ParserStatistics<MicrosecondClock>> parser;
+ *
+ *      if (auto frame = parser.processNextByte(x).getReceivedFrame())
+ *      {
+ *          // Process the frame here...
+ *          parser.getInstrumentation().markFrameHandled();     // Optional, updates the handling latency histogram
+ *      }
+ *
+ * The clock is sampled only twice per frame: at the first byte and at the delimiter.
+ * @tparam Clock        The clock to sample the timestamps from. The histograms are in the ticks of this clock.
+ * @tparam NumBuckets   Number of buckets in each latency histogram, see @ref LatencyHistogram.
+ */
+template <typename Clock, std::size_t NumBuckets = 16>
+class ParserStatistics
+{
+public:
+    using TimePoint = typename Clock::time_point;
+    using Histogram = LatencyHistogram<NumBuckets>;
+
+    struct Counters
+    {
+        std::uint64_t frames = 0;               ///< Valid frames received
+        std::uint64_t crc_errors = 0;           ///< Reported as extraneous data
+        std::uint64_t overflows = 0;            ///< Reported as extraneous data
+        std::uint64_t extraneous_bytes = 0;     ///< Total reported as extraneous data, including the above
+        std::uint64_t escape_characters = 0;    ///< Escape density is escape_characters / bytes
+        std::uint64_t bytes = 0;                ///< Unescaped bytes between delimiters, including the overhead
+    };
+
+private:
+    Counters counters_;
+    TimePoint current_frame_start_{};
+    TimePoint last_frame_start_{};
+    TimePoint last_frame_end_{};
+    Histogram reception_histogram_;
+    Histogram handling_histogram_;
+
+    static std::uint64_t computeTicks(const TimePoint a, const TimePoint b)
+    {
+        const auto ticks = (b - a).count();
+        return (ticks > 0) ? std::uint64_t(ticks) : 0;          // The clock may be non-monotonic
+    }
+
+    void onFrameEnd(const std::size_t size)
+    {
+        counters_.bytes += size;
+        last_frame_start_ = current_frame_start_;
+        last_frame_end_ = Clock::now();
+    }
+
+    void onFailedFrameEnd(const std::size_t size)
+    {
+        counters_.extraneous_bytes += size;
+        onFrameEnd(size);
+    }
+
+public:
+    /// @{ Invoked by the parser, see @ref NullParserInstrumentation.
+    void onFrameStart() { current_frame_start_ = Clock::now(); }
+    void onEscapeCharacter() { counters_.escape_characters++; }
+
+    void onFrameReceived(const std::size_t size)
+    {
+        counters_.frames++;
+        onFrameEnd(size);
+        reception_histogram_.add(computeTicks(last_frame_start_, last_frame_end_));
+    }
+
+    void onCRCError(const std::size_t size)
+    {
+        counters_.crc_errors++;
+        onFailedFrameEnd(size);
+    }
+
+    void onExtraneousData(const std::size_t size) { onFailedFrameEnd(size); }
+
+    void onOverflow(const std::size_t size)
+    {
+        counters_.overflows++;
+        onFailedFrameEnd(size);
+    }
+    /// @}
+
+    /**
+     * Updates the handling latency histogram with the time elapsed since the delimiter of the last frame.
+     * The application should invoke this method once it has finished processing the received frame.
+     */
+    void markFrameHandled() { handling_histogram_.add(computeTicks(last_frame_end_, Clock::now())); }
+
+    /**
+     * The timestamps of the first byte and the delimiter of the last frame (or extraneous data).
+     * Use them immediately after the parser has returned a non-empty output.
+     */
+    TimePoint getLastFrameStartTimestamp() const { return last_frame_start_; }
+    TimePoint getLastFrameEndTimestamp()   const { return last_frame_end_; }
+
+    const Counters& getCounters() const { return counters_; }
+
+    /// Time from the first byte to the delimiter of every valid frame.
+    const Histogram& getReceptionHistogram() const { return reception_histogram_; }
+
+    /// Time from the delimiter to @ref markFrameHandled().
+    const Histogram& getHandlingHistogram() const { return handling_histogram_; }
+
+    /// The timestamps are not affected.
+    void resetStatistics()
+    {
+        counters_ = Counters();
+        reception_histogram_.clear();
+        handling_histogram_.clear();
+    }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Returns true if the byte is either the frame delimiter or the escape character.
+ * The two special characters differ only in bit 4, which allows us to test for both at once.
+ */
+static_assert((FrameDelimiter | 0x10U) == EscapeCharacter, "The special character detection logic is invalid");
+
+inline constexpr bool isSpecialCharacter(const std::uint8_t x)
+{
+    return std::uint8_t(x | 0x10U) == EscapeCharacter;
+}
+
+/**
+ * Returns the pointer to the first special character (frame delimiter or escape character) in the range,
+ * or the end pointer if there are none. The data is scanned one machine word at a time; the classic
+ * "determine if a word has a zero byte" trick is used to skip over the words that contain no special characters.
+ */
+inline const std::uint8_t* findNextSpecialCharacterPortable(const std::uint8_t* begin,
+                                                            const std::uint8_t* const end)
+{
+    using Word = std::uintptr_t;
+    static constexpr Word Ones = Word(~Word(0)) / 0xFFU;        // 0x0101...01
+    static constexpr Word High = Ones * 0x80U;                  // 0x8080...80
+    static constexpr Word Mask = Ones * 0x10U;
+    static constexpr Word Pattern = Ones * EscapeCharacter;
+
+    while (std::size_t(end - begin) >= sizeof(Word))
+    {
+        Word w{};
+        std::memcpy(&w, begin, sizeof(Word));                   // Unaligned load, optimized out by the compiler
+        w = (w | Mask) ^ Pattern;                               // Special characters become zero bytes
+        if (((w - Ones) & ~w & High) != 0)
+        {
+            break;                                              // The exact position is found below
+        }
+        begin += sizeof(Word);
+    }
+
+    while ((begin != end) && !isSpecialCharacter(*begin))
+    {
+        ++begin;
+    }
+
+    return begin;
+}
+
+/*
+ * The vectorized versions of the above. Each byte is ORed with 0x10 and compared with the escape character,
+ * which yields a mask of special characters; the remainder that is shorter than a vector is left to the portable
+ * implementation.
+ */
+#ifdef POPCOP_SIMD_SSE2_
+inline const std::uint8_t* findNextSpecialCharacterSSE2(const std::uint8_t* begin, const std::uint8_t* const end)
+{
+    const __m128i mask = _mm_set1_epi8(0x10);
+    const __m128i pattern = _mm_set1_epi8(static_cast<char>(EscapeCharacter));
+    while (std::size_t(end - begin) >= 16U)
+    {
+        const __m128i x = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(begin)));
+        const auto special = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(x, mask), pattern)));
+        if (special != 0)
+        {
+            return begin + __builtin_ctz(special);
+        }
+        begin += 16;
+    }
+
+    return findNextSpecialCharacterPortable(begin, end);
+}
+
+__attribute__((target("avx2")))
+inline const std::uint8_t* findNextSpecialCharacterAVX2(const std::uint8_t* begin, const std::uint8_t* const end)
+{
+    const __m256i mask = _mm256_set1_epi8(0x10);
+    const __m256i pattern = _mm256_set1_epi8(static_cast<char>(EscapeCharacter));
+    while (std::size_t(end - begin) >= 32U)
+    {
+        const __m256i x = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(begin)));
+        const auto special = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_or_si256(x, mask), pattern)));
+        if (special != 0)
+        {
+            return begin + __builtin_ctz(special);
+        }
+        begin += 32;
+    }
+
+    return findNextSpecialCharacterSSE2(begin, end);
+}
+#endif
+
+#ifdef POPCOP_SIMD_NEON_
+inline const std::uint8_t* findNextSpecialCharacterNEON(const std::uint8_t* begin, const std::uint8_t* const end)
+{
+    const uint8x16_t mask = vdupq_n_u8(0x10);
+    const uint8x16_t pattern = vdupq_n_u8(EscapeCharacter);
+    while (std::size_t(end - begin) >= 16U)
+    {
+        const uint8x16_t special = vceqq_u8(vorrq_u8(vld1q_u8(begin), mask), pattern);
+        // Narrowing shift packs the 16 byte masks into 16 nibbles, since NEON has no movemask
+        const std::uint64_t nibbles =
+            vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (nibbles != 0)
+        {
+            return begin + (__builtin_ctzll(nibbles) / 4);
+        }
+        begin += 16;
+    }
+
+    return findNextSpecialCharacterPortable(begin, end);
+}
+#endif
+
+/**
+ * Returns the pointer to the first special character (frame delimiter or escape character) in the range,
+ * or the end pointer if there are none, using the fastest implementation available.
+ */
+inline const std::uint8_t* findNextSpecialCharacter(const std::uint8_t* const begin, const std::uint8_t* const end)
+{
+#if defined(POPCOP_SIMD_AVX2_RUNTIME_DISPATCH_)
+    static const bool avx2_available = __builtin_cpu_supports("avx2");
+    return avx2_available ? findNextSpecialCharacterAVX2(begin, end) : findNextSpecialCharacterSSE2(begin, end);
+#elif defined(POPCOP_SIMD_SSE2_)
+    return findNextSpecialCharacterAVX2(begin, end);
+#elif defined(POPCOP_SIMD_NEON_)
+    return findNextSpecialCharacterNEON(begin, end);
+#else
+    return findNextSpecialCharacterPortable(begin, end);
+#endif
+}
+
+/**
+ * The parser state machine. The buffer where the frame is being received is provided by the derived class
+ * via getBuffer(), which allows the derived class to switch to a different buffer between frames
+ * (see @ref FrameQueue) or to keep the buffer outside of the object (see @ref ExternalBufferParser).
+ * The buffer must be BufferSize bytes large, and its pointer must be aligned at BufferAlignment.
+ * The instrumentation policy is inherited privately in order to let the compiler optimize out the empty one.
+ */
+template <typename Derived,
+          std::size_t MaxPayloadSize,
+          typename Instrumentation = NullParserInstrumentation,
+          std::size_t BufferAlignment = ParserBufferAlignment>
+class ParserBase : private Instrumentation
+{
+    static_assert(MaxPayloadSize > 0, "Maximum payload size cannot be zero");
+    static_assert((BufferAlignment > 0) && ((BufferAlignment & (BufferAlignment - 1U)) == 0) &&
+                  (BufferAlignment <= ParserBufferAlignment), "Invalid buffer alignment");
 
+protected:
     static constexpr std::uint8_t PayloadOverheadNotIncludingDelimiters = 5;
 
     /// We add +1 to the size because of a special case explained in the update method.
-    /// The buffer pointer passed to the application is GUARANTEED to be aligned.
-    alignas(ParserBufferAlignment)
-    std::array<std::uint8_t, MaxPayloadSize + PayloadOverheadNotIncludingDelimiters + 1> buffer_;
+    static constexpr std::size_t BufferSize = MaxPayloadSize + PayloadOverheadNotIncludingDelimiters + 1;
 
+    using Buffer = std::array<std::uint8_t, BufferSize>;
+
+private:
     std::size_t buffer_pos_ = 0;
     CRCComputer crc_;
     bool unescape_next_ = false;
 
+    std::uint8_t* getBuffer() { return static_cast<Derived*>(this)->getBuffer(); }
+
+    Instrumentation& instrumentation() { return *this; }
+
     bool checkIfReceivedFrameValid()
     {
         return (buffer_pos_ >= PayloadOverheadNotIncludingDelimiters) && (crc_.isResidueCorrect());
@@ -303,10 +899,10 @@ class Parser
 
     class RAIIFrameFinalizer
     {
-        Parser& self_;
+        ParserBase& self_;
 
     public:
-        explicit RAIIFrameFinalizer(Parser* s) : self_(*s) { }
+        explicit RAIIFrameFinalizer(ParserBase* s) : self_(*s) { }
 
         ~RAIIFrameFinalizer()
         {
@@ -316,6 +912,9 @@ class Parser
         }
     };
 
+protected:
+    ParserBase() = default;
+
 public:
     /**
      * Invoke this method for every received byte from the channel.
@@ -334,6 +933,8 @@ public:
      */
     ParserOutput processNextByte(std::uint8_t x)
     {
+        std::uint8_t* const buffer_ = getBuffer();
+
         if (x == FrameDelimiter)
         {
             // This protocol offers a transparent data channel, which means that it is guaranteed that
@@ -346,13 +947,23 @@ public:
 
             if (checkIfReceivedFrameValid())
             {
+                instrumentation().onFrameReceived(buffer_pos_);
                 return ParserOutput(buffer_[buffer_pos_ - PayloadOverheadNotIncludingDelimiters],
-                                    buffer_.data(),
-                                    buffer_pos_ - PayloadOverheadNotIncludingDelimiters);
+                                    buffer_,
+                                    buffer_pos_ - PayloadOverheadNotIncludingDelimiters,
+                                    BufferAlignment);
             }
             else if (buffer_pos_ > 0)
             {
-                return ParserOutput(buffer_.data(), buffer_pos_);
+                if (buffer_pos_ >= PayloadOverheadNotIncludingDelimiters)
+                {
+                    instrumentation().onCRCError(buffer_pos_);
+                }
+                else
+                {
+                    instrumentation().onExtraneousData(buffer_pos_);
+                }
+                return ParserOutput(buffer_, buffer_pos_, BufferAlignment);
             }
             else
             {
@@ -360,8 +971,14 @@ public:
             }
         }
 
+        if ((buffer_pos_ == 0) && !unescape_next_)
+        {
+            instrumentation().onFrameStart();
+        }
+
         if (x == EscapeCharacter)
         {
+            instrumentation().onEscapeCharacter();
             unescape_next_ = true;
             return {};
         }
@@ -375,12 +992,12 @@ public:
         // Just add one byte and update the CRC. What we're receiving may not be a valid frame; the
         // only way to detect whether it's a valid frame or not is to wait until the next frame delimiter
         // and see if the CRC equals the right magic value.
-        assert(buffer_pos_ < buffer_.size());
+        assert(buffer_pos_ < BufferSize);
         buffer_[buffer_pos_] = x;
         ++buffer_pos_;
         crc_.add(x);
 
-        if (buffer_pos_ >= buffer_.size())
+        if (buffer_pos_ >= BufferSize)
         {
             // We ran out of space in the buffer! There is no hope to have a valid frame received then,
             // so we just unload this data to the application as unparseable bytes and reset the buffer.
@@ -393,7 +1010,8 @@ public:
             // one cycle early in order to ensure that no byte is lost. This is why we allocate one byte
             // more in the buffer than the maximum payload length requires.
             RAIIFrameFinalizer finalizer(this);
-            return ParserOutput(buffer_.data(), buffer_pos_);
+            instrumentation().onOverflow(buffer_pos_);
+            return ParserOutput(buffer_, buffer_pos_, BufferAlignment);
         }
         else
         {
@@ -402,22 +1020,405 @@ public:
     }
 
     /**
-     * Resets the inner state of the parser.
-     * Use this method when your communication channel is reset.
-     */
-    void reset()
+     * Bulk version of @ref processNextByte() for contiguous chunks of data, e.g. DMA buffers.
+     * The result is exactly the same as if every byte of the chunk was fed into @ref processNextByte()
+     * sequentially, but runs of regular bytes that contain no special characters are copied into the
+     * buffer and added to the CRC in one go rather than byte-by-byte.
+     *
+     * @param data      Pointer to the received data.
+     *
+     * @param size      Number of bytes in the chunk.
+     *
+     * @param handler   A callable of the form void (const ParserOutput&). It is invoked once for every
+     *                  non-empty parser output (received frame or extraneous data) in the order of occurrence.
+     *                  The referenced data is INVALIDATED as soon as the handler returns.
+     */
+    template <typename Handler>
+    void processBytes(const std::uint8_t* data, const std::size_t size, Handler&& handler)
+    {
+        const std::uint8_t* const end = data + size;
+        while (data != end)
+        {
+            // Special characters and escaped bytes are rare, they go through the regular path
+            if (unescape_next_ || detail_::isSpecialCharacter(*data))
+            {
+                const auto out = processNextByte(*data++);
+                if ((out.getReceivedFrame() != nullptr) || (out.getExtraneousData() != nullptr))
+                {
+                    handler(out);
+                }
+                continue;
+            }
+
+            // The buffer is re-fetched on every iteration because the handler may have caused a buffer switch
+            std::uint8_t* const buffer_ = getBuffer();
+
+            // The run is limited by the remaining buffer space in order to detect overflows at the same byte
+            // where the regular path would detect it. There is always at least one byte of space available.
+            assert(buffer_pos_ < BufferSize);
+            const std::size_t room = BufferSize - buffer_pos_;
+            const std::uint8_t* const run_end =
+                detail_::findNextSpecialCharacter(data, data + std::min<std::size_t>(room, std::size_t(end - data)));
+            const std::size_t run_length = std::size_t(run_end - data);
+            assert((run_length > 0) && (run_length <= room));
+
+            if (buffer_pos_ == 0)
+            {
+                instrumentation().onFrameStart();
+            }
+
+            std::copy(data, run_end, buffer_ + buffer_pos_);
+            crc_.add(data, run_length);
+            data = run_end;
+            buffer_pos_ += run_length;
+
+            if (buffer_pos_ >= BufferSize)
+            {
+                // See the explanation of the overflow handling logic in the regular path
+                RAIIFrameFinalizer finalizer(this);
+                instrumentation().onOverflow(buffer_pos_);
+                handler(ParserOutput(buffer_, buffer_pos_, BufferAlignment));
+            }
+        }
+    }
+
+    /**
+     * Resets the inner state of the parser.
+     * Use this method when your communication channel is reset.
+     */
+    void reset()
     {
         RAIIFrameFinalizer finalizer(this);
     }
+
+    /**
+     * Access to the instrumentation policy object, e.g. to read the statistics.
+     * See @ref NullParserInstrumentation.
+     */
+    Instrumentation& getInstrumentation() { return *this; }
+    const Instrumentation& getInstrumentation() const { return *this; }
+};
+
+/**
+ * The buffer of @ref Parser. It is a base class listed before @ref ParserBase, so that the buffer is laid out
+ * first and the parser state is placed into its tail padding rather than being padded to the buffer alignment.
+ * The member is protected on purpose: that makes the class non-POD, which permits the reuse of the tail padding.
+ */
+template <std::size_t Size>
+class ParserBufferHolder
+{
+protected:
+    /// The buffer pointer passed to the application is GUARANTEED to be aligned.
+    alignas(ParserBufferAlignment) std::array<std::uint8_t, Size> buffer_;
+};
+
+} // namespace detail_
+
+/**
+ * Simple and robust parser.
+ * See @ref detail_::ParserBase for the API.
+ * @tparam MaxPayloadSize   The maximum length of payload this parser will be able to receive.
+ *                          This value should not be less than 1024 bytes.
+ * @tparam Instrumentation  Optional instrumentation policy, e.g. @ref ParserStatistics for frame timestamping
+ *                          and reception statistics. The default one costs nothing.
+ */
+template <std::size_t MaxPayloadSize = 2048, typename Instrumentation = NullParserInstrumentation>
+class Parser :
+    private detail_::ParserBufferHolder<
+        detail_::ParserBase<Parser<MaxPayloadSize, Instrumentation>, MaxPayloadSize, Instrumentation>::BufferSize>,
+    public detail_::ParserBase<Parser<MaxPayloadSize, Instrumentation>, MaxPayloadSize, Instrumentation>
+{
+    static_assert(MaxPayloadSize >= 1024, "Maximum payload size should be larger; see ExternalBufferParser");
+
+    using Base = detail_::ParserBase<Parser<MaxPayloadSize, Instrumentation>, MaxPayloadSize, Instrumentation>;
+    friend Base;
+
+    std::uint8_t* getBuffer() { return this->buffer_.data(); }
+};
+
+/**
+ * The same parser that receives frames into a buffer provided by the application instead of its own,
+ * for memory-constrained systems. The buffer can be allocated from an arena shared between several links,
+ * and the payload size and the buffer alignment can be chosen freely; the frame semantics are the same as
+ * those of @ref Parser. The buffer must stay valid for the lifetime of the parser:
+ *
+ *      using SensorLinkParser = ExternalBufferParser<200, 4>;
+ *
+ *      alignas(4) std::uint8_t arena[SensorLinkParser::BufferSize * 3];
+ *
+ *      SensorLinkParser parsers[] = {
+ *          SensorLinkParser(&arena[SensorLinkParser::BufferSize * 0]),
+ *          SensorLinkParser(&arena[SensorLinkParser::BufferSize * 1]),
+ *          SensorLinkParser(&arena[SensorLinkParser::BufferSize * 2])
+ *      };
+ *
+ * Payloads longer than MaxPayloadSize are reported as extraneous data; note that most standard messages
+ * are much shorter than 1024 bytes, but not all of them are (see their MaxEncodedSize).
+ *
+ * @tparam MaxPayloadSize   The maximum length of payload this parser will be able to receive.
+ * @tparam BufferAlignment  The alignment of the buffer, which is guaranteed for the received payloads;
+ *                          it must be a power of two not larger than @ref ParserBufferAlignment.
+ * @tparam Instrumentation  Same as in @ref Parser.
+ */
+template <std::size_t MaxPayloadSize,
+          std::size_t BufferAlignment = ParserBufferAlignment,
+          typename Instrumentation = NullParserInstrumentation>
+class ExternalBufferParser :
+    public detail_::ParserBase<ExternalBufferParser<MaxPayloadSize, BufferAlignment, Instrumentation>,
+                               MaxPayloadSize,
+                               Instrumentation,
+                               BufferAlignment>
+{
+    using Base = detail_::ParserBase<ExternalBufferParser<MaxPayloadSize, BufferAlignment, Instrumentation>,
+                                     MaxPayloadSize,
+                                     Instrumentation,
+                                     BufferAlignment>;
+    friend Base;
+
+    std::uint8_t* buffer_;
+
+    std::uint8_t* getBuffer() { return buffer_; }
+
+public:
+    /// The size of the buffer required by the parser, in bytes; rounded up so that the buffers of several parsers
+    /// can be allocated from an array back-to-back.
+    static constexpr std::size_t BufferSize =
+        ((Base::BufferSize + BufferAlignment - 1U) / BufferAlignment) * BufferAlignment;
+
+    /**
+     * @param buffer    Pointer to BufferSize bytes aligned at BufferAlignment.
+     */
+    explicit ExternalBufferParser(std::uint8_t* const buffer) :
+        buffer_(buffer)
+    {
+        assert(buffer_ != nullptr);
+        assert((reinterpret_cast<std::uintptr_t>(buffer_) % BufferAlignment) == 0);
+    }
+};
+
+/**
+ * Lock-free single-producer single-consumer queue of received frames with a built-in parser.
+ * This is useful when the data is parsed in an interrupt handler and the frames are processed by a lower-priority
+ * task: the producer (e.g. a UART ISR) feeds the received bytes into the queue, and the consumer takes completed
+ * frames out of it. Frames are never copied: the parser receives every frame directly into a free slot of the queue,
+ * and once the frame is complete, the slot is handed over to the consumer and the parser switches to the next one.
+ *
+ * If the queue is full, newly received frames are dropped (see @ref getDroppedFrameCount()).
+ * The producer methods must be invoked from one context only, and so must the consumer methods.
+ *
+ * Usage:
+ *
+ *      FrameQueue<4> queue;
+ *
+ *      void uartISR()                          // Producer
+ *      {
+ *          queue.processNextByte(UART->DR);
+ *      }
+ *
+ *      void task()                             // Consumer
+ *      {
+ *          while (auto frame = queue.peek())
+ *          {
+ *              // Process the frame here...
+ *              queue.pop();                    // The frame is INVALIDATED here
+ *          }
+ *      }
+ *
+ * @tparam Capacity         Maximum number of frames that can be stored in the queue. The amount of memory occupied
+ *                          by the queue is roughly (Capacity + 1) * MaxPayloadSize, because the parser has to have
+ *                          one more slot to receive the next frame into.
+ * @tparam MaxPayloadSize   Same as in @ref Parser.
+ * @tparam Instrumentation  Same as in @ref Parser; the instrumentation is invoked from the producer side.
+ */
+template <std::size_t Capacity,
+          std::size_t MaxPayloadSize = 2048,
+          typename Instrumentation = NullParserInstrumentation>
+class FrameQueue :
+    private detail_::ParserBase<FrameQueue<Capacity, MaxPayloadSize, Instrumentation>, MaxPayloadSize, Instrumentation>
+{
+    static_assert(Capacity > 0, "Capacity cannot be zero");
+
+    static_assert(MaxPayloadSize >= 1024, "Maximum payload size should be larger");
+
+    using Base =
+        detail_::ParserBase<FrameQueue<Capacity, MaxPayloadSize, Instrumentation>, MaxPayloadSize, Instrumentation>;
+    friend Base;
+
+    static constexpr std::size_t NumberOfSlots = Capacity + 1;
+
+    struct Slot
+    {
+        /// The buffer pointer passed to the application is GUARANTEED to be aligned.
+        alignas(ParserBufferAlignment) typename Base::Buffer buffer;
+        ParserOutput::Frame frame;
+    };
+
+    std::array<Slot, NumberOfSlots> slots_;
+
+    /// The slots in [tail, head) are owned by the consumer; the slot at head is owned by the parser.
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+    std::uint32_t dropped_frame_count_ = 0;
+
+    static std::size_t next(const std::size_t index) { return (index + 1U) % NumberOfSlots; }
+
+    std::uint8_t* getBuffer() { return slots_[head_.load(std::memory_order_relaxed)].buffer.data(); }
+
+    /// Returns true if the output does not contain a frame, otherwise enqueues or drops the frame and returns false.
+    bool handleOutput(const ParserOutput& out)
+    {
+        const auto frame = out.getReceivedFrame();
+        if (frame == nullptr)
+        {
+            return true;
+        }
+
+        // The frame is already in the slot, so the slot is just handed over; the parser state is already reset
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t new_head = next(head);
+        if (new_head != tail_.load(std::memory_order_acquire))
+        {
+            slots_[head].frame = *frame;
+            head_.store(new_head, std::memory_order_release);
+        }
+        else
+        {
+            dropped_frame_count_++;     // No free slots, the parser will receive the next frame into the same slot
+        }
+        return false;
+    }
+
+public:
+    /// The atomic indexes must not involve locking, otherwise the queue cannot be used from interrupt handlers.
+    static_assert(std::atomic<std::size_t>::is_always_lock_free, "The queue requires lock-free atomics");
+
+    /**
+     * Feeds the next received byte into the parser; producer side.
+     * Completed frames are enqueued automatically. Unparseable data is reported via the optional handler;
+     * see @ref Parser::processNextByte() for details.
+     * @param handler   A callable of the form void (const ParserOutput::AlignedBufferView&) invoked with the
+     *                  extraneous data, if any. The referenced data is INVALIDATED as soon as the handler returns.
+     */
+    template <typename ExtraneousDataHandler = void (*)(const ParserOutput::AlignedBufferView&)>
+    void processNextByte(const std::uint8_t x,
+                         ExtraneousDataHandler&& handler = [](const ParserOutput::AlignedBufferView&) {})
+    {
+        const auto out = Base::processNextByte(x);
+        if (handleOutput(out) && (out.getExtraneousData() != nullptr))
+        {
+            handler(*out.getExtraneousData());
+        }
+    }
+
+    /**
+     * Bulk version of @ref processNextByte(); producer side.
+     * See @ref Parser::processBytes() for details.
+     */
+    template <typename ExtraneousDataHandler = void (*)(const ParserOutput::AlignedBufferView&)>
+    void processBytes(const std::uint8_t* const data,
+                      const std::size_t size,
+                      ExtraneousDataHandler&& handler = [](const ParserOutput::AlignedBufferView&) {})
+    {
+        Base::processBytes(data, size, [&](const ParserOutput& out)
+        {
+            if (handleOutput(out) && (out.getExtraneousData() != nullptr))
+            {
+                handler(*out.getExtraneousData());
+            }
+        });
+    }
+
+    /**
+     * Resets the parser; producer side. The frames that are already in the queue are not affected.
+     */
+    void reset() { Base::reset(); }
+
+    /**
+     * Access to the instrumentation policy object; see @ref Parser.
+     * Beware that the instrumentation is updated from the producer side.
+     */
+    using Base::getInstrumentation;
+
+    /**
+     * Number of frames that were received while the queue was full; producer side.
+     */
+    std::uint32_t getDroppedFrameCount() const { return dropped_frame_count_; }
+
+    /**
+     * Returns the oldest frame in the queue, or nullptr if the queue is empty; consumer side.
+     * The frame (and its payload) remains valid until @ref pop() is invoked.
+     */
+    const ParserOutput::Frame* peek() const
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail != head_.load(std::memory_order_acquire))
+        {
+            return &slots_[tail].frame;
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    /**
+     * Removes the oldest frame from the queue, returning its slot to the parser; consumer side.
+     * The queue must not be empty.
+     */
+    void pop()
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        assert(tail != head_.load(std::memory_order_acquire));
+        tail_.store(next(tail), std::memory_order_release);
+    }
+
+    /**
+     * Returns the number of frames in the queue. Can be invoked from either side; the value may be outdated.
+     */
+    std::size_t size() const
+    {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return (head + NumberOfSlots - tail) % NumberOfSlots;
+    }
+
+    [[nodiscard]]   // prevents confusion with clear()
+    bool empty() const { return size() == 0; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
 };
 
 /**
  * Simple byte-by-byte data encoder/emitter.
  * This version uses an underlying buffer, and returns encoded data byte-by-byte.
  * There is also a more complex but more efficient version, see @ref StreamEmitter.
+ *
+ * The payload can be either a single contiguous buffer or a sequence of buffers (scatter-gather emission),
+ * which are emitted as one frame. The latter allows the application to avoid copying the payload into
+ * an intermediate buffer, e.g. a message header can be emitted directly followed by a large chunk of data
+ * from wherever it resides in the memory:
+ *
+ *      const auto head = standard::BootloaderImageDataResponseMessage::encodeFixedPart(offset, image_type);
+ *      const BufferedEmitter::PayloadSegment segments[] =
+ *      {
+ *          { head.data(), head.size() },
+ *          { flash_ptr, 256 },
+ *      };
+ *      BufferedEmitter emitter(presentation::StandardFrameTypeCode, std::begin(segments), std::end(segments));
  */
 class BufferedEmitter
 {
+public:
+    /**
+     * One contiguous part of the payload for scatter-gather emission.
+     */
+    struct PayloadSegment
+    {
+        const void* data = nullptr;
+        std::size_t size = 0;
+    };
+
+private:
     enum class State : std::uint8_t
     {
         FrontDelimiter,
@@ -465,10 +1466,39 @@ class BufferedEmitter
     std::uint8_t type_code_;              // Made non-const in order to make the object copyable
     std::size_t remaining_bytes_;
     const std::uint8_t* next_byte_ptr_;
+    const PayloadSegment* next_segment_ = nullptr;
+    const PayloadSegment* end_segment_ = nullptr;
     CRCComputer crc_;
     State state_ = State::FrontDelimiter;
     EscapeInjector escaper_;
 
+    /**
+     * Switches to the next non-empty payload segment if the current one is exhausted.
+     * Returns false if there are no more payload bytes left.
+     */
+    bool loadNextNonEmptySegment()
+    {
+        while ((remaining_bytes_ == 0) && (next_segment_ != end_segment_))
+        {
+            next_byte_ptr_ = static_cast<const std::uint8_t*>(next_segment_->data);
+            remaining_bytes_ = next_segment_->size;
+            ++next_segment_;
+        }
+        return remaining_bytes_ > 0;
+    }
+
+    void consumePayload(const std::size_t amount)
+    {
+        assert(amount <= remaining_bytes_);
+        next_byte_ptr_ += amount;
+        remaining_bytes_ -= amount;
+
+        if (!loadNextNonEmptySegment())
+        {
+            state_ = State::FrameType;
+        }
+    }
+
 public:
     /**
      * Constructs the object from a raw data pointer with explicit length.
@@ -521,6 +1551,29 @@ public:
         assert(payload_size <= sizeof(T));
     }
 
+    /**
+     * Constructs the object from a sequence of payload segments, which are emitted as one frame.
+     * The segments and the data they point to must remain valid until the emission is finished.
+     *
+     * @param frame_type_code       Frame type code to use with this frame.
+     *
+     * @param segments_begin        Pointer to the first payload segment.
+     *
+     * @param segments_end          Pointer past the last payload segment.
+     */
+    BufferedEmitter(std::uint8_t frame_type_code,
+                    const PayloadSegment* segments_begin,
+                    const PayloadSegment* segments_end) :
+        type_code_(frame_type_code),
+        remaining_bytes_(0),
+        next_byte_ptr_(nullptr),
+        next_segment_(segments_begin),
+        end_segment_(segments_end)
+    {
+        assert(segments_begin <= segments_end);
+        (void) loadNextNonEmptySegment();
+    }
+
     /**
      * Returns true if there are no more bytes to emit.
      */
@@ -553,14 +1606,7 @@ public:
         case State::Payload:
         {
             const std::uint8_t x = *next_byte_ptr_;
-            ++next_byte_ptr_;
-            --remaining_bytes_;
-
-            if (remaining_bytes_ == 0)
-            {
-                state_ = State::FrameType;
-            }
-
+            consumePayload(1);
             crc_.add(x);
             return escaper_.process(x);
         }
@@ -607,8 +1653,138 @@ public:
         // Stuff the output after the packet is finished with frame delimiters.
         return FrameDelimiter;
     }
+
+    /**
+     * Block-oriented alternative to @ref getNextByte(); useful for filling DMA buffers.
+     * Writes as many encoded bytes into the provided buffer as it can accommodate, until the frame is finished.
+     * Runs of payload bytes that do not require escaping are copied in bulk.
+     * The emission can be resumed by calling this function again (or @ref getNextByte()) with a new buffer;
+     * the resulting state is exactly the same as if the bytes were fetched one by one.
+     *
+     * @param out       Pointer to the output buffer.
+     *
+     * @param capacity  Size of the output buffer.
+     *
+     * @return          Number of bytes written. Less than capacity only if the frame is finished.
+     */
+    std::size_t emitInto(std::uint8_t* const out, const std::size_t capacity)
+    {
+        std::size_t size = 0;
+        while ((size < capacity) && !isFinished())
+        {
+            if ((state_ == State::Payload) && !escaper_.isPending())
+            {
+                const std::size_t max_run_length = std::min(remaining_bytes_, capacity - size);
+                const std::uint8_t* const run_end =
+                    detail_::findNextSpecialCharacter(next_byte_ptr_, next_byte_ptr_ + max_run_length);
+                const std::size_t run_length = std::size_t(run_end - next_byte_ptr_);
+                if (run_length > 0)
+                {
+                    std::memcpy(out + size, next_byte_ptr_, run_length);
+                    crc_.add(next_byte_ptr_, run_length);
+                    consumePayload(run_length);
+                    size += run_length;
+                    continue;
+                }
+            }
+
+            out[size++] = getNextByte();    // Special characters and the rest of the frame
+        }
+
+        return size;
+    }
+
+    /**
+     * Zero-copy alternative to @ref emitInto(); fills an array of I/O vectors that is ready to be passed
+     * to writev() or a similar scatter-gather output API. Runs of payload bytes that do not require escaping
+     * are referenced directly where they reside in the memory; everything else (delimiters, escape sequences,
+     * frame type code, CRC) is written into the provided scratch buffer, which the output vectors then refer to.
+     * The emission can be resumed by calling this function again once the output is consumed; the scratch
+     * buffer (and the payload) must not be altered until then.
+     *
+     * @tparam IOVector     A struct with the fields iov_base (pointer) and iov_len (size), e.g. POSIX ::iovec.
+     *
+     * @param out_vectors   Pointer to the output array of I/O vectors.
+     *
+     * @param max_vectors   Capacity of the output array.
+     *
+     * @param scratch       Pointer to the scratch buffer.
+     *
+     * @param scratch_size  Size of the scratch buffer; the emission stops early if it is exhausted.
+     *
+     * @return              Number of I/O vectors populated. Zero if there is nothing left to emit.
+     */
+    template <typename IOVector>
+    std::size_t emitIOVectors(IOVector* const out_vectors,
+                              const std::size_t max_vectors,
+                              std::uint8_t* const scratch,
+                              const std::size_t scratch_size)
+    {
+        std::size_t num_vectors = 0;
+        std::size_t scratch_used = 0;
+        bool last_vector_in_scratch = false;
+
+        while ((num_vectors < max_vectors) && !isFinished())
+        {
+            if ((state_ == State::Payload) && !escaper_.isPending())
+            {
+                const std::uint8_t* const run_end =
+                    detail_::findNextSpecialCharacter(next_byte_ptr_, next_byte_ptr_ + remaining_bytes_);
+                const std::size_t run_length = std::size_t(run_end - next_byte_ptr_);
+                if (run_length > 0)
+                {
+                    out_vectors[num_vectors].iov_base = const_cast<std::uint8_t*>(next_byte_ptr_);
+                    out_vectors[num_vectors].iov_len = run_length;
+                    ++num_vectors;
+                    last_vector_in_scratch = false;
+
+                    crc_.add(next_byte_ptr_, run_length);
+                    consumePayload(run_length);
+                    continue;
+                }
+            }
+
+            if (scratch_used >= scratch_size)
+            {
+                break;
+            }
+
+            scratch[scratch_used] = getNextByte();
+            if (last_vector_in_scratch)
+            {
+                out_vectors[num_vectors - 1].iov_len++;     // Adjacent bytes in the scratch are merged
+            }
+            else
+            {
+                out_vectors[num_vectors].iov_base = &scratch[scratch_used];
+                out_vectors[num_vectors].iov_len = 1;
+                ++num_vectors;
+                last_vector_in_scratch = true;
+            }
+            ++scratch_used;
+        }
+
+        return num_vectors;
+    }
 };
 
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Detects whether the stream emitter sink offers the optional bulk write method:
+ *      void write(const std::uint8_t* data, std::size_t size)
+ */
+template <typename Sink, typename = void>
+struct HasBulkWrite : public std::false_type { };
+
+template <typename Sink>
+struct HasBulkWrite<Sink, std::void_t<decltype(std::declval<Sink&>().write(std::declval<const std::uint8_t*>(),
+                                                                           std::declval<std::size_t>()))>> :
+    public std::true_type { };
+
+} // namespace detail_
+
 /**
  * This emitter is a bit trickier than @ref BufferedEmitter, use with care!
  * It works through a SEQUENTIAL ACCESS OUTPUT ITERATOR. When a byte of data is written into the iterator,
@@ -617,11 +1793,17 @@ public:
  * The class automatically finalizes the emitted message when the instance is destroyed. This is why the class
  * can't be copyable - that would break the RAII paradigm. An attempt to copy an instance of it will trigger a
  * compile-time error, so it is safe in this regard.
+ *
+ * @tparam Sink     The type of the data sink. It must be invocable as void (std::uint8_t); the invocation is
+ *                  inlined, unless the sink is type-erased (see @ref StreamEmitter). Optionally, the sink may
+ *                  also define the method void write(const std::uint8_t*, std::size_t); if it does, runs of bytes
+ *                  that do not require escaping are passed to it in one call (see @ref write()).
  */
-class StreamEmitter
+template <typename Sink>
+class BasicStreamEmitter
 {
     const std::uint8_t frame_type_code_;
-    const std::function<void (std::uint8_t)> sink_;
+    mutable Sink sink_;
     mutable CRCComputer crc_;
 
     void sinkWithEscaping(const std::uint8_t byte) const
@@ -637,6 +1819,21 @@ class StreamEmitter
         }
     }
 
+    void sinkRun(const std::uint8_t* data, std::size_t size) const
+    {
+        if constexpr (detail_::HasBulkWrite<Sink>::value)
+        {
+            sink_.write(data, size);
+        }
+        else
+        {
+            while (size --> 0)
+            {
+                sink_(*data++);
+            }
+        }
+    }
+
 public:
     /**
      * The proxy output iterator that is actually used to emit data.
@@ -644,11 +1841,11 @@ public:
      */
     class OutputIterator
     {
-        friend class StreamEmitter;
+        friend class BasicStreamEmitter;
 
-        const StreamEmitter* owner_;
+        const BasicStreamEmitter* owner_;
 
-        explicit OutputIterator(const StreamEmitter* master) : owner_(master) { }
+        explicit OutputIterator(const BasicStreamEmitter* master) : owner_(master) { }
 
     public:
         /**
@@ -687,13 +1884,16 @@ public:
      *
      *      encode(StreamEmitter(frame_type_code, my_callback).begin());
      *
+     * Or, if the sink should be inlined:
+     *
+     *      encode(BasicStreamEmitter(frame_type_code, my_lambda).begin());
+     *
      * In this way, usage is simple and the transfer is finalized as soon as possible.
      * More on lifetimes: https://stackoverflow.com/questions/584824/guaranteed-lifetime-of-temporary-in-c
      */
-    StreamEmitter(std::uint8_t frame_type_code,
-                  const std::function<void (std::uint8_t)>& sink) :
+    BasicStreamEmitter(std::uint8_t frame_type_code, Sink sink) :
         frame_type_code_(frame_type_code),
-        sink_(sink)
+        sink_(std::move(sink))
     {
         sink_(FrameDelimiter);
     }
@@ -702,7 +1902,7 @@ public:
      * Finalizes the transfer.
      * Make sure that the destructor is invoked before the next transfer is initiated!
      */
-    ~StreamEmitter()
+    ~BasicStreamEmitter()
     {
         sinkWithEscaping(frame_type_code_);
         crc_.add(frame_type_code_);
@@ -724,11 +1924,298 @@ public:
     }
 
     /**
-     * This is a RAII class with strong side effects, therefore it is non-copyable.
+     * Emits a block of payload bytes; this is equivalent to writing the bytes into the output iterator one by one.
+     * Runs of bytes that do not require escaping are passed to the bulk write method of the sink, if it has one.
      */
-    StreamEmitter(const StreamEmitter&) = delete;
-    StreamEmitter& operator=(const StreamEmitter&) = delete;
-};
+    void write(const void* const data, const std::size_t size) const
+    {
+        const auto* ptr = static_cast<const std::uint8_t*>(data);
+        const auto* const end = ptr + size;
+        crc_.add(ptr, size);
+
+        while (ptr != end)
+        {
+            const std::uint8_t* const run_end = detail_::findNextSpecialCharacter(ptr, end);
+            if (run_end != ptr)
+            {
+                sinkRun(ptr, std::size_t(run_end - ptr));
+                ptr = run_end;
+            }
+            else
+            {
+                sinkWithEscaping(*ptr++);
+            }
+        }
+    }
+
+    /**
+     * This is a RAII class with strong side effects, therefore it is non-copyable.
+     */
+    BasicStreamEmitter(const BasicStreamEmitter&) = delete;
+    BasicStreamEmitter& operator=(const BasicStreamEmitter&) = delete;
+};
+
+/**
+ * The stream emitter with a type-erased sink; see @ref BasicStreamEmitter.
+ * The sink invocation costs an indirect call per byte; use @ref BasicStreamEmitter directly where that matters.
+ */
+using StreamEmitter = BasicStreamEmitter<std::function<void (std::uint8_t)>>;
+
+/**
+ * Transmit scheduler that coalesces multiple frames into large blocks of data, one block per write.
+ * This is useful on links where every write has high fixed overhead, e.g. USB CDC, where every write
+ * becomes a separate transfer. The frames are encoded into their priority class queues upon arrival;
+ * the application then repeatedly invokes @ref poll() and writes the returned blocks to the link:
+ *
+ *      TransmitScheduler<2> scheduler(64, std::chrono::milliseconds(1));
+ *
+ *      scheduler.enqueue(0, BufferedEmitter(StandardFrameTypeCode, telemetry.data(), telemetry.size()), now());
+ *      scheduler.enqueue(1, BufferedEmitter(StandardFrameTypeCode, chunk.data(), chunk.size()), now());
+ *
+ *      if (const auto block = scheduler.poll(now()); !block.empty())
+ *      {
+ *          usbWrite(block.data(), block.size());       // The block is INVALIDATED by the next call to poll()
+ *      }
+ *
+ * Adjacent frames in a block share the frame delimiter between them, which is supported by the parser.
+ * Every block that begins at a frame boundary begins with a frame delimiter.
+ * Frames are taken in the order of priority (zero is the highest); within a class, in the order of arrival.
+ * A frame that does not fit into the remaining space of a block is split across consecutive blocks, so a
+ * higher-priority frame waits for at most one block (and the rest of the frame being transmitted).
+ *
+ * @tparam NumPriorities    Number of priority classes, each having its own queue.
+ * @tparam QueueCapacity    Capacity of each queue, in bytes of encoded data.
+ * @tparam BlockCapacity    Maximum size of one block returned by @ref poll().
+ * @tparam Duration         Time type used to express the flush deadline.
+ */
+template <std::size_t NumPriorities = 2,
+          std::size_t QueueCapacity = 4096,
+          std::size_t BlockCapacity = 512,
+          typename Duration = std::chrono::microseconds>
+class TransmitScheduler
+{
+    static_assert(NumPriorities > 0, "There shall be at least one priority class");
+    static_assert(QueueCapacity > 0, "Queue capacity cannot be zero");
+    static_assert(BlockCapacity >= 2, "The block must accommodate the delimiter and at least one byte of a frame");
+
+    /**
+     * Circular buffer of encoded frames. Frames are stored without the leading delimiter, so the boundaries
+     * are defined by the trailing delimiters.
+     */
+    class Queue
+    {
+        std::array<std::uint8_t, QueueCapacity> buffer_{};
+        std::size_t read_pos_ = 0;
+        std::size_t size_ = 0;
+
+    public:
+        /// The frame is either added completely or not at all.
+        bool push(BufferedEmitter& emitter)
+        {
+            (void) emitter.getNextByte();                       // The leading delimiter is not stored
+            std::size_t written = 0;
+            std::size_t pos = (read_pos_ + size_) % QueueCapacity;
+            while (!emitter.isFinished())
+            {
+                const std::size_t free = QueueCapacity - size_ - written;
+                if (free == 0)
+                {
+                    return false;
+                }
+                const std::size_t n = emitter.emitInto(&buffer_[pos], std::min(free, QueueCapacity - pos));
+                written += n;
+                pos = (pos + n) % QueueCapacity;
+            }
+            size_ += written;
+            return true;
+        }
+
+        /// Moves up to max_size bytes into the output until the end of the frame; returns true if reached the end.
+        bool pop(std::uint8_t* const out, std::size_t& inout_size, const std::size_t max_size)
+        {
+            while ((inout_size < max_size) && (size_ > 0))
+            {
+                const std::uint8_t* const begin = &buffer_[read_pos_];
+                const std::size_t contiguous = std::min({size_, QueueCapacity - read_pos_, max_size - inout_size});
+                const auto delimiter = static_cast<const std::uint8_t*>(std::memchr(begin, FrameDelimiter,
+                                                                                    contiguous));
+                const std::size_t amount = (delimiter != nullptr) ? std::size_t(delimiter - begin + 1) : contiguous;
+
+                std::memcpy(out + inout_size, begin, amount);
+                inout_size += amount;
+                read_pos_ = (read_pos_ + amount) % QueueCapacity;
+                size_ -= amount;
+
+                if (delimiter != nullptr)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::size_t size() const { return size_; }
+    };
+
+    std::array<Queue, NumPriorities> queues_;
+    std::array<std::uint8_t, BlockCapacity> block_{};
+    std::optional<std::size_t> unfinished_class_;           ///< The class the last block has ended in the middle of
+    std::optional<Duration> oldest_enqueued_at_;            ///< When the oldest of the pending frames was enqueued
+
+    const std::size_t flush_threshold_;
+    const Duration max_delay_;
+
+public:
+    /**
+     * A contiguous block of encoded data that is ready to be written to the link.
+     */
+    class Block
+    {
+        const std::uint8_t* ptr_ = nullptr;
+        std::size_t size_ = 0;
+
+    public:
+        Block() = default;
+        Block(const std::uint8_t* data_ptr, std::size_t data_size) : ptr_(data_ptr), size_(data_size) { }
+
+        const std::uint8_t* begin() const { return ptr_; }
+        const std::uint8_t* end() const { return ptr_ + size_; }
+        const std::uint8_t* data() const { return ptr_; }
+        std::size_t size() const { return size_; }
+        [[nodiscard]]   // prevents confusion with clear()
+        bool empty() const { return size_ == 0; }
+    };
+
+    /**
+     * @param flush_threshold   A block is returned as soon as this many bytes are pending.
+     *                          Normally this is the optimal transfer size of the link.
+     * @param max_delay         A block is returned when the oldest pending frame has been waiting for this long,
+     *                          even if the threshold is not reached. Zero means no coalescing delay:
+     *                          the frames that were enqueued since the last poll are sent immediately.
+     *                          The frames that remain pending after a block is returned keep their original
+     *                          enqueue time, so the deadline is never extended by the link being busy.
+     */
+    explicit TransmitScheduler(const std::size_t flush_threshold = BlockCapacity,
+                               const Duration max_delay = Duration::zero()) :
+        flush_threshold_(std::min(std::max<std::size_t>(1, flush_threshold), BlockCapacity)),
+        max_delay_(max_delay)
+    { }
+
+    /**
+     * Encodes the frame into the queue of the specified priority class.
+     * The payload is copied, so the emitter and its payload can be discarded immediately.
+     *
+     * @param priority  Priority class, zero is the highest. Must be less than NumPriorities.
+     * @param emitter   Not started emitter of the frame.
+     * @param now       Current time, used for the flush deadline.
+     *
+     * @return          False if the queue does not have enough space for the frame; it is not enqueued then.
+     */
+    bool enqueue(const std::size_t priority, BufferedEmitter emitter, const Duration now)
+    {
+        assert(priority < NumPriorities);
+        if (!queues_[priority].push(emitter))
+        {
+            return false;
+        }
+
+        if (!oldest_enqueued_at_)
+        {
+            oldest_enqueued_at_ = now;
+        }
+        return true;
+    }
+
+    bool enqueue(const std::size_t priority,
+                 const std::uint8_t frame_type_code,
+                 const void* const payload_ptr,
+                 const std::size_t payload_size,
+                 const Duration now)
+    {
+        return enqueue(priority, BufferedEmitter(frame_type_code, payload_ptr, payload_size), now);
+    }
+
+    /**
+     * Returns the next block to write if the flush threshold or the deadline is reached, otherwise an empty block.
+     * The returned data is INVALIDATED upon the next call to this method or @ref flush().
+     */
+    Block poll(const Duration now)
+    {
+        const bool due = (getPendingSize() >= flush_threshold_) ||
+                         (oldest_enqueued_at_ && (now >= (*oldest_enqueued_at_ + max_delay_)));
+        return due ? flush() : Block();
+    }
+
+    /**
+     * Like @ref poll(), but returns the next block unconditionally. The block is empty if nothing is pending.
+     */
+    Block flush()
+    {
+        std::size_t size = 0;
+        if (!unfinished_class_ && (getPendingSize() > 0))
+        {
+            block_[size++] = FrameDelimiter;
+        }
+
+        while (size < BlockCapacity)
+        {
+            std::size_t cls = 0;
+            if (unfinished_class_)
+            {
+                cls = *unfinished_class_;
+            }
+            else
+            {
+                while ((cls < NumPriorities) && (queues_[cls].size() == 0))
+                {
+                    cls++;
+                }
+                if (cls >= NumPriorities)
+                {
+                    break;
+                }
+            }
+
+            if (queues_[cls].pop(block_.data(), size, BlockCapacity))
+            {
+                unfinished_class_.reset();
+            }
+            else
+            {
+                unfinished_class_ = cls;
+            }
+        }
+
+        if (getPendingSize() == 0)
+        {
+            oldest_enqueued_at_.reset();
+        }
+
+        return Block(block_.data(), size);
+    }
+
+    /**
+     * Number of encoded bytes waiting in the queues; the shared delimiters are not included.
+     */
+    std::size_t getPendingSize() const
+    {
+        std::size_t out = 0;
+        for (auto& q : queues_)
+        {
+            out += q.size();
+        }
+        return out;
+    }
+
+    std::size_t getPendingSize(const std::size_t priority) const
+    {
+        assert(priority < NumPriorities);
+        return queues_[priority].size();
+    }
+
+    [[nodiscard]]   // prevents confusion with clear()
+    bool empty() const { return getPendingSize() == 0; }
+};
 
 } // namespace transport
 
@@ -739,11 +2226,63 @@ namespace presentation
 {
 /**
  * Application-specific frame type codes range from 0 to 127 (0x7F), inclusive.
- * Standard frame type codes range from 128 (0x80) to 255 (0xFF), inclusive. Currently, only 255 (0xFF) is used.
+ * Standard frame type codes range from 128 (0x80) to 255 (0xFF), inclusive. Currently, only 255 (0xFF) and
+ * 254 (0xFE, see @ref FrameCompressor) are used.
  */
 static constexpr std::uint8_t StandardFrameTypeCode               = 0xFF;
+static constexpr std::uint8_t CompressedFrameTypeCode             = 0xFE;
 static constexpr std::uint8_t MaxApplicationSpecificFrameTypeCode = 0x7F;
 
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+# define POPCOP_LITTLE_ENDIAN_ 1
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+# define POPCOP_BIG_ENDIAN_ 1
+#endif
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * The byte order of the target is known only if the compiler reports it (GCC and Clang do).
+ * If it is unknown (e.g. MSVC, IAR, armcc 5), the values are encoded and decoded byte by byte using shifts,
+ * which is correct on any target.
+ */
+enum class ByteOrder
+{
+    LittleEndian,
+    BigEndian,
+    Unknown,
+};
+
+#if defined(POPCOP_LITTLE_ENDIAN_)
+static constexpr ByteOrder TargetByteOrder = ByteOrder::LittleEndian;
+#elif defined(POPCOP_BIG_ENDIAN_)
+static constexpr ByteOrder TargetByteOrder = ByteOrder::BigEndian;
+#else
+static constexpr ByteOrder TargetByteOrder = ByteOrder::Unknown;
+#endif
+
+template <typename T>
+constexpr T reverseByteOrder(const T x)
+{
+    static_assert(std::is_unsigned_v<T>);
+    T out = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++)
+    {
+        out = T(out | T(((x >> (i * 8U)) & 0xFFU) << ((sizeof(T) - 1U - i) * 8U)));
+    }
+    return out;
+}
+
+/**
+ * True if the iterator is a raw pointer to bytes, so that the data can be accessed in bulk.
+ */
+template <typename Iterator>
+static constexpr bool IsContiguousByteIterator =
+    std::is_pointer_v<Iterator> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<Iterator>>, std::uint8_t>;
+
+} // namespace detail_
+
 /**
  * A simple helper class that writes out encoded data into a designated iterator.
  */
@@ -866,10 +2405,33 @@ public:
         end_(end)
     { }
 
+    /**
+     * If the input is a contiguous range of bytes (see @ref detail_::IsContiguousByteIterator, e.g. the payload of
+     * @ref transport::ParserOutput::Frame), the length is checked once per field and the data is copied in bulk.
+     * Otherwise, or if the input is too short, the data is fetched byte by byte, and missing bytes read as zero.
+     */
+    static constexpr bool IsContiguous = detail_::IsContiguousByteIterator<InputByteIterator>;
+
     template <std::size_t NumBytes>
     auto fetchUnsignedInteger()
     {
         using T = typename UnsignedTypeSelector<NumBytes>::T;
+        if constexpr (IsContiguous && (detail_::TargetByteOrder != detail_::ByteOrder::Unknown))
+        {
+            if (std::size_t(end_ - input_) >= NumBytes)
+            {
+                T out = 0;
+                std::memcpy(&out, input_, NumBytes);        // Unaligned little-endian load
+                if constexpr (detail_::TargetByteOrder == detail_::ByteOrder::BigEndian)
+                {
+                    out = detail_::reverseByteOrder(out);
+                }
+                input_ += NumBytes;
+                length_ += NumBytes;
+                return out;
+            }
+        }
+
         T out = 0;
         for (std::size_t i = 0; (i < NumBytes) && (input_ != end_); i++)
         {
@@ -929,6 +2491,13 @@ public:
     template <typename OutputByteIterator, typename = std::enable_if_t<!std::is_integral_v<OutputByteIterator>>>
     void fetchBytes(OutputByteIterator out_begin, const OutputByteIterator out_end)
     {
+        using Category = typename std::iterator_traits<OutputByteIterator>::iterator_category;
+        if constexpr (IsContiguous && std::is_base_of_v<std::random_access_iterator_tag, Category>)
+        {
+            fetchBytes(out_begin, std::size_t(std::max<std::ptrdiff_t>(0, std::distance(out_begin, out_end))));
+            return;
+        }
+
         while ((out_begin != out_end) && (input_ != end_))
         {
             *out_begin++ = *input_++;
@@ -939,6 +2508,25 @@ public:
     template <typename OutputByteIterator>
     void fetchBytes(OutputByteIterator out_begin, std::size_t amount)
     {
+        if constexpr (IsContiguous)
+        {
+            const std::size_t n = std::min(amount, std::size_t(end_ - input_));
+            if constexpr (detail_::IsContiguousByteIterator<OutputByteIterator>)
+            {
+                if (n > 0)
+                {
+                    std::memcpy(out_begin, input_, n);
+                }
+            }
+            else
+            {
+                std::copy_n(input_, n, out_begin);
+            }
+            input_ += n;
+            length_ += n;
+            return;
+        }
+
         while ((amount --> 0) && (input_ != end_))
         {
             *out_begin++ = *input_++;
@@ -967,6 +2555,14 @@ public:
     void skipUpToOffset(const std::size_t offset)
     {
         assert(length_ <= offset);
+        if constexpr (IsContiguous)
+        {
+            const std::size_t n = std::min(offset - length_, std::size_t(end_ - input_));
+            input_ += n;
+            length_ += n;
+            return;
+        }
+
         while ((length_ < offset) && (input_ != end_))
         {
             input_++;
@@ -981,184 +2577,2312 @@ public:
         return std::size_t(std::max<std::int64_t>(0, std::distance(input_, end_)));
     }
 
+    /**
+     * The iterator pointing to the next byte of the input.
+     */
+    InputByteIterator getPosition() const { return input_; }
+
     StreamDecoder<InputByteIterator> makeNew() const
     {
         return StreamDecoder<InputByteIterator>(input_, end_);
     }
 };
 
-}   // namespace presentation
-
 /**
- * Standard messages.
+ * Kinds of fields supported by @ref FieldCodec.
  */
-namespace standard
+enum class FieldKind : std::uint8_t
 {
-/**
- * Default request timeout applicable to standard messages.
- */
-static constexpr std::chrono::seconds DefaultStandardRequestTimeout = std::chrono::seconds(1);
-
-/**
- * Time point representation used in standard Popcop messages. Application-specific messages can obviously use custom
- * time representation formats.
- * The timestamp is a 64-bit unsigned integer number of nanoseconds since some arbitrary point in time.
- * Assuming the worst case that the reference point is the beginning of the UNIX epoch, we can expect the
- * timestamp to roll over to zero on:
- *  1970 + (2**64 - 1) / 1e9 / 3600 / 24 / 365 = 2554.9
- */
-using Timestamp = std::chrono::duration<std::uint64_t, std::nano>;
+    Unsigned,           ///< Unsigned integers, bool, and enums or durations whose representation is unsigned
+    Signed,             ///< Signed integers, and enums or durations whose representation is signed
+    IEEE754,            ///< float, double
+    Bytes,              ///< std::array<std::uint8_t, N>, copied verbatim
+};
 
 /**
- * ID of all standard messages are listed here.
+ * Compile-time description of an encoded field: where it is located in the encoded stream and how it is encoded.
  */
-enum class MessageID : std::uint16_t
+struct FieldDescriptor
 {
-    EndpointInfo                    = 0,
-    RegisterDataRequest             = 1,
-    RegisterDataResponse            = 2,
-    RegisterDiscoveryRequest        = 3,
-    RegisterDiscoveryResponse       = 4,
-    RegisterTraceSetupRequest       = 5,
-    RegisterTraceSetupResponse      = 6,
-    RegisterTraceEvent              = 7,
-    DeviceManagementCommandRequest  = 8,
-    DeviceManagementCommandResponse = 9,
-    BootloaderStatusRequest         = 10,
-    BootloaderStatusResponse        = 11,
-    BootloaderImageDataRequest      = 12,
-    BootloaderImageDataResponse     = 13,
+    std::size_t offset = 0;
+    std::size_t width = 0;
+    FieldKind kind{};
 };
 
-/**
- * This class represents a standard frame header.
- * It can be used to parse and generate standard frames.
- *
- *    Offset    Type    Name
- *  ---------------------------------------------------
- *      0       u16     message_id
- *  ---------------------------------------------------
- *      2
- */
-struct MessageHeader
+/// Implementation details; do not use that in user code
+namespace detail_
 {
-    static constexpr std::size_t Size = 2;
 
-    MessageID message_id{};
+template <typename T>
+struct MemberPointerTraits;
 
-    MessageHeader() = default;
+template <typename C, typename V>
+struct MemberPointerTraits<V C::*>
+{
+    using Owner = C;
+    using Value = V;
+};
 
-    explicit MessageHeader(MessageID mid) : message_id(mid) { }
+template <typename T> struct IsByteArray : public std::false_type { };
+template <std::size_t N> struct IsByteArray<std::array<std::uint8_t, N>> : public std::true_type { };
 
-    /**
-     * Encodes the message into the provided stream encoder.
-     * The encoder's underlying iterator can encode and emit the message on the fly - that would be highly efficient.
-     */
-    template <typename OutputIterator>
-    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+template <typename T> struct IsDuration : public std::false_type { };
+template <typename R, typename P> struct IsDuration<std::chrono::duration<R, P>> : public std::true_type { };
+
+/**
+ * Converts the value into the scalar type that is actually serialized.
+ */
+template <typename T>
+constexpr auto toFieldScalar(const T& x)
+{
+    if constexpr (std::is_enum_v<T>)
     {
-        encoder.addU16(std::uint16_t(message_id));
+        return static_cast<std::underlying_type_t<T>>(x);
     }
-
-    template <typename InputIterator>
-    static std::optional<MessageHeader> tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    else if constexpr (IsDuration<T>::value)
     {
-        if (decoder.getRemainingLength() >= Size)
-        {
-            MessageHeader hdr(MessageID(decoder.fetchU16()));
-            return hdr;
+        return x.count();
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return std::uint8_t(x ? 1U : 0U);
+    }
+    else
+    {
+        static_assert(std::is_arithmetic_v<T>, "Unsupported field type");
+        return x;
+    }
+}
+
+template <typename T, typename S>
+constexpr T fromFieldScalar(const S& x)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        return static_cast<T>(static_cast<std::underlying_type_t<T>>(x));
+    }
+    else if constexpr (IsDuration<T>::value)
+    {
+        return T(static_cast<typename T::rep>(x));
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return x != 0;
+    }
+    else
+    {
+        return static_cast<T>(x);
+    }
+}
+
+template <typename T>
+constexpr FieldKind getFieldKind()
+{
+    if constexpr (IsByteArray<T>::value)
+    {
+        return FieldKind::Bytes;
+    }
+    else
+    {
+        using S = decltype(toFieldScalar(std::declval<T>()));
+        if constexpr (std::is_floating_point_v<S>)
+        {
+            return FieldKind::IEEE754;
+        }
+        else
+        {
+            return std::is_signed_v<S> ? FieldKind::Signed : FieldKind::Unsigned;
+        }
+    }
+}
+
+template <typename T>
+constexpr std::size_t getNaturalFieldWidth()
+{
+    if constexpr (IsByteArray<T>::value)
+    {
+        return std::tuple_size_v<T>;
+    }
+    else
+    {
+        return sizeof(decltype(toFieldScalar(std::declval<T>())));
+    }
+}
+
+} // namespace detail_
+
+/**
+ * Describes one field of a structure for @ref FieldCodec.
+ * @tparam Member   Pointer to the data member.
+ * @tparam Width    Number of bytes in the encoded stream; defaults to the size of the member. Integers can be
+ *                  encoded narrower than their in-memory representation (e.g. std::size_t as u16), doubles can be
+ *                  encoded as f32.
+ */
+template <auto Member, std::size_t EncodedWidth = 0>
+struct Field
+{
+    using Owner = typename detail_::MemberPointerTraits<decltype(Member)>::Owner;
+    using Value = typename detail_::MemberPointerTraits<decltype(Member)>::Value;
+
+    static constexpr auto Pointer = Member;
+    static constexpr FieldKind Kind = detail_::getFieldKind<Value>();
+    static constexpr std::size_t NaturalWidth = detail_::getNaturalFieldWidth<Value>();
+    static constexpr std::size_t Width = (EncodedWidth > 0) ? EncodedWidth : NaturalWidth;
+
+    static_assert((Kind == FieldKind::Bytes) ? (Width == NaturalWidth) :
+                  (Kind == FieldKind::IEEE754) ? ((Width == 4) || (Width == 8)) :
+                  (((Width == 1) || (Width == 2) || (Width == 4) || (Width == 8)) && (Width <= NaturalWidth)),
+                  "Invalid field width");
+
+    /**
+     * The field can be copied to and from the encoded stream with memcpy(): the encoded representation is the same
+     * as the in-memory representation (bool is excluded because not every byte value is a valid bool).
+     */
+    static constexpr bool IsMemcpyCompatible =
+        std::is_trivially_copyable_v<Value> &&
+        ((Kind == FieldKind::Bytes) ||
+         ((detail_::TargetByteOrder == detail_::ByteOrder::LittleEndian) &&
+          (Width == sizeof(Value)) && !std::is_same_v<Value, bool>));
+};
+
+/**
+ * Generates the encoding and decoding code for a structure from the list of its fields, so that the repetitive
+ * sequences of StreamEncoder::addU64() and StreamDecoder::fetchU8() calls need not be written by hand.
+ * The fields are encoded one after another in the specified order, little-endian, without padding,
+ * the same way as they would be encoded manually. Only fixed-size fields are supported (see @ref FieldKind),
+ * so the encoded size is known at compile time. For example:
+ *
+ *      struct Telemetry
+ *      {
+ *          std::chrono::microseconds timestamp;
+ *          float voltage;
+ *          std::size_t error_count;
+ *          Mode mode;
+ *      };
+ *
+ *      using TelemetryCodec = presentation::FieldCodec<Telemetry,
+ *                                                      presentation::Field<&Telemetry::timestamp>,
+ *                                                      presentation::Field<&Telemetry::voltage>,
+ *                                                      presentation::Field<&Telemetry::error_count, 2>,
+ *                                                      presentation::Field<&Telemetry::mode>>;
+ *
+ *      std::array<std::uint8_t, TelemetryCodec::EncodedSize> buf;
+ *      TelemetryCodec::encode(telemetry, buf.data());
+ *
+ * The code is fully unrolled. The overloads that operate on raw pointers copy the fields whose in-memory
+ * representation matches the encoded one with memcpy() (on little-endian targets), which the compiler merges
+ * into wide loads and stores for contiguous runs of fields; this is much faster than the byte-by-byte stream
+ * encoder for large structures.
+ */
+template <typename Struct, typename... Fields>
+class FieldCodec
+{
+    static_assert((std::is_same_v<typename Fields::Owner, Struct> && ...), "Fields must belong to the structure");
+
+    static constexpr std::array<FieldDescriptor, sizeof...(Fields)> makeDescriptors()
+    {
+        std::array<FieldDescriptor, sizeof...(Fields)> out{};
+        std::size_t offset = 0;
+        std::size_t index = 0;
+        ((out[index++] = FieldDescriptor{ offset, Fields::Width, Fields::Kind }, offset += Fields::Width), ...);
+        return out;
+    }
+
+public:
+    /**
+     * Offset, width, and kind of every field, in the order of encoding.
+     */
+    static constexpr std::array<FieldDescriptor, sizeof...(Fields)> Descriptors = makeDescriptors();
+
+    static constexpr std::size_t EncodedSize = (std::size_t(0) + ... + Fields::Width);
+    static constexpr std::size_t MinEncodedSize = EncodedSize;
+    static constexpr std::size_t MaxEncodedSize = EncodedSize;
+
+private:
+    template <typename F, typename OutputIterator>
+    static void encodeField(const Struct& obj, StreamEncoder<OutputIterator>& encoder)
+    {
+        const auto& value = obj.*F::Pointer;
+        if constexpr (F::Kind == FieldKind::Bytes)
+        {
+            encoder.addBytes(value);
+        }
+        else if constexpr (F::Kind == FieldKind::IEEE754)
+        {
+            encoder.template addIEEE754<F::Width>(value);
+        }
+        else if constexpr (F::Kind == FieldKind::Signed)
+        {
+            encoder.template addSignedInteger<F::Width>(detail_::toFieldScalar(value));
+        }
+        else
+        {
+            encoder.template addUnsignedInteger<F::Width>(detail_::toFieldScalar(value));
+        }
+    }
+
+    template <typename F, typename InputIterator>
+    static void decodeField(Struct& obj, StreamDecoder<InputIterator>& decoder)
+    {
+        auto& value = obj.*F::Pointer;
+        using V = typename F::Value;
+        if constexpr (F::Kind == FieldKind::Bytes)
+        {
+            decoder.fetchBytes(value.begin(), value.size());
+        }
+        else if constexpr (F::Kind == FieldKind::IEEE754)
+        {
+            value = V(decoder.template fetchIEEE754<F::Width>());
+        }
+        else if constexpr (F::Kind == FieldKind::Signed)
+        {
+            value = detail_::fromFieldScalar<V>(decoder.template fetchSignedInteger<F::Width>());
+        }
+        else
+        {
+            value = detail_::fromFieldScalar<V>(decoder.template fetchUnsignedInteger<F::Width>());
+        }
+    }
+
+    template <std::size_t Index, typename F>
+    static void encodeFieldAt(const Struct& obj, std::uint8_t* const out)
+    {
+        if constexpr (F::IsMemcpyCompatible)
+        {
+            std::memcpy(out + Descriptors[Index].offset, &(obj.*F::Pointer), F::Width);
+        }
+        else
+        {
+            StreamEncoder<std::uint8_t*> encoder(out + Descriptors[Index].offset);
+            encodeField<F>(obj, encoder);
+        }
+    }
+
+    template <std::size_t Index, typename F>
+    static void decodeFieldAt(Struct& obj, const std::uint8_t* const in)
+    {
+        if constexpr (F::IsMemcpyCompatible)
+        {
+            std::memcpy(&(obj.*F::Pointer), in + Descriptors[Index].offset, F::Width);
         }
         else
+        {
+            StreamDecoder<const std::uint8_t*> decoder(in + Descriptors[Index].offset,
+                                                       in + Descriptors[Index].offset + F::Width);
+            decodeField<F>(obj, decoder);
+        }
+    }
+
+    template <std::size_t... Is>
+    static void encodeAll(const Struct& obj, std::uint8_t* const out, std::index_sequence<Is...>)
+    {
+        (encodeFieldAt<Is, Fields>(obj, out), ...);
+    }
+
+    template <std::size_t... Is>
+    static void decodeAll(Struct& obj, const std::uint8_t* const in, std::index_sequence<Is...>)
+    {
+        (decodeFieldAt<Is, Fields>(obj, in), ...);
+    }
+
+public:
+    /**
+     * Encodes all fields into the provided stream encoder; this allows one to prepend a header or append
+     * variable-length data.
+     */
+    template <typename OutputIterator>
+    static void encode(const Struct& obj, StreamEncoder<OutputIterator>& encoder)
+    {
+        (encodeField<Fields>(obj, encoder), ...);
+    }
+
+    /**
+     * Encodes all fields into the provided buffer, which must be at least @ref EncodedSize bytes large.
+     * Returns the number of bytes written, which is always @ref EncodedSize.
+     */
+    static std::size_t encode(const Struct& obj, std::uint8_t* const out)
+    {
+        encodeAll(obj, out, std::index_sequence_for<Fields...>{});
+        return EncodedSize;
+    }
+
+    /**
+     * Decodes all fields from the provided stream decoder.
+     * If the decoder has less than @ref EncodedSize bytes left, the missing bytes read as zero.
+     */
+    template <typename InputIterator>
+    static void decode(Struct& obj, StreamDecoder<InputIterator>& decoder)
+    {
+        if constexpr (StreamDecoder<InputIterator>::IsContiguous)
+        {
+            if (decoder.getRemainingLength() >= EncodedSize)
+            {
+                decode(obj, decoder.getPosition());     // The length is checked once per structure
+                decoder.skipUpToOffset(decoder.getOffset() + EncodedSize);
+                return;
+            }
+        }
+
+        (decodeField<Fields>(obj, decoder), ...);
+    }
+
+    /**
+     * Decodes all fields from the provided buffer, which must be at least @ref EncodedSize bytes large.
+     */
+    static void decode(Struct& obj, const std::uint8_t* const in)
+    {
+        decodeAll(obj, in, std::index_sequence_for<Fields...>{});
+    }
+
+    /**
+     * Decodes a default-constructed structure; the size of the input must be exactly @ref EncodedSize.
+     */
+    static std::optional<Struct> tryDecode(const std::uint8_t* const begin, const std::uint8_t* const end)
+    {
+        if ((end < begin) || (std::size_t(end - begin) != EncodedSize))
+        {
+            return {};
+        }
+
+        Struct obj{};
+        decode(obj, begin);
+        return obj;
+    }
+};
+
+/**
+ * A tiny LZ77-style codec for frame payloads. It needs no memory apart from a small hash table on the stack
+ * of the compressor; the decompressor uses the output buffer as its window. The compressed data is a sequence
+ * of tokens:
+ *
+ *      Token                       Meaning
+ *  -----------------------------------------------------------------------------------------------
+ *      0LLLLLLL                    Literal run: the next L+1 bytes (1 to 128) are copied to the output verbatim.
+ *      1LLLLLLL, u16 distance      Match: L+4 bytes (4 to 131) are copied from distance bytes back in the output
+ *                                  (1 to 65535); the source may overlap the destination, which encodes runs.
+ *  -----------------------------------------------------------------------------------------------
+ */
+namespace compression
+{
+
+static constexpr std::size_t MinMatchLength = 4;
+static constexpr std::size_t MaxMatchLength = 0x7F + MinMatchLength;
+static constexpr std::size_t MaxLiteralRunLength = 0x80;
+static constexpr std::size_t MaxInputSize = 0xFFFF;
+
+/**
+ * Compresses the data into the provided buffer.
+ * Returns the size of the compressed data, or nothing if it does not fit into the buffer or the input is larger
+ * than @ref MaxInputSize.
+ *
+ * @tparam HashBits     The hash table occupies 2**(HashBits+1) bytes of stack; larger tables compress better.
+ */
+template <std::size_t HashBits = 8>
+inline std::optional<std::size_t> compress(const std::uint8_t* const in,
+                                           const std::size_t in_size,
+                                           std::uint8_t* const out,
+                                           const std::size_t out_capacity)
+{
+    static_assert((HashBits > 0) && (HashBits <= 16));
+
+    if (in_size > MaxInputSize)
+    {
+        return {};
+    }
+
+    std::array<std::uint16_t, (1U << HashBits)> table{};    // Positions of the last occurrences of the hashes
+
+    const auto hash = [in](const std::size_t pos)
+    {
+        const std::uint32_t x = (std::uint32_t(in[pos + 0]) <<  0U) | (std::uint32_t(in[pos + 1]) <<  8U) |
+                                (std::uint32_t(in[pos + 2]) << 16U) | (std::uint32_t(in[pos + 3]) << 24U);
+        return std::size_t((x * 2654435761U) >> (32U - HashBits));
+    };
+
+    std::size_t op = 0;
+    std::size_t literal_start = 0;
+
+    const auto flush_literals = [&](const std::size_t literal_end)
+    {
+        while (literal_start < literal_end)
+        {
+            const std::size_t n = std::min(MaxLiteralRunLength, literal_end - literal_start);
+            if ((op + 1 + n) > out_capacity)
+            {
+                return false;
+            }
+            out[op++] = std::uint8_t(n - 1);
+            std::memcpy(out + op, in + literal_start, n);
+            op += n;
+            literal_start += n;
+        }
+        return true;
+    };
+
+    std::size_t ip = 0;
+    while ((ip + MinMatchLength) <= in_size)
+    {
+        const std::size_t h = hash(ip);
+        const std::size_t candidate = table[h];
+        table[h] = std::uint16_t(ip);
+
+        if ((candidate >= ip) || (std::memcmp(in + candidate, in + ip, MinMatchLength) != 0))
+        {
+            ip++;
+            continue;
+        }
+
+        std::size_t length = MinMatchLength;
+        while (((ip + length) < in_size) && (length < MaxMatchLength) && (in[candidate + length] == in[ip + length]))
+        {
+            length++;
+        }
+
+        if (!flush_literals(ip) || ((op + 3) > out_capacity))
         {
             return {};
         }
+
+        const std::size_t distance = ip - candidate;
+        out[op++] = std::uint8_t(0x80U | (length - MinMatchLength));
+        out[op++] = std::uint8_t(distance & 0xFFU);
+        out[op++] = std::uint8_t(distance >> 8U);
+
+        for (std::size_t i = ip + 1; (i < (ip + length)) && ((i + MinMatchLength) <= in_size); i++)
+        {
+            table[hash(i)] = std::uint16_t(i);
+        }
+        ip += length;
+        literal_start = ip;
+    }
+
+    if (!flush_literals(in_size))
+    {
+        return {};
+    }
+    return op;
+}
+
+/**
+ * Decompresses the data into the provided buffer.
+ * Returns the size of the decompressed data, or nothing if the input is malformed or the output does not fit.
+ */
+inline std::optional<std::size_t> decompress(const std::uint8_t* const in,
+                                             const std::size_t in_size,
+                                             std::uint8_t* const out,
+                                             const std::size_t out_capacity)
+{
+    std::size_t ip = 0;
+    std::size_t op = 0;
+    while (ip < in_size)
+    {
+        const std::uint8_t token = in[ip++];
+        if ((token & 0x80U) == 0)
+        {
+            const std::size_t n = std::size_t(token) + 1U;
+            if (((ip + n) > in_size) || ((op + n) > out_capacity))
+            {
+                return {};
+            }
+            std::memcpy(out + op, in + ip, n);
+            ip += n;
+            op += n;
+        }
+        else
+        {
+            if ((ip + 2) > in_size)
+            {
+                return {};
+            }
+            const std::size_t n = std::size_t(token & 0x7FU) + MinMatchLength;
+            const std::size_t distance = std::size_t(in[ip]) | (std::size_t(in[ip + 1]) << 8U);
+            ip += 2;
+            if ((distance == 0) || (distance > op) || ((op + n) > out_capacity))
+            {
+                return {};
+            }
+            for (std::size_t i = 0; i < n; i++, op++)
+            {
+                out[op] = out[op - distance];     // Byte by byte, because the source may overlap the destination
+            }
+        }
+    }
+    return op;
+}
+
+}   // namespace compression
+
+/**
+ * Compresses outgoing frames. A compressed frame has the type code @ref CompressedFrameTypeCode; its payload is
+ * the type code of the original frame followed by the compressed payload (see @ref compression):
+ *
+ *      Offset  Type    Name
+ *  ---------------------------------------------------
+ *      0       u8      type_code           Type code of the original frame; cannot be CompressedFrameTypeCode.
+ *      1       u8[]    compressed_payload
+ *  ---------------------------------------------------
+ *
+ * If compression does not make the frame shorter, the frame is emitted as-is, without copying the payload,
+ * so the receiving side must be prepared to accept either form; see @ref FrameDecompressor.
+ * Receivers that are not aware of compression will ignore the compressed frames as unknown, so compression
+ * should be enabled only if the other side is known to support it.
+ *
+ *      FrameCompressor<> compressor;
+ *      compressor.compress(presentation::StandardFrameTypeCode, buf.data(), buf.size());
+ *      transport::BufferedEmitter emitter = compressor.makeEmitter();
+ *      // Or: StreamEmitter(compressor.getTypeCode(), sink).write(compressor.getPayloadData(), ...);
+ *
+ * @tparam MaxPayloadSize   Capacity of the compressed payload; frames that do not fit are emitted uncompressed.
+ * @tparam HashBits         See @ref compression::compress().
+ */
+template <std::size_t MaxPayloadSize = 2048, std::size_t HashBits = 8>
+class FrameCompressor
+{
+    static_assert(MaxPayloadSize >= 2);
+
+    std::array<std::uint8_t, MaxPayloadSize> buffer_{};
+    std::uint8_t type_code_ = 0;
+    const std::uint8_t* payload_ptr_ = nullptr;
+    std::size_t payload_size_ = 0;
+
+public:
+    /**
+     * Compresses the frame; the payload must remain valid until the frame is emitted, unless it was compressed.
+     * Returns true if the frame was compressed.
+     */
+    bool compress(const std::uint8_t frame_type_code, const void* const payload_ptr, const std::size_t payload_size)
+    {
+        assert(frame_type_code != CompressedFrameTypeCode);
+        type_code_ = frame_type_code;
+        payload_ptr_ = static_cast<const std::uint8_t*>(payload_ptr);
+        payload_size_ = payload_size;
+
+        if ((payload_size < 2) || (frame_type_code == CompressedFrameTypeCode))
+        {
+            return false;
+        }
+
+        // The compressed frame must be shorter than the original, so that incompressible data is rejected early
+        const std::size_t capacity = std::min(MaxPayloadSize - 1U, payload_size - 2U);
+        if (const auto size = compression::compress<HashBits>(payload_ptr_, payload_size, buffer_.data() + 1,
+                                                              capacity))
+        {
+            buffer_[0] = frame_type_code;
+            type_code_ = CompressedFrameTypeCode;
+            payload_ptr_ = buffer_.data();
+            payload_size_ = *size + 1U;
+            return true;
+        }
+        return false;
+    }
+
+    std::uint8_t getTypeCode() const { return type_code_; }
+    const std::uint8_t* getPayloadData() const { return payload_ptr_; }
+    std::size_t getPayloadSize() const { return payload_size_; }
+
+    transport::BufferedEmitter makeEmitter() const
+    {
+        return transport::BufferedEmitter(type_code_, payload_ptr_, payload_size_);
+    }
+};
+
+/**
+ * The decompression stage that follows the parser; see @ref FrameCompressor.
+ * Compressed frames are decompressed into the internal buffer, which is aligned at
+ * @ref transport::ParserBufferAlignment; all other parser outputs are passed through with the alignment of the parser.
+ * Malformed compressed frames are reported as extraneous data.
+ *
+ *      const auto out = decompressor.process(parser.processNextByte(byte));
+ *
+ * @tparam MaxPayloadSize   Maximum size of the decompressed payload; it can exceed that of the parser.
+ */
+template <std::size_t MaxPayloadSize = 2048>
+class FrameDecompressor
+{
+    alignas(transport::ParserBufferAlignment) std::array<std::uint8_t, MaxPayloadSize> buffer_{};
+
+public:
+    /**
+     * The returned object may refer to the internal buffer, which is INVALIDATED on the next invocation.
+     */
+    transport::ParserOutput process(const transport::ParserOutput& out)
+    {
+        const auto frame = out.getReceivedFrame();
+        if ((frame == nullptr) || (frame->type_code != CompressedFrameTypeCode))
+        {
+            return out;
+        }
+
+        const auto& payload = frame->payload;
+        if ((payload.size() > 0) && (payload.at(0) != CompressedFrameTypeCode))
+        {
+            if (const auto size = compression::decompress(payload.data() + 1, payload.size() - 1U,
+                                                          buffer_.data(), buffer_.size()))
+            {
+                return transport::ParserOutput(payload.at(0), buffer_.data(), *size);
+            }
+        }
+
+        // Extraneous data cannot be empty
+        return (payload.size() > 0) ? transport::ParserOutput(payload.data(), payload.size(), payload.getAlignment()) :
+                                      transport::ParserOutput();
+    }
+};
+
+}   // namespace presentation
+
+/**
+ * Standard messages.
+ */
+namespace standard
+{
+/**
+ * Default request timeout applicable to standard messages.
+ */
+static constexpr std::chrono::seconds DefaultStandardRequestTimeout = std::chrono::seconds(1);
+
+/**
+ * Time point representation used in standard Popcop messages. Application-specific messages can obviously use custom
+ * time representation formats.
+ * The timestamp is a 64-bit unsigned integer number of nanoseconds since some arbitrary point in time.
+ * Assuming the worst case that the reference point is the beginning of the UNIX epoch, we can expect the
+ * timestamp to roll over to zero on:
+ *  1970 + (2**64 - 1) / 1e9 / 3600 / 24 / 365 = 2554.9
+ */
+using Timestamp = std::chrono::duration<std::uint64_t, std::nano>;
+
+/**
+ * ID of all standard messages are listed here.
+ */
+enum class MessageID : std::uint16_t
+{
+    EndpointInfo                    = 0,
+    RegisterDataRequest             = 1,
+    RegisterDataResponse            = 2,
+    RegisterDiscoveryRequest        = 3,
+    RegisterDiscoveryResponse       = 4,
+    RegisterTraceSetupRequest       = 5,
+    RegisterTraceSetupResponse      = 6,
+    RegisterTraceEvent              = 7,
+    DeviceManagementCommandRequest  = 8,
+    DeviceManagementCommandResponse = 9,
+    BootloaderStatusRequest         = 10,
+    BootloaderStatusResponse        = 11,
+    BootloaderImageDataRequest      = 12,
+    BootloaderImageDataResponse     = 13,
+    RegisterBatchDataRequest        = 14,
+    RegisterBatchDataResponse       = 15,
+    RegisterIndexedDataRequest      = 16,
+    RegisterIndexedDataResponse     = 17,
+    BootloaderImageDigestRequest    = 18,
+    BootloaderImageDigestResponse   = 19,
+};
+
+/**
+ * This class represents a standard frame header.
+ * It can be used to parse and generate standard frames.
+ *
+ *    Offset    Type    Name
+ *  ---------------------------------------------------
+ *      0       u16     message_id
+ *  ---------------------------------------------------
+ *      2
+ */
+struct MessageHeader
+{
+    static constexpr std::size_t Size = 2;
+
+    MessageID message_id{};
+
+    MessageHeader() = default;
+
+    explicit MessageHeader(MessageID mid) : message_id(mid) { }
+
+    /**
+     * Encodes the message into the provided stream encoder.
+     * The encoder's underlying iterator can encode and emit the message on the fly - that would be highly efficient.
+     */
+    template <typename OutputIterator>
+    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+    {
+        encoder.addU16(std::uint16_t(message_id));
+    }
+
+    template <typename InputIterator>
+    static std::optional<MessageHeader> tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    {
+        if (decoder.getRemainingLength() >= Size)
+        {
+            MessageHeader hdr(MessageID(decoder.fetchU16()));
+            return hdr;
+        }
+        else
+        {
+            return {};
+        }
+    }
+};
+
+/**
+ * Static buffer type that can be used by fixed-size message definitions.
+ */
+template <std::size_t MessageSizeNotIncludingHeader>
+using StaticMessageBuffer = std::array<std::uint8_t, MessageSizeNotIncludingHeader + MessageHeader::Size>;
+
+/**
+ * Resizeable buffer type that can be used by variable-length message definitions.
+ */
+template <std::size_t MaxMessageSizeNotIncludingHeader>
+using DynamicMessageBuffer = senoval::Vector<std::uint8_t, MaxMessageSizeNotIncludingHeader + MessageHeader::Size>;
+
+/**
+ * Endpoint info message representation.
+ *
+ *      Offset  Type        Name
+ *  ---------------------------------------------------
+ *      0       u64         software_image_crc
+ *      8       u32         software_vcs_commit_id
+ *      12      u32         software_build_timestamp_utc        UTC Unix time in seconds
+ *      16      u8          software_version_major
+ *      17      u8          software_version_minor
+ *      18      u8          hardware_version_major
+ *      19      u8          hardware_version_minor
+ *      20      u8          flags                               1 - SW CRC set, 2 - SW release, 4 - SW dirty build,
+ *                                                                  8 - register schema hash set
+ *      21      u8          mode                                0 - normal, 1 - bootloader
+ *      22      u16         register_schema_hash                See RegisterSchemaHasher
+ *      24      u8[16]      globally_unique_id
+ *      40      u8[80]      endpoint_name
+ *      120     u8[80]      endpoint_description
+ *      200     u8[80]      build_environment_description
+ *      280     u8[80]      runtime_environment_description
+ *      360     u8[<=255]   certificate_of_authenticity         Until the end of the message
+ *  ---------------------------------------------------
+ *      <=615
+ */
+struct EndpointInfoMessage
+{
+    static constexpr std::size_t MinEncodedSize = 360;
+    static constexpr std::size_t MaxEncodedSize = 615;
+
+    struct SoftwareVersion
+    {
+        std::optional<std::uint64_t> image_crc;
+        std::uint32_t vcs_commit_id = 0;
+        std::uint32_t build_timestamp_utc = 0;
+        std::uint8_t major = 0;
+        std::uint8_t minor = 0;
+        bool release_build = false;
+        bool dirty_build = false;
+    };
+
+    struct HardwareVersion
+    {
+        std::uint8_t major = 0;
+        std::uint8_t minor = 0;
+    };
+
+    enum class Mode : std::uint8_t
+    {
+        Normal,
+        Bootloader,
+    };
+
+    using String = senoval::String<80>;
+
+    /**
+     * Message fields.
+     * Note that an empty message is treated as request for endpoint info. There is a dedicated method for that.
+     */
+    SoftwareVersion software_version;
+    HardwareVersion hardware_version;
+    Mode mode{};
+    std::optional<std::uint16_t> register_schema_hash;      ///< Allows the host to cache register indexes
+    std::array<std::uint8_t, 16> globally_unique_id{};
+    String endpoint_name;
+    String endpoint_description;
+    String build_environment_description;
+    String runtime_environment_description;
+    senoval::Vector<std::uint8_t, 255> certificate_of_authenticity;
+
+    /**
+     * True if the message is empty. An empty message is considered a request for endpoint info.
+     */
+    bool isRequest() const { return endpoint_name.empty() && endpoint_description.empty(); }
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder header_encoder(begin);
+        MessageHeader(MessageID::EndpointInfo).encode(header_encoder);
+        auto encoder = header_encoder.makeNew();     // Creating new encoder in order to exclude the header offset
+
+        encoder.addU64(software_version.image_crc ? *software_version.image_crc : 0);
+        encoder.addU32(software_version.vcs_commit_id);
+        encoder.addU32(software_version.build_timestamp_utc);
+        encoder.addU8(software_version.major);
+        encoder.addU8(software_version.minor);
+
+        encoder.addU8(hardware_version.major);
+        encoder.addU8(hardware_version.minor);
+
+        {
+            std::uint8_t flags = 0;
+
+            if (software_version.image_crc)
+            {
+                flags |= 1;
+            }
+
+            if (software_version.release_build)
+            {
+                flags |= 2;
+            }
+
+            if (software_version.dirty_build)
+            {
+                flags |= 4;
+            }
+
+            if (register_schema_hash)
+            {
+                flags |= 8;
+            }
+
+            encoder.addU8(flags);
+        }
+
+        encoder.addU8(std::uint8_t(mode));
+        encoder.addU16(register_schema_hash ? *register_schema_hash : std::uint16_t(0));
+        assert(encoder.getOffset() == 24);
+        encoder.addBytes(globally_unique_id);
+        encoder.addBytes(endpoint_name);
+        encoder.fillUpToOffset(120);
+        encoder.addBytes(endpoint_description);
+        encoder.fillUpToOffset(200);
+        encoder.addBytes(build_environment_description);
+        encoder.fillUpToOffset(280);
+        encoder.addBytes(runtime_environment_description);
+        encoder.fillUpToOffset(360);
+
+        assert(encoder.getOffset() == MinEncodedSize);
+        encoder.addBytes(certificate_of_authenticity);
+        assert(encoder.getOffset() >= MinEncodedSize);
+        assert(encoder.getOffset() <= MaxEncodedSize);
+        assert(encoder.getOffset() ==  MinEncodedSize + certificate_of_authenticity.size());
+
+        return header_encoder.getOffset() + encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
+    {
+        DynamicMessageBuffer<MaxEncodedSize> out;
+        const std::size_t size = encode(std::back_inserter(out));
+        (void) size;
+        assert(size == out.size());
+        return out;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     * If no message could be parsed, an empty optional<> will be returned.
+     */
+    template <typename InputIterator>
+    static std::optional<EndpointInfoMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder header_decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(header_decoder);
+        if (!header || (header->message_id != MessageID::EndpointInfo))
+        {
+            return {};
+        }
+
+        auto decoder = header_decoder.makeNew();     // Creating a new one to exclude header offset
+        EndpointInfoMessage msg;
+        if (decoder.getRemainingLength() < MinEncodedSize)
+        {
+            return msg;     // An empty message is considered a request for endpoint info.
+        }
+
+        if (decoder.getRemainingLength() > MaxEncodedSize)
+        {
+            return {};
+        }
+
+        msg.software_version.image_crc              = decoder.fetchU64();
+        msg.software_version.vcs_commit_id          = decoder.fetchU32();
+        msg.software_version.build_timestamp_utc    = decoder.fetchU32();
+        msg.software_version.major                  = decoder.fetchU8();
+        msg.software_version.minor                  = decoder.fetchU8();
+
+        msg.hardware_version.major = decoder.fetchU8();
+        msg.hardware_version.minor = decoder.fetchU8();
+
+        bool register_schema_hash_present = false;
+        {
+            const std::uint8_t flags = decoder.fetchU8();
+
+            if ((flags & 1) == 0)
+            {
+                msg.software_version.image_crc.reset();
+            }
+
+            msg.software_version.release_build = (flags & 2) != 0;
+            msg.software_version.dirty_build   = (flags & 4) != 0;
+
+            register_schema_hash_present = (flags & 8) != 0;
+        }
+
+        switch (decoder.fetchU8())
+        {
+        case std::uint8_t(Mode::Normal):
+        {
+            msg.mode = Mode::Normal;
+            break;
+        }
+        case std::uint8_t(Mode::Bootloader):
+        {
+            msg.mode = Mode::Bootloader;
+            break;
+        }
+        default:
+        {
+            return {};
+        }
+        }
+
+        {
+            const std::uint16_t hash = decoder.fetchU16();
+            if (register_schema_hash_present)
+            {
+                msg.register_schema_hash = hash;
+            }
+        }
+
+        assert(decoder.getOffset() == 24);
+        decoder.fetchBytes(msg.globally_unique_id.begin(),
+                           msg.globally_unique_id.end());
+
+        assert(decoder.getOffset() == 40);
+        decoder.fetchASCIIString(msg.endpoint_name);
+        decoder.skipUpToOffset(120);
+        decoder.fetchASCIIString(msg.endpoint_description);
+        decoder.skipUpToOffset(200);
+        decoder.fetchASCIIString(msg.build_environment_description);
+        decoder.skipUpToOffset(280);
+        decoder.fetchASCIIString(msg.runtime_environment_description);
+        decoder.skipUpToOffset(360);
+        decoder.fetchBytes(std::back_inserter(msg.certificate_of_authenticity),
+                           decoder.getRemainingLength());
+        return msg;
+    }
+};
+
+/**
+ * This is not a message class.
+ * This is a serializable register name that can be used in register manipulation messages.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              length          Length of the next field.
+ *      1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=94
+ */
+struct RegisterName : public senoval::String<93>
+{
+    using Base = senoval::String<93>;
+
+    static constexpr std::size_t MinEncodedSize = 1;
+    static constexpr std::size_t MaxEncodedSize = 94;
+
+    using Base::String;    ///< All constructors are inherited
+    using Base::operator=;
+
+    /**
+     * Optional high-level naming convention.
+     * If the default value is defined for a register, it can be represented in a different register
+     * that has the same name suffixed with '='. Minimum and maximum values can be represented likewise,
+     * if necessary. For example:
+     *  Register name: "foo", default value 42, minimum 12, maximum 72.
+     *  Default value is stored in a read-only register "foo=" with the constant value 42.
+     *  Minimum and maximum values are stored in registers named "foo<" and "foo>", respectively.
+     */
+    struct Suffix
+    {
+        static constexpr char DefaultValue = '=';
+        static constexpr char MinimumValue = '<';
+        static constexpr char MaximumValue = '>';
+        // Other optional suffixes may be added in the future.
+    };
+
+    /**
+     * Serializes the object into the provided encoder.
+     */
+    template <typename OutputIterator>
+    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+    {
+        encoder.addU8(std::uint8_t(this->length()));
+        encoder.addBytes(*this);
+    }
+
+    /**
+     * Attempts to reconstruct the state of the current object from the provided data stream.
+     * Maximum size is not checked because this is not a greedy decoder, i.e. there may be more data after the string.
+     */
+    template <typename InputIterator>
+    bool tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    {
+        if (decoder.getRemainingLength() < MinEncodedSize)
+        {
+            return false;
+        }
+
+        const std::uint8_t name_len = decoder.fetchU8();
+        if ((name_len > Capacity) ||
+            (name_len > decoder.getRemainingLength()))
+        {
+            return false;
+        }
+
+        clear();
+        for (std::uint8_t i = 0; i < name_len; i++)
+        {
+            push_back(char(decoder.fetchU8()));
+        }
+
+        return true;
+    }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * List of possible register value types. There are 14 of them, each has a distinct type ID starting from 0.
+ * This type cannot be instantiated directly! It is only a type container.
+ */
+struct RegisterValueTypes
+{
+    /// No value; used to represent missing registers and requests for data
+    using Empty = std::monostate;                                             ///< Type ID 0
+
+    /// ASCII string, or UTF-8 encoded bytes
+    using String = senoval::String<256>;                                      ///< Type ID 1
+
+    /// A wrapper is needed rather than alias to create a distinct type for std::variant
+    struct Unstructured : public senoval::Vector<std::uint8_t, 256>           ///< Type ID 2
+    {
+        using Base = senoval::Vector<std::uint8_t, 256>;
+        Unstructured() = default;
+        Unstructured(std::size_t len, const std::uint8_t* ptr) : Base(ptr, ptr + len) {}
+    };
+
+    /// A wrapper is needed rather than alias to create a distinct type for std::variant
+    struct Boolean : public senoval::Vector<bool, 256>                        ///< Type ID 3
+    {
+        using Base = senoval::Vector<bool, 256>;
+        using Base::Vector;
+    };
+
+    /// Signed integers
+    using I64 = senoval::Vector<std::int64_t, 32>;                            ///< Type ID 4
+    using I32 = senoval::Vector<std::int32_t, 64>;                            ///< Type ID 5
+    using I16 = senoval::Vector<std::int16_t, 128>;                           ///< Type ID 6
+    using I8  = senoval::Vector<std::int8_t,  256>;                           ///< Type ID 7
+
+    /// Unsigned integers
+    using U64 = senoval::Vector<std::uint64_t, 32>;                           ///< Type ID 8
+    using U32 = senoval::Vector<std::uint32_t, 64>;                           ///< Type ID 9
+    using U16 = senoval::Vector<std::uint16_t, 128>;                          ///< Type ID 10
+    using U8  = senoval::Vector<std::uint8_t,  256>;                          ///< Type ID 11
+
+    /// IEEE754 floating point
+    using F64 = senoval::Vector<double, 32>;                                  ///< Type ID 12
+    using F32 = senoval::Vector<float,  64>;                                  ///< Type ID 13
+
+    /**
+     * All value types represented as a single algebraic type (tagged union).
+     * Note that the order of declaration matters, because it defines the type ID mappings.
+     */
+    using Variant = std::variant<
+        Empty,              ///< No value is provided
+        String,             ///< UTF-8 encoded string of text
+        Unstructured,       ///< Raw unstructured bytes
+        Boolean,            ///< One byte per value; 0 - false, 1...255 - true
+        // Signed integers
+        I64,
+        I32,
+        I16,
+        I8,
+        // Unsigned integers
+        U64,
+        U32,
+        U16,
+        U8,
+        // IEEE754 floating point
+        F64,
+        F32
+    >;
+
+private:
+    template <typename Scalar>
+    struct ValueTypeForScalarImpl;
+
+public:
+    /**
+     * This convenience type reduces the amount of boilerplate needed to map types from simple
+     * scalar types to value vector types.
+     */
+    template <typename Scalar>
+    using ValueTypeForScalar = typename ValueTypeForScalarImpl<Scalar>::T;
+
+protected:  // This type cannot be instantiated directly
+    RegisterValueTypes() = default;
+    ~RegisterValueTypes() = default;
+
+    /// The number of bytes the value is allowed to take in the encoded form.
+    static constexpr std::size_t MaxEncodedValueSize = 256;
+};
+
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<bool> { using T = Boolean; };
+
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int64_t> { using T = I64; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int32_t> { using T = I32; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int16_t> { using T = I16; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int8_t>  { using T = I8;  };
+
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint64_t> { using T = U64; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint32_t> { using T = U32; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint16_t> { using T = U16; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint8_t>  { using T = U8;  };
+
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<double> { using T = F64; };
+template <> struct RegisterValueTypes::ValueTypeForScalarImpl<float>  { using T = F32;  };
+
+} // namespace detail_
+
+/**
+ * This is not a message class.
+ * This is a serializable representation of a register value that can be used in register manipulation messages.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              type_id         Type of the value contained in this register.
+ *      1       u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=257
+ */
+struct RegisterValue : public detail_::RegisterValueTypes::Variant,
+                       public detail_::RegisterValueTypes
+{
+    /**
+     * Alias of the underlying std::variant<>
+     */
+    using Variant = detail_::RegisterValueTypes::Variant;
+
+    /**
+     * Size limits of the encoded representation.
+     */
+    static constexpr std::size_t MinEncodedSize = 1;
+    static constexpr std::size_t MaxEncodedSize = 257;
+
+    /**
+     * Number of types that are defined for this std::variant<>.
+     */
+    static constexpr std::uint8_t NumberOfVariants = std::uint8_t(std::variant_size_v<Variant>);
+
+    /**
+     * Maps variant index to type at compile time.
+     */
+    template <std::size_t VariantIndex>
+    using VariantTypeAtIndex = std::variant_alternative_t<VariantIndex, Variant>;
+
+    /**
+     * Maps type to variant index (type ID) at compile time.
+     */
+    template <typename T, std::size_t VariantIndex = 0>
+    static constexpr std::uint8_t getTypeID()
+    {
+        static_assert(VariantIndex < NumberOfVariants, "This is not a register value type");
+        if constexpr (std::is_same_v<T, VariantTypeAtIndex<VariantIndex>>)
+        {
+            return std::uint8_t(VariantIndex);
+        }
+        else
+        {
+            return getTypeID<T, VariantIndex + 1>();
+        }
+    }
+
+    /**
+     * All constructors and assignment operators are inherited from std::variant<>.
+     */
+    using Variant::variant;
+    using Variant::operator=;
+
+    /**
+     * Shortcut for std::holds_alternative<T>(*this).
+     * Usage:
+     *  if (msg.is<RegisterData::U64>())
+     *  {
+     *      // Message contains an array of uint64
+     *  }
+     */
+    template <typename T> [[nodiscard]] bool is() const { return std::holds_alternative<T>(*this); }
+
+    /**
+     * Shortcut for std::get_if<T>(this).
+     * Usage:
+     *  if (auto value = msg.as<RegisterData::U64>())
+     *  {
+     *      // Message contains an array of uint64; the pointer to that array is now stored in 'value'
+     *  }
+     */
+    template <typename T> [[nodiscard]]       T* as()       { return std::get_if<T>(this); }
+    template <typename T> [[nodiscard]] const T* as() const { return std::get_if<T>(this); }
+
+    /**
+     * A simple wrapper over std::visit<>(), refer to that for more info.
+     */
+    template <typename Visitor>
+    auto visit(Visitor&& vis) const
+    {
+        return std::visit(std::forward<Visitor>(vis), *static_cast<const Variant*>(this));
+    }
+    template <typename Visitor>
+    auto visit(Visitor&& vis)
+    {
+        return std::visit(std::forward<Visitor>(vis), *static_cast<Variant*>(this));
+    }
+
+    /**
+     * Returns the number of bytes that @ref encode() would produce.
+     */
+    std::size_t getEncodedSize() const
+    {
+        return MinEncodedSize + visit([](const auto& x) -> std::size_t
+        {
+            using T = std::decay_t<decltype(x)>;
+            if constexpr (std::is_same_v<T, Empty>)
+            {
+                return 0;
+            }
+            else if constexpr (std::is_same_v<T, String>)
+            {
+                return x.length();
+            }
+            else
+            {
+                return x.size() * (MaxEncodedValueSize / x.max_size());
+            }
+        });
+    }
+
+    /**
+     * Serializes the object into the provided encoder.
+     */
+    template <typename OutputIterator>
+    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+    {
+        encoder.addU8(std::uint8_t(index()));
+        visit(VariantEncoder(encoder));
+    }
+
+    /**
+     * Attempts to reconstruct the state of the current object from the provided data stream.
+     * Note that the function is greedy: it takes all remaining data in the stream.
+     * It is therefore necessary to always allocate the value at the end of the message,
+     * or prepend each value with a 16-bit length field and pass an accordingly truncated
+     * stream into this function.
+     */
+    template <typename InputIterator>
+    bool tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    {
+        if (decoder.getRemainingLength() < MinEncodedSize)
+        {
+            emplace<Empty>();       // No payload is treated as empty value as a last resort (not required)
+            return true;
+        }
+
+        if (decoder.getRemainingLength() > MaxEncodedSize)
+        {
+            return false;
+        }
+
+        const std::uint8_t type_id = decoder.fetchU8();
+        if (type_id >= NumberOfVariants)
+        {
+            return false;
+        }
+
+        decodeByTypeID(decoder, type_id);
+        return true;
+    }
+
+private:
+    template <typename OutputIterator>
+    class VariantEncoder
+    {
+        presentation::StreamEncoder<OutputIterator>& encoder_;
+
+    public:
+        explicit VariantEncoder(presentation::StreamEncoder<OutputIterator>& stream_encoder) :
+            encoder_(stream_encoder)
+        { }
+
+        /// Empty value handler
+        void operator()(const std::monostate&) const { }
+
+        /// String handler
+        void operator()(const String& str) const
+        {
+            encoder_.addBytes(str);
+        }
+
+        /// Integer vector handler
+        template <typename T, std::size_t Capacity>
+        std::enable_if_t<std::is_integral_v<T>>
+        operator()(const senoval::Vector<T, Capacity>& vec) const
+        {
+            // The following construct cleverly avoids dependency on the native type sizes.
+            static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
+            for (const T& x : vec)
+            {
+                if constexpr (std::is_signed_v<T>)
+                {
+                    encoder_.template addSignedInteger<EncodedItemSize>(x);
+                }
+                else
+                {
+                    encoder_.template addUnsignedInteger<EncodedItemSize>(x);
+                }
+            }
+        }
+
+        /// Float vector handler
+        template <typename T, std::size_t Capacity>
+        std::enable_if_t<std::is_floating_point_v<T>>
+        operator()(const senoval::Vector<T, Capacity>& vec) const
+        {
+            for (const T& x : vec)
+            {
+                encoder_.template addIEEE754<MaxEncodedValueSize / Capacity>(x);
+            }
+        }
+    };
+
+    template <typename InputByteIterator, std::uint8_t TypeIDCandidate = 0>
+    void decodeByTypeID(presentation::StreamDecoder<InputByteIterator>& decoder, const std::uint8_t type_id)
+    {
+        if constexpr (TypeIDCandidate < NumberOfVariants)
+        {
+            if (type_id == TypeIDCandidate)
+            {
+                decodeSpecificValue(decoder, emplace<VariantTypeAtIndex<TypeIDCandidate>>());
+            }
+            else
+            {
+                decodeByTypeID<InputByteIterator, TypeIDCandidate + 1>(decoder, type_id);
+            }
+        }
+        // Otherwise the type ID is wrong. The caller is supposed to catch that; we're going to leave the value Empty.
+    }
+
+    template <typename InputByteIterator, typename T, std::size_t Capacity>
+    static void resizeVectorBeforeDecoding(presentation::StreamDecoder<InputByteIterator>& decoder,
+                                           senoval::Vector<T, Capacity>& vector)
+    {
+        // The following construct cleverly avoids dependency on the native type sizes.
+        static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
+        const std::size_t NumItems = std::min(Capacity, decoder.getRemainingLength() / EncodedItemSize);
+        vector.resize(NumItems);
+    }
+
+    /// Empty value handler
+    template <typename InputByteIterator>
+    static void decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>&, std::monostate&) { }
+
+    /// String handler
+    template <typename InputByteIterator>
+    static void decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
+                                    String& out_string)
+    {
+        decoder.fetchASCIIString(out_string);
+    }
+
+    /// Integer vector handler
+    template <typename InputByteIterator, typename T, std::size_t Capacity>
+    static std::enable_if_t<std::is_integral_v<T>>
+    decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
+                        senoval::Vector<T, Capacity>& out_vector)
+    {
+        // The following construct cleverly avoids dependency on the native type sizes.
+        static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
+        resizeVectorBeforeDecoding(decoder, out_vector);
+        for (auto& x : out_vector)
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                x = decoder.template fetchSignedInteger<EncodedItemSize>();
+            }
+            else
+            {
+                // Cast is needed here to properly handle booleans
+                x = T(decoder.template fetchUnsignedInteger<EncodedItemSize>());
+            }
+        }
+    }
+
+    /// Float vector handler
+    template <typename InputByteIterator, typename T, std::size_t Capacity>
+    static std::enable_if_t<std::is_floating_point_v<T>>
+    decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
+                        senoval::Vector<T, Capacity>& out_vector)
+    {
+        resizeVectorBeforeDecoding(decoder, out_vector);
+        for (auto& x : out_vector)
+        {
+            x = decoder.template fetchIEEE754<MaxEncodedValueSize / Capacity>();
+        }
+    }
+};
+
+/**
+ * Non-owning view of an encoded @ref RegisterValue. The value is not decoded into a container;
+ * instead, the elements are read directly from the encoded representation (e.g. the payload of a received frame)
+ * on demand. This is useful when the application is only interested in a few elements, or when the stack space
+ * is scarce. The referenced data must outlive the view.
+ *
+ * Usage:
+ *
+ *      if (auto value = RegisterValueView::tryDecode(begin, end))
+ *      {
+ *          if (auto elements = value->as<RegisterValue::F32>(); elements && !elements->empty())
+ *          {
+ *              const float x = elements->at(0);
+ *          }
+ *      }
+ */
+class RegisterValueView
+{
+public:
+    /**
+     * Random access view of the elements of an array value. The elements are decoded on access.
+     */
+    template <typename Element>
+    class Elements
+    {
+        static constexpr std::size_t EncodedElementSize = std::is_same_v<Element, bool> ? 1 : sizeof(Element);
+
+        const std::uint8_t* ptr_ = nullptr;
+        std::size_t size_ = 0;
+
+    public:
+        Elements(const std::uint8_t* const encoded_data, const std::size_t encoded_size) :
+            ptr_(encoded_data),
+            size_(encoded_size / EncodedElementSize)    // The remainder is ignored, like in the regular decoder
+        { }
+
+        std::size_t size() const { return size_; }
+
+        [[nodiscard]]   // prevents confusion with clear()
+        bool empty() const { return size_ == 0; }
+
+        Element at(const std::size_t index) const
+        {
+            assert(index < size_);
+            const std::uint8_t* const p = ptr_ + index * EncodedElementSize;
+            presentation::StreamDecoder decoder(p, p + EncodedElementSize);
+            if constexpr (std::is_same_v<Element, bool>)
+            {
+                return decoder.fetchU8() != 0;
+            }
+            else if constexpr (std::is_floating_point_v<Element>)
+            {
+                return decoder.template fetchIEEE754<EncodedElementSize>();
+            }
+            else if constexpr (std::is_signed_v<Element>)
+            {
+                return decoder.template fetchSignedInteger<EncodedElementSize>();
+            }
+            else
+            {
+                return decoder.template fetchUnsignedInteger<EncodedElementSize>();
+            }
+        }
+
+        Element operator[](const std::size_t index) const { return at(index); }
+
+        /**
+         * Returns the pointer to the elements if they can be accessed in-place, otherwise nullptr.
+         * In-place access is possible if the native byte order is little-endian and the data is aligned properly,
+         * which is the case, for example, if the value is located at an aligned offset in the parser buffer.
+         * Boolean values can never be accessed in-place.
+         */
+        const Element* data() const
+        {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            if constexpr (!std::is_same_v<Element, bool>)
+            {
+                if ((reinterpret_cast<std::uintptr_t>(ptr_) % alignof(Element)) == 0)
+                {
+                    return static_cast<const Element*>(static_cast<const void*>(ptr_));
+                }
+            }
+#endif
+            return nullptr;
+        }
+    };
+
+private:
+    const std::uint8_t* begin_ = nullptr;   ///< Points to the type ID; null if the value is empty
+    const std::uint8_t* end_ = nullptr;
+
+    const std::uint8_t* getPayload() const { return begin_ + 1; }
+    std::size_t getPayloadSize() const { return (begin_ == nullptr) ? 0 : std::size_t(end_ - begin_ - 1); }
+
+    RegisterValueView(const std::uint8_t* const begin, const std::uint8_t* const end) :
+        begin_(begin),
+        end_(end)
+    { }
+
+public:
+    /**
+     * Constructs an empty value.
+     */
+    RegisterValueView() = default;
+
+    /**
+     * Attempts to parse the value from the provided encoded representation.
+     * The rules are the same as in @ref RegisterValue::tryDecode(); in particular, the function is greedy.
+     * The length of the value is checked, but the elements are not decoded.
+     */
+    static std::optional<RegisterValueView> tryDecode(const std::uint8_t* const begin, const std::uint8_t* const end)
+    {
+        assert(begin <= end);
+        const std::size_t size = std::size_t(end - begin);
+        if (size < RegisterValue::MinEncodedSize)
+        {
+            return RegisterValueView();     // No payload is treated as empty value as a last resort (not required)
+        }
+
+        if ((size > RegisterValue::MaxEncodedSize) || (*begin >= RegisterValue::NumberOfVariants))
+        {
+            return {};
+        }
+
+        if (*begin == RegisterValue::getTypeID<RegisterValue::Empty>())
+        {
+            return RegisterValueView();
+        }
+
+        return RegisterValueView(begin, end);
+    }
+
+    std::uint8_t getTypeID() const { return (begin_ == nullptr) ? 0 : *begin_; }
+
+    /**
+     * Same as @ref RegisterValue::is<>().
+     */
+    template <typename T> [[nodiscard]] bool is() const { return getTypeID() == RegisterValue::getTypeID<T>(); }
+
+    /**
+     * Returns a view of the value if it is of the specified type, otherwise an empty option.
+     * Strings are represented as std::string_view; other types are represented as @ref Elements.
+     */
+    template <typename T>
+    auto as() const
+    {
+        static_assert(!std::is_same_v<T, RegisterValue::Empty>, "Use is<>() to check if the value is empty");
+
+        if constexpr (std::is_same_v<T, RegisterValue::String>)
+        {
+            // Same as the regular decoder: the string is terminated by the first zero byte, if any
+            const char* const ptr = static_cast<const char*>(static_cast<const void*>(getPayload()));
+            return is<T>() ? std::optional<std::string_view>(std::string_view(ptr, std::size_t(
+                                 std::find(getPayload(), getPayload() + getPayloadSize(), 0U) - getPayload())))
+                           : std::nullopt;
+        }
+        else
+        {
+            using E = Elements<std::decay_t<decltype(*std::declval<const T&>().begin())>>;
+            return is<T>() ? std::optional<E>(E(getPayload(), getPayloadSize())) : std::nullopt;
+        }
+    }
+
+    /**
+     * Decodes the value into the regular owning representation.
+     */
+    RegisterValue decode() const
+    {
+        RegisterValue out;
+        if (begin_ != nullptr)
+        {
+            presentation::StreamDecoder decoder(begin_, end_);
+            const bool ok = out.tryDecode(decoder);
+            (void) ok;
+            assert(ok);
+        }
+        return out;
+    }
+};
+
+/**
+ * This is a simple composition of RegisterName and RegisterValue.
+ * Register read request if the value is empty.
+ * Register write request if the value is not empty.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              name_length     Length of the next field.
+ *      1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *      1..94   u8              type_id         Type of the value contained in this message.
+ *      2..95   u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=351
+ */
+struct RegisterDataRequestMessage
+{
+    static constexpr std::size_t MinEncodedSize = 2;
+    static constexpr std::size_t MaxEncodedSize = 351;
+
+    static constexpr MessageID ID = MessageID::RegisterDataRequest;
+
+    /**
+     * All fields of this message type.
+     */
+    RegisterName name;
+    RegisterValue value;
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        name.encode(encoder);
+        value.encode(encoder);
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
+    {
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<RegisterDataRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
+
+        RegisterDataRequestMessage msg;
+        if (!msg.name.tryDecode(decoder))
+        {
+            return {};
+        }
+
+        if (!msg.value.tryDecode(decoder))
+        {
+            return {};
+        }
+
+        return msg;
+    }
+};
+
+/**
+ * Non-owning view of an encoded @ref RegisterDataRequestMessage, see @ref RegisterValueView.
+ * This is useful for register request handlers on memory-constrained systems, because it does not require
+ * the message to be decoded into a separate object. The referenced data must outlive the view.
+ */
+struct RegisterDataRequestView
+{
+    std::string_view name;
+    RegisterValueView value;
+
+    /**
+     * Same as @ref RegisterDataRequestMessage::tryDecode().
+     * The data is typically the payload of a received standard frame.
+     */
+    static std::optional<RegisterDataRequestView> tryDecode(const std::uint8_t* const begin,
+                                                            const std::uint8_t* const end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != RegisterDataRequestMessage::ID))
+        {
+            return {};
+        }
+
+        if (decoder.getRemainingLength() < RegisterName::MinEncodedSize)
+        {
+            return {};
+        }
+
+        const std::uint8_t name_len = decoder.fetchU8();
+        if ((name_len > RegisterName::Capacity) ||
+            (name_len > decoder.getRemainingLength()))
+        {
+            return {};
+        }
+
+        const std::uint8_t* const name_ptr = begin + decoder.getOffset();
+        const auto value = RegisterValueView::tryDecode(name_ptr + name_len, end);
+        if (!value)
+        {
+            return {};
+        }
+
+        RegisterDataRequestView view;
+        view.name = std::string_view(static_cast<const char*>(static_cast<const void*>(name_ptr)), name_len);
+        view.value = *value;
+        return view;
+    }
+};
+
+/**
+ * Representation of register flags.
+ */
+struct RegisterFlags
+{
+    using Type = std::uint8_t;
+
+    static constexpr Type Mutable       = 1;
+    static constexpr Type Persistent    = 2;
+
+    Type value = 0;
+
+    [[nodiscard]] bool isMutable()    const { return check<Mutable>(); }
+    [[nodiscard]] bool isPersistent() const { return check<Persistent>(); }
+
+    void setMutable(bool x)    { set<Mutable>(x); }
+    void setPersistent(bool x) { set<Persistent>(x); }
+
+private:
+    template <Type F> [[nodiscard]] bool check() const { return (value & F) != 0; }
+
+    template <Type F>
+    void set(const bool x)
+    {
+        if (x) { value = Type(value |  F); }
+        else   { value = Type(value & ~F); }
+    }
+};
+
+/**
+ * This is a simple composition of RegisterName and RegisterValue with some additional values.
+ * Register does not exist if the value is empty.
+ * Register exists and the response contains its data if the value is not empty.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u64             timestamp       Timestamp of the provided value.
+ *      8       u8              flags           Register flags: 1 - mutable, 2 - persistent.
+ *      9       u8              name_length     Length of the next field.
+ *      10      u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *      10..103 u8              type_id         Type of the value contained in this message.
+ *      11..104 u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=360
+ */
+struct RegisterDataResponseMessage
+{
+    static constexpr std::size_t MinEncodedSize = 11;
+    static constexpr std::size_t MaxEncodedSize = 360;
+
+    static constexpr MessageID ID = MessageID::RegisterDataResponse;
+
+    /**
+     * All fields of this message type.
+     */
+    Timestamp timestamp{};
+    RegisterFlags flags;
+    RegisterName name;
+    RegisterValue value;
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        encoder.addU64(timestamp.count());
+        encoder.addU8(flags.value);
+        name.encode(encoder);
+        value.encode(encoder);
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
+    {
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<RegisterDataResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
+
+        if (decoder.getRemainingLength() < MinEncodedSize)
+        {
+            return {};
+        }
+
+        RegisterDataResponseMessage msg;
+        msg.timestamp = Timestamp(decoder.fetchU64());
+        msg.flags.value = decoder.fetchU8();
+
+        if (!msg.name.tryDecode(decoder))
+        {
+            return {};
+        }
+
+        if (!msg.value.tryDecode(decoder))
+        {
+            return {};
+        }
+
+        return msg;
+    }
+};
+
+/**
+ * An item of @ref RegisterBatchDataRequestMessage.
+ */
+struct RegisterBatchDataRequestItem
+{
+    RegisterName name;
+    RegisterValue value;
+
+    std::size_t getEncodedSize() const { return RegisterName::MinEncodedSize + name.length() + 2U +
+                                                value.getEncodedSize(); }
+};
+
+/**
+ * An item of @ref RegisterBatchDataResponseMessage.
+ */
+struct RegisterBatchDataResponseItem
+{
+    RegisterFlags flags;
+    RegisterName name;
+    RegisterValue value;
+
+    std::size_t getEncodedSize() const { return 1U + RegisterName::MinEncodedSize + name.length() + 2U +
+                                                value.getEncodedSize(); }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Common logic of the batched register messages.
+ * The encoded size of the message is limited so that it could be received by any parser (see @ref transport::Parser).
+ * Values are prefixed with their length, because the value decoder is greedy.
+ */
+template <typename Item, std::size_t FixedPartSize>
+struct RegisterBatchMessageBase
+{
+    static constexpr std::size_t MinEncodedSize = FixedPartSize;
+    static constexpr std::size_t MaxEncodedSize = 1024 - MessageHeader::Size;
+
+    /// The size limit is usually reached earlier; the number is chosen to cover typical use cases.
+    static constexpr std::size_t MaxItems = 64;
+
+    /**
+     * The items are processed in the same order as if they were received in separate messages.
+     */
+    senoval::Vector<Item, MaxItems> items;
+
+    /**
+     * Returns the size of the encoded message not including the header.
+     */
+    std::size_t getEncodedSize() const
+    {
+        std::size_t out = FixedPartSize;
+        for (auto& x : items)
+        {
+            out += x.getEncodedSize();
+        }
+        return out;
+    }
+
+    /**
+     * Adds the item if it fits into the message, otherwise returns false.
+     * This is the recommended way of populating the message.
+     */
+    bool tryAdd(const Item& item)
+    {
+        if ((items.size() < MaxItems) && ((getEncodedSize() + item.getEncodedSize()) <= MaxEncodedSize))
+        {
+            items.push_back(item);
+            return true;
+        }
+        return false;
+    }
+
+protected:
+    RegisterBatchMessageBase() = default;
+
+    template <typename OutputIterator>
+    static void encodeValue(presentation::StreamEncoder<OutputIterator>& encoder, const RegisterValue& value)
+    {
+        encoder.addU16(std::uint16_t(value.getEncodedSize()));
+        value.encode(encoder);
+    }
+
+    /**
+     * The offset of the stream decoder must be relative to the specified beginning of the message.
+     */
+    template <typename InputIterator>
+    static bool tryDecodeValue(presentation::StreamDecoder<InputIterator>& decoder,
+                               const InputIterator message_begin,
+                               RegisterValue& out_value)
+    {
+        if (decoder.getRemainingLength() < 2)
+        {
+            return false;
+        }
+
+        const std::size_t length = decoder.fetchU16();
+        if (length > decoder.getRemainingLength())
+        {
+            return false;
+        }
+
+        const std::size_t offset = decoder.getOffset();
+        presentation::StreamDecoder value_decoder(std::next(message_begin, std::ptrdiff_t(offset)),
+                                                  std::next(message_begin, std::ptrdiff_t(offset + length)));
+        if (!out_value.tryDecode(value_decoder))
+        {
+            return false;
+        }
+
+        decoder.skipUpToOffset(offset + length);
+        return true;
+    }
+};
+
+} // namespace detail_
+
+/**
+ * Batched version of @ref RegisterDataRequestMessage: a sequence of register read and write requests
+ * in one message. The response is @ref RegisterBatchDataResponseMessage.
+ * Unlike in the non-batched message, the value is prefixed with its length; zero length denotes an empty value.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       item[<=64]      items           The items follow each other until the end of the message.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=1022
+ *
+ * Item:
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              name_length     Length of the next field.
+ *      1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *      1..94   u16             value_length    Length of the next field.
+ *      3..96   u8[<=257]       value           Register value: type_id followed by encoded_payload.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=353
+ *
+ * The object keeps all items in memory, which takes a lot of space; it is intended mostly for the host side.
+ * Embedded systems should use @ref RegisterBatchDataRequestView instead.
+ */
+struct RegisterBatchDataRequestMessage :
+    public detail_::RegisterBatchMessageBase<RegisterBatchDataRequestItem, 0>
+{
+    using Item = RegisterBatchDataRequestItem;
+
+    static constexpr MessageID ID = MessageID::RegisterBatchDataRequest;
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        for (auto& x : items)
+        {
+            x.name.encode(encoder);
+            encodeValue(encoder, x.value);
+        }
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
+    {
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<RegisterBatchDataRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
+
+        RegisterBatchDataRequestMessage msg;
+        while (decoder.getRemainingLength() > 0)
+        {
+            if (msg.items.size() >= MaxItems)
+            {
+                return {};
+            }
+
+            Item item;
+            if (!item.name.tryDecode(decoder) || !tryDecodeValue(decoder, begin, item.value))
+            {
+                return {};
+            }
+            msg.items.push_back(item);
+        }
+
+        return msg;
     }
 };
 
 /**
- * Static buffer type that can be used by fixed-size message definitions.
+ * Non-owning view of an encoded @ref RegisterBatchDataRequestMessage, see @ref RegisterValueView.
+ * The whole message is validated once when the view is constructed; then the items can be traversed
+ * without any copying. The referenced data must outlive the view.
  */
-template <std::size_t MessageSizeNotIncludingHeader>
-using StaticMessageBuffer = std::array<std::uint8_t, MessageSizeNotIncludingHeader + MessageHeader::Size>;
+class RegisterBatchDataRequestView
+{
+    const std::uint8_t* begin_ = nullptr;
+    const std::uint8_t* end_ = nullptr;
+    std::size_t size_ = 0;
+
+    /// Returns the pointer to the next item, or nullptr if the item is malformed.
+    static const std::uint8_t* parseItem(const std::uint8_t* p,
+                                         const std::uint8_t* const end,
+                                         std::string_view& out_name,
+                                         RegisterValueView& out_value)
+    {
+        if ((p == end) || (*p > RegisterName::Capacity) || ((std::size_t(end - p) - 1U) < (*p + 2U)))
+        {
+            return nullptr;
+        }
 
-/**
- * Resizeable buffer type that can be used by variable-length message definitions.
- */
-template <std::size_t MaxMessageSizeNotIncludingHeader>
-using DynamicMessageBuffer = senoval::Vector<std::uint8_t, MaxMessageSizeNotIncludingHeader + MessageHeader::Size>;
+        out_name = std::string_view(static_cast<const char*>(static_cast<const void*>(p + 1)), *p);
+        p += 1U + *p;
 
-/**
- * Endpoint info message representation.
- *
- *      Offset  Type        Name
- *  ---------------------------------------------------
- *      0       u64         software_image_crc
- *      8       u32         software_vcs_commit_id
- *      12      u32         software_build_timestamp_utc        UTC Unix time in seconds
- *      16      u8          software_version_major
- *      17      u8          software_version_minor
- *      18      u8          hardware_version_major
- *      19      u8          hardware_version_minor
- *      20      u8          flags                               1 - SW CRC set, 2 - SW release, 4 - SW dirty build
- *      21      u8          mode                                0 - normal, 1 - bootloader
- *              u8[2]       <reserved>
- *      24      u8[16]      globally_unique_id
- *      40      u8[80]      endpoint_name
- *      120     u8[80]      endpoint_description
- *      200     u8[80]      build_environment_description
- *      280     u8[80]      runtime_environment_description
- *      360     u8[<=255]   certificate_of_authenticity         Until the end of the message
- *  ---------------------------------------------------
- *      <=615
- */
-struct EndpointInfoMessage
-{
-    static constexpr std::size_t MinEncodedSize = 360;
-    static constexpr std::size_t MaxEncodedSize = 615;
+        const std::size_t value_length = std::size_t(p[0]) | (std::size_t(p[1]) << 8U);
+        p += 2;
+        if (value_length > std::size_t(end - p))
+        {
+            return nullptr;
+        }
 
-    struct SoftwareVersion
-    {
-        std::optional<std::uint64_t> image_crc;
-        std::uint32_t vcs_commit_id = 0;
-        std::uint32_t build_timestamp_utc = 0;
-        std::uint8_t major = 0;
-        std::uint8_t minor = 0;
-        bool release_build = false;
-        bool dirty_build = false;
-    };
+        const auto value = RegisterValueView::tryDecode(p, p + value_length);
+        if (!value)
+        {
+            return nullptr;
+        }
 
-    struct HardwareVersion
+        out_value = *value;
+        return p + value_length;
+    }
+
+public:
+    /**
+     * Same as @ref RegisterBatchDataRequestMessage::tryDecode();
+     * the number of items is not limited though.
+     */
+    static std::optional<RegisterBatchDataRequestView> tryDecode(const std::uint8_t* const begin,
+                                                                 const std::uint8_t* const end)
     {
-        std::uint8_t major = 0;
-        std::uint8_t minor = 0;
-    };
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != RegisterBatchDataRequestMessage::ID))
+        {
+            return {};
+        }
 
-    enum class Mode : std::uint8_t
+        RegisterBatchDataRequestView view;
+        view.begin_ = begin + MessageHeader::Size;
+        view.end_ = end;
+
+        std::string_view name;
+        RegisterValueView value;
+        for (const std::uint8_t* p = view.begin_; p != end; view.size_++)
+        {
+            p = parseItem(p, end, name, value);
+            if (p == nullptr)
+            {
+                return {};
+            }
+        }
+
+        return view;
+    }
+
+    /**
+     * Invokes the visitor for every item in the order of appearance.
+     * The visitor is a callable of the form void (std::string_view name, const RegisterValueView& value).
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const
     {
-        Normal,
-        Bootloader,
-    };
+        std::string_view name;
+        RegisterValueView value;
+        for (const std::uint8_t* p = begin_; p != end_;)
+        {
+            p = parseItem(p, end_, name, value);
+            assert(p != nullptr);               // Validated during construction
+            visitor(name, value);
+        }
+    }
 
-    using String = senoval::String<80>;
+    /**
+     * Number of items.
+     */
+    std::size_t size() const { return size_; }
+};
+
+/**
+ * Batched version of @ref RegisterDataResponseMessage: a sequence of register states sampled at the same time.
+ * The items are in the same order as in the corresponding request.
+ * Unlike in the non-batched message, the value is prefixed with its length; zero length denotes an empty value.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u64             timestamp       Timestamp of the provided values.
+ *      8       item[<=64]      items           The items follow each other until the end of the message.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=1022
+ *
+ * Item:
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              flags           Register flags: 1 - mutable, 2 - persistent.
+ *      1       u8              name_length     Length of the next field.
+ *      2       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *      2..95   u16             value_length    Length of the next field.
+ *      4..97   u8[<=257]       value           Register value: type_id followed by encoded_payload.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=354
+ *
+ * The object keeps all items in memory, which takes a lot of space; it is intended mostly for the host side.
+ * Embedded systems can emit the response item by item instead, using @ref encodeItem() after
+ * @ref encodeFixedPart(); the encoded size should be checked with @ref RegisterBatchDataResponseItem::getEncodedSize().
+ */
+struct RegisterBatchDataResponseMessage :
+    public detail_::RegisterBatchMessageBase<RegisterBatchDataResponseItem, 8>
+{
+    using Item = RegisterBatchDataResponseItem;
+
+    static constexpr MessageID ID = MessageID::RegisterBatchDataResponse;
 
     /**
-     * Message fields.
-     * Note that an empty message is treated as request for endpoint info. There is a dedicated method for that.
+     * All fields of this message type except the items.
      */
-    SoftwareVersion software_version;
-    HardwareVersion hardware_version;
-    Mode mode{};
-    std::array<std::uint8_t, 16> globally_unique_id{};
-    String endpoint_name;
-    String endpoint_description;
-    String build_environment_description;
-    String runtime_environment_description;
-    senoval::Vector<std::uint8_t, 255> certificate_of_authenticity;
+    Timestamp timestamp{};
 
     /**
-     * True if the message is empty. An empty message is considered a request for endpoint info.
+     * Encodes the message header and the timestamp.
      */
-    bool isRequest() const { return endpoint_name.empty() && endpoint_description.empty(); }
+    template <typename OutputIterator>
+    static void encodeFixedPart(presentation::StreamEncoder<OutputIterator>& encoder, const Timestamp ts)
+    {
+        MessageHeader(ID).encode(encoder);
+        encoder.addU64(ts.count());
+    }
+
+    /**
+     * Encodes one item; see the class description.
+     */
+    template <typename OutputIterator>
+    static void encodeItem(presentation::StreamEncoder<OutputIterator>& encoder, const Item& item)
+    {
+        encoder.addU8(item.flags.value);
+        item.name.encode(encoder);
+        encodeValue(encoder, item.value);
+    }
 
     /**
      * Encodes the message into the provided sequential iterator.
@@ -1169,59 +4893,15 @@ struct EndpointInfoMessage
     template <typename OutputIterator>
     std::size_t encode(OutputIterator begin) const
     {
-        presentation::StreamEncoder header_encoder(begin);
-        MessageHeader(MessageID::EndpointInfo).encode(header_encoder);
-        auto encoder = header_encoder.makeNew();     // Creating new encoder in order to exclude the header offset
-
-        encoder.addU64(software_version.image_crc ? *software_version.image_crc : 0);
-        encoder.addU32(software_version.vcs_commit_id);
-        encoder.addU32(software_version.build_timestamp_utc);
-        encoder.addU8(software_version.major);
-        encoder.addU8(software_version.minor);
-
-        encoder.addU8(hardware_version.major);
-        encoder.addU8(hardware_version.minor);
-
+        presentation::StreamEncoder encoder(begin);
+        encodeFixedPart(encoder, timestamp);
+        for (auto& x : items)
         {
-            std::uint8_t flags = 0;
-
-            if (software_version.image_crc)
-            {
-                flags |= 1;
-            }
-
-            if (software_version.release_build)
-            {
-                flags |= 2;
-            }
-
-            if (software_version.dirty_build)
-            {
-                flags |= 4;
-            }
-
-            encoder.addU8(flags);
+            encodeItem(encoder, x);
         }
-
-        encoder.addU8(std::uint8_t(mode));
-        encoder.fillUpToOffset(24);
-        encoder.addBytes(globally_unique_id);
-        encoder.addBytes(endpoint_name);
-        encoder.fillUpToOffset(120);
-        encoder.addBytes(endpoint_description);
-        encoder.fillUpToOffset(200);
-        encoder.addBytes(build_environment_description);
-        encoder.fillUpToOffset(280);
-        encoder.addBytes(runtime_environment_description);
-        encoder.fillUpToOffset(360);
-
-        assert(encoder.getOffset() == MinEncodedSize);
-        encoder.addBytes(certificate_of_authenticity);
-        assert(encoder.getOffset() >= MinEncodedSize);
-        assert(encoder.getOffset() <= MaxEncodedSize);
-        assert(encoder.getOffset() ==  MinEncodedSize + certificate_of_authenticity.size());
-
-        return header_encoder.getOffset() + encoder.getOffset();
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
     }
 
     /**
@@ -1231,554 +4911,623 @@ struct EndpointInfoMessage
      */
     DynamicMessageBuffer<MaxEncodedSize> encode() const
     {
-        DynamicMessageBuffer<MaxEncodedSize> out;
-        const std::size_t size = encode(std::back_inserter(out));
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
         (void) size;
-        assert(size == out.size());
-        return out;
+        assert(size == buf.size());
+        return buf;
     }
 
     /**
      * Attempts to decode a message from the provided standard frame.
      * The message ID value in the header will be checked.
-     * If no message could be parsed, an empty optional<> will be returned.
      */
     template <typename InputIterator>
-    static std::optional<EndpointInfoMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<RegisterBatchDataResponseMessage> tryDecode(InputIterator begin, InputIterator end)
     {
-        presentation::StreamDecoder header_decoder(begin, end);
-        const auto header = MessageHeader::tryDecode(header_decoder);
-        if (!header || (header->message_id != MessageID::EndpointInfo))
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
         {
             return {};
         }
 
-        auto decoder = header_decoder.makeNew();     // Creating a new one to exclude header offset
-        EndpointInfoMessage msg;
         if (decoder.getRemainingLength() < MinEncodedSize)
         {
-            return msg;     // An empty message is considered a request for endpoint info.
+            return {};
         }
 
-        if (decoder.getRemainingLength() > MaxEncodedSize)
+        RegisterBatchDataResponseMessage msg;
+        msg.timestamp = Timestamp(decoder.fetchU64());
+        while (decoder.getRemainingLength() > 0)
         {
-            return {};
+            if (msg.items.size() >= MaxItems)
+            {
+                return {};
+            }
+
+            Item item;
+            item.flags.value = decoder.fetchU8();
+            if (!item.name.tryDecode(decoder) || !tryDecodeValue(decoder, begin, item.value))
+            {
+                return {};
+            }
+            msg.items.push_back(item);
         }
 
-        msg.software_version.image_crc              = decoder.fetchU64();
-        msg.software_version.vcs_commit_id          = decoder.fetchU32();
-        msg.software_version.build_timestamp_utc    = decoder.fetchU32();
-        msg.software_version.major                  = decoder.fetchU8();
-        msg.software_version.minor                  = decoder.fetchU8();
+        return msg;
+    }
+};
 
-        msg.hardware_version.major = decoder.fetchU8();
-        msg.hardware_version.minor = decoder.fetchU8();
+/**
+ * An item of @ref RegisterTraceSetupRequestMessage.
+ */
+struct RegisterTraceSetupRequestItem
+{
+    RegisterName name;
 
-        {
-            const std::uint8_t flags = decoder.fetchU8();
+    std::size_t getEncodedSize() const { return RegisterName::MinEncodedSize + name.length(); }
+};
 
-            if ((flags & 1) == 0)
-            {
-                msg.software_version.image_crc.reset();
-            }
+/**
+ * An item of @ref RegisterTraceEventMessage.
+ */
+struct RegisterTraceEventItem
+{
+    RegisterValue value;
 
-            msg.software_version.release_build = (flags & 2) != 0;
-            msg.software_version.dirty_build   = (flags & 4) != 0;
-        }
+    std::size_t getEncodedSize() const { return 2U + value.getEncodedSize(); }
+};
+
+/**
+ * Common definitions of the register trace messages.
+ * A trace is a subscription: the host names a set of registers once, and then the device reports their values
+ * in unsolicited @ref RegisterTraceEventMessage messages, either periodically or when they change, until
+ * the trace is cancelled. This removes the need for polling.
+ */
+struct RegisterTrace
+{
+    /**
+     * The trace period is represented with microsecond resolution.
+     */
+    using Period = std::chrono::duration<std::uint32_t, std::micro>;
+
+    /**
+     * The trigger is a bit mask; zero cancels the trace.
+     * Periodic - the event is sent once per period.
+     * OnChange - the event is sent when any of the traced registers has changed, but not more often than
+     *            once per period (zero period means no rate limiting).
+     */
+    struct Trigger
+    {
+        using Type = std::uint8_t;
 
-        switch (decoder.fetchU8())
-        {
-        case std::uint8_t(Mode::Normal):
-        {
-            msg.mode = Mode::Normal;
-            break;
-        }
-        case std::uint8_t(Mode::Bootloader):
-        {
-            msg.mode = Mode::Bootloader;
-            break;
-        }
-        default:
-        {
-            return {};
-        }
-        }
+        static constexpr Type Periodic  = 1;
+        static constexpr Type OnChange  = 2;
 
-        decoder.skipUpToOffset(24);
-        decoder.fetchBytes(msg.globally_unique_id.begin(),
-                           msg.globally_unique_id.end());
+        Type value = 0;
 
-        assert(decoder.getOffset() == 40);
-        decoder.fetchASCIIString(msg.endpoint_name);
-        decoder.skipUpToOffset(120);
-        decoder.fetchASCIIString(msg.endpoint_description);
-        decoder.skipUpToOffset(200);
-        decoder.fetchASCIIString(msg.build_environment_description);
-        decoder.skipUpToOffset(280);
-        decoder.fetchASCIIString(msg.runtime_environment_description);
-        decoder.skipUpToOffset(360);
-        decoder.fetchBytes(std::back_inserter(msg.certificate_of_authenticity),
-                           decoder.getRemainingLength());
-        return msg;
-    }
+        [[nodiscard]] bool isCancel()   const { return value == 0; }
+        [[nodiscard]] bool isPeriodic() const { return (value & Periodic) != 0; }
+        [[nodiscard]] bool isOnChange() const { return (value & OnChange) != 0; }
+    };
 };
 
 /**
- * This is not a message class.
- * This is a serializable register name that can be used in register manipulation messages.
+ * Sets up, replaces, or cancels a register trace, see @ref RegisterTrace.
+ * The trace ID is chosen by the host; a request with a trace ID that is already in use replaces the old trace.
+ * The device responds with @ref RegisterTraceSetupResponseMessage.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u8              length          Length of the next field.
+ *      0       u8              trace_id        Arbitrary host-assigned identifier of the trace.
+ *      1       u8              trigger         1 - periodic, 2 - on change; zero cancels the trace.
+ *      2       u32             period          Microseconds; see RegisterTrace::Trigger.
+ *      6       item[<=64]      names           The items follow each other until the end of the message.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=1022
+ *
+ * Item:
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              name_length     Length of the next field.
  *      1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
  *  -----------------------------------------------------------------------------------------------
  *    <=94
  */
-struct RegisterName : public senoval::String<93>
+struct RegisterTraceSetupRequestMessage :
+    public detail_::RegisterBatchMessageBase<RegisterTraceSetupRequestItem, 6>
 {
-    using Base = senoval::String<93>;
+    using Item = RegisterTraceSetupRequestItem;
 
-    static constexpr std::size_t MinEncodedSize = 1;
-    static constexpr std::size_t MaxEncodedSize = 94;
+    static constexpr MessageID ID = MessageID::RegisterTraceSetupRequest;
 
-    using Base::String;    ///< All constructors are inherited
-    using Base::operator=;
+    /**
+     * All fields of this message type except the items.
+     */
+    std::uint8_t trace_id = 0;
+    RegisterTrace::Trigger trigger;
+    RegisterTrace::Period period{};
 
     /**
-     * Optional high-level naming convention.
-     * If the default value is defined for a register, it can be represented in a different register
-     * that has the same name suffixed with '='. Minimum and maximum values can be represented likewise,
-     * if necessary. For example:
-     *  Register name: "foo", default value 42, minimum 12, maximum 72.
-     *  Default value is stored in a read-only register "foo=" with the constant value 42.
-     *  Minimum and maximum values are stored in registers named "foo<" and "foo>", respectively.
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
      */
-    struct Suffix
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
     {
-        static constexpr char DefaultValue = '=';
-        static constexpr char MinimumValue = '<';
-        static constexpr char MaximumValue = '>';
-        // Other optional suffixes may be added in the future.
-    };
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        encoder.addU8(trace_id);
+        encoder.addU8(trigger.value);
+        encoder.addU32(period.count());
+        for (auto& x : items)
+        {
+            x.name.encode(encoder);
+        }
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
 
     /**
-     * Serializes the object into the provided encoder.
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
      */
-    template <typename OutputIterator>
-    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
     {
-        encoder.addU8(std::uint8_t(this->length()));
-        encoder.addBytes(*this);
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
+        return buf;
     }
 
     /**
-     * Attempts to reconstruct the state of the current object from the provided data stream.
-     * Maximum size is not checked because this is not a greedy decoder, i.e. there may be more data after the string.
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    bool tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    static std::optional<RegisterTraceSetupRequestMessage> tryDecode(InputIterator begin, InputIterator end)
     {
-        if (decoder.getRemainingLength() < MinEncodedSize)
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
         {
-            return false;
+            return {};
         }
 
-        const std::uint8_t name_len = decoder.fetchU8();
-        if ((name_len > Capacity) ||
-            (name_len > decoder.getRemainingLength()))
+        if (decoder.getRemainingLength() < MinEncodedSize)
         {
-            return false;
+            return {};
         }
 
-        clear();
-        for (std::uint8_t i = 0; i < name_len; i++)
+        RegisterTraceSetupRequestMessage msg;
+        msg.trace_id      = decoder.fetchU8();
+        msg.trigger.value = decoder.fetchU8();
+        msg.period        = RegisterTrace::Period(decoder.fetchU32());
+        while (decoder.getRemainingLength() > 0)
         {
-            push_back(char(decoder.fetchU8()));
+            if (msg.items.size() >= MaxItems)
+            {
+                return {};
+            }
+
+            Item item;
+            if (!item.name.tryDecode(decoder))
+            {
+                return {};
+            }
+            msg.items.push_back(item);
         }
 
-        return true;
+        return msg;
     }
 };
 
-/// Implementation details; do not use that in user code
-namespace detail_
-{
 /**
- * List of possible register value types. There are 14 of them, each has a distinct type ID starting from 0.
- * This type cannot be instantiated directly! It is only a type container.
+ * Response to @ref RegisterTraceSetupRequestMessage.
+ * The device may adjust the requested period to its capabilities; the actual period is reported back.
+ * If the status is not OK, the trace is not active and the old trace with the same ID (if any) is removed.
+ * Traced registers that do not exist are not an error; their values are reported empty.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u8              trace_id        Trace ID copied from the request.
+ *      1       u8              status          Setup status.
+ *      2       u32             period          Actual period in microseconds.
+ *  -----------------------------------------------------------------------------------------------
+ *      6
  */
-struct RegisterValueTypes
+struct RegisterTraceSetupResponseMessage
 {
-    /// No value; used to represent missing registers and requests for data
-    using Empty = std::monostate;                                             ///< Type ID 0
+    static constexpr std::size_t EncodedSize = 6;
 
-    /// ASCII string, or UTF-8 encoded bytes
-    using String = senoval::String<256>;                                      ///< Type ID 1
-
-    /// A wrapper is needed rather than alias to create a distinct type for std::variant
-    struct Unstructured : public senoval::Vector<std::uint8_t, 256>           ///< Type ID 2
-    {
-        using Base = senoval::Vector<std::uint8_t, 256>;
-        Unstructured() = default;
-        Unstructured(std::size_t len, const std::uint8_t* ptr) : Base(ptr, ptr + len) {}
-    };
+    static constexpr MessageID ID = MessageID::RegisterTraceSetupResponse;
 
-    /// A wrapper is needed rather than alias to create a distinct type for std::variant
-    struct Boolean : public senoval::Vector<bool, 256>                        ///< Type ID 3
+    /**
+     * Trace setup result.
+     */
+    enum class Status : std::uint8_t
     {
-        using Base = senoval::Vector<bool, 256>;
-        using Base::Vector;
+        Ok                  = 0,
+        TooManyTraces       = 1,
+        TooManyRegisters    = 2,
+        BadTrigger          = 3,
     };
 
-    /// Signed integers
-    using I64 = senoval::Vector<std::int64_t, 32>;                            ///< Type ID 4
-    using I32 = senoval::Vector<std::int32_t, 64>;                            ///< Type ID 5
-    using I16 = senoval::Vector<std::int16_t, 128>;                           ///< Type ID 6
-    using I8  = senoval::Vector<std::int8_t,  256>;                           ///< Type ID 7
-
-    /// Unsigned integers
-    using U64 = senoval::Vector<std::uint64_t, 32>;                           ///< Type ID 8
-    using U32 = senoval::Vector<std::uint32_t, 64>;                           ///< Type ID 9
-    using U16 = senoval::Vector<std::uint16_t, 128>;                          ///< Type ID 10
-    using U8  = senoval::Vector<std::uint8_t,  256>;                          ///< Type ID 11
-
-    /// IEEE754 floating point
-    using F64 = senoval::Vector<double, 32>;                                  ///< Type ID 12
-    using F32 = senoval::Vector<float,  64>;                                  ///< Type ID 13
-
     /**
-     * All value types represented as a single algebraic type (tagged union).
-     * Note that the order of declaration matters, because it defines the type ID mappings.
+     * All fields of this message type.
      */
-    using Variant = std::variant<
-        Empty,              ///< No value is provided
-        String,             ///< UTF-8 encoded string of text
-        Unstructured,       ///< Raw unstructured bytes
-        Boolean,            ///< One byte per value; 0 - false, 1...255 - true
-        // Signed integers
-        I64,
-        I32,
-        I16,
-        I8,
-        // Unsigned integers
-        U64,
-        U32,
-        U16,
-        U8,
-        // IEEE754 floating point
-        F64,
-        F32
-    >;
-
-private:
-    template <typename Scalar>
-    struct ValueTypeForScalarImpl;
+    std::uint8_t trace_id = 0;
+    Status status{};
+    RegisterTrace::Period period{};
 
-public:
     /**
-     * This convenience type reduces the amount of boilerplate needed to map types from simple
-     * scalar types to value vector types.
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
      */
-    template <typename Scalar>
-    using ValueTypeForScalar = typename ValueTypeForScalarImpl<Scalar>::T;
-
-protected:  // This type cannot be instantiated directly
-    RegisterValueTypes() = default;
-    ~RegisterValueTypes() = default;
-
-    /// The number of bytes the value is allowed to take in the encoded form.
-    static constexpr std::size_t MaxEncodedValueSize = 256;
-};
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        encoder.addU8(trace_id);
+        encoder.addU8(std::uint8_t(status));
+        encoder.addU32(period.count());
+        assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
 
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<bool> { using T = Boolean; };
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    StaticMessageBuffer<EncodedSize> encode() const
+    {
+        StaticMessageBuffer<EncodedSize> buf;
+        const std::size_t size = encode(buf.begin());
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
 
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int64_t> { using T = I64; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int32_t> { using T = I32; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int16_t> { using T = I16; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::int8_t>  { using T = I8;  };
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<RegisterTraceSetupResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
 
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint64_t> { using T = U64; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint32_t> { using T = U32; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint16_t> { using T = U16; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<std::uint8_t>  { using T = U8;  };
+        if (decoder.getRemainingLength() != EncodedSize)
+        {
+            return {};
+        }
 
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<double> { using T = F64; };
-template <> struct RegisterValueTypes::ValueTypeForScalarImpl<float>  { using T = F32;  };
+        RegisterTraceSetupResponseMessage msg;
+        msg.trace_id = decoder.fetchU8();
+        msg.status   = Status(decoder.fetchU8());
+        msg.period   = RegisterTrace::Period(decoder.fetchU32());
 
-} // namespace detail_
+        return msg;
+    }
+};
 
 /**
- * This is not a message class.
- * This is a serializable representation of a register value that can be used in register manipulation messages.
+ * Unsolicited message that reports the values of the traced registers, see @ref RegisterTrace.
+ * The values are in the same order as the names in the setup request, so the names are not repeated.
+ * The sequence number is incremented by one with every event of the trace (it starts from zero when the trace
+ * is set up and wraps around), which allows the host to detect lost events.
+ * Unlike in the non-batched messages, the value is prefixed with its length; zero length denotes an empty value.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u8              type_id         Type of the value contained in this register.
- *      1       u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *      0       u8              trace_id        Trace ID from the setup request.
+ *      1       u32             sequence_number Incremented with every event of the trace.
+ *      5       u64             timestamp       Timestamp of the provided values.
+ *      13      item[<=64]      values          The items follow each other until the end of the message.
  *  -----------------------------------------------------------------------------------------------
- *    <=257
+ *    <=1022
+ *
+ * Item:
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u16             value_length    Length of the next field.
+ *      2       u8[<=257]       value           Register value: type_id followed by encoded_payload.
+ *  -----------------------------------------------------------------------------------------------
+ *    <=259
+ *
+ * Embedded systems can emit the event item by item instead of populating the object, using @ref encodeItem()
+ * after @ref encodeFixedPart().
  */
-struct RegisterValue : public detail_::RegisterValueTypes::Variant,
-                       public detail_::RegisterValueTypes
+struct RegisterTraceEventMessage :
+    public detail_::RegisterBatchMessageBase<RegisterTraceEventItem, 13>
 {
-    /**
-     * Alias of the underlying std::variant<>
-     */
-    using Variant = detail_::RegisterValueTypes::Variant;
-
-    /**
-     * Size limits of the encoded representation.
-     */
-    static constexpr std::size_t MinEncodedSize = 1;
-    static constexpr std::size_t MaxEncodedSize = 257;
-
-    /**
-     * Number of types that are defined for this std::variant<>.
-     */
-    static constexpr std::uint8_t NumberOfVariants = std::uint8_t(std::variant_size_v<Variant>);
+    using Item = RegisterTraceEventItem;
 
-    /**
-     * Maps variant index to type at compile time.
-     */
-    template <std::size_t VariantIndex>
-    using VariantTypeAtIndex = std::variant_alternative_t<VariantIndex, Variant>;
+    static constexpr MessageID ID = MessageID::RegisterTraceEvent;
 
     /**
-     * All constructors and assignment operators are inherited from std::variant<>.
+     * All fields of this message type except the items.
      */
-    using Variant::variant;
-    using Variant::operator=;
+    std::uint8_t trace_id = 0;
+    std::uint32_t sequence_number = 0;
+    Timestamp timestamp{};
 
     /**
-     * Shortcut for std::holds_alternative<T>(*this).
-     * Usage:
-     *  if (msg.is<RegisterData::U64>())
-     *  {
-     *      // Message contains an array of uint64
-     *  }
+     * Encodes the message header and all fields except the items.
      */
-    template <typename T> [[nodiscard]] bool is() const { return std::holds_alternative<T>(*this); }
+    template <typename OutputIterator>
+    static void encodeFixedPart(presentation::StreamEncoder<OutputIterator>& encoder,
+                                const std::uint8_t trace_id,
+                                const std::uint32_t sequence_number,
+                                const Timestamp ts)
+    {
+        MessageHeader(ID).encode(encoder);
+        encoder.addU8(trace_id);
+        encoder.addU32(sequence_number);
+        encoder.addU64(ts.count());
+    }
 
     /**
-     * Shortcut for std::get_if<T>(this).
-     * Usage:
-     *  if (auto value = msg.as<RegisterData::U64>())
-     *  {
-     *      // Message contains an array of uint64; the pointer to that array is now stored in 'value'
-     *  }
+     * Encodes one item; see the class description.
      */
-    template <typename T> [[nodiscard]]       T* as()       { return std::get_if<T>(this); }
-    template <typename T> [[nodiscard]] const T* as() const { return std::get_if<T>(this); }
+    template <typename OutputIterator>
+    static void encodeItem(presentation::StreamEncoder<OutputIterator>& encoder, const RegisterValue& value)
+    {
+        encodeValue(encoder, value);
+    }
 
     /**
-     * A simple wrapper over std::visit<>(), refer to that for more info.
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
      */
-    template <typename Visitor>
-    auto visit(Visitor&& vis) const
-    {
-        return std::visit(std::forward<Visitor>(vis), *static_cast<const Variant*>(this));
-    }
-    template <typename Visitor>
-    auto visit(Visitor&& vis)
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
     {
-        return std::visit(std::forward<Visitor>(vis), *static_cast<Variant*>(this));
+        presentation::StreamEncoder encoder(begin);
+        encodeFixedPart(encoder, trace_id, sequence_number, timestamp);
+        for (auto& x : items)
+        {
+            encodeItem(encoder, x.value);
+        }
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
     }
 
     /**
-     * Serializes the object into the provided encoder.
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
      */
-    template <typename OutputIterator>
-    void encode(presentation::StreamEncoder<OutputIterator>& encoder) const
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
     {
-        encoder.addU8(std::uint8_t(index()));
-        visit(VariantEncoder(encoder));
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
+        return buf;
     }
 
     /**
-     * Attempts to reconstruct the state of the current object from the provided data stream.
-     * Note that the function is greedy: it takes all remaining data in the stream.
-     * It is therefore necessary to always allocate the value at the end of the message,
-     * or prepend each value with a 16-bit length field and pass an accordingly truncated
-     * stream into this function.
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    bool tryDecode(presentation::StreamDecoder<InputIterator>& decoder)
+    static std::optional<RegisterTraceEventMessage> tryDecode(InputIterator begin, InputIterator end)
     {
-        if (decoder.getRemainingLength() < MinEncodedSize)
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
         {
-            emplace<Empty>();       // No payload is treated as empty value as a last resort (not required)
-            return true;
+            return {};
         }
 
-        if (decoder.getRemainingLength() > MaxEncodedSize)
+        if (decoder.getRemainingLength() < MinEncodedSize)
         {
-            return false;
+            return {};
         }
 
-        const std::uint8_t type_id = decoder.fetchU8();
-        if (type_id >= NumberOfVariants)
+        RegisterTraceEventMessage msg;
+        msg.trace_id        = decoder.fetchU8();
+        msg.sequence_number = decoder.fetchU32();
+        msg.timestamp       = Timestamp(decoder.fetchU64());
+        while (decoder.getRemainingLength() > 0)
         {
-            return false;
+            if (msg.items.size() >= MaxItems)
+            {
+                return {};
+            }
+
+            Item item;
+            if (!tryDecodeValue(decoder, begin, item.value))
+            {
+                return {};
+            }
+            msg.items.push_back(item);
         }
 
-        decodeByTypeID(decoder, type_id);
-        return true;
+        return msg;
     }
+};
 
-private:
-    template <typename OutputIterator>
-    class VariantEncoder
-    {
-        presentation::StreamEncoder<OutputIterator>& encoder_;
-
-    public:
-        explicit VariantEncoder(presentation::StreamEncoder<OutputIterator>& stream_encoder) :
-            encoder_(stream_encoder)
-        { }
-
-        /// Empty value handler
-        void operator()(const std::monostate&) const { }
+/**
+ * Device-side scheduling logic of one register trace: decides when the next event is due and keeps
+ * its sequence number. The values and the names of the traced registers are kept by the application.
+ * Usage: invoke @ref setUp() upon reception of a setup request, then invoke @ref poll() periodically;
+ * whenever it returns a sequence number, send an event with that sequence number.
+ */
+class RegisterTraceScheduler
+{
+    RegisterTrace::Trigger trigger_;
+    Timestamp period_{};
+    Timestamp deadline_{};
+    std::uint32_t next_sequence_number_ = 0;
 
-        /// String handler
-        void operator()(const String& str) const
+public:
+    /**
+     * Activates the trace, or deactivates it if the trigger is zero. The sequence number is reset.
+     * Periodic traces with zero period are not allowed, because they would saturate the link.
+     */
+    RegisterTraceSetupResponseMessage::Status setUp(const RegisterTrace::Trigger trigger,
+                                                    const RegisterTrace::Period period,
+                                                    const Timestamp now)
+    {
+        if (trigger.isPeriodic() && (period.count() == 0))
         {
-            encoder_.addBytes(str);
+            trigger_ = {};
+            return RegisterTraceSetupResponseMessage::Status::BadTrigger;
         }
 
-        /// Integer vector handler
-        template <typename T, std::size_t Capacity>
-        std::enable_if_t<std::is_integral_v<T>>
-        operator()(const senoval::Vector<T, Capacity>& vec) const
-        {
-            // The following construct cleverly avoids dependency on the native type sizes.
-            static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
-            for (const T& x : vec)
-            {
-                if constexpr (std::is_signed_v<T>)
-                {
-                    encoder_.template addSignedInteger<EncodedItemSize>(x);
-                }
-                else
-                {
-                    encoder_.template addUnsignedInteger<EncodedItemSize>(x);
-                }
-            }
-        }
+        trigger_ = trigger;
+        period_ = std::chrono::duration_cast<Timestamp>(period);
+        deadline_ = now;                                    // The first event is sent immediately
+        next_sequence_number_ = 0;
+        return RegisterTraceSetupResponseMessage::Status::Ok;
+    }
 
-        /// Float vector handler
-        template <typename T, std::size_t Capacity>
-        std::enable_if_t<std::is_floating_point_v<T>>
-        operator()(const senoval::Vector<T, Capacity>& vec) const
+    /**
+     * Returns the sequence number of the event that should be sent now, or nothing if it is not time yet.
+     * @param now           Current time.
+     * @param changed       Whether any of the traced registers has changed since the last event;
+     *                      ignored unless the trigger is on change.
+     */
+    std::optional<std::uint32_t> poll(const Timestamp now, const bool changed)
+    {
+        const bool period_expired = now >= deadline_;
+        const bool due = trigger_.isPeriodic() ? period_expired :
+                         trigger_.isOnChange() ? (period_expired && changed) : false;
+        if (!due)
         {
-            for (const T& x : vec)
-            {
-                encoder_.template addIEEE754<MaxEncodedValueSize / Capacity>(x);
-            }
+            return {};
         }
-    };
 
-    template <typename InputByteIterator, std::uint8_t TypeIDCandidate = 0>
-    void decodeByTypeID(presentation::StreamDecoder<InputByteIterator>& decoder, const std::uint8_t type_id)
-    {
-        if constexpr (TypeIDCandidate < NumberOfVariants)
+        // If we fell behind by more than one period, skip the missed events instead of sending them in a burst
+        deadline_ += period_;
+        if (deadline_ <= now)
         {
-            if (type_id == TypeIDCandidate)
-            {
-                decodeSpecificValue(decoder, emplace<VariantTypeAtIndex<TypeIDCandidate>>());
-            }
-            else
-            {
-                decodeByTypeID<InputByteIterator, TypeIDCandidate + 1>(decoder, type_id);
-            }
+            deadline_ = now + period_;
         }
-        // Otherwise the type ID is wrong. The caller is supposed to catch that; we're going to leave the value Empty.
+
+        return next_sequence_number_++;
     }
 
-    template <typename InputByteIterator, typename T, std::size_t Capacity>
-    static void resizeVectorBeforeDecoding(presentation::StreamDecoder<InputByteIterator>& decoder,
-                                           senoval::Vector<T, Capacity>& vector)
+    [[nodiscard]] bool isActive() const { return !trigger_.isCancel(); }
+};
+
+/**
+ * Request of register name by index. Used for discovery purposes only.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u16             register_index  Index of the register name of which is requested.
+ *  -----------------------------------------------------------------------------------------------
+ *      2
+ */
+struct RegisterDiscoveryRequestMessage
+{
+    static constexpr std::size_t EncodedSize = 2;
+
+    static constexpr MessageID ID = MessageID::RegisterDiscoveryRequest;
+
+    /**
+     * All fields of this message type.
+     */
+    std::uint16_t index = 0;
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
     {
-        // The following construct cleverly avoids dependency on the native type sizes.
-        static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
-        const std::size_t NumItems = std::min(Capacity, decoder.getRemainingLength() / EncodedItemSize);
-        vector.resize(NumItems);
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        encoder.addU16(index);
+        assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
+        return EncodedSize + MessageHeader::Size;
     }
 
-    /// Empty value handler
-    template <typename InputByteIterator>
-    static void decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>&, std::monostate&) { }
-
-    /// String handler
-    template <typename InputByteIterator>
-    static void decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
-                                    String& out_string)
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    StaticMessageBuffer<EncodedSize> encode() const
     {
-        decoder.fetchASCIIString(out_string);
+        StaticMessageBuffer<EncodedSize> buf;
+        (void) encode(buf.begin());
+        return buf;
     }
 
-    /// Integer vector handler
-    template <typename InputByteIterator, typename T, std::size_t Capacity>
-    static std::enable_if_t<std::is_integral_v<T>>
-    decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
-                        senoval::Vector<T, Capacity>& out_vector)
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<RegisterDiscoveryRequestMessage> tryDecode(InputIterator begin, InputIterator end)
     {
-        // The following construct cleverly avoids dependency on the native type sizes.
-        static constexpr std::size_t EncodedItemSize = MaxEncodedValueSize / Capacity;
-        resizeVectorBeforeDecoding(decoder, out_vector);
-        for (auto& x : out_vector)
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
         {
-            if constexpr (std::is_signed_v<T>)
-            {
-                x = decoder.template fetchSignedInteger<EncodedItemSize>();
-            }
-            else
-            {
-                // Cast is needed here to properly handle booleans
-                x = T(decoder.template fetchUnsignedInteger<EncodedItemSize>());
-            }
+            return {};
         }
-    }
 
-    /// Float vector handler
-    template <typename InputByteIterator, typename T, std::size_t Capacity>
-    static std::enable_if_t<std::is_floating_point_v<T>>
-    decodeSpecificValue(presentation::StreamDecoder<InputByteIterator>& decoder,
-                        senoval::Vector<T, Capacity>& out_vector)
-    {
-        resizeVectorBeforeDecoding(decoder, out_vector);
-        for (auto& x : out_vector)
+        if (decoder.getRemainingLength() != EncodedSize)
         {
-            x = decoder.template fetchIEEE754<MaxEncodedValueSize / Capacity>();
+            return {};
         }
+
+        RegisterDiscoveryRequestMessage msg;
+        msg.index = decoder.fetchU16();
+        return msg;
     }
 };
 
 /**
- * This is a simple composition of RegisterName and RegisterValue.
- * Register read request if the value is empty.
- * Register write request if the value is not empty.
+ * Discovery response - contains the name of the register at the index. Used for discovery purposes only.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u8              name_length     Length of the next field.
- *      1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
- *      1..94   u8              type_id         Type of the value contained in this message.
- *      2..95   u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *      0       u16             register_index  Index of the provided register name.
+ *      2       u8              name_length     Length of the next field.
+ *      3       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+ *      3..96                                   reserved for future use
  *  -----------------------------------------------------------------------------------------------
- *    <=351
+ *      (max size unconstrained)
  */
-struct RegisterDataRequestMessage
+struct RegisterDiscoveryResponseMessage
 {
-    static constexpr std::size_t MinEncodedSize = 2;
-    static constexpr std::size_t MaxEncodedSize = 351;
+    static constexpr std::size_t MinEncodedSize = 3;
+    static constexpr std::size_t MaxEncodedSize = 96;   ///< May be changed in the future, do not check when decoding
 
-    static constexpr MessageID ID = MessageID::RegisterDataRequest;
+    static constexpr MessageID ID = MessageID::RegisterDiscoveryResponse;
 
     /**
      * All fields of this message type.
      */
+    std::uint16_t index = 0;
     RegisterName name;
-    RegisterValue value;
 
     /**
      * Encodes the message into the provided sequential iterator.
@@ -1791,8 +5540,8 @@ struct RegisterDataRequestMessage
     {
         presentation::StreamEncoder encoder(begin);
         MessageHeader(ID).encode(encoder);
+        encoder.addU16(index);
         name.encode(encoder);
-        value.encode(encoder);
         assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
         assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
         return encoder.getOffset();
@@ -1817,7 +5566,7 @@ struct RegisterDataRequestMessage
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<RegisterDataRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<RegisterDiscoveryResponseMessage> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
@@ -1826,13 +5575,14 @@ struct RegisterDataRequestMessage
             return {};
         }
 
-        RegisterDataRequestMessage msg;
-        if (!msg.name.tryDecode(decoder))
+        if (decoder.getRemainingLength() < MinEncodedSize)  // Max is not checked - extra data should be ignored
         {
             return {};
         }
 
-        if (!msg.value.tryDecode(decoder))
+        RegisterDiscoveryResponseMessage msg;
+        msg.index = decoder.fetchU16();
+        if (!msg.name.tryDecode(decoder))
         {
             return {};
         }
@@ -1842,63 +5592,68 @@ struct RegisterDataRequestMessage
 };
 
 /**
- * Representation of register flags.
+ * Computes the register schema hash that is reported via @ref EndpointInfoMessage::register_schema_hash.
+ * The hash covers the register names in the order of their indexes, so a change of the hash tells the host
+ * that its cached name-to-index mapping (obtained via discovery) is no longer valid and that it should
+ * rediscover the registers before using @ref RegisterIndexedDataRequestMessage.
+ * Since the host obtains the same names during discovery, it can compute the hash too and compare.
+ *
+ * The hash is 32-bit FNV-1a over every name followed by a zero byte, XOR-folded to 16 bits.
  */
-struct RegisterFlags
+class RegisterSchemaHasher
 {
-    using Type = std::uint8_t;
-
-    static constexpr Type Mutable       = 1;
-    static constexpr Type Persistent    = 2;
-
-    Type value = 0;
-
-    [[nodiscard]] bool isMutable()    const { return check<Mutable>(); }
-    [[nodiscard]] bool isPersistent() const { return check<Persistent>(); }
+    std::uint32_t state_ = 0x811C9DC5U;
 
-    void setMutable(bool x)    { set<Mutable>(x); }
-    void setPersistent(bool x) { set<Persistent>(x); }
+    constexpr void addByte(const std::uint8_t x)
+    {
+        state_ = std::uint32_t((state_ ^ x) * 0x01000193U);
+    }
 
-private:
-    template <Type F> [[nodiscard]] bool check() const { return (value & F) != 0; }
+public:
+    /**
+     * Adds the next register name; the names must be added in the order of their indexes.
+     */
+    constexpr void add(const std::string_view name)
+    {
+        for (char c : name)
+        {
+            addByte(std::uint8_t(c));
+        }
+        addByte(0);
+    }
 
-    template <Type F>
-    void set(const bool x)
+    constexpr std::uint16_t get() const
     {
-        if (x) { value = Type(value |  F); }
-        else   { value = Type(value & ~F); }
+        return std::uint16_t((state_ >> 16U) ^ (state_ & 0xFFFFU));
     }
 };
 
 /**
- * This is a simple composition of RegisterName and RegisterValue with some additional values.
- * Register does not exist if the value is empty.
- * Register exists and the response contains its data if the value is not empty.
+ * Same as @ref RegisterDataRequestMessage, but the register is referred to by its index rather than by name,
+ * which makes the message much shorter. The mapping is obtained using the discovery messages
+ * (see @ref RegisterDiscoveryRequestMessage) and should be cached by the host only as long as the
+ * register schema hash reported by the endpoint does not change (see @ref RegisterSchemaHasher).
+ * The response is @ref RegisterIndexedDataResponseMessage.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u64             timestamp       Timestamp of the provided value.
- *      8       u8              flags           Register flags: 1 - mutable, 2 - persistent.
- *      9       u8              name_length     Length of the next field.
- *      10      u8[<=93]        name            ASCII name, not terminated - see the previous field.
- *      10..103 u8              type_id         Type of the value contained in this message.
- *      11..104 u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+ *      0       u16             register_index  Index of the register as reported by the discovery messages.
+ *      2       u8              type_id         Type of the value contained in this message.
+ *      3       u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
  *  -----------------------------------------------------------------------------------------------
- *    <=360
+ *    <=259
  */
-struct RegisterDataResponseMessage
+struct RegisterIndexedDataRequestMessage
 {
-    static constexpr std::size_t MinEncodedSize = 11;
-    static constexpr std::size_t MaxEncodedSize = 360;
+    static constexpr std::size_t MinEncodedSize = 3;
+    static constexpr std::size_t MaxEncodedSize = 259;
 
-    static constexpr MessageID ID = MessageID::RegisterDataResponse;
+    static constexpr MessageID ID = MessageID::RegisterIndexedDataRequest;
 
     /**
      * All fields of this message type.
      */
-    Timestamp timestamp{};
-    RegisterFlags flags;
-    RegisterName name;
+    std::uint16_t index = 0;
     RegisterValue value;
 
     /**
@@ -1912,9 +5667,7 @@ struct RegisterDataResponseMessage
     {
         presentation::StreamEncoder encoder(begin);
         MessageHeader(ID).encode(encoder);
-        encoder.addU64(timestamp.count());
-        encoder.addU8(flags.value);
-        name.encode(encoder);
+        encoder.addU16(index);
         value.encode(encoder);
         assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
         assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
@@ -1940,7 +5693,7 @@ struct RegisterDataResponseMessage
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<RegisterDataResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<RegisterIndexedDataRequestMessage> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
@@ -1954,14 +5707,8 @@ struct RegisterDataResponseMessage
             return {};
         }
 
-        RegisterDataResponseMessage msg;
-        msg.timestamp = Timestamp(decoder.fetchU64());
-        msg.flags.value = decoder.fetchU8();
-
-        if (!msg.name.tryDecode(decoder))
-        {
-            return {};
-        }
+        RegisterIndexedDataRequestMessage msg;
+        msg.index = decoder.fetchU16();
 
         if (!msg.value.tryDecode(decoder))
         {
@@ -1973,24 +5720,33 @@ struct RegisterDataResponseMessage
 };
 
 /**
- * Request of register name by index. Used for discovery purposes only.
+ * Same as @ref RegisterDataResponseMessage, but the register is referred to by its index rather than by name.
+ * Register does not exist (the index is out of range) if the value is empty.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u16             register_index  Index of the register name of which is requested.
+ *      0       u64             timestamp       Timestamp of the provided value.
+ *      8       u16             register_index  Index of the register copied from the request.
+ *      10      u8              flags           Register flags: 1 - mutable, 2 - persistent.
+ *      11      u8              type_id         Type of the value contained in this message.
+ *      12      u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
  *  -----------------------------------------------------------------------------------------------
- *      2
+ *    <=268
  */
-struct RegisterDiscoveryRequestMessage
+struct RegisterIndexedDataResponseMessage
 {
-    static constexpr std::size_t EncodedSize = 2;
+    static constexpr std::size_t MinEncodedSize = 12;
+    static constexpr std::size_t MaxEncodedSize = 268;
 
-    static constexpr MessageID ID = MessageID::RegisterDiscoveryRequest;
+    static constexpr MessageID ID = MessageID::RegisterIndexedDataResponse;
 
     /**
      * All fields of this message type.
      */
+    Timestamp timestamp{};
     std::uint16_t index = 0;
+    RegisterFlags flags;
+    RegisterValue value;
 
     /**
      * Encodes the message into the provided sequential iterator.
@@ -2003,9 +5759,13 @@ struct RegisterDiscoveryRequestMessage
     {
         presentation::StreamEncoder encoder(begin);
         MessageHeader(ID).encode(encoder);
+        encoder.addU64(timestamp.count());
         encoder.addU16(index);
-        assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
-        return EncodedSize + MessageHeader::Size;
+        encoder.addU8(flags.value);
+        value.encode(encoder);
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
     }
 
     /**
@@ -2013,10 +5773,12 @@ struct RegisterDiscoveryRequestMessage
      * This version encodes the message into a fixed capacity array and returns it by value.
      * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
      */
-    StaticMessageBuffer<EncodedSize> encode() const
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
     {
-        StaticMessageBuffer<EncodedSize> buf;
-        (void) encode(buf.begin());
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
+        (void) size;
+        assert(size == buf.size());
         return buf;
     }
 
@@ -2025,7 +5787,7 @@ struct RegisterDiscoveryRequestMessage
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<RegisterDiscoveryRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<RegisterIndexedDataResponseMessage> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
@@ -2034,104 +5796,286 @@ struct RegisterDiscoveryRequestMessage
             return {};
         }
 
-        if (decoder.getRemainingLength() != EncodedSize)
+        if (decoder.getRemainingLength() < MinEncodedSize)
         {
             return {};
         }
 
-        RegisterDiscoveryRequestMessage msg;
+        RegisterIndexedDataResponseMessage msg;
+        msg.timestamp = Timestamp(decoder.fetchU64());
         msg.index = decoder.fetchU16();
+        msg.flags.value = decoder.fetchU8();
+
+        if (!msg.value.tryDecode(decoder))
+        {
+            return {};
+        }
+
         return msg;
     }
 };
 
 /**
- * Discovery response - contains the name of the register at the index. Used for discovery purposes only.
+ * An entry of @ref RegisterTable.
+ * @tparam Handler      Application-defined handler type, e.g. a function pointer.
+ *                      It must be a literal type in order to let the table be constructed at compile time.
+ */
+template <typename Handler>
+struct RegisterTableEntry
+{
+    std::string_view name;
+    std::uint8_t type_id = 0;       ///< @ref RegisterValue type ID, see @ref RegisterValue::getTypeID<>()
+    Handler handler{};
+};
+
+/**
+ * A flat register table that is constructed at compile time, so that it can reside in ROM entirely.
+ * It maps register names to the application-defined handlers and value types in constant time using a hash index,
+ * and register indexes (as used in the discovery messages) to the entries by direct indexing.
+ * The register index is the position of the entry in the initializer list.
  *
- *      Offset  Type            Name            Description
- *  -----------------------------------------------------------------------------------------------
- *      0       u16             register_index  Index of the provided register name.
- *      2       u8              name_length     Length of the next field.
- *      3       u8[<=93]        name            ASCII name, not terminated - see the previous field.
- *      3..96                                   reserved for future use
- *  -----------------------------------------------------------------------------------------------
- *      (max size unconstrained)
+ * Usage:
+ *
+ *      using Handler = RegisterDataResponseMessage (*)(const RegisterDataRequestMessage&);
+ *
+ *      static constexpr auto Registers = makeRegisterTable<Handler>({
+ *          { "uavcan.node_id", RegisterValue::getTypeID<RegisterValue::U8>(),  &handleNodeID },
+ *          { "motor.kv",       RegisterValue::getTypeID<RegisterValue::F32>(), &handleKV },
+ *      });
+ *      static_assert(Registers.isValid(), "Register names must be unique and non-empty");
+ *
+ *      if (auto entry = Registers.find(request.name))
+ *      {
+ *          response = entry->handler(request);
+ *      }
  */
-struct RegisterDiscoveryResponseMessage
+template <typename Handler, std::size_t NumberOfRegisters>
+class RegisterTable
 {
-    static constexpr std::size_t MinEncodedSize = 3;
-    static constexpr std::size_t MaxEncodedSize = 96;   ///< May be changed in the future, do not check when decoding
+public:
+    using Entry = RegisterTableEntry<Handler>;
 
-    static constexpr MessageID ID = MessageID::RegisterDiscoveryResponse;
+private:
+    static_assert(NumberOfRegisters > 0, "The register table cannot be empty");
+    static_assert(NumberOfRegisters < 0xFFFFU, "Register indexes are 16-bit wide");
+
+    using IndexEntry = std::uint16_t;
+    static constexpr IndexEntry EmptyIndexEntry = 0xFFFFU;
+
+    /// The load factor of the hash index does not exceed 50%, so the probe sequences are short.
+    static constexpr std::size_t computeIndexSize()
+    {
+        std::size_t size = 1;
+        while (size < (NumberOfRegisters * 2U))
+        {
+            size *= 2U;
+        }
+        return size;
+    }
+    static constexpr std::size_t IndexSize = computeIndexSize();
+
+    std::array<Entry, NumberOfRegisters> entries_{};
+    std::array<IndexEntry, IndexSize> index_{};
+    bool valid_ = true;
+
+    /// FNV-1a
+    static constexpr std::uint32_t computeHash(const std::string_view s)
+    {
+        std::uint32_t hash = 0x811C9DC5U;
+        for (char c : s)
+        {
+            hash = std::uint32_t((hash ^ std::uint8_t(c)) * 0x01000193U);
+        }
+        return hash;
+    }
+
+    /// Returns the position of the name in the hash index, which is either the entry or an empty place.
+    constexpr std::size_t probe(const std::string_view name) const
+    {
+        std::size_t pos = computeHash(name) & (IndexSize - 1U);
+        while ((index_[pos] != EmptyIndexEntry) && (entries_[index_[pos]].name != name))
+        {
+            pos = (pos + 1U) & (IndexSize - 1U);    // Terminates because there is always an empty place
+        }
+        return pos;
+    }
+
+public:
+    constexpr explicit RegisterTable(const Entry (&entries)[NumberOfRegisters])
+    {
+        for (auto& x : index_)
+        {
+            x = EmptyIndexEntry;
+        }
+
+        for (std::size_t i = 0; i < NumberOfRegisters; i++)
+        {
+            entries_[i] = entries[i];
+            valid_ = valid_ &&
+                     !entries[i].name.empty() &&
+                     (entries[i].name.size() <= RegisterName::Capacity) &&
+                     (entries[i].type_id < RegisterValue::NumberOfVariants);
+
+            const std::size_t pos = probe(entries[i].name);
+            valid_ = valid_ && (index_[pos] == EmptyIndexEntry);    // Otherwise the name is not unique
+            index_[pos] = IndexEntry(i);
+        }
+    }
 
     /**
-     * All fields of this message type.
+     * True if all names are unique and fit into @ref RegisterName, and all type IDs are valid.
+     * Use this method in a static assertion to validate the table at compile time.
      */
-    std::uint16_t index = 0;
-    RegisterName name;
+    constexpr bool isValid() const { return valid_; }
 
     /**
-     * Encodes the message into the provided sequential iterator.
-     * The iterator can encode and emit the message on the fly - that would be highly efficient;
-     * see @ref transport::StreamEmitter.
-     * Returns the number of bytes in the encoded stream.
+     * Returns the entry for the specified register name, or nullptr if there is no such register.
      */
-    template <typename OutputIterator>
-    std::size_t encode(OutputIterator begin) const
+    constexpr const Entry* find(const std::string_view name) const
     {
-        presentation::StreamEncoder encoder(begin);
-        MessageHeader(ID).encode(encoder);
-        encoder.addU16(index);
-        name.encode(encoder);
-        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
-        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
-        return encoder.getOffset();
+        const std::size_t pos = probe(name);
+        return (index_[pos] == EmptyIndexEntry) ? nullptr : &entries_[index_[pos]];
+    }
+
+    template <std::size_t Capacity>
+    const Entry* find(const senoval::String<Capacity>& name) const
+    {
+        return find(std::string_view(name.c_str(), name.length()));
+    }
+
+    /**
+     * Returns the register index for the specified register name, if there is such register.
+     */
+    template <typename Name>
+    std::optional<std::uint16_t> findIndex(const Name& name) const
+    {
+        if (const Entry* const e = find(name))
+        {
+            return std::uint16_t(e - entries_.data());
+        }
+        return {};
     }
 
     /**
-     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
-     * This version encodes the message into a fixed capacity array and returns it by value.
-     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     * Returns the entry at the specified register index, or nullptr if the index is out of range.
      */
-    DynamicMessageBuffer<MaxEncodedSize> encode() const
+    constexpr const Entry* at(const std::size_t index) const
     {
-        DynamicMessageBuffer<MaxEncodedSize> buf;
-        const std::size_t size = encode(std::back_inserter(buf));
-        (void) size;
-        assert(size == buf.size());
-        return buf;
+        return (index < NumberOfRegisters) ? &entries_[index] : nullptr;
     }
 
     /**
-     * Attempts to decode a message from the provided standard frame.
-     * The message ID value in the header will be checked.
+     * Constructs a response to the discovery request.
+     * The name in the response is empty if the requested index is out of range.
      */
-    template <typename InputIterator>
-    static std::optional<RegisterDiscoveryResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    RegisterDiscoveryResponseMessage getDiscoveryResponse(const RegisterDiscoveryRequestMessage& request) const
     {
-        presentation::StreamDecoder decoder(begin, end);
-        const auto header = MessageHeader::tryDecode(decoder);
-        if (!header || (header->message_id != ID))
+        RegisterDiscoveryResponseMessage response;
+        response.index = request.index;
+        if (const Entry* const e = at(request.index))
         {
-            return {};
+            for (char c : e->name)
+            {
+                response.name.push_back(c);
+            }
         }
+        return response;
+    }
 
-        if (decoder.getRemainingLength() < MinEncodedSize)  // Max is not checked - extra data should be ignored
+    /**
+     * Register schema hash for @ref EndpointInfoMessage::register_schema_hash; see @ref RegisterSchemaHasher.
+     */
+    constexpr std::uint16_t getSchemaHash() const
+    {
+        RegisterSchemaHasher hasher;
+        for (auto& x : entries_)
         {
-            return {};
+            hasher.add(x.name);
         }
+        return hasher.get();
+    }
 
-        RegisterDiscoveryResponseMessage msg;
-        msg.index = decoder.fetchU16();
-        if (!msg.name.tryDecode(decoder))
-        {
-            return {};
-        }
+    static constexpr std::size_t size() { return NumberOfRegisters; }
 
-        return msg;
-    }
+    constexpr const Entry* begin() const { return entries_.data(); }
+    constexpr const Entry* end()   const { return entries_.data() + NumberOfRegisters; }
+};
+
+/**
+ * Constructs a @ref RegisterTable from a list of entries.
+ * The number of entries is deduced, the handler type has to be specified explicitly.
+ */
+template <typename Handler, std::size_t NumberOfRegisters>
+constexpr RegisterTable<Handler, NumberOfRegisters>
+makeRegisterTable(const RegisterTableEntry<Handler> (&entries)[NumberOfRegisters])
+{
+    return RegisterTable<Handler, NumberOfRegisters>(entries);
+}
+
+/**
+ * Standard names of the registers that expose @ref transport::ParserStatistics; see
+ * @ref getParserStatisticsRegisterValue(). The counters are of type U64, the histograms are of type U32
+ * (one value per bucket, see @ref transport::LatencyHistogram).
+ */
+struct ParserStatisticsRegisterNames
+{
+    static constexpr std::string_view Frames             = "popcop.rx.frames";
+    static constexpr std::string_view CRCErrors          = "popcop.rx.crc_errors";
+    static constexpr std::string_view Overflows          = "popcop.rx.overflows";
+    static constexpr std::string_view ExtraneousBytes    = "popcop.rx.extraneous_bytes";
+    static constexpr std::string_view EscapeCharacters   = "popcop.rx.escape_characters";
+    static constexpr std::string_view Bytes              = "popcop.rx.bytes";
+    static constexpr std::string_view ReceptionHistogram = "popcop.rx.reception_histogram";
+    static constexpr std::string_view HandlingHistogram  = "popcop.rx.handling_histogram";
 };
 
+/**
+ * Returns the value of the standard parser statistics register, or an empty value if there is no such register.
+ * This allows the application to serve the statistics through the regular register data requests:
+ *
+ *      response.value = getParserStatisticsRegisterValue(parser.getInstrumentation(), request.name);
+ *      if (!response.value.is<RegisterValue::Empty>())
+ *      {
+ *          response.timestamp = getTimestamp();
+ *      }
+ */
+template <typename Clock, std::size_t NumBuckets>
+RegisterValue getParserStatisticsRegisterValue(const transport::ParserStatistics<Clock, NumBuckets>& statistics,
+                                               const std::string_view name)
+{
+    using Names = ParserStatisticsRegisterNames;
+    const auto& c = statistics.getCounters();
+
+    const auto counter = [](const std::uint64_t x)
+    {
+        RegisterValue::U64 out;
+        out.push_back(x);
+        return RegisterValue(out);
+    };
+
+    const auto histogram = [](const auto& h)
+    {
+        return RegisterValue(RegisterValue::U32(h.getBuckets().begin(), h.getBuckets().end()));
+    };
+
+    if (name == Names::Frames)             { return counter(c.frames); }
+    if (name == Names::CRCErrors)          { return counter(c.crc_errors); }
+    if (name == Names::Overflows)          { return counter(c.overflows); }
+    if (name == Names::ExtraneousBytes)    { return counter(c.extraneous_bytes); }
+    if (name == Names::EscapeCharacters)   { return counter(c.escape_characters); }
+    if (name == Names::Bytes)              { return counter(c.bytes); }
+    if (name == Names::ReceptionHistogram) { return histogram(statistics.getReceptionHistogram()); }
+    if (name == Names::HandlingHistogram)  { return histogram(statistics.getHandlingHistogram()); }
+    return {};
+}
+
+template <typename Clock, std::size_t NumBuckets, std::size_t Capacity>
+RegisterValue getParserStatisticsRegisterValue(const transport::ParserStatistics<Clock, NumBuckets>& statistics,
+                                               const senoval::String<Capacity>& name)
+{
+    return getParserStatisticsRegisterValue(statistics, std::string_view(name.c_str(), name.length()));
+}
+
 /**
  * Standard generic device command set.
  * Commands should be idempotent whenever possible.
@@ -2256,6 +6200,11 @@ struct DeviceManagementCommandResponseMessage
     DeviceManagementCommand command{};
     Status status{};
 
+    using Codec = presentation::FieldCodec<DeviceManagementCommandResponseMessage,
+                                           presentation::Field<&DeviceManagementCommandResponseMessage::command>,
+                                           presentation::Field<&DeviceManagementCommandResponseMessage::status>>;
+    static_assert(Codec::EncodedSize == EncodedSize);
+
     /**
      * Encodes the message into the provided sequential iterator.
      * The iterator can encode and emit the message on the fly - that would be highly efficient;
@@ -2267,8 +6216,7 @@ struct DeviceManagementCommandResponseMessage
     {
         presentation::StreamEncoder encoder(begin);
         MessageHeader(ID).encode(encoder);
-        encoder.addU16(std::uint16_t(command));
-        encoder.addU8(std::uint8_t(status));
+        Codec::encode(*this, encoder);
         assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
         return encoder.getOffset();
     }
@@ -2307,8 +6255,7 @@ struct DeviceManagementCommandResponseMessage
         }
 
         DeviceManagementCommandResponseMessage msg;
-        msg.command = DeviceManagementCommand(decoder.fetchU16());
-        msg.status  = Status(decoder.fetchU8());
+        Codec::decode(msg, decoder);
 
         return msg;
     }
@@ -2360,6 +6307,30 @@ enum class BootloaderImageType : std::uint8_t
     CertificateOfAuthenticity   = 1,
 };
 
+/**
+ * The image data size per message is a multiple of this; it is also the default and the minimum,
+ * so that old hosts and bootloaders remain compatible.
+ */
+static constexpr std::size_t BootloaderImageDataUnitSize = 256;
+
+/**
+ * The largest image data size per message that can be advertised by the bootloader.
+ */
+static constexpr std::size_t BootloaderMaxImageDataSize = 255 * BootloaderImageDataUnitSize;
+
+/**
+ * Returns the largest image data size per message (a multiple of @ref BootloaderImageDataUnitSize) that
+ * fits into the frames that can be received by a parser with the specified maximum payload size.
+ * Bootloaders are expected to advertise at most that via @ref BootloaderStatusResponseMessage.
+ */
+constexpr std::size_t computeMaxBootloaderImageDataSize(const std::size_t parser_max_payload_size)
+{
+    constexpr std::size_t Overhead = MessageHeader::Size + 9;     // See BootloaderImageDataMessageBase
+    const std::size_t units = (parser_max_payload_size > Overhead) ?
+                              ((parser_max_payload_size - Overhead) / BootloaderImageDataUnitSize) : 0U;
+    return std::min(units * BootloaderImageDataUnitSize, BootloaderMaxImageDataSize);
+}
+
 /**
  * Bootloader status request; contains the desired status, the response will contain the actual new status.
  *
@@ -2406,64 +6377,397 @@ struct BootloaderStatusRequestMessage
      * This version encodes the message into a fixed capacity array and returns it by value.
      * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
      */
-    StaticMessageBuffer<EncodedSize> encode() const
+    StaticMessageBuffer<EncodedSize> encode() const
+    {
+        StaticMessageBuffer<EncodedSize> buf;
+        const std::size_t size = encode(buf.begin());
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<BootloaderStatusRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
+
+        if (decoder.getRemainingLength() != EncodedSize)
+        {
+            return {};
+        }
+
+        BootloaderStatusRequestMessage msg;
+        msg.desired_state  = BootloaderState(decoder.fetchU8());
+
+        return msg;
+    }
+};
+
+/**
+ * Bootloader status response; contains the current status and stuff.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u64             uptime_ns       Bootloader's uptime in nanoseconds.
+ *      8       u64             flags           Bits 0..7 - image data window, see below;
+ *                                              bits 8..15 - max image data size in 256-byte units, see below;
+ *                                              bit 16 - delta upload is supported, see below;
+ *                                              the rest is reserved.
+ *      16      u8              state           The current state of the bootloader's standard state machine.
+ *  -----------------------------------------------------------------------------------------------
+ *      17
+ *
+ * The image data window is the maximum number of image data requests that the host is allowed to send
+ * without waiting for the responses (pipelined upload, see @ref BootloaderImageUploadWindow).
+ * Zero (old bootloaders) and one mean that the upload is strictly stop-and-wait.
+ *
+ * The max image data size is the largest chunk of image data per message that the bootloader can accept;
+ * zero (old bootloaders) means 256 bytes. See @ref BootloaderImageDataMessageBase for the chunking rules.
+ *
+ * If delta upload is supported, the bootloader serves @ref BootloaderImageDigestRequestMessage, does not erase
+ * the existing image when the upgrade begins, and accepts chunks at sparse offsets, leaving the skipped parts of
+ * the image as they are. The host can then send only the chunks that differ from the installed image.
+ */
+struct BootloaderStatusResponseMessage
+{
+    static constexpr std::size_t EncodedSize = 17;
+
+    static constexpr MessageID ID = MessageID::BootloaderStatusResponse;
+
+    /**
+     * All fields of this message type.
+     */
+    Timestamp timestamp{};
+    std::uint64_t flags = 0;
+    BootloaderState state{};
+
+    using Codec = presentation::FieldCodec<BootloaderStatusResponseMessage,
+                                           presentation::Field<&BootloaderStatusResponseMessage::timestamp>,
+                                           presentation::Field<&BootloaderStatusResponseMessage::flags>,
+                                           presentation::Field<&BootloaderStatusResponseMessage::state>>;
+    static_assert(Codec::EncodedSize == EncodedSize);
+
+    static constexpr std::uint64_t ImageDataWindowMask = 0xFFU;
+
+    [[nodiscard]] std::uint8_t getImageDataWindow() const { return std::uint8_t(flags & ImageDataWindowMask); }
+
+    void setImageDataWindow(const std::uint8_t x) { flags = (flags & ~ImageDataWindowMask) | x; }
+
+    static constexpr std::uint64_t MaxImageDataSizeMask = 0xFF00U;
+
+    [[nodiscard]] std::size_t getMaxImageDataSize() const
+    {
+        const auto units = std::size_t((flags & MaxImageDataSizeMask) >> 8U);
+        return std::max<std::size_t>(1, units) * BootloaderImageDataUnitSize;
+    }
+
+    /**
+     * The size must be a multiple of @ref BootloaderImageDataUnitSize not greater than
+     * @ref BootloaderMaxImageDataSize; see @ref computeMaxBootloaderImageDataSize().
+     */
+    void setMaxImageDataSize(const std::size_t x)
+    {
+        assert(((x % BootloaderImageDataUnitSize) == 0) && (x <= BootloaderMaxImageDataSize));
+        flags = (flags & ~MaxImageDataSizeMask) | (std::uint64_t(x / BootloaderImageDataUnitSize) << 8U);
+    }
+
+    static constexpr std::uint64_t DeltaUploadSupportedMask = 1ULL << 16U;
+
+    [[nodiscard]] bool isDeltaUploadSupported() const { return (flags & DeltaUploadSupportedMask) != 0; }
+
+    void setDeltaUploadSupported(const bool x)
+    {
+        flags = x ? (flags | DeltaUploadSupportedMask) : (flags & ~DeltaUploadSupportedMask);
+    }
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(ID).encode(encoder);
+        Codec::encode(*this, encoder);
+        assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    StaticMessageBuffer<EncodedSize> encode() const
+    {
+        StaticMessageBuffer<EncodedSize> buf;
+        const std::size_t size = encode(buf.begin());
+        (void) size;
+        assert(size == buf.size());
+        return buf;
+    }
+
+    /**
+     * Attempts to decode a message from the provided standard frame.
+     * The message ID value in the header will be checked.
+     */
+    template <typename InputIterator>
+    static std::optional<BootloaderStatusResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    {
+        presentation::StreamDecoder decoder(begin, end);
+        const auto header = MessageHeader::tryDecode(decoder);
+        if (!header || (header->message_id != ID))
+        {
+            return {};
+        }
+
+        if (decoder.getRemainingLength() != EncodedSize)
+        {
+            return {};
+        }
+
+        BootloaderStatusResponseMessage msg;
+        Codec::decode(msg, decoder);
+
+        return msg;
+    }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Base type for request/response messages.
+ *
+ *      Offset  Type            Name            Description
+ *  -----------------------------------------------------------------------------------------------
+ *      0       u64             image_offset    Offset from the beginning of the image. Must grow sequentially,
+ *                                              unless the upload is pipelined (see below).
+ *      1       u8              image_type      Kind of image contained in the message:
+ *                                                  0 - application
+ *                                                  1 - certificate of authenticity
+ *      9       u8[<=N]         image_data      Image data at the specified offset. All messages except the last
+ *                                              one are required to contain exactly N bytes of image data.
+ *                                              The last message is required to contain less than N bytes of
+ *                                              image data, possibly zero if the image size is N-byte aligned.
+ *                                              Terminated at the end of the message (implicit length).
+ *  -----------------------------------------------------------------------------------------------
+ *      9+N
+ *
+ * The chunk size N is 256 bytes by default. If the bootloader advertises a larger max image data size
+ * (see @ref BootloaderStatusResponseMessage), the host may choose any multiple of 256 up to that; the bootloader
+ * infers N from the first full chunk it receives. In order to keep that unambiguous, N must not exceed the image
+ * size (rounded down to a multiple of 256), so that the first chunk is never mistaken for the last one.
+ *
+ * If the bootloader reports an image data window greater than one (see @ref BootloaderStatusResponseMessage),
+ * the host may have that many requests outstanding. In that case the bootloader must accept the full-size chunks
+ * in any order and repeatedly (a chunk is retransmitted if its response is lost or does not match), and the
+ * responses identify the chunks by their offsets. The last (short) chunk is still sent only after all preceding
+ * chunks are acknowledged, so it keeps marking the end of the image.
+ *
+ * If the bootloader supports delta upload (see @ref BootloaderStatusResponseMessage), the host may skip the
+ * chunks that are already present in the installed image, except the first and the last ones; the first chunk
+ * establishes N, and the last one marks the end of the image.
+ */
+template <typename Derived, std::size_t MaxImageDataSize>
+struct BootloaderImageDataMessageBase
+{
+    static_assert((MaxImageDataSize % BootloaderImageDataUnitSize) == 0, "Image data size must be 256-byte aligned");
+    static_assert((MaxImageDataSize > 0) && (MaxImageDataSize <= BootloaderMaxImageDataSize));
+
+    static constexpr std::size_t MinEncodedSize = 9;
+    static constexpr std::size_t MaxEncodedSize = MinEncodedSize + MaxImageDataSize;
+
+    /**
+     * All fields of this message type.
+     */
+     std::uint64_t image_offset = 0;
+     BootloaderImageType image_type{};
+     senoval::Vector<std::uint8_t, MaxImageDataSize> image_data;
+
+    /**
+     * Encodes the message into the provided sequential iterator.
+     * The iterator can encode and emit the message on the fly - that would be highly efficient;
+     * see @ref transport::StreamEmitter.
+     * Returns the number of bytes in the encoded stream.
+     */
+    template <typename OutputIterator>
+    std::size_t encode(OutputIterator begin) const
+    {
+        presentation::StreamEncoder encoder(begin);
+        MessageHeader(Derived::ID).encode(encoder);
+        encoder.addU64(image_offset);
+        encoder.addU8(std::uint8_t(image_type));
+        encoder.addBytes(image_data);
+        assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
+        assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
+        return encoder.getOffset();
+    }
+
+    /**
+     * A simpler wrapper on top of the other version of @ref encode<>() that accepts an output iterator.
+     * This version encodes the message into a fixed capacity array and returns it by value.
+     * Needless to say, it is less efficient than the iterator-based version, but it's easier to use.
+     */
+    DynamicMessageBuffer<MaxEncodedSize> encode() const
     {
-        StaticMessageBuffer<EncodedSize> buf;
-        const std::size_t size = encode(buf.begin());
+        DynamicMessageBuffer<MaxEncodedSize> buf;
+        const std::size_t size = encode(std::back_inserter(buf));
         (void) size;
         assert(size == buf.size());
         return buf;
     }
 
+    /**
+     * Encodes the header and all fields of the message except the image data, which is supposed to follow
+     * immediately after. This allows the application to emit the image data directly from wherever it resides
+     * in the memory without copying it into the message object; see the scatter-gather emission API of
+     * @ref transport::BufferedEmitter.
+     */
+    static StaticMessageBuffer<MinEncodedSize> encodeFixedPart(const std::uint64_t image_offset,
+                                                               const BootloaderImageType image_type)
+    {
+        StaticMessageBuffer<MinEncodedSize> buf;
+        presentation::StreamEncoder encoder(buf.begin());
+        MessageHeader(Derived::ID).encode(encoder);
+        encoder.addU64(image_offset);
+        encoder.addU8(std::uint8_t(image_type));
+        assert(encoder.getOffset() == buf.size());
+        return buf;
+    }
+
     /**
      * Attempts to decode a message from the provided standard frame.
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<BootloaderStatusRequestMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<Derived> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
-        if (!header || (header->message_id != ID))
+        if (!header || (header->message_id != Derived::ID))
         {
             return {};
         }
 
-        if (decoder.getRemainingLength() != EncodedSize)
+        if (decoder.getRemainingLength() < MinEncodedSize)
         {
             return {};
         }
 
-        BootloaderStatusRequestMessage msg;
-        msg.desired_state  = BootloaderState(decoder.fetchU8());
+        if (decoder.getRemainingLength() > MaxEncodedSize)
+        {
+            return {};
+        }
 
+        Derived msg;
+        msg.image_offset = decoder.fetchU64();
+        msg.image_type = BootloaderImageType(decoder.fetchU8());
+        decoder.fetchBytes(std::back_inserter(msg.image_data),
+                           decoder.getRemainingLength());
         return msg;
     }
 };
 
+} // namespace detail_
+
 /**
- * Bootloader status response; contains the current status and stuff.
+ * This message is used to write new application images via the bootloader.
+ * It can also be utilized to read data back, but this is not considered useful at the moment.
+ * @tparam MaxImageDataSize     Capacity of the image data; see @ref computeMaxBootloaderImageDataSize().
+ */
+template <std::size_t MaxImageDataSize = BootloaderImageDataUnitSize>
+struct BasicBootloaderImageDataRequestMessage :
+    public detail_::BootloaderImageDataMessageBase<BasicBootloaderImageDataRequestMessage<MaxImageDataSize>,
+                                                   MaxImageDataSize>
+{
+    static constexpr MessageID ID = MessageID::BootloaderImageDataRequest;
+};
+
+/**
+ * The counterpart for the request message.
+ * The response always contains the actual data from the memory.
+ * The host compares the written data with the response and determines whether the write was successful.
+ * All fields except image_data must have the same values as in the request.
+ */
+template <std::size_t MaxImageDataSize = BootloaderImageDataUnitSize>
+struct BasicBootloaderImageDataResponseMessage :
+    public detail_::BootloaderImageDataMessageBase<BasicBootloaderImageDataResponseMessage<MaxImageDataSize>,
+                                                   MaxImageDataSize>
+{
+    static constexpr MessageID ID = MessageID::BootloaderImageDataResponse;
+};
+
+/**
+ * The classic image data messages with 256-byte chunks, which are supported by every bootloader.
+ */
+using BootloaderImageDataRequestMessage  = BasicBootloaderImageDataRequestMessage<>;
+using BootloaderImageDataResponseMessage = BasicBootloaderImageDataResponseMessage<>;
+
+/**
+ * Maximum number of block digests that can be requested or reported by a single message.
+ */
+static constexpr std::size_t BootloaderMaxImageDigestsPerMessage = 64;
+
+/**
+ * Computes the digest of a block of image data as defined by @ref BootloaderImageDigestRequestMessage.
+ */
+inline std::uint32_t computeBootloaderImageBlockDigest(const void* const data, const std::size_t size)
+{
+    transport::CRCComputer crc;
+    crc.add(data, size);
+    return crc.get();
+}
+
+/**
+ * Requests digests of consecutive fixed-size blocks of the image that is currently stored by the bootloader.
+ * Only bootloaders that support delta upload (see @ref BootloaderStatusResponseMessage) are required to serve it.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u64             uptime_ns       Bootloader's uptime in nanoseconds.
- *      8       u64             flags           Reserved.
- *      16      u8              state           The current state of the bootloader's standard state machine.
+ *      0       u64             image_offset    Offset of the first block from the beginning of the image.
+ *      8       u8              image_type      Same as in @ref BootloaderImageDataMessageBase.
+ *      9       u32             block_size      Size of each block in bytes. In order to map the blocks onto the
+ *                                              image data chunks it should be equal to the chunk size.
+ *      13      u8              block_count     Number of the blocks, at most 64.
  *  -----------------------------------------------------------------------------------------------
- *      17
+ *      14
+ *
+ * The digest of a block is the CRC-32C (see @ref transport::CRCComputer) of the block_size bytes of the image
+ * storage at the block's offset, see @ref computeBootloaderImageBlockDigest().
  */
-struct BootloaderStatusResponseMessage
+struct BootloaderImageDigestRequestMessage
 {
-    static constexpr std::size_t EncodedSize = 17;
+    static constexpr std::size_t EncodedSize = 14;
 
-    static constexpr MessageID ID = MessageID::BootloaderStatusResponse;
+    static constexpr MessageID ID = MessageID::BootloaderImageDigestRequest;
 
     /**
      * All fields of this message type.
      */
-    Timestamp timestamp{};
-    std::uint64_t flags = 0;
-    BootloaderState state{};
+    std::uint64_t image_offset = 0;
+    BootloaderImageType image_type{};
+    std::uint32_t block_size = 0;
+    std::uint8_t block_count = 0;
+
+    using Codec = presentation::FieldCodec<BootloaderImageDigestRequestMessage,
+                                           presentation::Field<&BootloaderImageDigestRequestMessage::image_offset>,
+                                           presentation::Field<&BootloaderImageDigestRequestMessage::image_type>,
+                                           presentation::Field<&BootloaderImageDigestRequestMessage::block_size>,
+                                           presentation::Field<&BootloaderImageDigestRequestMessage::block_count>>;
+    static_assert(Codec::EncodedSize == EncodedSize);
 
     /**
      * Encodes the message into the provided sequential iterator.
@@ -2476,9 +6780,7 @@ struct BootloaderStatusResponseMessage
     {
         presentation::StreamEncoder encoder(begin);
         MessageHeader(ID).encode(encoder);
-        encoder.addU64(timestamp.count());
-        encoder.addU64(flags);
-        encoder.addU8(std::uint8_t(state));
+        Codec::encode(*this, encoder);
         assert(encoder.getOffset() == (EncodedSize + MessageHeader::Size));
         return encoder.getOffset();
     }
@@ -2502,7 +6804,7 @@ struct BootloaderStatusResponseMessage
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<BootloaderStatusResponseMessage> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<BootloaderImageDigestRequestMessage> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
@@ -2516,47 +6818,66 @@ struct BootloaderStatusResponseMessage
             return {};
         }
 
-        BootloaderStatusResponseMessage msg;
-        msg.timestamp = Timestamp(decoder.fetchU64());
-        msg.flags = decoder.fetchU64();
-        msg.state  = BootloaderState(decoder.fetchU8());
+        BootloaderImageDigestRequestMessage msg;
+        Codec::decode(msg, decoder);
+        if (msg.block_count > BootloaderMaxImageDigestsPerMessage)
+        {
+            return {};
+        }
 
         return msg;
     }
 };
 
-/// Implementation details; do not use that in user code
-namespace detail_
-{
 /**
- * Base type for request/response messages.
+ * The counterpart for the request message.
  *
  *      Offset  Type            Name            Description
  *  -----------------------------------------------------------------------------------------------
- *      0       u64             image_offset    Offset from the beginning of the image. Must grow sequentially.
- *      1       u8              image_type      Kind of image contained in the message:
- *                                                  0 - application
- *                                                  1 - certificate of authenticity
- *      9       u8[<=256]       image_data      Image data at the specified offset. All messages except the last
- *                                              one are required to contain exactly 256 bytes of image data.
- *                                              The last message is required to contain less than 256 bytes of
- *                                              image data, possibly zero if the image size is 256-byte aligned.
+ *      0       u64             image_offset    Same as in the request.
+ *      8       u8              image_type      Same as in the request.
+ *      9       u32             block_size      Same as in the request.
+ *      13      u32[<=64]       digests         Digests of the consecutive blocks starting from image_offset.
  *                                              Terminated at the end of the message (implicit length).
  *  -----------------------------------------------------------------------------------------------
- *      265
+ *      13+4*64
+ *
+ * The response contains fewer digests than requested if the image storage ends earlier; no digests are reported
+ * if the block size or the image type is not supported. The host treats the blocks with missing digests as
+ * different from the new image.
  */
-template <typename Derived>
-struct BootloaderImageDataMessageBase
+struct BootloaderImageDigestResponseMessage
 {
-    static constexpr std::size_t MinEncodedSize = 9;
-    static constexpr std::size_t MaxEncodedSize = 265;
+    static constexpr std::size_t MinEncodedSize = 13;
+    static constexpr std::size_t MaxEncodedSize = MinEncodedSize + 4 * BootloaderMaxImageDigestsPerMessage;
+
+    static constexpr MessageID ID = MessageID::BootloaderImageDigestResponse;
 
     /**
      * All fields of this message type.
      */
-     std::uint64_t image_offset = 0;
-     BootloaderImageType image_type{};
-     senoval::Vector<std::uint8_t, 256> image_data;
+    std::uint64_t image_offset = 0;
+    BootloaderImageType image_type{};
+    std::uint32_t block_size = 0;
+    senoval::Vector<std::uint32_t, BootloaderMaxImageDigestsPerMessage> digests;
+
+    /**
+     * Returns the reported digest of the block at the specified image offset, if there is one.
+     */
+    [[nodiscard]] std::optional<std::uint32_t> getDigestAt(const std::uint64_t offset) const
+    {
+        if ((block_size == 0) || (offset < image_offset) || (((offset - image_offset) % block_size) != 0))
+        {
+            return {};
+        }
+
+        const std::uint64_t index = (offset - image_offset) / block_size;
+        if (index < digests.size())
+        {
+            return digests[std::size_t(index)];
+        }
+        return {};
+    }
 
     /**
      * Encodes the message into the provided sequential iterator.
@@ -2568,10 +6889,14 @@ struct BootloaderImageDataMessageBase
     std::size_t encode(OutputIterator begin) const
     {
         presentation::StreamEncoder encoder(begin);
-        MessageHeader(Derived::ID).encode(encoder);
+        MessageHeader(ID).encode(encoder);
         encoder.addU64(image_offset);
         encoder.addU8(std::uint8_t(image_type));
-        encoder.addBytes(image_data);
+        encoder.addU32(block_size);
+        for (const auto x : digests)
+        {
+            encoder.addU32(x);
+        }
         assert(encoder.getOffset() <= (MaxEncodedSize + MessageHeader::Size));
         assert(encoder.getOffset() >= (MinEncodedSize + MessageHeader::Size));
         return encoder.getOffset();
@@ -2596,58 +6921,364 @@ struct BootloaderImageDataMessageBase
      * The message ID value in the header will be checked.
      */
     template <typename InputIterator>
-    static std::optional<Derived> tryDecode(InputIterator begin, InputIterator end)
+    static std::optional<BootloaderImageDigestResponseMessage> tryDecode(InputIterator begin, InputIterator end)
     {
         presentation::StreamDecoder decoder(begin, end);
         const auto header = MessageHeader::tryDecode(decoder);
-        if (!header || (header->message_id != Derived::ID))
+        if (!header || (header->message_id != ID))
         {
             return {};
         }
 
-        if (decoder.getRemainingLength() < MinEncodedSize)
+        if ((decoder.getRemainingLength() < MinEncodedSize) ||
+            (decoder.getRemainingLength() > MaxEncodedSize) ||
+            (((decoder.getRemainingLength() - MinEncodedSize) % 4) != 0))
         {
             return {};
         }
 
-        if (decoder.getRemainingLength() > MaxEncodedSize)
+        BootloaderImageDigestResponseMessage msg;
+        msg.image_offset = decoder.fetchU64();
+        msg.image_type = BootloaderImageType(decoder.fetchU8());
+        msg.block_size = decoder.fetchU32();
+        while (decoder.getRemainingLength() > 0)
         {
-            return {};
+            msg.digests.push_back(decoder.fetchU32());
         }
 
-        Derived msg;
-        msg.image_offset = decoder.fetchU64();
-        msg.image_type = BootloaderImageType(decoder.fetchU8());
-        decoder.fetchBytes(std::back_inserter(msg.image_data),
-                           decoder.getRemainingLength());
         return msg;
     }
 };
 
-} // namespace detail_
+/**
+ * Host-side bookkeeping of a pipelined (windowed) image upload, see @ref BootloaderImageDataMessageBase.
+ * The object does not perform any IO itself; it only decides which chunk should be sent next:
+ *
+ *      BootloaderImageUploadWindow<> window(image_size, status.getImageDataWindow(), timeout,
+ *                                           std::min(status.getMaxImageDataSize(), MaxMessageImageDataSize));
+ *      while (!window.isComplete())
+ *      {
+ *          while (const auto offset = window.poll(now()))
+ *          {
+ *              send(*offset, window.getChunkSize(*offset));
+ *          }
+ *          if (const auto response = receive())
+ *          {
+ *              window.acknowledge(response->image_offset, response_matches_image);
+ *          }
+ *      }
+ *
+ * Chunks whose responses are lost or do not match the image are retransmitted selectively, the others are not.
+ * With the window size of one, the behavior is identical to the classic stop-and-wait upload.
+ * The chunk size is chosen according to the rules given in @ref BootloaderImageDataMessageBase.
+ *
+ * @tparam MaxWindowSize    Maximum supported window size; larger windows offered by the bootloader are truncated.
+ */
+template <std::size_t MaxWindowSize = 32>
+class BootloaderImageUploadWindow
+{
+    static_assert(MaxWindowSize > 0);
+
+    enum class ChunkState : std::uint8_t
+    {
+        Pending,        ///< Not sent yet, or must be retransmitted
+        InFlight,
+        Acknowledged,
+    };
+
+    struct Slot
+    {
+        Timestamp sent_at{};
+        ChunkState state = ChunkState::Pending;
+    };
+
+    const std::uint64_t image_size_;
+    const std::size_t chunk_size_;
+    const std::uint64_t number_of_chunks_;      ///< Including the last short (possibly empty) chunk
+    const std::size_t window_size_;
+    const Timestamp timeout_;
+
+    std::array<Slot, MaxWindowSize> slots_{};   ///< Circular, indexed by the chunk index modulo MaxWindowSize
+    std::uint64_t base_ = 0;                    ///< Lowest chunk that is not acknowledged yet
+    std::uint64_t next_ = 0;                    ///< Lowest chunk that has never been sent
+    std::size_t in_flight_ = 0;
+    std::uint64_t retransmission_count_ = 0;
+
+    std::uint64_t skipped_count_ = 0;
+
+    Slot& getSlot(const std::uint64_t chunk_index) { return slots_[std::size_t(chunk_index % MaxWindowSize)]; }
+
+    void advanceBase()
+    {
+        while ((base_ < next_) && (getSlot(base_).state == ChunkState::Acknowledged))
+        {
+            getSlot(base_).state = ChunkState::Pending;     // The slot is reused for the chunk base + MaxWindowSize
+            base_++;
+        }
+    }
+
+    std::uint64_t send(const std::uint64_t chunk_index, const Timestamp now)
+    {
+        Slot& s = getSlot(chunk_index);
+        s.state = ChunkState::InFlight;
+        s.sent_at = now;
+        in_flight_++;
+        return chunk_index * chunk_size_;
+    }
+
+    static std::size_t chooseChunkSize(const std::uint64_t image_size, const std::size_t max_chunk_size)
+    {
+        const std::uint64_t limit = std::min<std::uint64_t>(max_chunk_size, image_size);
+        return std::size_t(std::max<std::uint64_t>(1, limit / BootloaderImageDataUnitSize)) *
+               BootloaderImageDataUnitSize;
+    }
+
+public:
+    /**
+     * @param image_size                Size of the image in bytes.
+     * @param window_size               As reported by the bootloader; zero is treated as one.
+     * @param retransmission_timeout    A chunk is retransmitted if it has not been acknowledged in this time.
+     * @param max_chunk_size            The smaller of the max image data size advertised by the bootloader and
+     *                                  the capacity of the message used by the host.
+     */
+    BootloaderImageUploadWindow(const std::uint64_t image_size,
+                                const std::size_t window_size,
+                                const Timestamp retransmission_timeout,
+                                const std::size_t max_chunk_size = BootloaderImageDataUnitSize) :
+        image_size_(image_size),
+        chunk_size_(chooseChunkSize(image_size, max_chunk_size)),
+        number_of_chunks_(image_size / chunk_size_ + 1U),
+        window_size_(std::min(std::max<std::size_t>(1, window_size), MaxWindowSize)),
+        timeout_(retransmission_timeout)
+    { }
+
+    /**
+     * Returns the offset of the chunk that should be sent now, or nothing if the window is full or the upload
+     * is complete; the chunk is considered sent at the specified time. Invoke repeatedly until nothing is returned.
+     * Chunks that need to be retransmitted take precedence over the new ones.
+     */
+    std::optional<std::uint64_t> poll(const Timestamp now)
+    {
+        return poll(now, [](std::uint64_t) { return false; });
+    }
+
+    /**
+     * Same as above, for the delta upload (see @ref BootloaderImageDataMessageBase): the chunks for which the
+     * predicate returns true are considered acknowledged without being sent. The predicate accepts the offset of
+     * a chunk; it is never invoked for the first and the last chunks. For example:
+     *
+     *      window.poll(now(), [&](std::uint64_t offset) { return digests.getDigestAt(offset) == digestOf(offset); });
+     */
+    template <typename SkipPredicate>
+    std::optional<std::uint64_t> poll(const Timestamp now, SkipPredicate&& should_skip)
+    {
+        for (std::uint64_t i = base_; i < next_; i++)
+        {
+            Slot& s = getSlot(i);
+            if ((s.state == ChunkState::InFlight) && ((now - s.sent_at) >= timeout_))
+            {
+                s.state = ChunkState::Pending;      // Timed out, the response is considered lost
+                in_flight_--;
+            }
+
+            if (s.state == ChunkState::Pending)
+            {
+                retransmission_count_++;
+                return send(i, now);
+            }
+        }
+
+        while ((next_ > 0) &&
+               ((next_ + 1U) < number_of_chunks_) &&
+               ((next_ - base_) < window_size_) &&
+               should_skip(next_ * chunk_size_))
+        {
+            getSlot(next_++).state = ChunkState::Acknowledged;
+            skipped_count_++;
+            advanceBase();
+        }
+
+        const bool is_last = (next_ + 1U) == number_of_chunks_;
+        if ((next_ < number_of_chunks_) &&
+            ((next_ - base_) < window_size_) &&
+            (!is_last || (base_ == next_)))         // The last chunk terminates the image, so it goes last
+        {
+            return send(next_++, now);
+        }
+
+        return {};
+    }
+
+    /**
+     * Processes a response from the bootloader.
+     * @param image_offset  The offset reported in the response.
+     * @param ok            Whether the data in the response matches the image; if not, the chunk is retransmitted.
+     * @return              False if the response does not correspond to any outstanding chunk (e.g. a duplicate).
+     */
+    bool acknowledge(const std::uint64_t image_offset, const bool ok)
+    {
+        if ((image_offset % chunk_size_) != 0)
+        {
+            return false;
+        }
+
+        const std::uint64_t index = image_offset / chunk_size_;
+        if ((index < base_) || (index >= next_) || (getSlot(index).state != ChunkState::InFlight))
+        {
+            return false;
+        }
+
+        getSlot(index).state = ok ? ChunkState::Acknowledged : ChunkState::Pending;
+        in_flight_--;
+        advanceBase();
+        return true;
+    }
+
+    /**
+     * Number of image bytes in the chunk at the specified offset.
+     */
+    std::size_t getChunkSize(const std::uint64_t image_offset) const
+    {
+        return (image_offset >= image_size_) ? 0U : std::size_t(std::min<std::uint64_t>(chunk_size_,
+                                                                                         image_size_ - image_offset));
+    }
+
+    [[nodiscard]] bool isComplete() const { return base_ == number_of_chunks_; }
+
+    /**
+     * All chunks except the last one contain this many bytes of image data.
+     */
+    std::size_t getNominalChunkSize()           const { return chunk_size_; }
+
+    std::size_t getWindowSize()                 const { return window_size_; }
+    std::size_t getNumberOfChunksInFlight()     const { return in_flight_; }
+    std::uint64_t getNumberOfAcknowledgedBytes() const { return std::min(base_ * chunk_size_, image_size_); }
+    std::uint64_t getRetransmissionCount()      const { return retransmission_count_; }
+    std::uint64_t getNumberOfSkippedChunks()    const { return skipped_count_; }
+};
 
 /**
- * This message is used to write new application images via the bootloader.
- * It can also be utilized to read data back, but this is not considered useful at the moment.
+ * Static memory footprint of a standard message type, see @ref footprint().
+ * The sizes are in bytes; they depend on the target, so they should be checked with the target compiler.
  */
-struct BootloaderImageDataRequestMessage :
-    public detail_::BootloaderImageDataMessageBase<BootloaderImageDataRequestMessage>
+struct Footprint
 {
-    static constexpr MessageID ID = MessageID::BootloaderImageDataRequest;
+    std::size_t object_size = 0;            ///< The message object itself
+    std::size_t max_encoded_size = 0;       ///< Worst-case encoded size including the header
+    std::size_t encode_buffer_size = 0;     ///< The buffer returned by encode() by value
+    std::size_t decode_temporary_size = 0;  ///< The message object and the optional<> built by tryDecode()
+
+    /**
+     * The worst-case amount of stack occupied by the message when it is encoded with encode() (the message itself
+     * and the returned buffer) or decoded with tryDecode(). The iterator-based encode<>() needs no buffer.
+     */
+    constexpr std::size_t getPeakSize() const
+    {
+        return std::max(object_size + encode_buffer_size, decode_temporary_size);
+    }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+
+template <typename Message, typename = void>
+struct MaxEncodedSizeOf
+{
+    static constexpr std::size_t Value = Message::EncodedSize;
+};
+
+template <typename Message>
+struct MaxEncodedSizeOf<Message, std::void_t<decltype(Message::MaxEncodedSize)>>
+{
+    static constexpr std::size_t Value = Message::MaxEncodedSize;
 };
 
+template <typename... Messages>
+struct MessageTypeList { };
+
+/// Every standard message type; the list is used for compile-time checks and for dispatching.
+using StandardMessageTypes = MessageTypeList<
+    EndpointInfoMessage,
+    RegisterDataRequestMessage,
+    RegisterDataResponseMessage,
+    RegisterDiscoveryRequestMessage,
+    RegisterDiscoveryResponseMessage,
+    RegisterTraceSetupRequestMessage,
+    RegisterTraceSetupResponseMessage,
+    RegisterTraceEventMessage,
+    DeviceManagementCommandRequestMessage,
+    DeviceManagementCommandResponseMessage,
+    BootloaderStatusRequestMessage,
+    BootloaderStatusResponseMessage,
+    BootloaderImageDataRequestMessage,
+    BootloaderImageDataResponseMessage,
+    RegisterBatchDataRequestMessage,
+    RegisterBatchDataResponseMessage,
+    RegisterIndexedDataRequestMessage,
+    RegisterIndexedDataResponseMessage,
+    BootloaderImageDigestRequestMessage,
+    BootloaderImageDigestResponseMessage
+>;
+
+} // namespace detail_
+
 /**
- * The counterpart for the request message.
- * The response always contains the actual data from the memory.
- * The host compares the written data with the response and determines whether the write was successful.
- * All fields except image_data must have the same values as in the request.
+ * Returns the static memory footprint of the specified standard message type.
+ * This is useful for budgeting the stack of interrupt handlers and tasks that process messages,
+ * see @ref checkFootprintBudget().
  */
-struct BootloaderImageDataResponseMessage :
-    public detail_::BootloaderImageDataMessageBase<BootloaderImageDataResponseMessage>
+template <typename Message>
+constexpr Footprint footprint()
 {
-    static constexpr MessageID ID = MessageID::BootloaderImageDataResponse;
+    Footprint f;
+    f.object_size = sizeof(Message);
+    f.max_encoded_size = detail_::MaxEncodedSizeOf<Message>::Value + MessageHeader::Size;
+    f.encode_buffer_size = sizeof(decltype(std::declval<const Message&>().encode()));
+    f.decode_temporary_size = sizeof(Message) + sizeof(std::optional<Message>);
+    return f;
+}
+
+/**
+ * Instantiation of this template fails to compile if the peak footprint of the message exceeds the budget.
+ * The compiler error refers to the offending message type. See @ref checkFootprintBudget().
+ */
+template <std::size_t Budget, typename Message>
+struct FootprintBudgetCheck
+{
+    static_assert(footprint<Message>().getPeakSize() <= Budget, "The message does not fit into the footprint budget");
+    static constexpr bool Value = true;
 };
 
+/**
+ * Opt-in compile-time check of the stack budget of the message types used by the application:
+ *
+ *      static_assert(standard::checkFootprintBudget<512, RegisterDataRequestMessage, RegisterDataResponseMessage>());
+ *
+ * Every standard message type can be checked at once by defining the macro POPCOP_STANDARD_FOOTPRINT_BUDGET
+ * to the budget in bytes before this header is included.
+ */
+template <std::size_t Budget, typename... Messages>
+constexpr bool checkFootprintBudget()
+{
+    return (FootprintBudgetCheck<Budget, Messages>::Value && ...);
+}
+
+#ifdef POPCOP_STANDARD_FOOTPRINT_BUDGET
+namespace detail_
+{
+
+template <typename... Messages>
+constexpr bool checkStandardFootprintBudget(MessageTypeList<Messages...>)
+{
+    return checkFootprintBudget<POPCOP_STANDARD_FOOTPRINT_BUDGET, Messages...>();
+}
+
+static_assert(checkStandardFootprintBudget(StandardMessageTypes{}));
+
+} // namespace detail_
+#endif
+
 } // namespace standard
 
 } // namespace popcop
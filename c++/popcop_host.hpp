@@ -0,0 +1,1319 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Zubax Robotics
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+ */
+
+/*
+ * Host-side extensions of Popcop. Unlike the core library, these require a hosted environment
+ * with heap and threads, so they are kept in a separate header in order to keep the core library
+ * usable on bare metal embedded systems.
+ */
+
+#ifndef POPCOP_HOST_HPP_INCLUDED
+#define POPCOP_HOST_HPP_INCLUDED
+
+#include "popcop.hpp"
+
+#include <condition_variable>
+#include <system_error>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <array>
+#include <mutex>
+#include <deque>
+
+
+namespace popcop
+{
+/**
+ * Host-side entities that require a hosted environment.
+ */
+namespace host
+{
+/**
+ * Objects that are accessed by different threads are aligned at this boundary in order to avoid false sharing.
+ */
+static constexpr std::size_t CacheLineSize = 64;
+
+/**
+ * A set of independent parsers for gateways that terminate many communication channels at once.
+ *
+ * The reader thread(s) submit received chunks of data for the specified channel; the chunks are then parsed by
+ * a pool of worker threads. Each channel is sharded to a home worker (channel index modulo the number of workers);
+ * a worker that has run out of work steals ready channels from other workers.
+ * A channel is never processed by more than one worker at a time, so the frames received from one channel are
+ * always reported in order, whereas different channels are processed in parallel.
+ * Chunks that are submitted for a channel while it is being processed are coalesced and parsed in the next pass.
+ *
+ * The parser state of every channel resides in its own cache-line-aligned arena in order to avoid false sharing.
+ *
+ * @tparam MaxPayloadSize   Maximum payload size of every parser, see @ref transport::Parser.
+ */
+template <std::size_t MaxPayloadSize = 2048>
+class ParserPool
+{
+public:
+    /**
+     * The handler is invoked from the worker threads, once for every non-empty parser output.
+     * Invocations are serialized per channel but not across channels, so the handler must be thread-safe if it
+     * accesses any state shared between channels. The referenced data is INVALIDATED when the handler returns.
+     */
+    using Handler = std::function<void (std::size_t channel_index, const transport::ParserOutput&)>;
+
+private:
+    struct alignas(CacheLineSize) Channel
+    {
+        transport::Parser<MaxPayloadSize> parser;   ///< Accessed only by the worker that has scheduled the channel
+        std::mutex mutex;
+        std::vector<std::uint8_t> pending;          ///< Data submitted but not yet parsed
+        bool scheduled = false;                     ///< Queued or being processed; protected by the mutex
+    };
+
+    struct alignas(CacheLineSize) Worker
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> ready;              ///< Indexes of the channels that are ready for processing
+        std::thread thread;
+    };
+
+    const std::size_t number_of_channels_;
+    const std::size_t number_of_workers_;
+    const Handler handler_;
+
+    std::unique_ptr<Channel[]> channels_;
+    std::unique_ptr<Worker[]> workers_;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> number_of_queued_channels_{0};
+    std::atomic<std::size_t> number_of_scheduled_channels_{0};
+
+    alignas(CacheLineSize) std::mutex sleep_mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable idle_;
+    bool stop_ = false;                             ///< Protected by the sleep mutex
+
+    void enqueue(const std::size_t worker_index, const std::size_t channel_index)
+    {
+        {
+            Worker& w = workers_[worker_index];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            w.ready.push_back(channel_index);
+            number_of_queued_channels_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);    // Prevents the wakeup from being lost
+        }
+        wakeup_.notify_one();
+    }
+
+    std::optional<std::size_t> tryDequeue(const std::size_t worker_index)
+    {
+        // The own queue is processed in FIFO order; other queues are stolen from the back
+        for (std::size_t i = 0; i < number_of_workers_; i++)
+        {
+            Worker& w = workers_[(worker_index + i) % number_of_workers_];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.ready.empty())
+            {
+                std::size_t channel_index = 0;
+                if (i == 0)
+                {
+                    channel_index = w.ready.front();
+                    w.ready.pop_front();
+                }
+                else
+                {
+                    channel_index = w.ready.back();
+                    w.ready.pop_back();
+                }
+                number_of_queued_channels_--;
+                return channel_index;
+            }
+        }
+        return {};
+    }
+
+    void processChannel(const std::size_t worker_index,
+                        const std::size_t channel_index,
+                        std::vector<std::uint8_t>& scratch)
+    {
+        Channel& ch = channels_[channel_index];
+        {
+            std::lock_guard<std::mutex> lock(ch.mutex);
+            scratch.clear();
+            scratch.swap(ch.pending);       // The buffers are swapped back and forth, so their capacity is reused
+        }
+
+        ch.parser.processBytes(scratch.data(), scratch.size(), [&](const transport::ParserOutput& out)
+        {
+            handler_(channel_index, out);
+        });
+
+        bool more = false;
+        {
+            std::lock_guard<std::mutex> lock(ch.mutex);
+            more = !ch.pending.empty();
+            ch.scheduled = more;
+        }
+
+        if (more)
+        {
+            enqueue(worker_index, channel_index);       // To the back of the queue, so that other channels can proceed
+        }
+        else if (--number_of_scheduled_channels_ == 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+            }
+            idle_.notify_all();
+        }
+    }
+
+    void runWorker(const std::size_t worker_index)
+    {
+        std::vector<std::uint8_t> scratch;
+        while (true)
+        {
+            if (const auto channel_index = tryDequeue(worker_index))
+            {
+                processChannel(worker_index, *channel_index, scratch);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wakeup_.wait(lock, [this]() { return stop_ || (number_of_queued_channels_ > 0); });
+            if (stop_ && (number_of_queued_channels_ == 0))
+            {
+                break;
+            }
+        }
+    }
+
+public:
+    /**
+     * @param number_of_channels    Number of independent channels, each with its own parser.
+     * @param handler               See @ref Handler.
+     * @param number_of_workers     Number of worker threads; defaults to the number of CPU cores.
+     */
+    ParserPool(const std::size_t number_of_channels,
+               Handler handler,
+               const std::size_t number_of_workers = std::max(1U, std::thread::hardware_concurrency())) :
+        number_of_channels_(number_of_channels),
+        number_of_workers_(std::max<std::size_t>(1, number_of_workers)),
+        handler_(std::move(handler)),
+        channels_(new Channel[number_of_channels_]),
+        workers_(new Worker[number_of_workers_])
+    {
+        for (std::size_t i = 0; i < number_of_workers_; i++)
+        {
+            workers_[i].thread = std::thread([this, i]() { runWorker(i); });
+        }
+    }
+
+    /**
+     * Parses all data that has been submitted so far, then stops the workers.
+     */
+    ~ParserPool()
+    {
+        waitUntilIdle();
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wakeup_.notify_all();
+        for (std::size_t i = 0; i < number_of_workers_; i++)
+        {
+            workers_[i].thread.join();
+        }
+    }
+
+    ParserPool(const ParserPool&) = delete;
+    ParserPool& operator=(const ParserPool&) = delete;
+
+    /**
+     * Submits a received chunk of data for parsing. The data is copied, so the buffer can be reused immediately.
+     * This method is thread-safe, but the chunks of the same channel are parsed in the order of submission only if
+     * they are submitted by the same thread.
+     */
+    void submit(const std::size_t channel_index, const std::uint8_t* const data, const std::size_t size)
+    {
+        assert(channel_index < number_of_channels_);
+        if (size == 0)
+        {
+            return;
+        }
+
+        Channel& ch = channels_[channel_index];
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(ch.mutex);
+            ch.pending.insert(ch.pending.end(), data, data + size);
+            schedule = !ch.scheduled;
+            ch.scheduled = true;
+        }
+
+        if (schedule)
+        {
+            number_of_scheduled_channels_++;
+            enqueue(channel_index % number_of_workers_, channel_index);
+        }
+    }
+
+    /**
+     * Blocks until all data that has been submitted so far is parsed.
+     */
+    void waitUntilIdle()
+    {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        idle_.wait(lock, [this]() { return number_of_scheduled_channels_ == 0; });
+    }
+
+    std::size_t getNumberOfChannels() const { return number_of_channels_; }
+    std::size_t getNumberOfWorkers()  const { return number_of_workers_; }
+};
+
+/**
+ * Maps standard request message types to their response message types; see @ref Client.
+ */
+template <typename Request> struct ResponseMessageOf;
+
+template <> struct ResponseMessageOf<standard::EndpointInfoMessage>
+{ using Type = standard::EndpointInfoMessage; };
+
+template <> struct ResponseMessageOf<standard::RegisterDataRequestMessage>
+{ using Type = standard::RegisterDataResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::RegisterDiscoveryRequestMessage>
+{ using Type = standard::RegisterDiscoveryResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::RegisterTraceSetupRequestMessage>
+{ using Type = standard::RegisterTraceSetupResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::DeviceManagementCommandRequestMessage>
+{ using Type = standard::DeviceManagementCommandResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::BootloaderStatusRequestMessage>
+{ using Type = standard::BootloaderStatusResponseMessage; };
+
+template <std::size_t MaxImageDataSize>
+struct ResponseMessageOf<standard::BasicBootloaderImageDataRequestMessage<MaxImageDataSize>>
+{ using Type = standard::BasicBootloaderImageDataResponseMessage<MaxImageDataSize>; };
+
+template <> struct ResponseMessageOf<standard::RegisterBatchDataRequestMessage>
+{ using Type = standard::RegisterBatchDataResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::RegisterIndexedDataRequestMessage>
+{ using Type = standard::RegisterIndexedDataResponseMessage; };
+
+template <> struct ResponseMessageOf<standard::BootloaderImageDigestRequestMessage>
+{ using Type = standard::BootloaderImageDigestResponseMessage; };
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+/**
+ * Responses are matched to requests by the response message ID and a discriminator, which is a part of
+ * the message that the response copies from the request: the register name, index, image offset, etc.
+ * The offsets do not include the message header.
+ */
+struct CorrelationRule
+{
+    standard::MessageID request_id;
+    standard::MessageID response_id;
+    std::size_t request_offset;
+    std::size_t response_offset;
+    std::size_t size;                   ///< Zero - no discriminator, SIZE_MAX - length-prefixed register name
+};
+
+static constexpr std::size_t NameDiscriminator = ~std::size_t(0);
+
+static constexpr CorrelationRule CorrelationRules[] =
+{
+    { standard::MessageID::EndpointInfo,                   standard::MessageID::EndpointInfo,                    0, 0, 0 },
+    { standard::MessageID::RegisterDataRequest,            standard::MessageID::RegisterDataResponse,            0, 9,
+      NameDiscriminator },
+    { standard::MessageID::RegisterDiscoveryRequest,       standard::MessageID::RegisterDiscoveryResponse,       0, 0, 2 },
+    { standard::MessageID::RegisterTraceSetupRequest,      standard::MessageID::RegisterTraceSetupResponse,      0, 0, 1 },
+    { standard::MessageID::DeviceManagementCommandRequest, standard::MessageID::DeviceManagementCommandResponse, 0, 0, 2 },
+    { standard::MessageID::BootloaderStatusRequest,        standard::MessageID::BootloaderStatusResponse,        0, 0, 0 },
+    { standard::MessageID::BootloaderImageDataRequest,     standard::MessageID::BootloaderImageDataResponse,     0, 0, 9 },
+    { standard::MessageID::RegisterBatchDataRequest,       standard::MessageID::RegisterBatchDataResponse,       0, 0, 0 },
+    { standard::MessageID::RegisterIndexedDataRequest,     standard::MessageID::RegisterIndexedDataResponse,     0, 8, 2 },
+    { standard::MessageID::BootloaderImageDigestRequest,   standard::MessageID::BootloaderImageDigestResponse,   0, 0, 9 },
+};
+
+struct CorrelationKey
+{
+    standard::MessageID response_id{};
+    std::vector<std::uint8_t> discriminator;
+
+    bool operator==(const CorrelationKey& rhs) const
+    {
+        return (response_id == rhs.response_id) && (discriminator == rhs.discriminator);
+    }
+};
+
+/**
+ * Extracts the discriminator from the message (header included); returns false if the message is too short.
+ */
+inline bool extractDiscriminator(const std::uint8_t* const data,
+                                 const std::size_t size,
+                                 std::size_t offset,
+                                 const std::size_t discriminator_size,
+                                 std::vector<std::uint8_t>& out)
+{
+    offset += standard::MessageHeader::Size;
+    if (offset > size)
+    {
+        return false;
+    }
+
+    std::size_t amount = discriminator_size;
+    if (discriminator_size == NameDiscriminator)
+    {
+        amount = (offset < size) ? (1U + data[offset]) : 1U;
+    }
+
+    if (amount > (size - offset))
+    {
+        return false;
+    }
+
+    out.assign(data + offset, data + offset + amount);
+    return true;
+}
+
+/**
+ * Returns the key that the response to the specified request will have, or nothing if the request is unknown.
+ */
+inline std::optional<CorrelationKey> getRequestCorrelationKey(const std::uint8_t* const data, const std::size_t size)
+{
+    presentation::StreamDecoder decoder(data, data + size);
+    if (const auto header = standard::MessageHeader::tryDecode(decoder))
+    {
+        for (auto& r : CorrelationRules)
+        {
+            CorrelationKey key;
+            key.response_id = r.response_id;
+            if ((r.request_id == header->message_id) &&
+                extractDiscriminator(data, size, r.request_offset, r.size, key.discriminator))
+            {
+                return key;
+            }
+        }
+    }
+    return {};
+}
+
+/**
+ * Returns the key of the specified response, or nothing if the message is not a known response.
+ */
+inline std::optional<CorrelationKey> getResponseCorrelationKey(const std::uint8_t* const data, const std::size_t size)
+{
+    presentation::StreamDecoder decoder(data, data + size);
+    if (const auto header = standard::MessageHeader::tryDecode(decoder))
+    {
+        for (auto& r : CorrelationRules)
+        {
+            CorrelationKey key;
+            key.response_id = r.response_id;
+            if ((r.response_id == header->message_id) &&
+                extractDiscriminator(data, size, r.response_offset, r.size, key.discriminator))
+            {
+                return key;
+            }
+        }
+    }
+    return {};
+}
+
+} // namespace detail_
+
+/**
+ * Asynchronous client of the standard request/response protocol, one instance per remote endpoint.
+ * Several requests can be outstanding at the same time; further requests are queued and sent as soon as the
+ * earlier ones are completed. A response is matched with the oldest outstanding request that it can be a response
+ * to, which is determined by the message ID and the part of the message that the response copies from the request
+ * (the register name for register data, the image offset for bootloader image data, and so on).
+ *
+ * The object performs no IO itself and owns no threads, so any number of clients can be driven by one event loop:
+ * the encoded frames are passed to the writer; the received data is fed via @ref processReceivedData();
+ * @ref poll() is invoked periodically to enforce the timeouts (see @ref getNextDeadline()).
+ * All methods and the handlers are invoked from the same thread; the handlers are allowed to send new requests.
+ *
+ *      Client<> client([&](const std::uint8_t* data, std::size_t size) { ::write(fd, data, size); });
+ *
+ *      standard::RegisterDataRequestMessage req;
+ *      req.name = "motor.kv";
+ *      client.request(req,
+ *                     [](const std::optional<standard::RegisterDataResponseMessage>& response)
+ *                     {
+ *                         // The response is empty if the request has timed out
+ *                     },
+ *                     Client<>::Clock::now());
+ *
+ * @tparam MaxPayloadSize   Maximum payload size of the parser, see @ref transport::Parser.
+ */
+template <std::size_t MaxPayloadSize = 2048>
+class Client
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Invoked once for every frame to be sent, with the whole encoded frame.
+     */
+    using Writer = std::function<void (const std::uint8_t* data, std::size_t size)>;
+
+    /**
+     * Invoked once when the request is completed. The arguments point to the payload of the response frame
+     * (the message header included); the pointer is null if the request has timed out or has been cancelled.
+     * The referenced data is INVALIDATED when the handler returns.
+     */
+    using RawResponseHandler = std::function<void (const std::uint8_t* data, std::size_t size)>;
+
+    /**
+     * Invoked for every parser output that does not complete a request: unsolicited messages (e.g. register trace
+     * events), application-specific frames, late responses, and extraneous data.
+     */
+    using UnsolicitedHandler = std::function<void (const transport::ParserOutput&)>;
+
+private:
+    struct Request
+    {
+        detail_::CorrelationKey key;
+        std::vector<std::uint8_t> payload;              ///< Released once the request is sent
+        RawResponseHandler handler;
+        Clock::duration timeout{};
+        Clock::time_point deadline{};
+    };
+
+    const Writer writer_;
+    const UnsolicitedHandler unsolicited_handler_;
+    const Clock::duration default_timeout_;
+    const std::size_t max_outstanding_;
+
+    transport::Parser<MaxPayloadSize> parser_;
+    std::deque<Request> outstanding_;                   ///< In the order of sending
+    std::deque<Request> queued_;
+    std::vector<std::uint8_t> frame_buffer_;
+
+    void send(const std::vector<std::uint8_t>& payload)
+    {
+        transport::BufferedEmitter emitter(presentation::StandardFrameTypeCode, payload.data(), payload.size());
+        frame_buffer_.resize(2U * (payload.size() + 6U));   // Worst case: every byte is escaped
+        frame_buffer_.resize(emitter.emitInto(frame_buffer_.data(), frame_buffer_.size()));
+        writer_(frame_buffer_.data(), frame_buffer_.size());
+    }
+
+    void sendQueued(const Clock::time_point now)
+    {
+        while ((outstanding_.size() < max_outstanding_) && !queued_.empty())
+        {
+            Request r = std::move(queued_.front());
+            queued_.pop_front();
+            r.deadline = now + r.timeout;
+            send(r.payload);
+            r.payload = {};
+            outstanding_.push_back(std::move(r));
+        }
+    }
+
+    /// Returns true if the frame has completed a request.
+    bool processFrame(const transport::ParserOutput::Frame& frame)
+    {
+        if (frame.type_code != presentation::StandardFrameTypeCode)
+        {
+            return false;
+        }
+
+        const auto key = detail_::getResponseCorrelationKey(frame.payload.data(), frame.payload.size());
+        if (!key)
+        {
+            return false;
+        }
+
+        const auto it = std::find_if(outstanding_.begin(), outstanding_.end(),
+                                     [&](const Request& r) { return r.key == *key; });
+        if (it == outstanding_.end())
+        {
+            return false;
+        }
+
+        // The request is removed before the handler is invoked, because the handler may send new requests
+        const RawResponseHandler handler = std::move(it->handler);
+        outstanding_.erase(it);
+        handler(frame.payload.data(), frame.payload.size());
+        return true;
+    }
+
+    void processOutput(const transport::ParserOutput& out)
+    {
+        const auto frame = out.getReceivedFrame();
+        if (((frame == nullptr) || !processFrame(*frame)) && unsolicited_handler_)
+        {
+            unsolicited_handler_(out);
+        }
+    }
+
+public:
+    /**
+     * @param writer                See @ref Writer.
+     * @param unsolicited_handler   See @ref UnsolicitedHandler; may be empty.
+     * @param default_timeout       Response timeout of the requests that do not specify their own; counted from
+     *                              the moment when the request is sent rather than queued.
+     * @param max_outstanding       Maximum number of requests that are sent but not completed; at least one.
+     */
+    explicit Client(Writer writer,
+                    UnsolicitedHandler unsolicited_handler = {},
+                    const Clock::duration default_timeout = standard::DefaultStandardRequestTimeout,
+                    const std::size_t max_outstanding = 8) :
+        writer_(std::move(writer)),
+        unsolicited_handler_(std::move(unsolicited_handler)),
+        default_timeout_(default_timeout),
+        max_outstanding_(std::max<std::size_t>(1, max_outstanding))
+    { }
+
+    /**
+     * Sends the encoded standard message (the header included) as a request, or queues it if too many requests
+     * are outstanding already.
+     * @return      False if the message is not a known standard request; the handler is not invoked then.
+     */
+    bool requestRaw(const std::uint8_t* const data,
+                    const std::size_t size,
+                    RawResponseHandler handler,
+                    const Clock::time_point now,
+                    const std::optional<Clock::duration> timeout = {})
+    {
+        auto key = detail_::getRequestCorrelationKey(data, size);
+        if (!key)
+        {
+            return false;
+        }
+
+        Request r;
+        r.key = std::move(*key);
+        r.payload.assign(data, data + size);
+        r.handler = std::move(handler);
+        r.timeout = timeout.value_or(default_timeout_);
+        queued_.push_back(std::move(r));
+        sendQueued(now);
+        return true;
+    }
+
+    /**
+     * Typed version of @ref requestRaw().
+     * The handler receives std::optional<> of the response message type (see @ref ResponseMessageOf);
+     * it is empty if the request has timed out or has been cancelled, or if the response could not be decoded.
+     */
+    template <typename RequestMessage, typename Handler>
+    void request(const RequestMessage& message,
+                 Handler&& handler,
+                 const Clock::time_point now,
+                 const std::optional<Clock::duration> timeout = {})
+    {
+        using Response = typename ResponseMessageOf<RequestMessage>::Type;
+        const auto encoded = message.encode();
+        const bool ok = requestRaw(encoded.data(), encoded.size(),
+                                   [h = std::forward<Handler>(handler)](const std::uint8_t* data, std::size_t size)
+                                   {
+                                       h((data != nullptr) ? Response::tryDecode(data, data + size) :
+                                                             std::optional<Response>());
+                                   },
+                                   now,
+                                   timeout);
+        assert(ok);
+        (void) ok;
+    }
+
+    /**
+     * Feeds the data received from the endpoint into the parser.
+     * Responses invoke the handlers of the matching requests; everything else goes to the unsolicited handler.
+     */
+    void processReceivedData(const std::uint8_t* const data, const std::size_t size, const Clock::time_point now)
+    {
+        parser_.processBytes(data, size, [&](const transport::ParserOutput& out) { processOutput(out); });
+        sendQueued(now);
+    }
+
+    /**
+     * Alternative to @ref processReceivedData() for the cases where the data is parsed elsewhere,
+     * e.g. by @ref SerialMultiplexer. The internal parser is not used then.
+     */
+    void processParserOutput(const transport::ParserOutput& out, const Clock::time_point now)
+    {
+        processOutput(out);
+        sendQueued(now);
+    }
+
+    /**
+     * Completes the timed out requests and sends the queued ones if possible.
+     * Should be invoked at least at @ref getNextDeadline().
+     */
+    void poll(const Clock::time_point now)
+    {
+        // The deadlines are not ordered because the timeouts can differ, hence the full scan
+        for (auto it = outstanding_.begin(); it != outstanding_.end();)
+        {
+            if (it->deadline <= now)
+            {
+                const RawResponseHandler handler = std::move(it->handler);
+                outstanding_.erase(it);
+                handler(nullptr, 0);
+                it = outstanding_.begin();      // The handler may have modified the container
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        sendQueued(now);
+    }
+
+    /**
+     * Completes all outstanding and queued requests as cancelled, i.e. with no response.
+     */
+    void cancelAll()
+    {
+        std::deque<Request> requests;
+        requests.swap(outstanding_);
+        requests.insert(requests.end(),
+                        std::make_move_iterator(queued_.begin()),
+                        std::make_move_iterator(queued_.end()));
+        queued_.clear();
+        for (auto& r : requests)
+        {
+            r.handler(nullptr, 0);
+        }
+    }
+
+    /**
+     * The earliest deadline of the outstanding requests; useful as the event loop timeout.
+     */
+    std::optional<Clock::time_point> getNextDeadline() const
+    {
+        std::optional<Clock::time_point> out;
+        for (auto& r : outstanding_)
+        {
+            out = out ? std::min(*out, r.deadline) : r.deadline;
+        }
+        return out;
+    }
+
+    std::size_t getNumberOfOutstandingRequests() const { return outstanding_.size(); }
+    std::size_t getNumberOfQueuedRequests()      const { return queued_.size(); }
+};
+
+/**
+ * Direction of the data stored in a capture file, see @ref CaptureWriter.
+ */
+enum class CaptureDirection : std::uint8_t
+{
+    Received    = 0,
+    Transmitted = 1,
+};
+
+/**
+ * The kind of a capture record; mirrors the contents of @ref transport::ParserOutput.
+ */
+enum class CaptureRecordKind : std::uint8_t
+{
+    Frame          = 1,
+    ExtraneousData = 2,
+};
+
+/**
+ * An entry of the capture index, see @ref CaptureWriter.
+ */
+struct CaptureIndexEntry
+{
+    std::chrono::nanoseconds timestamp{};
+    std::uint64_t record_offset = 0;
+    std::optional<standard::MessageID> message_id;      ///< Standard frames only
+    CaptureRecordKind kind = CaptureRecordKind::Frame;
+    CaptureDirection direction = CaptureDirection::Received;
+    std::uint8_t frame_type_code = 0;
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+
+static constexpr std::uint32_t CaptureFormatVersion = 1;
+static constexpr std::size_t CaptureRecordAlignment = 64;
+static constexpr std::size_t CaptureFileHeaderSize = 48;
+static constexpr std::size_t CaptureRecordHeaderSize = 16;
+static constexpr std::size_t CaptureIndexHeaderSize = 16;
+static constexpr std::size_t CaptureIndexEntrySize = 24;
+static constexpr std::uint16_t CaptureNoMessageID = 0xFFFF;
+static constexpr std::array<std::uint8_t, 8> CaptureFileMagic  {{ 'P', 'o', 'p', 'C', 'o', 'P', 'C', 'F' }};
+static constexpr std::array<std::uint8_t, 8> CaptureIndexMagic {{ 'P', 'o', 'p', 'C', 'o', 'P', 'C', 'I' }};
+
+// The payloads of the records are handed out as parser output, so they must meet the same alignment guarantee
+static_assert(CaptureRecordAlignment % transport::ParserBufferAlignment == 0, "Invalid capture record alignment");
+static_assert(CaptureFileHeaderSize + CaptureRecordHeaderSize == CaptureRecordAlignment, "Invalid capture layout");
+
+struct CaptureRecordHeader
+{
+    std::uint64_t timestamp = 0;
+    std::uint32_t size = 0;
+    std::uint8_t kind = 0;
+    std::uint8_t direction = 0;
+    std::uint8_t frame_type_code = 0;
+
+    void encode(std::uint8_t* const out) const
+    {
+        presentation::StreamEncoder<std::uint8_t*> encoder(out);
+        encoder.addU64(timestamp);
+        encoder.addU32(size);
+        encoder.addU8(kind);
+        encoder.addU8(direction);
+        encoder.addU8(frame_type_code);
+        encoder.fillUpToOffset(CaptureRecordHeaderSize);
+    }
+
+    static CaptureRecordHeader decode(const std::uint8_t* const data)
+    {
+        presentation::StreamDecoder<const std::uint8_t*> decoder(data, data + CaptureRecordHeaderSize);
+        CaptureRecordHeader hdr;
+        hdr.timestamp       = decoder.fetchU64();
+        hdr.size            = decoder.fetchU32();
+        hdr.kind            = decoder.fetchU8();
+        hdr.direction       = decoder.fetchU8();
+        hdr.frame_type_code = decoder.fetchU8();
+        return hdr;
+    }
+};
+
+/**
+ * Records are laid out so that every payload starts at an aligned offset, preceded immediately by its header.
+ * Returns the offset of the header of the record that follows the specified end of the previous one.
+ */
+inline constexpr std::uint64_t getNextCaptureRecordOffset(const std::uint64_t end_of_previous_record)
+{
+    const std::uint64_t payload_offset =
+        ((end_of_previous_record + CaptureRecordHeaderSize + CaptureRecordAlignment - 1U) / CaptureRecordAlignment) *
+        CaptureRecordAlignment;
+    return payload_offset - CaptureRecordHeaderSize;
+}
+
+static_assert(getNextCaptureRecordOffset(CaptureFileHeaderSize) == CaptureFileHeaderSize);
+
+inline void encodeCaptureIndexEntry(const CaptureIndexEntry& entry, std::uint8_t* const out)
+{
+    presentation::StreamEncoder<std::uint8_t*> encoder(out);
+    encoder.addU64(std::uint64_t(entry.timestamp.count()));
+    encoder.addU64(entry.record_offset);
+    encoder.addU16(entry.message_id ? std::uint16_t(*entry.message_id) : CaptureNoMessageID);
+    encoder.addU8(std::uint8_t(entry.kind));
+    encoder.addU8(std::uint8_t(entry.direction));
+    encoder.addU8(entry.frame_type_code);
+    encoder.fillUpToOffset(CaptureIndexEntrySize);
+}
+
+inline CaptureIndexEntry decodeCaptureIndexEntry(const std::uint8_t* const data)
+{
+    presentation::StreamDecoder<const std::uint8_t*> decoder(data, data + CaptureIndexEntrySize);
+    CaptureIndexEntry entry;
+    entry.timestamp       = std::chrono::nanoseconds(std::int64_t(decoder.fetchU64()));
+    entry.record_offset   = decoder.fetchU64();
+    const std::uint16_t message_id = decoder.fetchU16();
+    if (message_id != CaptureNoMessageID)
+    {
+        entry.message_id = standard::MessageID(message_id);
+    }
+    entry.kind            = CaptureRecordKind(decoder.fetchU8());
+    entry.direction       = CaptureDirection(decoder.fetchU8());
+    entry.frame_type_code = decoder.fetchU8();
+    return entry;
+}
+
+} // namespace detail_
+
+/**
+ * The index of a capture file is stored next to it, with ".idx" appended to the path.
+ */
+inline std::string getCaptureIndexPath(const std::string& capture_path)
+{
+    return capture_path + ".idx";
+}
+
+/**
+ * Records the link traffic into a capture file for offline analysis, along with its index.
+ * The received data is recorded as it is reported by the parser (frames and extraneous data);
+ * the transmitted frames are recorded before they are encoded. The reader is @ref CaptureReader in popcop_linux.hpp;
+ * it maps the file into memory and hands out the payloads as zero-copy parser outputs, so the payloads are stored
+ * at aligned offsets. The index contains one small entry per record, so that a time window or the frames of
+ * a specific standard message can be found without touching the capture itself.
+ * All integers are little-endian. Errors are reported by throwing std::system_error.
+ *
+ * Capture file:
+ *
+ *    Offset    Type    Name
+ *  ---------------------------------------------------
+ *      0       u8[8]   magic "PopCoPCF"
+ *      8       u32     format version (1)
+ *      12      u32     record alignment (64)
+ *      16      u8[32]  reserved, zero
+ *  ---------------------------------------------------
+ *      48      records
+ *
+ * Record; the payload starts at a multiple of the record alignment, the gap before the header is zero-filled:
+ *
+ *    Offset    Type    Name
+ *  ---------------------------------------------------
+ *      0       u64     timestamp, nanoseconds since an arbitrary epoch
+ *      8       u32     payload size
+ *      12      u8      record kind (CaptureRecordKind)
+ *      13      u8      direction (CaptureDirection)
+ *      14      u8      frame type code; zero for extraneous data
+ *      15      u8      reserved, zero
+ *  ---------------------------------------------------
+ *      16      u8[]    payload
+ *
+ * Index file: magic "PopCoPCI", u32 format version (1), u32 entry size (24); then one entry per record:
+ *
+ *    Offset    Type    Name
+ *  ---------------------------------------------------
+ *      0       u64     timestamp, nanoseconds since an arbitrary epoch
+ *      8       u64     offset of the record in the capture file
+ *      16      u16     message ID of standard frames, 0xFFFF otherwise
+ *      18      u8      record kind (CaptureRecordKind)
+ *      19      u8      direction (CaptureDirection)
+ *      20      u8      frame type code; zero for extraneous data
+ *      21      u8[3]   reserved, zero
+ *  ---------------------------------------------------
+ *      24
+ *
+ * The timestamps should be monotonic (the index is searched by time); the wall clock is usually the most useful
+ * choice for post-mortem analysis. The capture can be produced from the handler of the parser output:
+ *
+ *      CaptureWriter capture("link.popcop");
+ *      SerialMultiplexer<> mux([&](std::size_t, const transport::ParserOutput& out)
+ *      {
+ *          capture.write(std::chrono::system_clock::now().time_since_epoch(), CaptureDirection::Received, out);
+ *      });
+ */
+class CaptureWriter
+{
+    struct FileCloser
+    {
+        void operator()(std::FILE* const f) const { (void) std::fclose(f); }
+    };
+    using File = std::unique_ptr<std::FILE, FileCloser>;
+
+    File capture_;
+    File index_;
+    std::uint64_t size_ = 0;
+
+    [[noreturn]] static void throwLastError(const char* const what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static File open(const std::string& path)
+    {
+        File f(std::fopen(path.c_str(), "wb"));
+        if (!f)
+        {
+            throwLastError("fopen");
+        }
+        return f;
+    }
+
+    static void write(std::FILE* const f, const void* const data, const std::size_t size)
+    {
+        if ((size > 0) && (std::fwrite(data, 1, size, f) != size))
+        {
+            throwLastError("fwrite");
+        }
+    }
+
+    void writeRecord(const std::chrono::nanoseconds timestamp,
+                     const CaptureDirection direction,
+                     const CaptureRecordKind kind,
+                     const std::uint8_t frame_type_code,
+                     const void* const data,
+                     const std::size_t size)
+    {
+        if (size > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::system_error(std::make_error_code(std::errc::value_too_large), "Capture record is too large");
+        }
+
+        detail_::CaptureRecordHeader hdr;
+        hdr.timestamp       = std::uint64_t(timestamp.count());
+        hdr.size            = std::uint32_t(size);
+        hdr.kind            = std::uint8_t(kind);
+        hdr.direction       = std::uint8_t(direction);
+        hdr.frame_type_code = frame_type_code;
+
+        const std::uint64_t record_offset = detail_::getNextCaptureRecordOffset(size_);
+
+        CaptureIndexEntry entry;
+        entry.timestamp       = timestamp;
+        entry.record_offset   = record_offset;
+        entry.kind            = kind;
+        entry.direction       = direction;
+        entry.frame_type_code = frame_type_code;
+        if ((kind == CaptureRecordKind::Frame) &&
+            (frame_type_code == presentation::StandardFrameTypeCode) &&
+            (size >= standard::MessageHeader::Size))
+        {
+            const auto p = static_cast<const std::uint8_t*>(data);
+            entry.message_id = standard::MessageID(std::uint16_t(p[0] | (p[1] << 8U)));
+        }
+
+        std::array<std::uint8_t, detail_::CaptureRecordHeaderSize> header_buffer{};
+        hdr.encode(header_buffer.data());
+        std::array<std::uint8_t, detail_::CaptureIndexEntrySize> entry_buffer{};
+        detail_::encodeCaptureIndexEntry(entry, entry_buffer.data());
+
+        static constexpr std::array<std::uint8_t, detail_::CaptureRecordAlignment> Padding{};
+        write(capture_.get(), Padding.data(), std::size_t(record_offset - size_));
+        write(capture_.get(), header_buffer.data(), header_buffer.size());
+        write(capture_.get(), data, size);
+        write(index_.get(), entry_buffer.data(), entry_buffer.size());
+        size_ = record_offset + detail_::CaptureRecordHeaderSize + size;
+    }
+
+public:
+    /**
+     * Creates the capture file and its index (see @ref getCaptureIndexPath()); existing files are overwritten.
+     */
+    explicit CaptureWriter(const std::string& path) :
+        capture_(open(path)),
+        index_(open(getCaptureIndexPath(path)))
+    {
+        std::array<std::uint8_t, detail_::CaptureFileHeaderSize> file_header{};
+        {
+            presentation::StreamEncoder<std::uint8_t*> encoder(file_header.data());
+            encoder.addBytes(detail_::CaptureFileMagic);
+            encoder.addU32(detail_::CaptureFormatVersion);
+            encoder.addU32(std::uint32_t(detail_::CaptureRecordAlignment));
+        }
+        std::array<std::uint8_t, detail_::CaptureIndexHeaderSize> index_header{};
+        {
+            presentation::StreamEncoder<std::uint8_t*> encoder(index_header.data());
+            encoder.addBytes(detail_::CaptureIndexMagic);
+            encoder.addU32(detail_::CaptureFormatVersion);
+            encoder.addU32(std::uint32_t(detail_::CaptureIndexEntrySize));
+        }
+        write(capture_.get(), file_header.data(), file_header.size());
+        write(index_.get(), index_header.data(), index_header.size());
+        size_ = detail_::CaptureFileHeaderSize;
+    }
+
+    /**
+     * Records the output of the parser; empty outputs are ignored.
+     */
+    void write(const std::chrono::nanoseconds timestamp,
+               const CaptureDirection direction,
+               const transport::ParserOutput& output)
+    {
+        if (auto f = output.getReceivedFrame())
+        {
+            writeRecord(timestamp, direction, CaptureRecordKind::Frame, f->type_code,
+                        f->payload.data(), f->payload.size());
+        }
+        else if (auto e = output.getExtraneousData())
+        {
+            writeRecord(timestamp, direction, CaptureRecordKind::ExtraneousData, 0, e->data(), e->size());
+        }
+        else
+        {
+            ;   // Nothing to record
+        }
+    }
+
+    void writeFrame(const std::chrono::nanoseconds timestamp,
+                    const CaptureDirection direction,
+                    const std::uint8_t frame_type_code,
+                    const void* const payload,
+                    const std::size_t payload_size)
+    {
+        writeRecord(timestamp, direction, CaptureRecordKind::Frame, frame_type_code, payload, payload_size);
+    }
+
+    void writeExtraneousData(const std::chrono::nanoseconds timestamp,
+                             const CaptureDirection direction,
+                             const void* const data,
+                             const std::size_t size)
+    {
+        writeRecord(timestamp, direction, CaptureRecordKind::ExtraneousData, 0, data, size);
+    }
+
+    /**
+     * The files are buffered; the data is guaranteed to be written out only after this call or on destruction.
+     */
+    void flush()
+    {
+        if ((std::fflush(capture_.get()) != 0) || (std::fflush(index_.get()) != 0))
+        {
+            throwLastError("fflush");
+        }
+    }
+
+    /// The size of the capture file, including the data that has not been flushed yet.
+    std::uint64_t getSize() const { return size_; }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+
+template <typename Message>
+struct StandardMessageIDOf
+{
+    static constexpr standard::MessageID Value = Message::ID;
+};
+
+template <>
+struct StandardMessageIDOf<standard::EndpointInfoMessage>
+{
+    static constexpr standard::MessageID Value = standard::MessageID::EndpointInfo;
+};
+
+template <typename MessageTypeList>
+struct StandardMessageDecoder;
+
+template <typename... Messages>
+struct StandardMessageDecoder<standard::detail_::MessageTypeList<Messages...>>
+{
+    template <typename Message, typename Visitor>
+    static bool tryDecodeAs(const standard::MessageID id,
+                            const std::uint8_t* const begin,
+                            const std::uint8_t* const end,
+                            Visitor& visitor)
+    {
+        if (id == StandardMessageIDOf<Message>::Value)
+        {
+            if (const auto msg = Message::tryDecode(begin, end))
+            {
+                visitor(*msg);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Visitor>
+    static bool tryDecode(const standard::MessageID id,
+                          const std::uint8_t* const begin,
+                          const std::uint8_t* const end,
+                          Visitor& visitor)
+    {
+        return (tryDecodeAs<Messages>(id, begin, end, visitor) || ...);
+    }
+};
+
+/**
+ * The outputs of a parser copied out of it, so that they can be reported later.
+ * Every payload is placed at an aligned offset, so that the outputs can be reproduced exactly.
+ */
+class ParsedChunk
+{
+    struct alignas(transport::ParserBufferAlignment) Block
+    {
+        std::array<std::uint8_t, transport::ParserBufferAlignment> bytes;
+    };
+
+    struct Item
+    {
+        std::size_t offset = 0;                         ///< In bytes
+        std::size_t size = 0;
+        std::optional<std::uint8_t> frame_type_code;    ///< Empty for extraneous data
+    };
+
+    std::vector<Block> arena_;
+    std::vector<Item> items_;
+
+    /// The arena is addressed as a whole rather than through the array of the first block
+    std::uint8_t* getArenaBytes() { return reinterpret_cast<std::uint8_t*>(arena_.data()); }
+    const std::uint8_t* getArenaBytes() const { return reinterpret_cast<const std::uint8_t*>(arena_.data()); }
+
+    void append(const std::optional<std::uint8_t> frame_type_code,
+                const std::uint8_t* const data,
+                const std::size_t size)
+    {
+        Item item;
+        item.offset = arena_.size() * sizeof(Block);
+        item.size = size;
+        item.frame_type_code = frame_type_code;
+        arena_.resize(arena_.size() + std::max<std::size_t>(1, (size + sizeof(Block) - 1U) / sizeof(Block)));
+        std::memcpy(getArenaBytes() + item.offset, data, size);
+        items_.push_back(item);
+    }
+
+public:
+    void add(const transport::ParserOutput& out)
+    {
+        if (auto f = out.getReceivedFrame())
+        {
+            append(f->type_code, f->payload.data(), f->payload.size());
+        }
+        else if (auto e = out.getExtraneousData())
+        {
+            append({}, e->data(), e->size());
+        }
+        else
+        {
+            ;   // Nothing to keep
+        }
+    }
+
+    template <typename Handler>
+    void replay(Handler& handler) const
+    {
+        for (const Item& item : items_)
+        {
+            const std::uint8_t* const ptr = getArenaBytes() + item.offset;
+            if (item.frame_type_code)
+            {
+                handler(transport::ParserOutput(*item.frame_type_code, ptr, item.size));
+            }
+            else
+            {
+                handler(transport::ParserOutput(ptr, item.size));
+            }
+        }
+    }
+};
+
+} // namespace detail_
+
+/**
+ * Decodes the standard message contained in the frame using the tryDecode() method of the matching message type,
+ * and invokes the visitor with the decoded message. The visitor must accept every standard message type;
+ * a generic lambda is a convenient choice:
+ *
+ *      decodeStandardMessage(*frame, [](const auto& msg) { std::cout << int(msg.ID) << std::endl; });
+ *
+ * Note that @ref standard::EndpointInfoMessage does not define the ID; use @ref standard::MessageID::EndpointInfo.
+ *
+ * @return  False if the frame is not a standard frame, or if the message is unknown or malformed.
+ */
+template <typename Visitor>
+inline bool decodeStandardMessage(const transport::ParserOutput::Frame& frame, Visitor&& visitor)
+{
+    if ((frame.type_code != presentation::StandardFrameTypeCode) ||
+        (frame.payload.size() < standard::MessageHeader::Size))
+    {
+        return false;
+    }
+
+    const auto id = standard::MessageID(std::uint16_t(frame.payload.at(0) | (frame.payload.at(1) << 8U)));
+    using Decoder = detail_::StandardMessageDecoder<standard::detail_::StandardMessageTypes>;
+    return Decoder::tryDecode(id, frame.payload.begin(), frame.payload.end(), visitor);
+}
+
+/**
+ * The default amount of data parsed by one task of @ref decodeInParallel().
+ */
+static constexpr std::size_t DefaultParallelDecoderChunkSize = 4U * 1024U * 1024U;
+
+/**
+ * Parses a large raw byte capture (e.g. a dump of a serial link) using all CPU cores.
+ * The result is exactly the same as if the data was fed into a new @ref transport::Parser sequentially:
+ * the handler is invoked from the calling thread for every non-empty parser output in the order of occurrence.
+ *
+ * The data is split into chunks right after a frame delimiter. Since a frame delimiter never occurs inside a frame
+ * and the parser discards its state upon reception of a delimiter, every chunk can be parsed independently by
+ * its own parser. The outputs of a chunk are copied out of its parser and reported once all of the preceding chunks
+ * are reported; the number of chunks in flight is limited, so the memory footprint does not depend on the size of
+ * the capture. Use @ref decodeStandardMessage() in the handler in order to decode the standard messages.
+ *
+ * @tparam MaxPayloadSize       Maximum payload size of the parsers, see @ref transport::Parser.
+ *
+ * @param data                  The capture, e.g. a memory-mapped file.
+ * @param size                  Size of the capture, in bytes.
+ * @param handler               void (const transport::ParserOutput&); the data is INVALIDATED when it returns.
+ * @param number_of_threads     Number of chunks that are parsed concurrently; defaults to the number of CPU cores.
+ * @param chunk_size            Approximate amount of data per chunk.
+ *
+ * @return  The offset after the last frame delimiter. The data past that offset did not produce any output yet;
+ *          if the capture is still being written, the decoding can be resumed from this offset later.
+ */
+template <std::size_t MaxPayloadSize = 2048, typename Handler>
+inline std::size_t decodeInParallel(const std::uint8_t* const data,
+                                    const std::size_t size,
+                                    Handler&& handler,
+                                    const std::size_t number_of_threads =
+                                        std::max(1U, std::thread::hardware_concurrency()),
+                                    const std::size_t chunk_size = DefaultParallelDecoderChunkSize)
+{
+    const auto parse = [](const std::uint8_t* const begin, const std::uint8_t* const end)
+    {
+        const auto parser = std::make_unique<transport::Parser<MaxPayloadSize>>();
+        detail_::ParsedChunk chunk;
+        parser->processBytes(begin, std::size_t(end - begin), [&](const transport::ParserOutput& out)
+        {
+            chunk.add(out);
+        });
+        return chunk;
+    };
+
+    const std::size_t max_in_flight = std::max<std::size_t>(1, number_of_threads) * 2U;
+    const std::uint8_t* const end = data + size;
+    const std::uint8_t* next = data;
+    std::deque<std::future<detail_::ParsedChunk>> in_flight;
+    while ((next != end) || !in_flight.empty())
+    {
+        while ((next != end) && (in_flight.size() < max_in_flight))
+        {
+            // The chunk ends right after the first delimiter past the nominal size, or at the end of the data
+            const std::size_t nominal = std::min(std::max<std::size_t>(1, chunk_size), std::size_t(end - next));
+            const void* const delimiter =
+                std::memchr(next + nominal - 1U, transport::FrameDelimiter, std::size_t(end - next) - nominal + 1U);
+            const std::uint8_t* const chunk_end =
+                (delimiter != nullptr) ? (static_cast<const std::uint8_t*>(delimiter) + 1) : end;
+            in_flight.push_back(std::async(std::launch::async, parse, next, chunk_end));
+            next = chunk_end;
+        }
+
+        const detail_::ParsedChunk chunk = in_flight.front().get();
+        in_flight.pop_front();
+        chunk.replay(handler);
+    }
+
+    std::size_t offset = size;
+    while ((offset > 0) && (data[offset - 1U] != transport::FrameDelimiter))
+    {
+        offset--;
+    }
+    return offset;
+}
+
+} // namespace host
+
+} // namespace popcop
+
+#endif
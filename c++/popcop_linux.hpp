@@ -0,0 +1,776 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Zubax Robotics
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+ */
+
+/*
+ * Linux-specific host-side extensions of Popcop: native serial port transport, memory-mapped capture reader.
+ * They are kept separate from the portable host-side extensions because they depend on the Linux system API.
+ */
+
+#ifndef POPCOP_LINUX_HPP_INCLUDED
+#define POPCOP_LINUX_HPP_INCLUDED
+
+#include "popcop_host.hpp"
+
+#include <system_error>
+#include <string>
+#include <cerrno>
+
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+
+namespace popcop
+{
+namespace host
+{
+/**
+ * Non-blocking raw serial port, e.g. /dev/ttyUSB0 or /dev/ttyACM0.
+ * The port is configured for the lowest latency: raw mode, no flow control, reads return whatever is available
+ * immediately, and the low latency flag is set for the drivers that support it (this disables the receive
+ * buffering delay of the FTDI and similar USB-serial adapters). The port is opened in the exclusive mode.
+ * Errors are reported by throwing std::system_error.
+ */
+class SerialPort
+{
+    int fd_ = -1;
+
+    static speed_t convertBaudRate(const unsigned baud_rate)
+    {
+        switch (baud_rate)
+        {
+        case 9600:      return B9600;
+        case 19200:     return B19200;
+        case 38400:     return B38400;
+        case 57600:     return B57600;
+        case 115200:    return B115200;
+        case 230400:    return B230400;
+        case 460800:    return B460800;
+        case 921600:    return B921600;
+        case 1000000:   return B1000000;
+        case 2000000:   return B2000000;
+        case 3000000:   return B3000000;
+        case 4000000:   return B4000000;
+        default:        throw std::system_error(EINVAL, std::generic_category(), "Unsupported baud rate");
+        }
+    }
+
+    [[noreturn]] static void throwLastError(const char* const what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void configure(const unsigned baud_rate)
+    {
+        (void) ::ioctl(fd_, TIOCEXCL);
+
+        ::termios tio{};
+        if (::tcgetattr(fd_, &tio) != 0)
+        {
+            throwLastError("tcgetattr");
+        }
+        ::cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~tcflag_t(CRTSCTS | CSTOPB);
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        const speed_t speed = convertBaudRate(baud_rate);
+        if ((::cfsetispeed(&tio, speed) != 0) ||
+            (::cfsetospeed(&tio, speed) != 0) ||
+            (::tcsetattr(fd_, TCSANOW, &tio) != 0))
+        {
+            throwLastError("tcsetattr");
+        }
+
+        // Not all drivers support this (e.g. CDC ACM and pseudo terminals do not need it), so errors are ignored
+        ::serial_struct ser{};
+        if (::ioctl(fd_, TIOCGSERIAL, &ser) == 0)
+        {
+            ser.flags = int(unsigned(ser.flags) | unsigned(ASYNC_LOW_LATENCY));
+            (void) ::ioctl(fd_, TIOCSSERIAL, &ser);
+        }
+
+        (void) ::tcflush(fd_, TCIOFLUSH);
+    }
+
+public:
+    /**
+     * @param path          Path to the device, e.g. /dev/serial/by-id/usb-Zubax_Robotics_Zubax_Babel_...-if00
+     * @param baud_rate     Ignored by virtual serial ports such as USB CDC ACM.
+     */
+    explicit SerialPort(const std::string& path, const unsigned baud_rate = 115200)
+    {
+        fd_ = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd_ < 0)
+        {
+            throwLastError("open");
+        }
+
+        try
+        {
+            configure(baud_rate);
+        }
+        catch (...)
+        {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    ~SerialPort()
+    {
+        if (fd_ >= 0)
+        {
+            (void) ::close(fd_);
+        }
+    }
+
+    SerialPort(SerialPort&& other) noexcept : fd_(std::exchange(other.fd_, -1)) { }
+
+    SerialPort& operator=(SerialPort&& other) noexcept
+    {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    int getFileDescriptor() const { return fd_; }
+
+    /**
+     * Reads whatever is available, without blocking.
+     * @return  The number of bytes read; zero if no data is available.
+     */
+    std::size_t read(std::uint8_t* const data, const std::size_t size)
+    {
+        const auto res = ::read(fd_, data, size);
+        if (res >= 0)
+        {
+            return std::size_t(res);
+        }
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+        {
+            return 0;
+        }
+        throwLastError("read");
+    }
+
+    /**
+     * Writes as much as the driver can accept, without blocking.
+     * @return  The number of bytes written, possibly less than the size; zero if the output buffer is full.
+     */
+    std::size_t write(const std::uint8_t* const data, const std::size_t size)
+    {
+        const auto res = ::write(fd_, data, size);
+        if (res >= 0)
+        {
+            return std::size_t(res);
+        }
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+        {
+            return 0;
+        }
+        throwLastError("write");
+    }
+};
+
+/**
+ * Event loop that serves many serial ports from one thread using epoll.
+ * The received data is read into one preallocated buffer and fed directly into the bulk path of the parser of
+ * the port (see @ref transport::ParserBase::processBytes()), so the received frames are reported without ever
+ * being copied. The outgoing data is written immediately; the part that the driver cannot accept right away is
+ * buffered and written as soon as the port becomes writable.
+ *
+ * A port that fails (e.g. the USB adapter is unplugged) is closed and removed from the loop; the other ports
+ * are not affected. See @ref isOpen().
+ *
+ * The standard request/response client can be connected to a port as follows:
+ *
+ *      SerialMultiplexer<> mux([&](std::size_t port_index, const transport::ParserOutput& out)
+ *      {
+ *          clients.at(port_index).processParserOutput(out, Client<>::Clock::now());
+ *      });
+ *      const auto index = mux.add(SerialPort("/dev/ttyACM0"));
+ *      clients.emplace_back([&mux, index](const std::uint8_t* data, std::size_t size) { mux.send(index, data, size); });
+ *
+ *      while (true)
+ *      {
+ *          mux.poll(std::chrono::milliseconds(10));
+ *          // Invoke Client::poll() here
+ *      }
+ *
+ * @tparam MaxPayloadSize   Maximum payload size of the parsers, see @ref transport::Parser.
+ * @tparam ReadBufferSize   Maximum amount of data read from one port at once.
+ */
+template <std::size_t MaxPayloadSize = 2048, std::size_t ReadBufferSize = 4096>
+class SerialMultiplexer
+{
+public:
+    /**
+     * Invoked once for every non-empty parser output. The referenced data is INVALIDATED when the handler returns.
+     */
+    using Handler = std::function<void (std::size_t port_index, const transport::ParserOutput&)>;
+
+private:
+    struct Port
+    {
+        SerialPort port;
+        transport::Parser<MaxPayloadSize> parser;
+        std::vector<std::uint8_t> tx_pending;           ///< Not accepted by the driver yet
+        bool open = true;
+
+        explicit Port(SerialPort&& p) : port(std::move(p)) { }
+    };
+
+    static constexpr std::size_t MaxEventsPerPoll = 64;
+
+    const Handler handler_;
+    int epoll_fd_ = -1;
+    std::vector<std::unique_ptr<Port>> ports_;          ///< The parsers are large, so the ports are not moved
+    alignas(CacheLineSize) std::array<std::uint8_t, ReadBufferSize> read_buffer_{};
+
+    void updateEvents(const std::size_t index)
+    {
+        Port& p = *ports_[index];
+        ::epoll_event ev{};
+        ev.events = EPOLLIN | (p.tx_pending.empty() ? 0U : unsigned(EPOLLOUT));
+        ev.data.u64 = index;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, p.port.getFileDescriptor(), &ev) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+        }
+    }
+
+    void close(const std::size_t index)
+    {
+        Port& p = *ports_[index];
+        (void) ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, p.port.getFileDescriptor(), nullptr);
+        {
+            SerialPort discarded(std::move(p.port));    // Closes the file descriptor
+        }
+        p.tx_pending.clear();
+        p.open = false;
+    }
+
+    void flushPending(const std::size_t index)
+    {
+        Port& p = *ports_[index];
+        const std::size_t written = p.port.write(p.tx_pending.data(), p.tx_pending.size());
+        p.tx_pending.erase(p.tx_pending.begin(), p.tx_pending.begin() + std::ptrdiff_t(written));
+        if (p.tx_pending.empty())
+        {
+            updateEvents(index);
+        }
+    }
+
+    void processEvent(const std::size_t index, const std::uint32_t events)
+    {
+        Port& p = *ports_[index];
+        try
+        {
+            if ((events & EPOLLIN) != 0)
+            {
+                const std::size_t size = p.port.read(read_buffer_.data(), read_buffer_.size());
+                p.parser.processBytes(read_buffer_.data(), size, [&](const transport::ParserOutput& out)
+                {
+                    handler_(index, out);
+                });
+                if ((size == 0) && ((events & EPOLLHUP) != 0))
+                {
+                    close(index);                       // The other end is gone and there is no more data
+                    return;
+                }
+            }
+            else if ((events & (EPOLLHUP | EPOLLERR)) != 0)
+            {
+                close(index);
+                return;
+            }
+
+            if (p.open && ((events & EPOLLOUT) != 0) && !p.tx_pending.empty())
+            {
+                flushPending(index);
+            }
+        }
+        catch (const std::system_error&)
+        {
+            close(index);
+        }
+    }
+
+public:
+    explicit SerialMultiplexer(Handler handler) :
+        handler_(std::move(handler)),
+        epoll_fd_(::epoll_create1(EPOLL_CLOEXEC))
+    {
+        if (epoll_fd_ < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        }
+    }
+
+    ~SerialMultiplexer()
+    {
+        (void) ::close(epoll_fd_);
+    }
+
+    SerialMultiplexer(const SerialMultiplexer&) = delete;
+    SerialMultiplexer& operator=(const SerialMultiplexer&) = delete;
+
+    /**
+     * Adds the port to the loop.
+     * @return  The index of the port, which is used to refer to it in other methods and in the handler.
+     */
+    std::size_t add(SerialPort port)
+    {
+        const std::size_t index = ports_.size();
+        ports_.push_back(std::make_unique<Port>(std::move(port)));
+
+        ::epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = index;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, ports_.back()->port.getFileDescriptor(), &ev) != 0)
+        {
+            const int error = errno;
+            ports_.pop_back();
+            throw std::system_error(error, std::generic_category(), "epoll_ctl");
+        }
+        return index;
+    }
+
+    /**
+     * Sends the data to the port. The data is copied, so the buffer can be reused immediately.
+     * The data is dropped if the port is closed.
+     */
+    void send(const std::size_t index, const std::uint8_t* const data, const std::size_t size)
+    {
+        Port& p = *ports_.at(index);
+        if (!p.open || (size == 0))
+        {
+            return;
+        }
+
+        if (!p.tx_pending.empty())
+        {
+            p.tx_pending.insert(p.tx_pending.end(), data, data + size);     // Preserving the order
+            return;
+        }
+
+        try
+        {
+            const std::size_t written = p.port.write(data, size);
+            if (written < size)
+            {
+                p.tx_pending.assign(data + written, data + size);
+                updateEvents(index);
+            }
+        }
+        catch (const std::system_error&)
+        {
+            close(index);
+        }
+    }
+
+    /**
+     * Waits for at most the specified time, processes the events of all ready ports, and returns.
+     * Every ready port is read at most once per call, so that all ports are served fairly.
+     * A negative timeout means to wait indefinitely.
+     * @return  The number of ports that had any events.
+     */
+    std::size_t poll(const std::chrono::milliseconds timeout)
+    {
+        std::array<::epoll_event, MaxEventsPerPoll> events{};
+        const int timeout_ms = (timeout.count() < 0) ? -1 :
+                               int(std::min<std::chrono::milliseconds::rep>(timeout.count(), 0x7FFFFFFF));
+        const int n = ::epoll_wait(epoll_fd_, events.data(), int(events.size()), timeout_ms);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                return 0;
+            }
+            throw std::system_error(errno, std::generic_category(), "epoll_wait");
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            const auto& ev = events[std::size_t(i)];
+            processEvent(std::size_t(ev.data.u64), ev.events);
+        }
+        return std::size_t(n);
+    }
+
+    /**
+     * False if the port has failed and has been removed from the loop.
+     */
+    bool isOpen(const std::size_t index) const { return ports_.at(index)->open; }
+
+    /**
+     * The amount of outgoing data that is not yet accepted by the driver.
+     */
+    std::size_t getPendingSize(const std::size_t index) const { return ports_.at(index)->tx_pending.size(); }
+
+    std::size_t getNumberOfPorts() const { return ports_.size(); }
+
+    /**
+     * The epoll descriptor becomes readable when any of the ports has events to process, so the wait can be done
+     * outside of @ref poll(), e.g. in another event loop or without holding a lock; then call poll() with zero timeout.
+     */
+    int getFileDescriptor() const { return epoll_fd_; }
+};
+
+/**
+ * Read-only memory mapping of a whole file, e.g. a raw capture for @ref decodeInParallel().
+ * The advice is passed to madvise(), e.g. MADV_SEQUENTIAL.
+ */
+class MappedFile
+{
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    [[noreturn]] static void throwLastError(const char* const what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+public:
+    MappedFile(const std::string& path, const int advice)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throwLastError("open");
+        }
+
+        struct ::stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            const int error = errno;
+            (void) ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+
+        size_ = std::size_t(st.st_size);
+        if (size_ > 0)
+        {
+            void* const p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                const int error = errno;
+                (void) ::close(fd);
+                throw std::system_error(error, std::generic_category(), "mmap");
+            }
+            data_ = static_cast<const std::uint8_t*>(p);
+            (void) ::madvise(p, size_, advice);
+        }
+
+        (void) ::close(fd);                             // The mapping stays valid
+    }
+
+    ~MappedFile()
+    {
+        if (data_ != nullptr)
+        {
+            (void) ::munmap(const_cast<std::uint8_t*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+};
+
+/// Implementation details; do not use that in user code
+namespace detail_
+{
+
+[[noreturn]] inline void throwInvalidCaptureFile(const char* const what)
+{
+    throw std::system_error(std::make_error_code(std::errc::invalid_argument), what);
+}
+
+inline void checkCaptureFileHeader(const MappedFile& file,
+                                   const std::size_t header_size,
+                                   const std::array<std::uint8_t, 8>& magic,
+                                   const std::uint32_t parameter)
+{
+    if ((file.size() < header_size) || !std::equal(magic.begin(), magic.end(), file.data()))
+    {
+        throwInvalidCaptureFile("Not a Popcop capture file");
+    }
+
+    presentation::StreamDecoder<const std::uint8_t*> decoder(file.data() + magic.size(), file.data() + header_size);
+    const std::uint32_t version = decoder.fetchU32();
+    if ((version != CaptureFormatVersion) || (decoder.fetchU32() != parameter))
+    {
+        throwInvalidCaptureFile("Unsupported Popcop capture file format");
+    }
+}
+
+} // namespace detail_
+
+/**
+ * Zero-copy reader of the capture files produced by @ref CaptureWriter.
+ * The file is mapped into memory; the payloads of the records are handed out as parser outputs that point directly
+ * into the mapping, so they meet the alignment guarantees of @ref transport::ParserOutput::AlignedBufferView.
+ * The references are valid as long as the reader exists.
+ * A file that is still being written can be read; an incomplete record at the end is ignored.
+ *
+ *      for (const CaptureReader::Record& rec : CaptureReader("link.popcop"))
+ *      {
+ *          if (auto frame = rec.output.getReceivedFrame())
+ *          {
+ *              // Process the frame
+ *          }
+ *      }
+ *
+ * Use @ref CaptureIndex in order to locate the records without scanning the whole capture.
+ */
+class CaptureReader
+{
+public:
+    struct Record
+    {
+        std::uint64_t offset = 0;                       ///< Can be used with getRecordAt()
+        std::chrono::nanoseconds timestamp{};
+        CaptureDirection direction = CaptureDirection::Received;
+        transport::ParserOutput output;
+    };
+
+    class Iterator
+    {
+        friend class CaptureReader;
+
+        const CaptureReader* owner_ = nullptr;
+        std::optional<Record> record_;
+
+        Iterator(const CaptureReader* owner, std::optional<Record>&& record) :
+            owner_(owner),
+            record_(std::move(record))
+        { }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Record;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Record*;
+        using reference         = const Record&;
+
+        Iterator() = default;
+
+        reference operator*()  const { return *record_; }
+        pointer   operator->() const { return &*record_; }
+
+        Iterator& operator++()
+        {
+            record_ = owner_->getNextRecord(*record_);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            const auto offset = [](const Iterator& it) { return it.record_ ? it.record_->offset : ~std::uint64_t{}; };
+            return offset(*this) == offset(other);
+        }
+
+        bool operator!=(const Iterator& other) const { return !operator==(other); }
+    };
+
+private:
+    MappedFile file_;
+
+public:
+    /**
+     * Throws std::system_error if the file cannot be opened or if it is not a capture file.
+     */
+    explicit CaptureReader(const std::string& path) :
+        file_(path, MADV_SEQUENTIAL)
+    {
+        detail_::checkCaptureFileHeader(file_,
+                                        detail_::CaptureFileHeaderSize,
+                                        detail_::CaptureFileMagic,
+                                        std::uint32_t(detail_::CaptureRecordAlignment));
+    }
+
+    /**
+     * Decodes the record at the specified offset, e.g. from @ref CaptureIndexEntry::record_offset.
+     * Returns an empty option if there is no complete valid record at that offset.
+     */
+    std::optional<Record> getRecordAt(const std::uint64_t offset) const
+    {
+        // The offset may come from an untrusted index, so it is checked before any arithmetic that could overflow
+        if ((offset < detail_::CaptureFileHeaderSize) ||
+            (file_.size() < detail_::CaptureRecordHeaderSize) ||
+            (offset > (file_.size() - detail_::CaptureRecordHeaderSize)))
+        {
+            return {};
+        }
+
+        const std::uint64_t payload_offset = offset + detail_::CaptureRecordHeaderSize;
+        if ((payload_offset % detail_::CaptureRecordAlignment) != 0)
+        {
+            return {};
+        }
+
+        const auto hdr = detail_::CaptureRecordHeader::decode(file_.data() + offset);
+        if (hdr.size > (file_.size() - payload_offset))
+        {
+            return {};                                  // Incomplete
+        }
+
+        Record rec;
+        rec.offset    = offset;
+        rec.timestamp = std::chrono::nanoseconds(std::int64_t(hdr.timestamp));
+        rec.direction = CaptureDirection(hdr.direction);
+        const std::uint8_t* const payload = file_.data() + payload_offset;
+        switch (CaptureRecordKind(hdr.kind))
+        {
+        case CaptureRecordKind::Frame:
+        {
+            rec.output = transport::ParserOutput(hdr.frame_type_code, payload, hdr.size);
+            break;
+        }
+        case CaptureRecordKind::ExtraneousData:
+        {
+            rec.output = transport::ParserOutput(payload, hdr.size);
+            break;
+        }
+        default:
+        {
+            return {};
+        }
+        }
+        return rec;
+    }
+
+    std::optional<Record> getNextRecord(const Record& rec) const
+    {
+        const auto size = detail_::CaptureRecordHeader::decode(file_.data() + rec.offset).size;
+        return getRecordAt(detail_::getNextCaptureRecordOffset(rec.offset + detail_::CaptureRecordHeaderSize + size));
+    }
+
+    Iterator begin() const { return Iterator(this, getRecordAt(detail_::CaptureFileHeaderSize)); }
+    Iterator end()   const { return Iterator(this, {}); }
+
+    /// The size of the mapped file.
+    std::uint64_t getSize() const { return file_.size(); }
+};
+
+/**
+ * Memory-mapped index of a capture file, see @ref CaptureWriter.
+ * The entries are stored in the order of recording, so they can be searched by time if the timestamps are monotonic.
+ * Scanning the index is much faster than scanning the capture, since the index is compact and the payloads
+ * are not touched; the records of interest are then decoded with @ref CaptureReader::getRecordAt():
+ *
+ *      CaptureReader capture("link.popcop");
+ *      CaptureIndex index(getCaptureIndexPath("link.popcop"));
+ *      for (std::size_t i = index.lowerBound(window_begin); i < index.size(); i++)
+ *      {
+ *          const CaptureIndexEntry entry = index[i];
+ *          if (entry.timestamp >= window_end)
+ *          {
+ *              break;
+ *          }
+ *          if (entry.message_id == standard::MessageID::RegisterDataResponse)
+ *          {
+ *              const auto rec = capture.getRecordAt(entry.record_offset);
+ *              // Decode rec->output here
+ *          }
+ *      }
+ */
+class CaptureIndex
+{
+    MappedFile file_;
+
+public:
+    /**
+     * Throws std::system_error if the file cannot be opened or if it is not a capture index.
+     */
+    explicit CaptureIndex(const std::string& path) :
+        file_(path, MADV_RANDOM)
+    {
+        detail_::checkCaptureFileHeader(file_,
+                                        detail_::CaptureIndexHeaderSize,
+                                        detail_::CaptureIndexMagic,
+                                        std::uint32_t(detail_::CaptureIndexEntrySize));
+    }
+
+    /// An incomplete entry at the end is ignored.
+    std::size_t size() const
+    {
+        return (file_.size() - detail_::CaptureIndexHeaderSize) / detail_::CaptureIndexEntrySize;
+    }
+
+    CaptureIndexEntry operator[](const std::size_t index) const
+    {
+        assert(index < size());
+        return detail_::decodeCaptureIndexEntry(file_.data() + detail_::CaptureIndexHeaderSize +
+                                                index * detail_::CaptureIndexEntrySize);
+    }
+
+    /**
+     * The index of the first entry whose timestamp is not less than the specified one; size() if there is none.
+     * The timestamps must be monotonic.
+     */
+    std::size_t lowerBound(const std::chrono::nanoseconds timestamp) const
+    {
+        std::size_t lo = 0;
+        std::size_t hi = size();
+        while (lo < hi)
+        {
+            const std::size_t mid = lo + (hi - lo) / 2U;
+            if ((*this)[mid].timestamp < timestamp)
+            {
+                lo = mid + 1U;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+};
+
+} // namespace host
+
+} // namespace popcop
+
+#endif
@@ -0,0 +1,720 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Zubax Robotics
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+ */
+
+/*
+ * Performance benchmarks. The numbers are reported in bytes per second (throughput) and items per second,
+ * where an item is a frame (transport layer) or a message (presentation layer).
+ * Memory footprint of the relevant types is reported in the context section of the output and in the counters.
+ * Per-function stack usage is reported by the compiler in the *.su files next to the object files (GCC only).
+ */
+
+// The library should be included first in order to ensure that all necessary headers are included in the library itself
+#include <popcop.hpp>
+
+// Benchmark-only dependencies
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+
+using namespace popcop;
+
+namespace
+{
+
+constexpr std::size_t FramePayloadSize = 1024;
+constexpr std::size_t FramesPerInput = 64;
+
+/**
+ * Kinds of synthetic input data for the transport layer benchmarks.
+ */
+enum class InputKind
+{
+    Random,             ///< Valid frames with random payload
+    NoEscape,           ///< Valid frames where no payload byte has to be escaped, e.g. text - the best case
+    AllEscape,          ///< Valid frames where every payload byte has to be escaped - the worst case
+    AllDelimiter,       ///< Nothing but frame delimiters
+};
+
+std::vector<std::uint8_t> makePayload(const InputKind kind, std::mt19937& rng)
+{
+    std::vector<std::uint8_t> payload(FramePayloadSize);
+    for (auto& x : payload)
+    {
+        x = (kind == InputKind::AllEscape) ? transport::EscapeCharacter : std::uint8_t(rng());
+        if (kind == InputKind::NoEscape)
+        {
+            x &= 0x7FU;
+        }
+    }
+    return payload;
+}
+
+std::vector<std::uint8_t> makeEncodedInput(const InputKind kind)
+{
+    std::mt19937 rng(42);
+    std::vector<std::uint8_t> out;
+
+    if (kind == InputKind::AllDelimiter)
+    {
+        out.resize(FramesPerInput * FramePayloadSize, transport::FrameDelimiter);
+        return out;
+    }
+
+    for (std::size_t i = 0; i < FramesPerInput; i++)
+    {
+        const auto payload = makePayload(kind, rng);
+        transport::BufferedEmitter emitter(std::uint8_t(i), payload.data(), payload.size());
+        do
+        {
+            out.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+    }
+
+    return out;
+}
+
+void reportInput(benchmark::State& state, const std::vector<std::uint8_t>& input, const std::size_t frames)
+{
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(input.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * std::int64_t(frames));
+}
+
+/*
+ * Transport layer: parsing
+ */
+void benchParserProcessNextByte(benchmark::State& state, const InputKind kind)
+{
+    const auto input = makeEncodedInput(kind);
+    transport::Parser<> parser;
+    std::size_t frames = 0;
+    for (auto _ : state)
+    {
+        for (auto x : input)
+        {
+            const auto out = parser.processNextByte(x);
+            frames += (out.getReceivedFrame() != nullptr) ? 1U : 0U;
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    reportInput(state, input, frames / std::max<std::size_t>(1, std::size_t(state.iterations())));
+}
+
+void benchParserProcessBytes(benchmark::State& state, const InputKind kind)
+{
+    const auto input = makeEncodedInput(kind);
+    transport::Parser<> parser;
+    std::size_t frames = 0;
+    for (auto _ : state)
+    {
+        parser.processBytes(input.data(), input.size(), [&](const transport::ParserOutput& out)
+        {
+            frames += (out.getReceivedFrame() != nullptr) ? 1U : 0U;
+            benchmark::DoNotOptimize(out);
+        });
+    }
+    reportInput(state, input, frames / std::max<std::size_t>(1, std::size_t(state.iterations())));
+}
+
+BENCHMARK_CAPTURE(benchParserProcessNextByte, random,        InputKind::Random);
+BENCHMARK_CAPTURE(benchParserProcessNextByte, all_escape,    InputKind::AllEscape);
+BENCHMARK_CAPTURE(benchParserProcessNextByte, all_delimiter, InputKind::AllDelimiter);
+BENCHMARK_CAPTURE(benchParserProcessBytes,    random,        InputKind::Random);
+BENCHMARK_CAPTURE(benchParserProcessBytes,    no_escape,     InputKind::NoEscape);
+BENCHMARK_CAPTURE(benchParserProcessBytes,    all_escape,    InputKind::AllEscape);
+BENCHMARK_CAPTURE(benchParserProcessBytes,    all_delimiter, InputKind::AllDelimiter);
+
+/*
+ * Transport layer: emission
+ */
+void benchBufferedEmitterGetNextByte(benchmark::State& state, const InputKind kind)
+{
+    std::mt19937 rng(42);
+    const auto payload = makePayload(kind, rng);
+    for (auto _ : state)
+    {
+        transport::BufferedEmitter emitter(0, payload.data(), payload.size());
+        do
+        {
+            benchmark::DoNotOptimize(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+    }
+    reportInput(state, payload, 1);
+}
+
+void benchBufferedEmitterEmitInto(benchmark::State& state, const InputKind kind)
+{
+    std::mt19937 rng(42);
+    const auto payload = makePayload(kind, rng);
+    std::array<std::uint8_t, 4096> buffer{};
+    for (auto _ : state)
+    {
+        transport::BufferedEmitter emitter(0, payload.data(), payload.size());
+        while (emitter.emitInto(buffer.data(), buffer.size()) > 0)
+        {
+            benchmark::DoNotOptimize(buffer.data());
+            benchmark::ClobberMemory();
+        }
+    }
+    reportInput(state, payload, 1);
+}
+
+void benchStreamEmitter(benchmark::State& state, const InputKind kind)
+{
+    std::mt19937 rng(42);
+    const auto payload = makePayload(kind, rng);
+    std::uint8_t last = 0;
+    for (auto _ : state)
+    {
+        std::copy(payload.begin(),
+                  payload.end(),
+                  transport::StreamEmitter(0, [&](std::uint8_t x) { last = x; benchmark::ClobberMemory(); }).begin());
+    }
+    benchmark::DoNotOptimize(last);
+    reportInput(state, payload, 1);
+}
+
+void benchBasicStreamEmitter(benchmark::State& state, const InputKind kind)
+{
+    std::mt19937 rng(42);
+    const auto payload = makePayload(kind, rng);
+    std::uint8_t last = 0;
+    for (auto _ : state)
+    {
+        std::copy(payload.begin(),
+                  payload.end(),
+                  transport::BasicStreamEmitter(0, [&](std::uint8_t x) { last = x; benchmark::ClobberMemory(); })
+                      .begin());
+    }
+    benchmark::DoNotOptimize(last);
+    reportInput(state, payload, 1);
+}
+
+BENCHMARK_CAPTURE(benchBufferedEmitterGetNextByte, random,     InputKind::Random);
+BENCHMARK_CAPTURE(benchBufferedEmitterGetNextByte, all_escape, InputKind::AllEscape);
+BENCHMARK_CAPTURE(benchBufferedEmitterEmitInto,    random,     InputKind::Random);
+BENCHMARK_CAPTURE(benchBufferedEmitterEmitInto,    no_escape,  InputKind::NoEscape);
+BENCHMARK_CAPTURE(benchBufferedEmitterEmitInto,    all_escape, InputKind::AllEscape);
+BENCHMARK_CAPTURE(benchStreamEmitter,              random,     InputKind::Random);
+BENCHMARK_CAPTURE(benchStreamEmitter,              all_escape, InputKind::AllEscape);
+BENCHMARK_CAPTURE(benchBasicStreamEmitter,         random,     InputKind::Random);
+BENCHMARK_CAPTURE(benchBasicStreamEmitter,         all_escape, InputKind::AllEscape);
+
+/**
+ * Many small frames sent back to back, e.g. telemetry. The "writes" counter is the number of writes to the link
+ * per batch of frames: one per frame without coalescing, one per USB full-speed packet (64 bytes) with it.
+ */
+void benchTransmitSchedulerSmallFrames(benchmark::State& state)
+{
+    static constexpr std::size_t NumFrames = 64;
+    std::mt19937 rng(42);
+    std::vector<std::uint8_t> payload(12);
+    for (auto& x : payload)
+    {
+        x = std::uint8_t(rng());
+    }
+
+    transport::TransmitScheduler<2, 4096, 64> scheduler(64, std::chrono::microseconds(1000));
+    std::size_t writes = 0;
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < NumFrames; i++)
+        {
+            (void) scheduler.enqueue(i % 2U, 0, payload.data(), payload.size(), {});
+            while (true)
+            {
+                const auto block = scheduler.poll({});
+                if (block.empty())
+                {
+                    break;
+                }
+                benchmark::DoNotOptimize(block.data());
+                writes++;
+                bytes += block.size();
+            }
+        }
+        for (auto block = scheduler.flush(); !block.empty(); block = scheduler.flush())
+        {
+            benchmark::DoNotOptimize(block.data());
+            writes++;
+            bytes += block.size();
+        }
+    }
+
+    const auto iterations = double(std::max<std::int64_t>(1, std::int64_t(state.iterations())));
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * std::int64_t(NumFrames));
+    state.SetBytesProcessed(std::int64_t(bytes));
+    state.counters["writes"] = double(writes) / iterations;
+    state.counters["frames"] = double(NumFrames);
+}
+
+BENCHMARK(benchTransmitSchedulerSmallFrames);
+
+/*
+ * Transport layer: CRC
+ */
+void benchCRCByteByByte(benchmark::State& state)
+{
+    std::mt19937 rng(42);
+    const auto data = makePayload(InputKind::Random, rng);
+    for (auto _ : state)
+    {
+        transport::CRCComputer crc;
+        for (auto x : data)
+        {
+            crc.add(x);
+        }
+        benchmark::DoNotOptimize(crc.get());
+    }
+    reportInput(state, data, 1);
+}
+
+void benchCRCBlock(benchmark::State& state)
+{
+    std::mt19937 rng(42);
+    const auto data = makePayload(InputKind::Random, rng);
+    for (auto _ : state)
+    {
+        transport::CRCComputer crc;
+        crc.add(data.data(), data.size());
+        benchmark::DoNotOptimize(crc.get());
+    }
+    reportInput(state, data, 1);
+}
+
+template <std::size_t SlicingFactor>
+void benchCRCSoftware(benchmark::State& state)
+{
+    std::mt19937 rng(42);
+    const auto data = makePayload(InputKind::Random, rng);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(transport::detail_::updateCRC32CSoftware<SlicingFactor>(0xFFFFFFFFU,
+                                                                                         data.data(),
+                                                                                         data.size()));
+    }
+    reportInput(state, data, 1);
+}
+
+BENCHMARK(benchCRCByteByByte);
+BENCHMARK(benchCRCBlock);
+BENCHMARK_TEMPLATE(benchCRCSoftware, 1);
+BENCHMARK_TEMPLATE(benchCRCSoftware, 4);
+BENCHMARK_TEMPLATE(benchCRCSoftware, 8);
+
+/*
+ * Standard messages. Every message is populated to its maximum size.
+ */
+template <typename T> T makeSampleMessage() { return T(); }
+
+template <>
+standard::EndpointInfoMessage makeSampleMessage<standard::EndpointInfoMessage>()
+{
+    standard::EndpointInfoMessage msg;
+    msg.software_version.image_crc = 0xDEADBEEFBADC0FFEULL;
+    msg.software_version.vcs_commit_id = 0xDEADBEEFU;
+    msg.software_version.major = 1;
+    msg.hardware_version.major = 2;
+    while (msg.endpoint_name.length() < msg.endpoint_name.max_size())
+    {
+        msg.endpoint_name.push_back('n');
+        msg.endpoint_description.push_back('d');
+        msg.build_environment_description.push_back('b');
+        msg.runtime_environment_description.push_back('r');
+    }
+    while (msg.certificate_of_authenticity.size() < msg.certificate_of_authenticity.max_size())
+    {
+        msg.certificate_of_authenticity.push_back(std::uint8_t(msg.certificate_of_authenticity.size()));
+    }
+    return msg;
+}
+
+template <typename T>
+void fillRegisterName(T& msg)
+{
+    while (msg.name.length() < msg.name.max_size())
+    {
+        msg.name.push_back('z');
+    }
+}
+
+template <>
+standard::RegisterDataRequestMessage makeSampleMessage<standard::RegisterDataRequestMessage>()
+{
+    standard::RegisterDataRequestMessage msg;
+    fillRegisterName(msg);
+    msg.value.emplace<standard::RegisterValue::F32>(64, 3.14F);
+    return msg;
+}
+
+template <>
+standard::RegisterDiscoveryResponseMessage makeSampleMessage<standard::RegisterDiscoveryResponseMessage>()
+{
+    standard::RegisterDiscoveryResponseMessage msg;
+    msg.index = 123;
+    fillRegisterName(msg);
+    return msg;
+}
+
+template <typename T>
+T makeSampleImageDataMessage()
+{
+    T msg;
+    msg.image_offset = 0x12345678;
+    msg.image_data.resize(msg.image_data.max_size());
+    return msg;
+}
+
+template <>
+standard::BootloaderImageDataRequestMessage makeSampleMessage<standard::BootloaderImageDataRequestMessage>()
+{
+    return makeSampleImageDataMessage<standard::BootloaderImageDataRequestMessage>();
+}
+
+template <>
+standard::BootloaderImageDataResponseMessage makeSampleMessage<standard::BootloaderImageDataResponseMessage>()
+{
+    return makeSampleImageDataMessage<standard::BootloaderImageDataResponseMessage>();
+}
+
+/// The largest image data chunk that fits into the default parser
+using LargeBootloaderImageDataRequestMessage =
+    standard::BasicBootloaderImageDataRequestMessage<standard::computeMaxBootloaderImageDataSize(2048)>;
+
+template <>
+LargeBootloaderImageDataRequestMessage makeSampleMessage<LargeBootloaderImageDataRequestMessage>()
+{
+    return makeSampleImageDataMessage<LargeBootloaderImageDataRequestMessage>();
+}
+
+/**
+ * Register data response with a value of the specified type ID, populated to the maximum capacity.
+ */
+template <std::uint8_t TypeID>
+standard::RegisterDataResponseMessage makeSampleRegisterDataResponse()
+{
+    using Type = standard::RegisterValue::VariantTypeAtIndex<TypeID>;
+    standard::RegisterDataResponseMessage msg;
+    fillRegisterName(msg);
+    auto& value = msg.value.emplace<TypeID>();
+    if constexpr (!std::is_same_v<Type, standard::RegisterValue::Empty>)
+    {
+        while (value.size() < value.max_size())
+        {
+            value.push_back(typename Type::value_type(1));
+        }
+    }
+    return msg;
+}
+
+void reportMessageFootprint(benchmark::State& state, const std::size_t object_size, const std::size_t encoded_size)
+{
+    state.counters["object_size"] = double(object_size);
+    state.counters["encoded_size"] = double(encoded_size);
+}
+
+template <typename T>
+void benchEncodeImpl(benchmark::State& state, const T& msg)
+{
+    std::array<std::uint8_t, 2048> buffer{};             // Fits the largest sample message
+    std::size_t size = 0;
+    for (auto _ : state)
+    {
+        size = msg.encode(buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(size));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+    reportMessageFootprint(state, sizeof(T), size);
+}
+
+template <typename T>
+void benchDecodeImpl(benchmark::State& state, const T& msg)
+{
+    std::array<std::uint8_t, 2048> buffer{};             // Fits the largest sample message
+    const std::size_t size = msg.encode(buffer.data());
+    for (auto _ : state)
+    {
+        auto decoded = T::tryDecode(buffer.begin(), buffer.begin() + std::ptrdiff_t(size));
+        if (!decoded)
+        {
+            state.SkipWithError("Could not decode the message");
+            break;
+        }
+        benchmark::DoNotOptimize(decoded);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(size));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+    reportMessageFootprint(state, sizeof(T), size);
+}
+
+template <typename T> void benchEncode(benchmark::State& state) { benchEncodeImpl(state, makeSampleMessage<T>()); }
+template <typename T> void benchDecode(benchmark::State& state) { benchDecodeImpl(state, makeSampleMessage<T>()); }
+
+template <std::uint8_t TypeID>
+void benchEncodeRegisterValue(benchmark::State& state)
+{
+    benchEncodeImpl(state, makeSampleRegisterDataResponse<TypeID>());
+}
+
+template <std::uint8_t TypeID>
+void benchDecodeRegisterValue(benchmark::State& state)
+{
+    benchDecodeImpl(state, makeSampleRegisterDataResponse<TypeID>());
+}
+
+#define POPCOP_BENCHMARK_MESSAGE(T)             \
+    BENCHMARK_TEMPLATE(benchEncode, T);         \
+    BENCHMARK_TEMPLATE(benchDecode, T)
+
+POPCOP_BENCHMARK_MESSAGE(standard::EndpointInfoMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::RegisterDataRequestMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::RegisterDiscoveryRequestMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::RegisterDiscoveryResponseMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::DeviceManagementCommandRequestMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::DeviceManagementCommandResponseMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::BootloaderStatusRequestMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::BootloaderStatusResponseMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::BootloaderImageDataRequestMessage);
+POPCOP_BENCHMARK_MESSAGE(standard::BootloaderImageDataResponseMessage);
+POPCOP_BENCHMARK_MESSAGE(LargeBootloaderImageDataRequestMessage);
+
+/*
+ * Register data response messages with every register value type (the type ID is in the benchmark name).
+ */
+#define POPCOP_BENCHMARK_REGISTER_VALUE(type_id)                \
+    BENCHMARK_TEMPLATE(benchEncodeRegisterValue, type_id);      \
+    BENCHMARK_TEMPLATE(benchDecodeRegisterValue, type_id)
+
+POPCOP_BENCHMARK_REGISTER_VALUE(0);
+POPCOP_BENCHMARK_REGISTER_VALUE(1);
+POPCOP_BENCHMARK_REGISTER_VALUE(2);
+POPCOP_BENCHMARK_REGISTER_VALUE(3);
+POPCOP_BENCHMARK_REGISTER_VALUE(4);
+POPCOP_BENCHMARK_REGISTER_VALUE(5);
+POPCOP_BENCHMARK_REGISTER_VALUE(6);
+POPCOP_BENCHMARK_REGISTER_VALUE(7);
+POPCOP_BENCHMARK_REGISTER_VALUE(8);
+POPCOP_BENCHMARK_REGISTER_VALUE(9);
+POPCOP_BENCHMARK_REGISTER_VALUE(10);
+POPCOP_BENCHMARK_REGISTER_VALUE(11);
+POPCOP_BENCHMARK_REGISTER_VALUE(12);
+POPCOP_BENCHMARK_REGISTER_VALUE(13);
+
+static_assert(standard::RegisterValue::NumberOfVariants == 14, "Please update the benchmarks");
+
+/*
+ * A 50-field application-specific telemetry structure encoded manually and with presentation::FieldCodec.
+ */
+#define POPCOP_TELEMETRY_GROUP(n)   \
+    std::uint64_t u64_##n = n;      \
+    float f32_##n = n;              \
+    std::int16_t i16_##n = -n;      \
+    std::uint8_t u8_##n = n;        \
+    std::uint32_t u32_##n = n;
+
+struct Telemetry
+{
+    POPCOP_TELEMETRY_GROUP(0) POPCOP_TELEMETRY_GROUP(1) POPCOP_TELEMETRY_GROUP(2) POPCOP_TELEMETRY_GROUP(3)
+    POPCOP_TELEMETRY_GROUP(4) POPCOP_TELEMETRY_GROUP(5) POPCOP_TELEMETRY_GROUP(6) POPCOP_TELEMETRY_GROUP(7)
+    POPCOP_TELEMETRY_GROUP(8) POPCOP_TELEMETRY_GROUP(9)
+};
+
+#define POPCOP_TELEMETRY_FIELDS(n)                  \
+    presentation::Field<&Telemetry::u64_##n>,       \
+    presentation::Field<&Telemetry::f32_##n>,       \
+    presentation::Field<&Telemetry::i16_##n>,       \
+    presentation::Field<&Telemetry::u8_##n>,        \
+    presentation::Field<&Telemetry::u32_##n>
+
+using TelemetryCodec = presentation::FieldCodec<Telemetry,
+    POPCOP_TELEMETRY_FIELDS(0), POPCOP_TELEMETRY_FIELDS(1), POPCOP_TELEMETRY_FIELDS(2), POPCOP_TELEMETRY_FIELDS(3),
+    POPCOP_TELEMETRY_FIELDS(4), POPCOP_TELEMETRY_FIELDS(5), POPCOP_TELEMETRY_FIELDS(6), POPCOP_TELEMETRY_FIELDS(7),
+    POPCOP_TELEMETRY_FIELDS(8), POPCOP_TELEMETRY_FIELDS(9)>;
+
+static_assert(TelemetryCodec::Descriptors.size() == 50);
+
+#define POPCOP_TELEMETRY_ENCODE(n)      \
+    encoder.addU64(t.u64_##n);          \
+    encoder.addF32(t.f32_##n);          \
+    encoder.addI16(t.i16_##n);          \
+    encoder.addU8(t.u8_##n);            \
+    encoder.addU32(t.u32_##n);
+
+#define POPCOP_TELEMETRY_DECODE(n)      \
+    t.u64_##n = decoder.fetchU64();     \
+    t.f32_##n = decoder.fetchF32();     \
+    t.i16_##n = decoder.fetchI16();     \
+    t.u8_##n  = decoder.fetchU8();      \
+    t.u32_##n = decoder.fetchU32();
+
+void benchTelemetryEncodeManual(benchmark::State& state)
+{
+    const Telemetry t;
+    std::array<std::uint8_t, TelemetryCodec::EncodedSize> buffer{};
+    for (auto _ : state)
+    {
+        presentation::StreamEncoder encoder(buffer.data());
+        POPCOP_TELEMETRY_ENCODE(0) POPCOP_TELEMETRY_ENCODE(1) POPCOP_TELEMETRY_ENCODE(2) POPCOP_TELEMETRY_ENCODE(3)
+        POPCOP_TELEMETRY_ENCODE(4) POPCOP_TELEMETRY_ENCODE(5) POPCOP_TELEMETRY_ENCODE(6) POPCOP_TELEMETRY_ENCODE(7)
+        POPCOP_TELEMETRY_ENCODE(8) POPCOP_TELEMETRY_ENCODE(9)
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(buffer.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+
+void benchTelemetryDecodeManual(benchmark::State& state)
+{
+    std::array<std::uint8_t, TelemetryCodec::EncodedSize> buffer{};
+    TelemetryCodec::encode(Telemetry(), buffer.data());
+    for (auto _ : state)
+    {
+        Telemetry t;
+        presentation::StreamDecoder decoder(buffer.begin(), buffer.end());
+        POPCOP_TELEMETRY_DECODE(0) POPCOP_TELEMETRY_DECODE(1) POPCOP_TELEMETRY_DECODE(2) POPCOP_TELEMETRY_DECODE(3)
+        POPCOP_TELEMETRY_DECODE(4) POPCOP_TELEMETRY_DECODE(5) POPCOP_TELEMETRY_DECODE(6) POPCOP_TELEMETRY_DECODE(7)
+        POPCOP_TELEMETRY_DECODE(8) POPCOP_TELEMETRY_DECODE(9)
+        benchmark::DoNotOptimize(t);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(buffer.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+
+void benchTelemetryEncodeCodec(benchmark::State& state)
+{
+    const Telemetry t;
+    std::array<std::uint8_t, TelemetryCodec::EncodedSize> buffer{};
+    for (auto _ : state)
+    {
+        TelemetryCodec::encode(t, buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(buffer.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+
+void benchTelemetryDecodeCodec(benchmark::State& state)
+{
+    std::array<std::uint8_t, TelemetryCodec::EncodedSize> buffer{};
+    TelemetryCodec::encode(Telemetry(), buffer.data());
+    for (auto _ : state)
+    {
+        Telemetry t;
+        TelemetryCodec::decode(t, buffer.data());
+        benchmark::DoNotOptimize(t);
+    }
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(buffer.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()));
+}
+
+BENCHMARK(benchTelemetryEncodeManual);
+BENCHMARK(benchTelemetryDecodeManual);
+BENCHMARK(benchTelemetryEncodeCodec);
+BENCHMARK(benchTelemetryDecodeCodec);
+
+/**
+ * Object sizes of the transport layer entities, which are typically allocated statically or on the stack.
+ */
+void reportTransportFootprint()
+{
+    const auto add = [](const std::string& name, const std::size_t size)
+    {
+        benchmark::AddCustomContext("sizeof(" + name + ")", std::to_string(size));
+    };
+
+    add("transport::Parser<>", sizeof(transport::Parser<>));
+    add("transport::Parser<1024>", sizeof(transport::Parser<1024>));
+    add("transport::ExternalBufferParser<128, 4>", sizeof(transport::ExternalBufferParser<128, 4>));
+    add("transport::ParserOutput", sizeof(transport::ParserOutput));
+    add("transport::BufferedEmitter", sizeof(transport::BufferedEmitter));
+    add("transport::StreamEmitter", sizeof(transport::StreamEmitter));
+    add("transport::CRCComputer", sizeof(transport::CRCComputer));
+    add("standard::RegisterValue", sizeof(standard::RegisterValue));
+}
+
+/**
+ * Memory footprint of every standard message, see standard::footprint<>().
+ */
+template <typename Message>
+void addMessageFootprint(const std::string& name)
+{
+    constexpr auto f = standard::footprint<Message>();
+    benchmark::AddCustomContext("footprint(standard::" + name + ")",
+                                "object " + std::to_string(f.object_size) +
+                                ", encoded <= " + std::to_string(f.max_encoded_size) +
+                                ", encode buffer " + std::to_string(f.encode_buffer_size) +
+                                ", decode temporaries " + std::to_string(f.decode_temporary_size) +
+                                ", peak " + std::to_string(f.getPeakSize()));
+}
+
+void reportMessageFootprint()
+{
+    using namespace standard;
+    addMessageFootprint<EndpointInfoMessage>("EndpointInfoMessage");
+    addMessageFootprint<RegisterDataRequestMessage>("RegisterDataRequestMessage");
+    addMessageFootprint<RegisterDataResponseMessage>("RegisterDataResponseMessage");
+    addMessageFootprint<RegisterDiscoveryRequestMessage>("RegisterDiscoveryRequestMessage");
+    addMessageFootprint<RegisterDiscoveryResponseMessage>("RegisterDiscoveryResponseMessage");
+    addMessageFootprint<RegisterTraceSetupRequestMessage>("RegisterTraceSetupRequestMessage");
+    addMessageFootprint<RegisterTraceSetupResponseMessage>("RegisterTraceSetupResponseMessage");
+    addMessageFootprint<RegisterTraceEventMessage>("RegisterTraceEventMessage");
+    addMessageFootprint<DeviceManagementCommandRequestMessage>("DeviceManagementCommandRequestMessage");
+    addMessageFootprint<DeviceManagementCommandResponseMessage>("DeviceManagementCommandResponseMessage");
+    addMessageFootprint<BootloaderStatusRequestMessage>("BootloaderStatusRequestMessage");
+    addMessageFootprint<BootloaderStatusResponseMessage>("BootloaderStatusResponseMessage");
+    addMessageFootprint<BootloaderImageDataRequestMessage>("BootloaderImageDataRequestMessage");
+    addMessageFootprint<BootloaderImageDataResponseMessage>("BootloaderImageDataResponseMessage");
+    addMessageFootprint<RegisterBatchDataRequestMessage>("RegisterBatchDataRequestMessage");
+    addMessageFootprint<RegisterBatchDataResponseMessage>("RegisterBatchDataResponseMessage");
+    addMessageFootprint<RegisterIndexedDataRequestMessage>("RegisterIndexedDataRequestMessage");
+    addMessageFootprint<RegisterIndexedDataResponseMessage>("RegisterIndexedDataResponseMessage");
+    addMessageFootprint<BootloaderImageDigestRequestMessage>("BootloaderImageDigestRequestMessage");
+    addMessageFootprint<BootloaderImageDigestResponseMessage>("BootloaderImageDigestResponseMessage");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    reportTransportFootprint();
+    reportMessageFootprint();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -28,14 +28,27 @@
 # undef NDEBUG
 #endif
 
+// Every standard message is checked against this stack budget at compile time
+#define POPCOP_STANDARD_FOOTPRINT_BUDGET 65536
+
 // The library should be included first in order to ensure that all necessary headers are included in the library itself
 #include <popcop.hpp>
+#include <popcop_host.hpp>
+#ifdef __linux__
+# include <popcop_linux.hpp>
+#endif
 
 // Test-only dependencies
 #include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <deque>
+#include <random>
 #include <cmath>
+#ifdef __linux__
+# include <poll.h>
+#endif
 
 // Note that we should NOT define CATCH_CONFIG_MAIN in the same translation unit which also contains tests;
 // that slows things down.
@@ -564,6 +577,269 @@ TEST_CASE("EmitterParserLoop-slow")
 }
 
 
+TEST_CASE("BufferedEmitterBlock")
+{
+    std::srand(unsigned(std::time(nullptr)));
+
+    for (int iteration = 0; iteration < 1000; iteration++)
+    {
+        const auto payload = getRandomNumberOfRandomBytes();
+        const auto frame_type_code = getRandomByte();
+
+        std::vector<std::uint8_t> reference;
+        {
+            transport::BufferedEmitter emitter(frame_type_code, payload.data(), payload.size());
+            do
+            {
+                reference.push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+        }
+
+        std::vector<std::uint8_t> output;
+        transport::BufferedEmitter emitter(frame_type_code, payload.data(), payload.size());
+        while (!emitter.isFinished())
+        {
+            // Mixing the block API with the byte API to make sure that they can resume each other
+            if (getRandomByte() < 16)
+            {
+                output.push_back(emitter.getNextByte());
+            }
+            else
+            {
+                std::array<std::uint8_t, 300> buffer{};
+                const std::size_t capacity = getRandomByte() + std::size_t(getRandomBit() ? 0U : 45U);
+                const std::size_t size = emitter.emitInto(buffer.data(), capacity);
+                REQUIRE(size <= capacity);
+                REQUIRE(((size == capacity) || emitter.isFinished()));
+                output.insert(output.end(), buffer.begin(), buffer.begin() + std::ptrdiff_t(size));
+            }
+        }
+
+        REQUIRE(output == reference);
+
+        std::array<std::uint8_t, 8> buffer{};
+        REQUIRE(emitter.emitInto(buffer.data(), buffer.size()) == 0);
+    }
+}
+
+
+/**
+ * A sink that supports the optional bulk write method and counts the calls.
+ */
+struct BulkSinkMock
+{
+    std::vector<std::uint8_t>& output;
+    std::size_t& bulk_write_count;
+
+    void operator()(const std::uint8_t byte) { output.push_back(byte); }
+
+    void write(const std::uint8_t* data, std::size_t size)
+    {
+        REQUIRE(size > 0);
+        REQUIRE(std::none_of(data, data + size, [](std::uint8_t x) {
+            return (x == transport::FrameDelimiter) || (x == transport::EscapeCharacter);
+        }));
+        output.insert(output.end(), data, data + size);
+        bulk_write_count++;
+    }
+};
+
+
+TEST_CASE("BasicStreamEmitter")
+{
+    using transport::FrameDelimiter;
+    using transport::EscapeCharacter;
+
+    static_assert(!transport::detail_::HasBulkWrite<std::function<void (std::uint8_t)>>::value);
+    static_assert(transport::detail_::HasBulkWrite<BulkSinkMock>::value);
+
+    std::vector<std::uint8_t> output;
+    std::size_t bulk_write_count = 0;
+
+    SECTION("simple")
+    {
+        const auto payload = makeArray(42, 12, 34, FrameDelimiter, 56, 78);
+        const auto reference = makeArray(FrameDelimiter, 42, 12, 34, EscapeCharacter, ~FrameDelimiter, 56, 78,
+                                         90, 0xE1, 0xAE, 0x2A, 0x59, FrameDelimiter);
+        {
+            const transport::BasicStreamEmitter emitter(90, [&](std::uint8_t x) { output.push_back(x); });
+            std::copy(payload.begin(), payload.end(), emitter.begin());
+        }
+        REQUIRE(std::equal(output.begin(), output.end(), reference.begin(), reference.end()));
+
+        output.clear();
+        transport::BasicStreamEmitter(90, BulkSinkMock{output, bulk_write_count}).write(payload.data(),
+                                                                                      payload.size());
+        REQUIRE(std::equal(output.begin(), output.end(), reference.begin(), reference.end()));
+        REQUIRE(bulk_write_count == 2);
+    }
+
+    SECTION("random")
+    {
+        std::srand(unsigned(std::time(nullptr)));
+
+        for (int iteration = 0; iteration < 1000; iteration++)
+        {
+            const auto payload = getRandomNumberOfRandomBytes();
+            const auto frame_type_code = getRandomByte();
+
+            std::vector<std::uint8_t> reference;
+            {
+                transport::BufferedEmitter emitter(frame_type_code, payload.data(), payload.size());
+                do
+                {
+                    reference.push_back(emitter.getNextByte());
+                }
+                while (!emitter.isFinished());
+            }
+
+            output.clear();
+            std::copy(payload.begin(),
+                      payload.end(),
+                      transport::StreamEmitter(frame_type_code, [&](std::uint8_t x) { output.push_back(x); }).begin());
+            REQUIRE(output == reference);
+
+            // Mixing the bulk API with the iterator API
+            output.clear();
+            {
+                const transport::BasicStreamEmitter emitter(frame_type_code, BulkSinkMock{output, bulk_write_count});
+                const std::size_t split = payload.empty() ? 0 : (getRandomByte() % payload.size());
+                emitter.write(payload.data(), split);
+                std::copy(payload.begin() + std::ptrdiff_t(split), payload.end(), emitter.begin());
+            }
+            REQUIRE(output == reference);
+        }
+    }
+}
+
+
+/**
+ * Mimics POSIX iovec in order to keep the test portable.
+ */
+struct IOVectorMock
+{
+    void* iov_base = nullptr;
+    std::size_t iov_len = 0;
+};
+
+
+TEST_CASE("BufferedEmitterScatterGather")
+{
+    std::srand(unsigned(std::time(nullptr)));
+
+    for (int iteration = 0; iteration < 1000; iteration++)
+    {
+        std::vector<std::vector<std::uint8_t>> parts(getRandomByte() % 5U);
+        std::vector<transport::BufferedEmitter::PayloadSegment> segments;
+        std::vector<std::uint8_t> payload;
+        for (auto& p : parts)
+        {
+            p = getRandomBit() ? getRandomNumberOfRandomBytes() : std::vector<std::uint8_t>();  // Empty ones too
+            segments.push_back({p.data(), p.size()});
+            payload.insert(payload.end(), p.begin(), p.end());
+        }
+        const auto frame_type_code = getRandomByte();
+
+        std::vector<std::uint8_t> reference;
+        {
+            transport::BufferedEmitter emitter(frame_type_code, payload.data(), payload.size());
+            do
+            {
+                reference.push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+        }
+
+        const auto* const segments_begin = segments.data();
+        const auto* const segments_end = segments.data() + segments.size();
+
+        {
+            std::vector<std::uint8_t> output;
+            transport::BufferedEmitter emitter(frame_type_code, segments_begin, segments_end);
+            do
+            {
+                output.push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+            REQUIRE(output == reference);
+        }
+
+        {
+            std::vector<std::uint8_t> output(reference.size() + 10);
+            transport::BufferedEmitter emitter(frame_type_code, segments_begin, segments_end);
+            REQUIRE(emitter.emitInto(output.data(), output.size()) == reference.size());
+            output.resize(reference.size());
+            REQUIRE(output == reference);
+        }
+
+        {
+            std::vector<std::uint8_t> output;
+            transport::BufferedEmitter emitter(frame_type_code, segments_begin, segments_end);
+            while (true)
+            {
+                std::array<IOVectorMock, 16> vectors{};
+                std::array<std::uint8_t, 32> scratch{};
+                const std::size_t num_vectors = emitter.emitIOVectors(vectors.data(),
+                                                                      1U + (getRandomByte() % vectors.size()),
+                                                                      scratch.data(),
+                                                                      getRandomByte() % scratch.size());
+                if ((num_vectors == 0) && emitter.isFinished())
+                {
+                    break;
+                }
+
+                for (std::size_t i = 0; i < num_vectors; i++)
+                {
+                    const auto* const base = static_cast<const std::uint8_t*>(vectors[i].iov_base);
+                    REQUIRE(vectors[i].iov_len > 0);
+                    output.insert(output.end(), base, base + vectors[i].iov_len);
+                }
+            }
+            REQUIRE(output == reference);
+        }
+    }
+
+    // Bootloader image data emitted directly from the source memory
+    std::array<std::uint8_t, 256> image{};
+    for (auto& x : image)
+    {
+        x = getRandomByte();
+    }
+
+    standard::BootloaderImageDataResponseMessage msg;
+    msg.image_offset = 123456;
+    msg.image_type = standard::BootloaderImageType::CertificateOfAuthenticity;
+    msg.image_data = senoval::Vector<std::uint8_t, 256>(image.begin(), image.end());
+    const auto encoded = msg.encode();
+
+    const auto head = standard::BootloaderImageDataResponseMessage::encodeFixedPart(msg.image_offset, msg.image_type);
+    REQUIRE(std::equal(head.begin(), head.end(), encoded.begin()));
+
+    const transport::BufferedEmitter::PayloadSegment segments[] =
+    {
+        { head.data(), head.size() },
+        { image.data(), image.size() },
+    };
+
+    transport::Parser<> parser;
+    transport::BufferedEmitter emitter(presentation::StandardFrameTypeCode, std::begin(segments), std::end(segments));
+    transport::ParserOutput out;
+    while (!emitter.isFinished())
+    {
+        out = parser.processNextByte(emitter.getNextByte());
+    }
+    REQUIRE(out.getReceivedFrame() != nullptr);
+    const auto decoded = standard::BootloaderImageDataResponseMessage::tryDecode(
+        out.getReceivedFrame()->payload.begin(),
+        out.getReceivedFrame()->payload.end());
+    REQUIRE(decoded);
+    REQUIRE(decoded->image_offset == msg.image_offset);
+    REQUIRE(decoded->image_type == msg.image_type);
+    REQUIRE(decoded->image_data == msg.image_data);
+}
+
+
 TEST_CASE("ParserMaxPacketLength")
 {
     transport::Parser<1024> parser;
@@ -635,118 +911,1415 @@ TEST_CASE("ParserOverflow")
 }
 
 
-TEST_CASE("CRC")
+/**
+ * Flattened parser output that can be stored and compared later, unlike ParserOutput.
+ */
+struct RecordedParserOutput
 {
-    transport::CRCComputer crc;
+    bool is_frame = false;
+    std::uint8_t type_code = 0;
+    std::vector<std::uint8_t> data;
 
-    REQUIRE(crc.get() == 0);
-    REQUIRE(!crc.isResidueCorrect());
+    explicit RecordedParserOutput(const transport::ParserOutput& o)
+    {
+        if (auto f = o.getReceivedFrame())
+        {
+            is_frame = true;
+            type_code = f->type_code;
+            data.assign(f->payload.begin(), f->payload.end());
+        }
+        else if (auto e = o.getExtraneousData())
+        {
+            data.assign(e->begin(), e->end());
+        }
+        else
+        {
+            FAIL("Empty outputs should not be recorded");
+        }
+    }
 
-    crc.add('1');
-    crc.add('2');
-    crc.add('3');
-    crc.add('4');
-    crc.add('5');
-    crc.add('6');
-    crc.add('7');
-    crc.add('8');
-    crc.add('9');
+    bool operator==(const RecordedParserOutput& rhs) const
+    {
+        return (is_frame == rhs.is_frame) && (type_code == rhs.type_code) && (data == rhs.data);
+    }
+};
 
-    REQUIRE(crc.get() == 0xE3069283);
-    REQUIRE(!crc.isResidueCorrect());
 
-    crc.add(0x83);
-    crc.add(0x92);
-    crc.add(0x06);
-    crc.add(0xE3);
+template <std::size_t ParserBufferSize, typename Instrumentation>
+inline std::vector<RecordedParserOutput> parseByteByByte(transport::Parser<ParserBufferSize, Instrumentation>& parser,
+                                                         const std::vector<std::uint8_t>& input)
+{
+    std::vector<RecordedParserOutput> out;
+    for (auto x : input)
+    {
+        const auto o = parser.processNextByte(x);
+        if ((o.getReceivedFrame() != nullptr) || (o.getExtraneousData() != nullptr))
+        {
+            out.emplace_back(o);
+        }
+    }
+    return out;
+}
 
-    REQUIRE(crc.isResidueCorrect());
+
+template <std::size_t ParserBufferSize, typename Instrumentation>
+inline std::vector<RecordedParserOutput> parseInRandomChunks(transport::Parser<ParserBufferSize, Instrumentation>& parser,
+                                                             const std::vector<std::uint8_t>& input)
+{
+    std::vector<RecordedParserOutput> out;
+    std::size_t offset = 0;
+    while (offset < input.size())
+    {
+        const std::size_t chunk = std::min<std::size_t>(input.size() - offset,
+                                                        std::size_t(getRandomByte()) * std::size_t(getRandomByte()));
+        parser.processBytes(input.data() + offset, chunk, [&](const transport::ParserOutput& o)
+        {
+            REQUIRE(((o.getReceivedFrame() != nullptr) || (o.getExtraneousData() != nullptr)));
+            if (auto f = o.getReceivedFrame())
+            {
+                REQUIRE((reinterpret_cast<std::uintptr_t>(f->payload.data()) %
+                         transport::ParserBufferAlignment) == 0);
+            }
+            out.emplace_back(o);
+        });
+        offset += chunk;
+    }
+    return out;
 }
 
 
-TEST_CASE("StreamEncoder")
+TEST_CASE("ParserBulk")
 {
-    senoval::Vector<std::uint8_t, 100> vec;
-    presentation::StreamEncoder encoder(std::back_inserter(vec));
+    using transport::FrameDelimiter;
+    using transport::EscapeCharacter;
 
-    REQUIRE(encoder.getOffset() == 0);
-    REQUIRE(vec.size() == 0);
+    transport::Parser<1024> reference;
+    transport::Parser<1024> bulk;
 
-    encoder.addU8(123U);
-    encoder.addI8(-123);
-    REQUIRE(encoder.getOffset() == 2);
-    REQUIRE(vec.size() == 2);
-    REQUIRE(vec[0] == 123);
-    REQUIRE(vec[1] == 133);     // as unsigned
+    SECTION("simple")
+    {
+        const std::vector<std::uint8_t> input{
+            FrameDelimiter, 42, 12, 34, 56, 78, 90, 0xCE, 0x4E, 0x88, 0xBC, FrameDelimiter,
+            'H', 'e', 'l', 'l', 'o', '!', FrameDelimiter,
+            EscapeCharacter, FrameDelimiter ^ 0xFF, EscapeCharacter, EscapeCharacter ^ 0xFF,
+            0x91, 0x5C, 0xA9, 0xC0, FrameDelimiter,
+        };
+
+        const auto out = parseInRandomChunks(bulk, input);
+        REQUIRE(out.size() == 3);
+        REQUIRE(out.at(0).is_frame);
+        REQUIRE(out.at(0).type_code == 90);
+        REQUIRE(out.at(0).data == std::vector<std::uint8_t>{42, 12, 34, 56, 78});
+        REQUIRE(!out.at(1).is_frame);
+        REQUIRE(out.at(1).data == std::vector<std::uint8_t>{'H', 'e', 'l', 'l', 'o', '!'});
+        REQUIRE(out.at(2).is_frame);
+        REQUIRE(out.at(2).type_code == EscapeCharacter);
+        REQUIRE(out.at(2).data == std::vector<std::uint8_t>{FrameDelimiter});
+        REQUIRE(out == parseByteByByte(reference, input));
+    }
 
-    encoder.addI16(-30000);
-    encoder.addU16(30000U);
-    REQUIRE(encoder.getOffset() == 6);
-    REQUIRE(vec.size() == 6);
-    REQUIRE(vec[0] == 123);
-    REQUIRE(vec[1] == 133);
-    REQUIRE(vec[2] == 208);
-    REQUIRE(vec[3] == 138);
-    REQUIRE(vec[4] == 48);
-    REQUIRE(vec[5] == 117);
+    SECTION("overflow")
+    {
+        std::vector<std::uint8_t> input;
+        for (unsigned i = 1; i < 5000; i++)
+        {
+            input.push_back(std::uint8_t(i & 0x7FU));
+            if (i % 1500 == 0)
+            {
+                input.push_back(EscapeCharacter);   // Escaped bytes should not shift the overflow point
+            }
+        }
 
-    encoder.fillUpToOffset(9, 42);
-    REQUIRE(encoder.getOffset() == 9);
-    REQUIRE(vec.size() == 9);
-    REQUIRE(vec[0] == 123);
-    REQUIRE(vec[1] == 133);
-    REQUIRE(vec[2] == 208);
-    REQUIRE(vec[3] == 138);
-    REQUIRE(vec[4] == 48);
-    REQUIRE(vec[5] == 117);
-    REQUIRE(vec[6] == 42);
-    REQUIRE(vec[7] == 42);
-    REQUIRE(vec[8] == 42);
+        const auto out = parseInRandomChunks(bulk, input);
+        REQUIRE(out.size() == 4);
+        REQUIRE(out.at(0).data.size() == 1030);
+        REQUIRE(out == parseByteByByte(reference, input));
+    }
 
-    encoder.addBytes(makeArray(1, 2, 3, 4, 5, 6));
-    REQUIRE(encoder.getOffset() == 15);
-    REQUIRE(vec.size() == 15);
-    REQUIRE(vec[6] == 42);
-    REQUIRE(vec[7] == 42);
-    REQUIRE(vec[8] == 42);
-    REQUIRE(vec[9] == 1);
-    REQUIRE(vec[10] == 2);
-    REQUIRE(vec[11] == 3);
-    REQUIRE(vec[12] == 4);
-    REQUIRE(vec[13] == 5);
-    REQUIRE(vec[14] == 6);
+    SECTION("random")
+    {
+        std::srand(unsigned(std::time(nullptr)));
 
-    encoder.addI32(-30000000);
-    encoder.addU32(30000000U);      // 00000001 11001001 11000011 10000000
-    REQUIRE(encoder.getOffset() == 23);
-    REQUIRE(vec.size() == 23);
-    REQUIRE(vec[15] == 128);
-    REQUIRE(vec[16] == 60);
-    REQUIRE(vec[17] == 54);
-    REQUIRE(vec[18] == 254);
-    REQUIRE(vec[19] == 0b10000000);
-    REQUIRE(vec[20] == 0b11000011);
-    REQUIRE(vec[21] == 0b11001001);
-    REQUIRE(vec[22] == 0b00000001);
+        for (int iteration = 0; iteration < 100; iteration++)
+        {
+            std::vector<std::uint8_t> input;
+            for (int i = 0; i < 10; i++)
+            {
+                const auto extraneous = getRandomNumberOfRandomBytes();
+                input.insert(input.end(), extraneous.begin(), extraneous.end());
 
-    encoder.addI64(-30000000010LL);
-    encoder.addU64(30000000010ULL);      // 00000000 00000000 00000000 00000110 11111100 00100011 10101100 00001010
-    REQUIRE(encoder.getOffset() == 39);
-    REQUIRE(vec.size() == 39);
-    REQUIRE(vec[23] == 246);
-    REQUIRE(vec[24] == 83);
-    REQUIRE(vec[25] == 220);
-    REQUIRE(vec[26] == 3);
-    REQUIRE(vec[27] == 249);
-    REQUIRE(vec[28] == 255);
-    REQUIRE(vec[29] == 255);
-    REQUIRE(vec[30] == 255);
-    // the unsigned starts here
-    REQUIRE(vec[31] == 0b00001010);
-    REQUIRE(vec[32] == 0b10101100);
-    REQUIRE(vec[33] == 0b00100011);
-    REQUIRE(vec[34] == 0b11111100);
-    REQUIRE(vec[35] == 0b00000110);
+                const auto payload = getRandomNumberOfRandomBytes();
+                transport::BufferedEmitter emitter(getRandomByte(), payload.data(), payload.size());
+                do
+                {
+                    input.push_back(emitter.getNextByte());
+                }
+                while (!emitter.isFinished());
+            }
+
+            REQUIRE(parseInRandomChunks(bulk, input) == parseByteByByte(reference, input));
+        }
+    }
+}
+
+
+TEST_CASE("SpecialCharacterSearch")
+{
+    using transport::detail_::findNextSpecialCharacter;
+    using transport::detail_::findNextSpecialCharacterPortable;
+    using transport::detail_::isSpecialCharacter;
+
+    std::srand(unsigned(std::time(nullptr)));
+
+    // Every length and alignment around the vector sizes, special characters at every position
+    std::array<std::uint8_t, 256> data{};
+    for (int iteration = 0; iteration < 20000; iteration++)
+    {
+        for (auto& x : data)
+        {
+            x = std::uint8_t(getRandomByte() & 0x7FU);
+        }
+        for (int i = getRandomByte() % 4; i > 0; i--)
+        {
+            data.at(getRandomByte()) = getRandomBit() ? transport::FrameDelimiter : transport::EscapeCharacter;
+        }
+        data.at(getRandomByte()) = 0x8F;       // Neither of the special characters, differs in another bit
+
+        const std::uint8_t* const begin = data.data() + (getRandomByte() % 64U);
+        const std::uint8_t* const end = begin + (getRandomByte() % 128U);
+        const auto expected = std::find_if(begin, end, isSpecialCharacter);
+        REQUIRE(findNextSpecialCharacter(begin, end) == expected);
+        REQUIRE(findNextSpecialCharacterPortable(begin, end) == expected);
+    }
+}
+
+
+TEST_CASE("ExternalBufferParser")
+{
+    using Parser = transport::ExternalBufferParser<100, 4>;
+    static_assert(Parser::BufferSize == 108);
+
+    // Deliberately misaligned relative to ParserBufferAlignment
+    alignas(transport::ParserBufferAlignment) static std::uint8_t arena[Parser::BufferSize * 2 + 4];
+    Parser bulk(&arena[4]);
+    Parser bytewise(&arena[4 + Parser::BufferSize]);
+    transport::Parser<1024> reference;
+    REQUIRE(sizeof(Parser) < 64);
+
+    const auto parse = [](auto& parser, const std::vector<std::uint8_t>& input, const bool byte_by_byte)
+    {
+        std::vector<RecordedParserOutput> out;
+        const auto handler = [&](const transport::ParserOutput& o)
+        {
+            if (auto f = o.getReceivedFrame())
+            {
+                REQUIRE((reinterpret_cast<std::uintptr_t>(f->payload.data()) % 4U) == 0);
+                (void) f->payload.alias<std::uint32_t>();
+            }
+            out.emplace_back(o);
+        };
+        if (byte_by_byte)
+        {
+            for (auto x : input)
+            {
+                const auto o = parser.processNextByte(x);
+                if ((o.getReceivedFrame() != nullptr) || (o.getExtraneousData() != nullptr))
+                {
+                    handler(o);
+                }
+            }
+        }
+        else
+        {
+            parser.processBytes(input.data(), input.size(), handler);
+        }
+        return out;
+    };
+
+    const auto emit = [](std::vector<std::uint8_t>& out, const std::uint8_t type_code, const std::size_t size)
+    {
+        std::vector<std::uint8_t> payload(size);
+        for (auto& x : payload)
+        {
+            x = getRandomByte();
+        }
+        transport::BufferedEmitter emitter(type_code, payload.data(), payload.size());
+        do
+        {
+            out.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+    };
+
+    std::srand(unsigned(std::time(nullptr)));
+
+    // Short frames and short extraneous data are received exactly like with the regular parser
+    for (int iteration = 0; iteration < 100; iteration++)
+    {
+        std::vector<std::uint8_t> input;
+        for (int i = 0; i < 20; i++)
+        {
+            for (std::size_t k = getRandomByte() % 50U; k > 0; k--)
+            {
+                input.push_back(getRandomByte());
+            }
+            emit(input, getRandomByte(), getRandomByte() % 101U);
+        }
+
+        const auto expected = parse(reference, input, true);
+        REQUIRE(parse(bulk, input, false) == expected);
+        REQUIRE(parse(bytewise, input, true) == expected);
+    }
+
+    // Long frames overflow the buffer; the bulk path detects that at the same byte
+    for (int iteration = 0; iteration < 100; iteration++)
+    {
+        std::vector<std::uint8_t> input = getRandomNumberOfRandomBytes();
+        emit(input, getRandomByte(), 101U + getRandomByte());
+        REQUIRE(parse(bulk, input, false) == parse(bytewise, input, true));
+    }
+
+    std::vector<std::uint8_t> input;
+    input.push_back(transport::FrameDelimiter);
+    emit(input, 42, 101);
+    const auto out = parse(bulk, input, false);
+    REQUIRE(!out.empty());
+    REQUIRE(!out.front().is_frame);
+    REQUIRE(out.front().data.size() == 106);     // Payload, type code, CRC, and the spare byte
+
+    // The lower alignment is retained when a malformed compressed frame is passed on by the decompressor
+    presentation::FrameDecompressor<> decompressor;
+    for (const auto& payload : {std::vector<std::uint8_t>{presentation::CompressedFrameTypeCode, 1, 2, 3},
+                                std::vector<std::uint8_t>{42, 0xFF, 0xFF, 0xFF, 0xFF}})
+    {
+        input.clear();
+        transport::BufferedEmitter emitter(presentation::CompressedFrameTypeCode, payload.data(), payload.size());
+        do
+        {
+            input.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+
+        std::size_t num_outputs = 0;
+        bulk.processBytes(input.data(), input.size(), [&](const transport::ParserOutput& o)
+        {
+            if (o.getReceivedFrame() == nullptr)
+            {
+                return;                                 // Leftovers from the previous input
+            }
+            const auto d = decompressor.process(o);
+            REQUIRE(d.getExtraneousData());
+            REQUIRE(d.getExtraneousData()->getAlignment() == 4);
+            REQUIRE(d.getExtraneousData()->data() == o.getReceivedFrame()->payload.data());
+            num_outputs++;
+        });
+        REQUIRE(num_outputs == 1);
+    }
+}
+
+
+TEST_CASE("TransmitScheduler")
+{
+    using transport::FrameDelimiter;
+    using Scheduler = transport::TransmitScheduler<2, 64, 16, std::chrono::milliseconds>;
+    using std::chrono::milliseconds;
+
+    transport::Parser<1024> parser;
+    const auto parse = [&](const Scheduler::Block& block)
+    {
+        return parseByteByByte(parser, std::vector<std::uint8_t>(block.begin(), block.end()));
+    };
+
+    SECTION("coalescing")
+    {
+        Scheduler scheduler(12, milliseconds(10));
+        const std::vector<std::uint8_t> a{1, 2};
+        const std::vector<std::uint8_t> b{3};
+
+        // Below the threshold and before the deadline, nothing is sent
+        REQUIRE(scheduler.enqueue(1, 10, a.data(), a.size(), milliseconds(100)));
+        REQUIRE(scheduler.getPendingSize() == 7 + 1);
+        REQUIRE(scheduler.getPendingSize(1) == 8);
+        REQUIRE(scheduler.poll(milliseconds(105)).empty());
+
+        // The deadline is reached; both frames go into one block sharing the delimiter between them
+        REQUIRE(scheduler.enqueue(1, 11, b.data(), b.size(), milliseconds(108)));
+        const auto block = scheduler.poll(milliseconds(110));
+        REQUIRE(block.size() == 1 + 8 + 7);
+        REQUIRE(std::count(block.begin(), block.end(), FrameDelimiter) == 3);
+        REQUIRE(scheduler.empty());
+        const auto out = parse(block);
+        REQUIRE(out.size() == 2);
+        REQUIRE(out.at(0).is_frame);
+        REQUIRE(out.at(0).type_code == 10);
+        REQUIRE(out.at(0).data == a);
+        REQUIRE(out.at(1).is_frame);
+        REQUIRE(out.at(1).type_code == 11);
+        REQUIRE(out.at(1).data == b);
+
+        // The threshold is reached; the deadline is not
+        REQUIRE(scheduler.poll(milliseconds(1000)).empty());
+        REQUIRE(scheduler.enqueue(0, 10, a.data(), a.size(), milliseconds(1000)));
+        REQUIRE(scheduler.poll(milliseconds(1000)).empty());
+        REQUIRE(scheduler.enqueue(0, 11, b.data(), b.size(), milliseconds(1000)));
+        REQUIRE(parse(scheduler.poll(milliseconds(1000))).size() == 2);
+        REQUIRE(scheduler.flush().empty());
+    }
+
+    SECTION("priority and splitting")
+    {
+        Scheduler scheduler;
+        const std::vector<std::uint8_t> chunk{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+        const std::vector<std::uint8_t> telemetry{42};
+
+        REQUIRE(scheduler.enqueue(1, 1, chunk.data(), chunk.size(), {}));
+        REQUIRE(scheduler.enqueue(1, 1, chunk.data(), chunk.size(), {}));
+        REQUIRE(scheduler.enqueue(0, 0, telemetry.data(), telemetry.size(), {}));
+
+        // The high-priority frame goes first even though it was enqueued last
+        std::vector<RecordedParserOutput> out;
+        bool enqueued = false;
+        while (!scheduler.empty())
+        {
+            const auto block = scheduler.poll({});
+            REQUIRE(!block.empty());
+            REQUIRE(block.size() <= 16);
+            const auto x = parse(block);
+            out.insert(out.end(), x.begin(), x.end());
+            if (!std::exchange(enqueued, true))
+            {
+                // Meanwhile, another one arrives; it gets ahead of the second chunk but not the first one
+                REQUIRE(scheduler.enqueue(0, 0, telemetry.data(), telemetry.size(), {}));
+            }
+        }
+
+        REQUIRE(out.size() == 4);
+        REQUIRE(out.at(0).type_code == 0);
+        REQUIRE(out.at(1).type_code == 1);
+        REQUIRE(out.at(1).data == chunk);
+        REQUIRE(out.at(2).type_code == 0);
+        REQUIRE(out.at(2).data == telemetry);
+        REQUIRE(out.at(3).type_code == 1);
+        REQUIRE(out.at(3).data == chunk);
+        for (auto& x : out)
+        {
+            REQUIRE(x.is_frame);
+        }
+    }
+
+    SECTION("overflow")
+    {
+        Scheduler scheduler;
+        const std::vector<std::uint8_t> payload(40, FrameDelimiter);      // Every byte is escaped
+        REQUIRE(!scheduler.enqueue(0, 0, payload.data(), payload.size(), {}));
+        REQUIRE(scheduler.empty());
+        REQUIRE(scheduler.enqueue(0, 0, payload.data(), 20, {}));
+        REQUIRE(scheduler.getPendingSize() == 46);
+        REQUIRE(!scheduler.enqueue(0, 0, payload.data(), 10, {}));
+        REQUIRE(scheduler.enqueue(1, 0, payload.data(), 10, {}));
+
+        std::vector<std::uint8_t> wire;
+        while (!scheduler.empty())
+        {
+            const auto block = scheduler.flush();
+            wire.insert(wire.end(), block.begin(), block.end());
+        }
+        const auto out = parseByteByByte(parser, wire);
+        REQUIRE(out.size() == 2);
+        REQUIRE(out.at(0).data == std::vector<std::uint8_t>(20, FrameDelimiter));
+        REQUIRE(out.at(1).data == std::vector<std::uint8_t>(10, FrameDelimiter));
+    }
+
+    SECTION("random")
+    {
+        transport::TransmitScheduler<3, 2048, 64> scheduler(48);
+        std::vector<std::vector<std::uint8_t>> sent(3);
+        std::vector<std::vector<std::uint8_t>> received(3);
+        std::vector<std::uint8_t> wire;
+
+        for (int i = 0; i < 300; i++)
+        {
+            const std::size_t priority = getRandomByte() % 3U;
+            auto payload = getRandomNumberOfRandomBytes();
+            payload.resize(std::min<std::size_t>(payload.size(), 100));
+            if (scheduler.enqueue(priority, std::uint8_t(priority), payload.data(), payload.size(), {}))
+            {
+                sent[priority].insert(sent[priority].end(), payload.begin(), payload.end());
+            }
+
+            const auto block = scheduler.poll({});
+            wire.insert(wire.end(), block.begin(), block.end());
+        }
+        while (!scheduler.empty())
+        {
+            const auto block = scheduler.flush();
+            wire.insert(wire.end(), block.begin(), block.end());
+        }
+
+        for (auto& x : parseByteByByte(parser, wire))
+        {
+            REQUIRE(x.is_frame);
+            received.at(x.type_code).insert(received.at(x.type_code).end(), x.data.begin(), x.data.end());
+        }
+        REQUIRE(received == sent);
+    }
+}
+
+
+/**
+ * A clock that is advanced manually by the test.
+ */
+struct ManualClock
+{
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    static inline std::int64_t ticks = 0;
+
+    static time_point now() { return time_point(duration(ticks)); }
+};
+
+
+TEST_CASE("ParserInstrumentation")
+{
+    using transport::FrameDelimiter;
+    using transport::EscapeCharacter;
+    using Statistics = transport::ParserStatistics<ManualClock, 8>;
+
+    // The default instrumentation costs nothing
+    static_assert(sizeof(transport::Parser<1024>) == sizeof(transport::Parser<1024, transport::NullParserInstrumentation>));
+
+    // The state is placed into the padding after the buffer, so the parser is not larger than its aligned buffer
+    constexpr std::size_t Alignment = transport::ParserBufferAlignment;
+    static_assert(sizeof(transport::Parser<1024>) == (((1024 + 6) + (Alignment - 1)) / Alignment) * Alignment);
+
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(0) == 0);
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(1) == 1);
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(3) == 2);
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(4) == 3);
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(64) == 7);
+    static_assert(transport::LatencyHistogram<8>::getBucketIndex(0xFFFFFFFFFFFFULL) == 7);
+    static_assert(transport::LatencyHistogram<8>::getBucketLowerBound(3) == 4);
+
+    transport::Parser<1024, Statistics> parser;
+    ManualClock::ticks = 1000;
+
+    const auto feed = [&](const std::vector<std::uint8_t>& bytes, const std::int64_t ticks_per_byte)
+    {
+        std::vector<RecordedParserOutput> out;
+        for (auto x : bytes)
+        {
+            const auto o = parser.processNextByte(x);
+            if ((o.getReceivedFrame() != nullptr) || (o.getExtraneousData() != nullptr))
+            {
+                out.emplace_back(o);
+            }
+            ManualClock::ticks += ticks_per_byte;
+        }
+        return out;
+    };
+
+    // Valid frame with two escaped bytes: 80 ticks from the first byte to the delimiter
+    auto out = feed({FrameDelimiter, EscapeCharacter, FrameDelimiter ^ 0xFF, EscapeCharacter, EscapeCharacter ^ 0xFF,
+                     0x91, 0x5C, 0xA9, 0xC0, FrameDelimiter, FrameDelimiter}, 10);
+    REQUIRE(out.size() == 1);
+    REQUIRE(out.at(0).is_frame);
+    {
+        const auto& st = parser.getInstrumentation();
+        REQUIRE(st.getCounters().frames == 1);
+        REQUIRE(st.getCounters().escape_characters == 2);
+        REQUIRE(st.getCounters().bytes == 6);
+        REQUIRE(st.getCounters().extraneous_bytes == 0);
+        REQUIRE(st.getLastFrameStartTimestamp().time_since_epoch().count() == 1010);
+        REQUIRE(st.getLastFrameEndTimestamp().time_since_epoch().count() == 1090);
+        REQUIRE(st.getReceptionHistogram().getBuckets().at(7) == 1);     // 80 ticks
+        REQUIRE(st.getReceptionHistogram().getTotalCount() == 1);
+    }
+
+    ManualClock::ticks += 3;
+    parser.getInstrumentation().markFrameHandled();     // 3 + 20 ticks after the delimiter
+    REQUIRE(parser.getInstrumentation().getHandlingHistogram().getBuckets().at(5) == 1);
+
+    // CRC error, short garbage, then overflow
+    out = feed({1, 2, 3, 4, 5, 6, FrameDelimiter, 'a', 'b', FrameDelimiter}, 1);
+    REQUIRE(out.size() == 2);
+    std::vector<std::uint8_t> garbage(1100, 0x55);
+    out = feed(garbage, 0);
+    REQUIRE(out.size() == 1);
+    {
+        const auto& c = parser.getInstrumentation().getCounters();
+        REQUIRE(c.frames == 1);
+        REQUIRE(c.crc_errors == 1);
+        REQUIRE(c.overflows == 1);
+        REQUIRE(c.extraneous_bytes == 6 + 2 + 1030);
+        REQUIRE(c.bytes == 6 + 6 + 2 + 1030);
+        REQUIRE(parser.getInstrumentation().getReceptionHistogram().getTotalCount() == 1);
+    }
+
+    // The bulk path produces the same statistics, apart from the timestamps
+    {
+        transport::Parser<1024, Statistics> reference;
+        transport::Parser<1024, Statistics> bulk;
+        std::vector<std::uint8_t> input;
+        for (int i = 0; i < 30; i++)
+        {
+            const auto extraneous = getRandomNumberOfRandomBytes();
+            input.insert(input.end(), extraneous.begin(), extraneous.end());
+
+            const auto payload = getRandomNumberOfRandomBytes();
+            transport::BufferedEmitter emitter(getRandomByte(), payload.data(), payload.size());
+            do
+            {
+                input.push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+        }
+
+        REQUIRE(parseInRandomChunks(bulk, input) == parseByteByByte(reference, input));
+        const auto& a = reference.getInstrumentation().getCounters();
+        const auto& b = bulk.getInstrumentation().getCounters();
+        REQUIRE((a.frames + a.crc_errors + a.overflows) > 0);
+        REQUIRE(a.frames == b.frames);
+        REQUIRE(a.crc_errors == b.crc_errors);
+        REQUIRE(a.overflows == b.overflows);
+        REQUIRE(a.extraneous_bytes == b.extraneous_bytes);
+        REQUIRE(a.escape_characters == b.escape_characters);
+        REQUIRE(a.bytes == b.bytes);
+    }
+
+    // Exposure via the standard registers
+    using standard::RegisterValue;
+    using Names = standard::ParserStatisticsRegisterNames;
+    const auto& st = parser.getInstrumentation();
+    auto value = standard::getParserStatisticsRegisterValue(st, Names::CRCErrors);
+    REQUIRE(value.is<RegisterValue::U64>());
+    REQUIRE(value.as<RegisterValue::U64>()->size() == 1);
+    REQUIRE((*value.as<RegisterValue::U64>())[0] == 1);
+
+    value = standard::getParserStatisticsRegisterValue(st, standard::RegisterName("popcop.rx.reception_histogram"));
+    REQUIRE(value.is<RegisterValue::U32>());
+    REQUIRE(value.as<RegisterValue::U32>()->size() == 8);
+    REQUIRE((*value.as<RegisterValue::U32>())[7] == 1);
+
+    REQUIRE(standard::getParserStatisticsRegisterValue(st, "popcop.rx.nonexistent").is<RegisterValue::Empty>());
+
+    parser.getInstrumentation().resetStatistics();
+    REQUIRE(parser.getInstrumentation().getCounters().frames == 0);
+    REQUIRE(parser.getInstrumentation().getReceptionHistogram().getTotalCount() == 0);
+}
+
+
+TEST_CASE("FrameQueue")
+{
+    using transport::FrameDelimiter;
+
+    const auto encode = [](const std::uint8_t type_code, const std::vector<std::uint8_t>& payload)
+    {
+        std::vector<std::uint8_t> out;
+        transport::BufferedEmitter emitter(type_code, payload.data(), payload.size());
+        do
+        {
+            out.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+        return out;
+    };
+
+    SECTION("simple")
+    {
+        transport::FrameQueue<2, 1024> queue;
+        REQUIRE(queue.capacity() == 2);
+        REQUIRE(queue.empty());
+        REQUIRE(queue.peek() == nullptr);
+
+        std::vector<std::vector<std::uint8_t>> extraneous;
+        const auto on_extraneous = [&](const transport::ParserOutput::AlignedBufferView& data)
+        {
+            extraneous.emplace_back(data.begin(), data.end());
+        };
+
+        std::vector<std::uint8_t> input{'H', 'i', FrameDelimiter};
+        for (std::uint8_t i = 0; i < 3; i++)
+        {
+            const auto frame = encode(i, {i, std::uint8_t(i + 1U), transport::EscapeCharacter});
+            input.insert(input.end(), frame.begin(), frame.end());
+        }
+
+        for (auto x : input)
+        {
+            queue.processNextByte(x, on_extraneous);
+        }
+
+        // The third frame did not fit
+        REQUIRE(queue.size() == 2);
+        REQUIRE(queue.getDroppedFrameCount() == 1);
+        REQUIRE(extraneous == std::vector<std::vector<std::uint8_t>>{{'H', 'i'}});
+
+        // The frames remain valid while more data is received, until they are popped
+        const auto first = queue.peek();
+        REQUIRE(first != nullptr);
+        queue.processBytes(input.data(), input.size());
+        REQUIRE(queue.getDroppedFrameCount() == 4);
+        REQUIRE(first == queue.peek());
+        REQUIRE(first->type_code == 0);
+        REQUIRE(std::vector<std::uint8_t>(first->payload.begin(), first->payload.end()) ==
+                std::vector<std::uint8_t>{0, 1, transport::EscapeCharacter});
+        queue.pop();
+
+        REQUIRE(queue.size() == 1);
+        REQUIRE(queue.peek()->type_code == 1);
+        REQUIRE(std::vector<std::uint8_t>(queue.peek()->payload.begin(), queue.peek()->payload.end()) ==
+                std::vector<std::uint8_t>{1, 2, transport::EscapeCharacter});
+        queue.pop();
+
+        REQUIRE(queue.empty());
+        REQUIRE(queue.peek() == nullptr);
+
+        // The slots are reused
+        queue.processBytes(input.data(), input.size(), on_extraneous);
+        REQUIRE(queue.size() == 2);
+        REQUIRE(queue.getDroppedFrameCount() == 5);
+        REQUIRE(extraneous.size() == 2);
+        REQUIRE(queue.peek()->type_code == 0);
+    }
+
+    SECTION("threaded")
+    {
+        static transport::FrameQueue<3, 1024> queue;    // Static because it is large
+
+        std::vector<std::vector<std::uint8_t>> payloads;
+        std::vector<std::uint8_t> input;
+        for (int i = 0; i < 1000; i++)
+        {
+            payloads.push_back(getRandomNumberOfRandomBytes());
+            payloads.back().resize(std::min<std::size_t>(payloads.back().size(), 1024));
+            const auto frame = encode(std::uint8_t(i), payloads.back());
+            input.insert(input.end(), frame.begin(), frame.end());
+        }
+
+        std::thread producer([&]()
+        {
+            std::size_t offset = 0;
+            while (offset < input.size())
+            {
+                if (queue.size() == queue.capacity())
+                {
+                    std::this_thread::yield();              // Throttling, otherwise frames would be dropped
+                    continue;
+                }
+                queue.processNextByte(input.at(offset++));
+            }
+        });
+
+        // The checks are deferred until the producer is joined
+        std::vector<RecordedParserOutput> received;
+        while (received.size() < payloads.size())
+        {
+            if (auto frame = queue.peek())
+            {
+                received.emplace_back(transport::ParserOutput(frame->type_code,
+                                                              frame->payload.data(),
+                                                              frame->payload.size()));
+                queue.pop();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        producer.join();
+        for (std::size_t i = 0; i < payloads.size(); i++)
+        {
+            REQUIRE(received.at(i).is_frame);
+            REQUIRE(received.at(i).type_code == std::uint8_t(i));
+            REQUIRE(received.at(i).data == payloads.at(i));
+        }
+        REQUIRE(queue.getDroppedFrameCount() == 0);
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("ParserPool")
+{
+    constexpr std::size_t NumberOfChannels = 16;
+
+    // Every channel gets its own stream of frames and extraneous data
+    std::vector<std::vector<std::uint8_t>> inputs(NumberOfChannels);
+    std::vector<std::vector<RecordedParserOutput>> references(NumberOfChannels);
+    for (std::size_t ch = 0; ch < NumberOfChannels; ch++)
+    {
+        for (int i = 0; i < 20; i++)
+        {
+            const auto extraneous = getRandomNumberOfRandomBytes();
+            inputs[ch].insert(inputs[ch].end(), extraneous.begin(), extraneous.end());
+
+            const auto payload = getRandomNumberOfRandomBytes();
+            transport::BufferedEmitter emitter(std::uint8_t(ch), payload.data(), payload.size());
+            do
+            {
+                inputs[ch].push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+        }
+
+        transport::Parser<1024> reference;
+        references[ch] = parseByteByByte(reference, inputs[ch]);
+    }
+
+    // The handler invocations are serialized per channel, so no locking is needed here
+    std::vector<std::vector<RecordedParserOutput>> outputs(NumberOfChannels);
+    {
+        host::ParserPool<1024> pool(NumberOfChannels, [&](std::size_t channel_index, const transport::ParserOutput& o)
+        {
+            outputs.at(channel_index).emplace_back(o);
+        }, 4);
+
+        REQUIRE(pool.getNumberOfChannels() == NumberOfChannels);
+        REQUIRE(pool.getNumberOfWorkers() == 4);
+
+        // Random chunks of all channels are interleaved, as in a real gateway
+        std::vector<std::size_t> offsets(NumberOfChannels);
+        bool done = false;
+        while (!done)
+        {
+            done = true;
+            for (std::size_t ch = 0; ch < NumberOfChannels; ch++)
+            {
+                const std::size_t chunk = std::min<std::size_t>(inputs[ch].size() - offsets[ch], getRandomByte());
+                pool.submit(ch, inputs[ch].data() + offsets[ch], chunk);
+                offsets[ch] += chunk;
+                done = done && (offsets[ch] == inputs[ch].size());
+            }
+        }
+
+        pool.waitUntilIdle();
+        REQUIRE(outputs == references);
+
+        // More data after the pool went idle; the remaining data is flushed upon destruction
+        for (std::size_t ch = 0; ch < NumberOfChannels; ch++)
+        {
+            pool.submit(ch, inputs[ch].data(), inputs[ch].size());
+        }
+    }
+
+    for (std::size_t ch = 0; ch < NumberOfChannels; ch++)
+    {
+        REQUIRE(outputs[ch].size() == references[ch].size() * 2);
+    }
+}
+
+
+TEST_CASE("Client")
+{
+    using standard::RegisterDataRequestMessage;
+    using standard::RegisterDataResponseMessage;
+    using standard::DeviceManagementCommandRequestMessage;
+    using standard::DeviceManagementCommandResponseMessage;
+    using standard::DeviceManagementCommand;
+    using Client = host::Client<>;
+    using std::chrono::milliseconds;
+
+    // The device side: collects the requests written by the client
+    std::vector<std::vector<std::uint8_t>> sent;
+    transport::Parser<> device;
+    std::vector<RecordedParserOutput> unsolicited;
+    Client client([&](const std::uint8_t* data, std::size_t size)
+                  {
+                      for (auto& x : parseByteByByte(device, std::vector<std::uint8_t>(data, data + size)))
+                      {
+                          REQUIRE(x.is_frame);
+                          REQUIRE(x.type_code == presentation::StandardFrameTypeCode);
+                          sent.push_back(x.data);
+                      }
+                  },
+                  [&](const transport::ParserOutput& out) { unsolicited.emplace_back(out); },
+                  milliseconds(100),
+                  2);
+
+    const auto respond = [&](const auto& message, const Client::Clock::time_point now)
+    {
+        const auto payload = message.encode();
+        std::vector<std::uint8_t> frame;
+        transport::BufferedEmitter emitter(presentation::StandardFrameTypeCode, payload.data(), payload.size());
+        do
+        {
+            frame.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+        client.processReceivedData(frame.data(), frame.size(), now);
+    };
+
+    const Client::Clock::time_point t0{};
+    std::vector<std::string> completed;
+
+    const auto read = [&](const char* name, const Client::Clock::time_point now)
+    {
+        RegisterDataRequestMessage req;
+        req.name = name;
+        client.request(req, [&completed, n = std::string(name)](const std::optional<RegisterDataResponseMessage>& r)
+        {
+            completed.push_back(r ? (n + "=" + r->name.c_str()) : (n + ":timeout"));
+        }, now);
+    };
+
+    // Only two requests are sent at once; the third one is queued
+    read("a", t0);
+    read("b", t0);
+    read("c", t0 + milliseconds(50));
+    REQUIRE(sent.size() == 2);
+    REQUIRE(client.getNumberOfOutstandingRequests() == 2);
+    REQUIRE(client.getNumberOfQueuedRequests() == 1);
+    REQUIRE(client.getNextDeadline() == t0 + milliseconds(100));
+    REQUIRE(RegisterDataRequestMessage::tryDecode(sent.at(1).begin(), sent.at(1).end())->name == "b");
+
+    // Responses arrive out of order and are matched by the register name
+    RegisterDataResponseMessage response;
+    response.name = "b";
+    respond(response, t0 + milliseconds(60));
+    REQUIRE(completed == std::vector<std::string>{"b=b"});
+    REQUIRE(sent.size() == 3);                                  // The queued request is sent now
+    REQUIRE(client.getNextDeadline() == t0 + milliseconds(100));
+
+    // A response to nothing goes to the unsolicited handler
+    response.name = "z";
+    respond(response, t0 + milliseconds(60));
+    REQUIRE(unsolicited.size() == 1);
+    REQUIRE(completed.size() == 1);
+
+    // Timeouts are counted from the moment of sending
+    client.poll(t0 + milliseconds(100));
+    REQUIRE(completed == std::vector<std::string>{"b=b", "a:timeout"});
+    REQUIRE(client.getNextDeadline() == t0 + milliseconds(160));
+    response.name = "c";
+    respond(response, t0 + milliseconds(150));
+    REQUIRE(completed == std::vector<std::string>{"b=b", "a:timeout", "c=c"});
+    REQUIRE(!client.getNextDeadline());
+
+    // Identical requests are completed in order; handlers can send new requests
+    int count = 0;
+    DeviceManagementCommandRequestMessage cmd;
+    cmd.command = DeviceManagementCommand::Restart;
+    const std::function<void (const std::optional<DeviceManagementCommandResponseMessage>&)> on_response =
+        [&](const std::optional<DeviceManagementCommandResponseMessage>& r)
+        {
+            REQUIRE(r);
+            REQUIRE(r->command == DeviceManagementCommand::Restart);
+            if (++count == 1)
+            {
+                client.request(cmd, on_response, t0 + milliseconds(200), milliseconds(1));
+            }
+        };
+    client.request(cmd, on_response, t0 + milliseconds(200));
+    DeviceManagementCommandResponseMessage cmd_response;
+    cmd_response.command = DeviceManagementCommand::Restart;
+    respond(cmd_response, t0 + milliseconds(200));
+    REQUIRE(count == 1);
+    REQUIRE(client.getNextDeadline() == t0 + milliseconds(201));
+    respond(cmd_response, t0 + milliseconds(200));
+    REQUIRE(count == 2);
+
+    // Unknown requests are rejected
+    const std::uint8_t bogus[] = {0xFF, 0xFF};
+    REQUIRE(!client.requestRaw(bogus, sizeof(bogus), [](const std::uint8_t*, std::size_t) {}, t0));
+
+    // Cancellation
+    read("d", t0);
+    read("e", t0);
+    read("f", t0);
+    client.cancelAll();
+    REQUIRE(completed.size() == 6);
+    REQUIRE(completed.back() == "f:timeout");
+    REQUIRE(client.getNumberOfOutstandingRequests() == 0);
+    REQUIRE(client.getNumberOfQueuedRequests() == 0);
+}
+
+
+TEST_CASE("ParallelDecoder")
+{
+    std::srand(unsigned(std::time(nullptr)));
+
+    const auto emit = [](std::vector<std::uint8_t>& out, std::uint8_t type_code, const std::vector<std::uint8_t>& p)
+    {
+        transport::BufferedEmitter emitter(type_code, p.data(), p.size());
+        do
+        {
+            out.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+    };
+
+    // Standard messages among random frames and extraneous data
+    std::vector<std::uint8_t> input;
+    std::size_t number_of_standard_messages = 0;
+    for (int i = 0; i < 300; i++)
+    {
+        const auto extraneous = getRandomNumberOfRandomBytes();
+        input.insert(input.end(), extraneous.begin(), extraneous.end());
+        if (getRandomBit())
+        {
+            standard::RegisterDataRequestMessage msg;
+            msg.name = "uavcan.node_id";
+            const auto payload = msg.encode();
+            emit(input, presentation::StandardFrameTypeCode, std::vector<std::uint8_t>(payload.begin(), payload.end()));
+            number_of_standard_messages++;
+        }
+        else
+        {
+            const auto type_code = std::uint8_t(getRandomByte() % presentation::StandardFrameTypeCode);
+            emit(input, type_code, getRandomNumberOfRandomBytes());
+        }
+    }
+    const std::vector<std::uint8_t> tail{1, 2, 3};      // Unterminated, produces no output
+    input.insert(input.end(), tail.begin(), tail.end());
+
+    transport::Parser<> reference;
+    std::vector<RecordedParserOutput> expected;
+    reference.processBytes(input.data(), input.size(), [&](const transport::ParserOutput& out)
+    {
+        expected.emplace_back(out);
+    });
+    REQUIRE(expected.size() >= 300);
+
+    for (const std::size_t chunk_size : {std::size_t(1), std::size_t(100), std::size_t(5000), input.size() * 2U})
+    {
+        for (const std::size_t number_of_threads : {1U, 3U, 8U})
+        {
+            std::vector<RecordedParserOutput> result;
+            const std::size_t consumed = host::decodeInParallel(input.data(), input.size(),
+                                                                [&](const transport::ParserOutput& out)
+                                                                {
+                                                                    result.emplace_back(out);
+                                                                },
+                                                                number_of_threads,
+                                                                chunk_size);
+            REQUIRE(consumed == input.size() - tail.size());
+            REQUIRE(result == expected);
+        }
+    }
+    REQUIRE(host::decodeInParallel(input.data(), 0, [](const transport::ParserOutput&) { FAIL(); }) == 0);
+
+    // Dispatching the standard frames to the message decoders
+    std::size_t number_of_decoded = 0;
+    host::decodeInParallel(input.data(), input.size(), [&](const transport::ParserOutput& out)
+    {
+        if (auto f = out.getReceivedFrame())
+        {
+            const bool decoded = host::decodeStandardMessage(*f, [&](const auto& msg)
+            {
+                using Message = std::decay_t<decltype(msg)>;
+                REQUIRE(std::is_same_v<Message, standard::RegisterDataRequestMessage>);
+                if constexpr (std::is_same_v<Message, standard::RegisterDataRequestMessage>)
+                {
+                    REQUIRE(msg.name == "uavcan.node_id");
+                }
+                number_of_decoded++;
+            });
+            REQUIRE(decoded == (f->type_code == presentation::StandardFrameTypeCode));
+        }
+    }, 4, 1000);
+    REQUIRE(number_of_decoded == number_of_standard_messages);
+
+    // Unknown and malformed messages
+    alignas(transport::ParserBufferAlignment) static const std::uint8_t unknown[] = {0xFF, 0xFF, 0, 0};
+    alignas(transport::ParserBufferAlignment) static const std::uint8_t truncated[] = {2, 0};
+    const auto visitor = [](const auto&) { FAIL(); };
+    for (const auto& out : {transport::ParserOutput(presentation::StandardFrameTypeCode, unknown, sizeof(unknown)),
+                            transport::ParserOutput(presentation::StandardFrameTypeCode, truncated, 1),
+                            transport::ParserOutput(presentation::StandardFrameTypeCode, truncated, 2),
+                            transport::ParserOutput(123, truncated, 2)})
+    {
+        REQUIRE(!host::decodeStandardMessage(*out.getReceivedFrame(), visitor));
+    }
+}
+
+
+#ifdef __linux__
+TEST_CASE("SerialMultiplexer")
+{
+    // A pseudo terminal stands in for the device; the master side is the device end
+    const int master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    REQUIRE(master >= 0);
+    REQUIRE(::grantpt(master) == 0);
+    REQUIRE(::unlockpt(master) == 0);
+    const std::string slave_name = ::ptsname(master);
+
+    REQUIRE_THROWS_AS(host::SerialPort("/dev/nonexistent-serial-port"), std::system_error);
+    REQUIRE_THROWS_AS(host::SerialPort(slave_name, 12345), std::system_error);
+
+    std::vector<RecordedParserOutput> received;
+    host::SerialMultiplexer<> mux([&](std::size_t port_index, const transport::ParserOutput& out)
+    {
+        REQUIRE(port_index == 0);
+        received.emplace_back(out);
+    });
+    const std::size_t index = mux.add(host::SerialPort(slave_name, 921600));
+    REQUIRE(index == 0);
+    REQUIRE(mux.getNumberOfPorts() == 1);
+    REQUIRE(mux.isOpen(index));
+    REQUIRE(mux.poll(std::chrono::milliseconds(0)) == 0);
+
+    // Device to host
+    std::vector<std::uint8_t> wire;
+    std::vector<std::vector<std::uint8_t>> payloads;
+    for (int i = 0; i < 10; i++)
+    {
+        payloads.push_back(getRandomNumberOfRandomBytes());
+        payloads.back().resize(std::min<std::size_t>(payloads.back().size(), 300));
+        transport::BufferedEmitter emitter(42, payloads.back().data(), payloads.back().size());
+        do
+        {
+            wire.push_back(emitter.getNextByte());
+        }
+        while (!emitter.isFinished());
+    }
+    REQUIRE(::write(master, wire.data(), wire.size()) == ssize_t(wire.size()));
+
+    // The wait can be done outside of the multiplexer
+    ::pollfd pfd{mux.getFileDescriptor(), POLLIN, 0};
+    REQUIRE(::poll(&pfd, 1, 5000) == 1);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((received.size() < payloads.size()) && (std::chrono::steady_clock::now() < deadline))
+    {
+        (void) mux.poll(std::chrono::milliseconds(10));
+    }
+    REQUIRE(received.size() == payloads.size());
+    for (std::size_t i = 0; i < payloads.size(); i++)
+    {
+        REQUIRE(received[i].is_frame);
+        REQUIRE(received[i].type_code == 42);
+        REQUIRE(received[i].data == payloads[i]);
+    }
+
+    // Host to device; the data that does not fit into the driver buffer is sent when the port becomes writable
+    std::vector<std::uint8_t> outgoing(100000);
+    for (auto& x : outgoing)
+    {
+        x = getRandomByte();
+    }
+    mux.send(index, outgoing.data(), 1000);
+    mux.send(index, outgoing.data() + 1000, outgoing.size() - 1000);
+
+    std::vector<std::uint8_t> incoming;
+    while ((incoming.size() < outgoing.size()) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::array<std::uint8_t, 4096> buf{};
+        const auto n = ::read(master, buf.data(), buf.size());
+        if (n > 0)
+        {
+            incoming.insert(incoming.end(), buf.begin(), buf.begin() + n);
+        }
+        (void) mux.poll(std::chrono::milliseconds(1));
+    }
+    REQUIRE(incoming == outgoing);
+    REQUIRE(mux.getPendingSize(index) == 0);
+
+    // The device is gone; the port is closed without affecting the loop
+    ::close(master);
+    while (mux.isOpen(index) && (std::chrono::steady_clock::now() < deadline))
+    {
+        (void) mux.poll(std::chrono::milliseconds(10));
+    }
+    REQUIRE(!mux.isOpen(index));
+    mux.send(index, outgoing.data(), 10);     // Dropped silently
+    REQUIRE(mux.poll(std::chrono::milliseconds(0)) == 0);
+}
+
+
+TEST_CASE("Capture")
+{
+    using std::chrono::nanoseconds;
+    const std::string path = "/tmp/popcop_test_capture_" + std::to_string(::getpid());
+
+    REQUIRE_THROWS_AS(host::CaptureReader("/tmp/nonexistent-popcop-capture"), std::system_error);
+
+    // Received data is recorded from the parser output; every fourth frame is a standard message
+    struct Expected
+    {
+        RecordedParserOutput output;
+        nanoseconds timestamp;
+        host::CaptureDirection direction;
+    };
+    std::vector<Expected> expected;
+    {
+        host::CaptureWriter writer(path);
+        REQUIRE(writer.getSize() == 48);
+
+        transport::Parser<2048> parser;
+        std::int64_t ts = 1000;
+        for (int i = 0; i < 200; i++)
+        {
+            std::vector<std::uint8_t> payload = getRandomNumberOfRandomBytes();
+            payload.resize(std::min<std::size_t>(payload.size(), 1000));
+            const bool standard_frame = (i % 4) == 0;
+            if (standard_frame)
+            {
+                payload.insert(payload.begin(), { std::uint8_t(i % 20), 0 });
+            }
+            const std::uint8_t type_code = standard_frame ? presentation::StandardFrameTypeCode : std::uint8_t(i % 100);
+
+            std::vector<std::uint8_t> wire;
+            if ((i % 10) == 9)
+            {
+                wire = { 'a', 'b', 'c' };       // Extraneous data
+            }
+            transport::BufferedEmitter emitter(type_code, payload.data(), payload.size());
+            do
+            {
+                wire.push_back(emitter.getNextByte());
+            }
+            while (!emitter.isFinished());
+
+            for (auto b : wire)
+            {
+                const auto out = parser.processNextByte(b);
+                if (out.getReceivedFrame() || out.getExtraneousData())
+                {
+                    writer.write(nanoseconds(ts), host::CaptureDirection::Received, out);
+                    expected.push_back({ RecordedParserOutput(out),
+                                         nanoseconds(ts), host::CaptureDirection::Received });
+                    ts += 10;
+                }
+            }
+
+            if ((i % 7) == 0)
+            {
+                alignas(transport::ParserBufferAlignment) const std::uint8_t tx[] = { 1, 2, 3, std::uint8_t(i) };
+                writer.writeFrame(nanoseconds(ts), host::CaptureDirection::Transmitted, 42, tx, sizeof(tx));
+                expected.push_back({ RecordedParserOutput(transport::ParserOutput(42, tx, sizeof(tx))),
+                                     nanoseconds(ts), host::CaptureDirection::Transmitted });
+                ts += 10;
+            }
+        }
+        writer.flush();
+        REQUIRE(writer.getSize() == std::uint64_t(std::ifstream(path, std::ios::binary | std::ios::ate).tellg()));
+    }
+
+    const host::CaptureReader reader(path);
+    const host::CaptureIndex index(host::getCaptureIndexPath(path));
+    REQUIRE(index.size() == expected.size());
+
+    std::size_t i = 0;
+    for (const host::CaptureReader::Record& rec : reader)
+    {
+        REQUIRE(i < expected.size());
+        REQUIRE(RecordedParserOutput(rec.output).is_frame == expected[i].output.is_frame);
+        REQUIRE(RecordedParserOutput(rec.output).type_code == expected[i].output.type_code);
+        REQUIRE(RecordedParserOutput(rec.output).data == expected[i].output.data);
+        REQUIRE(rec.timestamp == expected[i].timestamp);
+        REQUIRE(rec.direction == expected[i].direction);
+
+        const host::CaptureIndexEntry entry = index[i];
+        REQUIRE(entry.record_offset == rec.offset);
+        REQUIRE(entry.timestamp == rec.timestamp);
+        REQUIRE(entry.direction == rec.direction);
+        if (auto f = rec.output.getReceivedFrame())
+        {
+            REQUIRE(entry.kind == host::CaptureRecordKind::Frame);
+            REQUIRE(entry.frame_type_code == f->type_code);
+            REQUIRE((f->type_code == presentation::StandardFrameTypeCode) == bool(entry.message_id));
+            if (entry.message_id)
+            {
+                REQUIRE(std::uint8_t(*entry.message_id) == f->payload.at(0));
+            }
+            REQUIRE((reinterpret_cast<std::uintptr_t>(f->payload.data()) % transport::ParserBufferAlignment) == 0);
+        }
+        else
+        {
+            REQUIRE(entry.kind == host::CaptureRecordKind::ExtraneousData);
+            REQUIRE(!entry.message_id);
+        }
+        i++;
+    }
+    REQUIRE(i == expected.size());
+
+    // Time window lookup
+    REQUIRE(index.lowerBound(nanoseconds(0)) == 0);
+    REQUIRE(index.lowerBound(nanoseconds(1000)) == 0);
+    REQUIRE(index.lowerBound(nanoseconds(1001)) == 1);
+    REQUIRE(index.lowerBound(nanoseconds(1010)) == 1);
+    REQUIRE(index.lowerBound(expected.back().timestamp) == expected.size() - 1);
+    REQUIRE(index.lowerBound(expected.back().timestamp + nanoseconds(1)) == expected.size());
+    const std::size_t k = index.lowerBound(expected[100].timestamp);
+    REQUIRE(k == 100);
+    REQUIRE(reader.getRecordAt(index[k].record_offset)->timestamp == expected[100].timestamp);
+    REQUIRE(!reader.getRecordAt(index[k].record_offset + 1));
+    REQUIRE(!reader.getRecordAt(0));
+    REQUIRE(!reader.getRecordAt(reader.getSize()));
+    REQUIRE(!reader.getRecordAt(~0ULL - 15U));      // Corrupted index; the payload offset would wrap to zero
+    REQUIRE(!reader.getRecordAt(~0ULL));
+
+    // An incomplete record at the end is ignored
+    REQUIRE(::truncate(path.c_str(), off_t(reader.getSize() - 1)) == 0);
+    {
+        const host::CaptureReader truncated(path);
+        REQUIRE(std::distance(truncated.begin(), truncated.end()) == std::ptrdiff_t(expected.size() - 1));
+    }
+
+    // Not a capture file
+    REQUIRE_THROWS_AS(host::CaptureReader(host::getCaptureIndexPath(path)), std::system_error);
+    REQUIRE_THROWS_AS(host::CaptureIndex(path), std::system_error);
+
+    (void) std::remove(path.c_str());
+    (void) std::remove(host::getCaptureIndexPath(path).c_str());
+}
+#endif
+
+
+TEST_CASE("CRC")
+{
+    transport::CRCComputer crc;
+
+    REQUIRE(crc.get() == 0);
+    REQUIRE(!crc.isResidueCorrect());
+
+    crc.add('1');
+    crc.add('2');
+    crc.add('3');
+    crc.add('4');
+    crc.add('5');
+    crc.add('6');
+    crc.add('7');
+    crc.add('8');
+    crc.add('9');
+
+    REQUIRE(crc.get() == 0xE3069283);
+    REQUIRE(!crc.isResidueCorrect());
+
+    crc.add(0x83);
+    crc.add(0x92);
+    crc.add(0x06);
+    crc.add(0xE3);
+
+    REQUIRE(crc.isResidueCorrect());
+
+    transport::CRCComputer block_crc;
+    block_crc.add("123456789", 9);
+    REQUIRE(block_crc.get() == 0xE3069283);
+    block_crc.add("\x83\x92\x06\xE3", 4);
+    REQUIRE(block_crc.isResidueCorrect());
+}
+
+
+TEST_CASE("CRCBlock")
+{
+    std::srand(unsigned(std::time(nullptr)));
+
+    for (int iteration = 0; iteration < 1000; iteration++)
+    {
+        const auto data = getRandomNumberOfRandomBytes();
+        const std::size_t offset = std::min<std::size_t>(data.size(), getRandomByte() % 8U);
+
+        transport::CRCComputer reference;
+        reference.add(0x42);                        // Non-trivial initial state
+        for (std::size_t i = offset; i < data.size(); i++)
+        {
+            reference.add(data[i]);
+        }
+
+        transport::CRCComputer crc;
+        crc.add(0x42);
+        crc.add(data.data() + offset, data.size() - offset);
+        REQUIRE(crc.get() == reference.get());
+
+        // All software backends must be tested regardless of which one is selected
+        using transport::detail_::updateCRC32CSoftware;
+        const std::uint32_t initial = 0x12345678U;
+        const std::uint32_t expected = updateCRC32CSoftware<1>(initial, data.data() + offset, data.size() - offset);
+        REQUIRE(updateCRC32CSoftware<4>(initial, data.data() + offset, data.size() - offset) == expected);
+        REQUIRE(updateCRC32CSoftware<8>(initial, data.data() + offset, data.size() - offset) == expected);
+        REQUIRE(transport::detail_::updateCRC32C(initial, data.data() + offset, data.size() - offset) == expected);
+    }
+}
+
+
+TEST_CASE("StreamEncoder")
+{
+    senoval::Vector<std::uint8_t, 100> vec;
+    presentation::StreamEncoder encoder(std::back_inserter(vec));
+
+    REQUIRE(encoder.getOffset() == 0);
+    REQUIRE(vec.size() == 0);
+
+    encoder.addU8(123U);
+    encoder.addI8(-123);
+    REQUIRE(encoder.getOffset() == 2);
+    REQUIRE(vec.size() == 2);
+    REQUIRE(vec[0] == 123);
+    REQUIRE(vec[1] == 133);     // as unsigned
+
+    encoder.addI16(-30000);
+    encoder.addU16(30000U);
+    REQUIRE(encoder.getOffset() == 6);
+    REQUIRE(vec.size() == 6);
+    REQUIRE(vec[0] == 123);
+    REQUIRE(vec[1] == 133);
+    REQUIRE(vec[2] == 208);
+    REQUIRE(vec[3] == 138);
+    REQUIRE(vec[4] == 48);
+    REQUIRE(vec[5] == 117);
+
+    encoder.fillUpToOffset(9, 42);
+    REQUIRE(encoder.getOffset() == 9);
+    REQUIRE(vec.size() == 9);
+    REQUIRE(vec[0] == 123);
+    REQUIRE(vec[1] == 133);
+    REQUIRE(vec[2] == 208);
+    REQUIRE(vec[3] == 138);
+    REQUIRE(vec[4] == 48);
+    REQUIRE(vec[5] == 117);
+    REQUIRE(vec[6] == 42);
+    REQUIRE(vec[7] == 42);
+    REQUIRE(vec[8] == 42);
+
+    encoder.addBytes(makeArray(1, 2, 3, 4, 5, 6));
+    REQUIRE(encoder.getOffset() == 15);
+    REQUIRE(vec.size() == 15);
+    REQUIRE(vec[6] == 42);
+    REQUIRE(vec[7] == 42);
+    REQUIRE(vec[8] == 42);
+    REQUIRE(vec[9] == 1);
+    REQUIRE(vec[10] == 2);
+    REQUIRE(vec[11] == 3);
+    REQUIRE(vec[12] == 4);
+    REQUIRE(vec[13] == 5);
+    REQUIRE(vec[14] == 6);
+
+    encoder.addI32(-30000000);
+    encoder.addU32(30000000U);      // 00000001 11001001 11000011 10000000
+    REQUIRE(encoder.getOffset() == 23);
+    REQUIRE(vec.size() == 23);
+    REQUIRE(vec[15] == 128);
+    REQUIRE(vec[16] == 60);
+    REQUIRE(vec[17] == 54);
+    REQUIRE(vec[18] == 254);
+    REQUIRE(vec[19] == 0b10000000);
+    REQUIRE(vec[20] == 0b11000011);
+    REQUIRE(vec[21] == 0b11001001);
+    REQUIRE(vec[22] == 0b00000001);
+
+    encoder.addI64(-30000000010LL);
+    encoder.addU64(30000000010ULL);      // 00000000 00000000 00000000 00000110 11111100 00100011 10101100 00001010
+    REQUIRE(encoder.getOffset() == 39);
+    REQUIRE(vec.size() == 39);
+    REQUIRE(vec[23] == 246);
+    REQUIRE(vec[24] == 83);
+    REQUIRE(vec[25] == 220);
+    REQUIRE(vec[26] == 3);
+    REQUIRE(vec[27] == 249);
+    REQUIRE(vec[28] == 255);
+    REQUIRE(vec[29] == 255);
+    REQUIRE(vec[30] == 255);
+    // the unsigned starts here
+    REQUIRE(vec[31] == 0b00001010);
+    REQUIRE(vec[32] == 0b10101100);
+    REQUIRE(vec[33] == 0b00100011);
+    REQUIRE(vec[34] == 0b11111100);
+    REQUIRE(vec[35] == 0b00000110);
     REQUIRE(vec[36] == 0b00000000);
     REQUIRE(vec[37] == 0b00000000);
     REQUIRE(vec[38] == 0b00000000);
@@ -902,37 +2475,400 @@ TEST_CASE("StreamDecoder-slow")
             encoder.addBytes(str);
             if (str.size() < str.capacity())        // Decoder will ignore the null terminator if at full capacity
             {
-                encoder.addI8(0);                   // ...which is by design.
+                encoder.addI8(0);                   // ...which is by design.
+            }
+            senoval::String<65535> out = "Some garbage";
+            decoder.fetchASCIIString(out);
+            REQUIRE(out == str);
+            REQUIRE(decoder.getOffset() == encoder.getOffset());
+            break;
+        }
+        default:
+        {
+            assert(false);
+        }
+        }
+    }
+
+    std::cout << "Randomized stream decoder test has finished running." << std::endl;
+    std::cout << "decoder.getOffset()          = " << decoder.getOffset() << std::endl;
+    std::cout << "decoder.getRemainingLength() = " << decoder.getRemainingLength() << std::endl;
+
+    REQUIRE(decoder.getOffset() == encoder.getOffset());
+    REQUIRE(encoder.getOffset() == vec->size());
+    REQUIRE(decoder.getRemainingLength() == (vec->capacity() - vec->size()));
+
+    std::cout << "Decoder test type tag usage:" << std::endl;
+    std::uint64_t total = 0;
+    for (auto p : stats)
+    {
+        total += p.second;
+        std::cout << int(p.first) << ": " << p.second << std::endl;
+    }
+    std::cout << "Total: " << total << std::endl;
+}
+
+
+TEST_CASE("StreamDecoderContiguous")
+{
+    // The contiguous (pointer) input is decoded in bulk; the results must be identical to the generic version
+    static_assert(presentation::StreamDecoder<const std::uint8_t*>::IsContiguous);
+    static_assert(!presentation::StreamDecoder<std::vector<std::uint8_t>::const_iterator>::IsContiguous);
+
+    for (std::size_t size = 0; size < 40; size++)
+    {
+        std::vector<std::uint8_t> data;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            data.push_back(getRandomByte());
+        }
+
+        presentation::StreamDecoder<const std::uint8_t*> fast(data.data(), data.data() + data.size());
+        presentation::StreamDecoder slow(data.cbegin(), data.cend());
+
+        REQUIRE(fast.fetchU8()  == slow.fetchU8());
+        REQUIRE(fast.fetchU16() == slow.fetchU16());
+        REQUIRE(fast.fetchI32() == slow.fetchI32());
+        REQUIRE(fast.fetchU64() == slow.fetchU64());
+        REQUIRE(fast.getOffset() == slow.getOffset());
+
+        std::array<std::uint8_t, 5> fast_bytes{};
+        std::array<std::uint8_t, 5> slow_bytes{};
+        fast.fetchBytes(fast_bytes.begin(), fast_bytes.end());
+        slow.fetchBytes(slow_bytes.begin(), slow_bytes.end());
+        REQUIRE(fast_bytes == slow_bytes);
+
+        std::vector<std::uint8_t> fast_vector;
+        std::vector<std::uint8_t> slow_vector;
+        fast.fetchBytes(std::back_inserter(fast_vector), 6);
+        slow.fetchBytes(std::back_inserter(slow_vector), 6);
+        REQUIRE(fast_vector == slow_vector);
+
+        fast.skipUpToOffset(fast.getOffset() + 3);
+        slow.skipUpToOffset(slow.getOffset() + 3);
+        REQUIRE(fast.getOffset() == slow.getOffset());
+
+        REQUIRE(fast.fetchF64() == Approx(slow.fetchF64()).epsilon(0).margin(0));
+        REQUIRE(fast.getOffset() == slow.getOffset());
+        REQUIRE(fast.getRemainingLength() == slow.getRemainingLength());
+        REQUIRE(fast.getOffset() == std::min<std::size_t>(size, 1 + 2 + 4 + 8 + 5 + 6 + 3 + 8));
+    }
+
+    // Short input reads as zero-filled
+    const auto data = makeArray(0x11, 0x22, 0x33);
+    presentation::StreamDecoder<const std::uint8_t*> decoder(data.data(), data.data() + data.size());
+    REQUIRE(decoder.fetchU32() == 0x332211U);
+    REQUIRE(decoder.fetchU16() == 0);
+    REQUIRE(decoder.getOffset() == 3);
+}
+
+
+namespace
+{
+
+struct FieldCodecSample
+{
+    enum class Mode : std::int8_t
+    {
+        A = 1,
+        B = -2,
+    };
+
+    std::uint8_t a = 0;
+    bool b = false;
+    std::int16_t c = 0;
+    std::size_t d = 0;
+    std::int64_t e = 0;
+    float f = 0;
+    double g = 0;
+    double h = 0;
+    Mode mode{};
+    std::chrono::duration<std::uint32_t, std::micro> period{};
+    std::array<std::uint8_t, 3> bytes{};
+};
+
+using FieldCodecSampleCodec = presentation::FieldCodec<FieldCodecSample,
+                                                       presentation::Field<&FieldCodecSample::a>,
+                                                       presentation::Field<&FieldCodecSample::b>,
+                                                       presentation::Field<&FieldCodecSample::c>,
+                                                       presentation::Field<&FieldCodecSample::d, 2>,
+                                                       presentation::Field<&FieldCodecSample::e, 4>,
+                                                       presentation::Field<&FieldCodecSample::f>,
+                                                       presentation::Field<&FieldCodecSample::g>,
+                                                       presentation::Field<&FieldCodecSample::h, 4>,
+                                                       presentation::Field<&FieldCodecSample::mode>,
+                                                       presentation::Field<&FieldCodecSample::period>,
+                                                       presentation::Field<&FieldCodecSample::bytes>>;
+
+}
+
+
+TEST_CASE("FieldCodec")
+{
+    using Codec = FieldCodecSampleCodec;
+    using presentation::FieldKind;
+
+    static_assert(Codec::EncodedSize == 1 + 1 + 2 + 2 + 4 + 4 + 8 + 4 + 1 + 4 + 3);
+    static_assert(Codec::MinEncodedSize == Codec::MaxEncodedSize);
+    static_assert(Codec::Descriptors.size() == 11);
+    static_assert(Codec::Descriptors[3].offset == 4);
+    static_assert(Codec::Descriptors[3].width == 2);
+    static_assert(Codec::Descriptors[4].kind == FieldKind::Signed);
+    static_assert(Codec::Descriptors[7].kind == FieldKind::IEEE754);
+    static_assert(Codec::Descriptors[8].kind == FieldKind::Signed);
+    static_assert(Codec::Descriptors[9].kind == FieldKind::Unsigned);
+    static_assert(Codec::Descriptors[10].offset == 31);
+    static_assert(Codec::Descriptors[10].kind == FieldKind::Bytes);
+    static_assert(presentation::Field<&FieldCodecSample::bytes>::IsMemcpyCompatible);
+    static_assert(!presentation::Field<&FieldCodecSample::b>::IsMemcpyCompatible);
+    static_assert(!presentation::Field<&FieldCodecSample::d, 2>::IsMemcpyCompatible);
+
+    FieldCodecSample obj;
+    obj.a = 0x12;
+    obj.b = true;
+    obj.c = -2;
+    obj.d = 0xABCD;
+    obj.e = -3;
+    obj.f = 1.0F;
+    obj.g = -2.0;
+    obj.h = 0.5;
+    obj.mode = FieldCodecSample::Mode::B;
+    obj.period = std::chrono::microseconds(0x01020304);
+    obj.bytes = {{7, 8, 9}};
+
+    const auto reference = makeArray(0x12,
+                                     1,
+                                     0xFE, 0xFF,
+                                     0xCD, 0xAB,
+                                     0xFD, 0xFF, 0xFF, 0xFF,
+                                     0x00, 0x00, 0x80, 0x3F,
+                                     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0,
+                                     0x00, 0x00, 0x00, 0x3F,
+                                     0xFE,
+                                     0x04, 0x03, 0x02, 0x01,
+                                     7, 8, 9);
+    static_assert(reference.size() == Codec::EncodedSize);
+
+    // Both encoders produce the same output, which is identical to the manually encoded one
+    {
+        std::vector<std::uint8_t> buf;
+        presentation::StreamEncoder encoder(std::back_inserter(buf));
+        Codec::encode(obj, encoder);
+        REQUIRE(encoder.getOffset() == Codec::EncodedSize);
+        REQUIRE(std::equal(buf.begin(), buf.end(), reference.begin(), reference.end()));
+    }
+    {
+        std::array<std::uint8_t, Codec::EncodedSize + 1> buf{};
+        REQUIRE(Codec::encode(obj, buf.data()) == Codec::EncodedSize);
+        REQUIRE(std::equal(reference.begin(), reference.end(), buf.begin()));
+        REQUIRE(buf.back() == 0);
+    }
+
+    const auto check = [](const FieldCodecSample& x)
+    {
+        REQUIRE(x.a == 0x12);
+        REQUIRE(x.b);
+        REQUIRE(x.c == -2);
+        REQUIRE(x.d == 0xABCD);
+        REQUIRE(x.e == -3);         // Sign-extended
+        REQUIRE(x.f == Approx(1.0F));
+        REQUIRE(x.g == Approx(-2.0));
+        REQUIRE(x.h == Approx(0.5));
+        REQUIRE(x.mode == FieldCodecSample::Mode::B);
+        REQUIRE(x.period.count() == 0x01020304);
+        REQUIRE(x.bytes == std::array<std::uint8_t, 3>{{7, 8, 9}});
+    };
+
+    {
+        FieldCodecSample x;
+        presentation::StreamDecoder decoder(reference.begin(), reference.end());
+        Codec::decode(x, decoder);
+        REQUIRE(decoder.getRemainingLength() == 0);
+        check(x);
+    }
+    {
+        FieldCodecSample x;
+        Codec::decode(x, reference.data());
+        check(x);
+    }
+    {
+        const auto x = Codec::tryDecode(reference.data(), reference.data() + reference.size());
+        REQUIRE(x);
+        check(*x);
+        REQUIRE_FALSE(Codec::tryDecode(reference.data(), reference.data() + reference.size() - 1));
+    }
+
+    // Short input: the missing bytes read as zero, same as with a non-contiguous input
+    {
+        const std::deque<std::uint8_t> bytewise(reference.begin(), reference.end() - 6);
+        FieldCodecSample x;
+        FieldCodecSample y;
+        presentation::StreamDecoder contiguous_decoder(reference.data(), reference.data() + reference.size() - 6);
+        presentation::StreamDecoder bytewise_decoder(bytewise.begin(), bytewise.end());
+        Codec::decode(x, contiguous_decoder);
+        Codec::decode(y, bytewise_decoder);
+        REQUIRE(contiguous_decoder.getRemainingLength() == 0);
+        REQUIRE(contiguous_decoder.getOffset() == Codec::EncodedSize - 6);
+        REQUIRE(x.mode == FieldCodecSample::Mode::B);
+        REQUIRE(x.period.count() == 0x04);
+        REQUIRE(x.period == y.period);
+        REQUIRE(x.h == Approx(0.5));
+    }
+
+    // Any non-zero value decodes as true
+    auto modified = reference;
+    modified[1] = 0x55;
+    REQUIRE(Codec::tryDecode(modified.data(), modified.data() + modified.size())->b);
+}
+
+
+TEST_CASE("Compression")
+{
+    using presentation::compression::compress;
+    using presentation::compression::decompress;
+
+    const auto roundTrip = [](const std::vector<std::uint8_t>& data)
+    {
+        std::vector<std::uint8_t> compressed(data.size() + data.size() / 128 + 1);
+        const auto size = compress(data.data(), data.size(), compressed.data(), compressed.size());
+        REQUIRE(size);
+        std::vector<std::uint8_t> decompressed(data.size() + 1);
+        REQUIRE(decompress(compressed.data(), *size, decompressed.data(), decompressed.size()) == data.size());
+        decompressed.pop_back();
+        REQUIRE(decompressed == data);
+        return *size;
+    };
+
+    // Known encoding: a literal followed by an overlapping match
+    {
+        const std::uint8_t in[] = {'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a'};
+        std::array<std::uint8_t, 16> out{};
+        REQUIRE(compress(in, sizeof(in), out.data(), out.size()) == 5U);
+        REQUIRE(std::equal(out.begin(), out.begin() + 5, makeArray(0x00, 'a', 0x83, 1, 0).begin()));
+        REQUIRE_FALSE(compress(in, sizeof(in), out.data(), 4));
+    }
+
+    REQUIRE(roundTrip({}) == 0);
+    REQUIRE(roundTrip({1, 2, 3}) == 4);
+    REQUIRE(roundTrip(std::vector<std::uint8_t>(1000, 0)) < 30);
+
+    // Random data, including incompressible data, runs, and repeated fragments
+    for (int iteration = 0; iteration < 300; iteration++)
+    {
+        std::vector<std::uint8_t> data;
+        const std::size_t size = std::size_t(getRandomByte()) * std::size_t(getRandomByte() % 32U);
+        while (data.size() < size)
+        {
+            const std::uint8_t mode = getRandomByte() % 3U;
+            const std::size_t n = std::size_t(getRandomByte() % 64U) + 1U;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                if (mode == 0)
+                {
+                    data.push_back(getRandomByte());
+                }
+                else if ((mode == 1) || (data.size() < 300))
+                {
+                    data.push_back(std::uint8_t(iteration));
+                }
+                else
+                {
+                    data.push_back(data[data.size() - 300]);
+                }
             }
-            senoval::String<65535> out = "Some garbage";
-            decoder.fetchASCIIString(out);
-            REQUIRE(out == str);
-            REQUIRE(decoder.getOffset() == encoder.getOffset());
-            break;
         }
-        default:
+        (void) roundTrip(data);
+    }
+
+    // Malformed input
+    std::array<std::uint8_t, 16> out{};
+    REQUIRE(decompress(makeArray(1, 'a', 'b').data(), 3, out.data(), out.size()) == 2U);
+    REQUIRE_FALSE(decompress(makeArray(2, 'a', 'b').data(), 3, out.data(), out.size()));       // Truncated
+    REQUIRE_FALSE(decompress(makeArray(1, 'a', 'b').data(), 3, out.data(), 1));                // Overflow
+    REQUIRE(decompress(makeArray(0, 'a', 0x80, 1, 0).data(), 5, out.data(), out.size()) == 5U);
+    REQUIRE_FALSE(decompress(makeArray(0, 'a', 0x80, 1, 0).data(), 5, out.data(), 4));         // Overflow
+    REQUIRE_FALSE(decompress(makeArray(0, 'a', 0x80, 1).data(), 4, out.data(), out.size()));   // Truncated
+    REQUIRE_FALSE(decompress(makeArray(0, 'a', 0x80, 0, 0).data(), 5, out.data(), out.size()));   // Zero distance
+    REQUIRE_FALSE(decompress(makeArray(0, 'a', 0x80, 2, 0).data(), 5, out.data(), out.size()));   // Too far back
+}
+
+
+TEST_CASE("FrameCompression")
+{
+    standard::EndpointInfoMessage msg;
+    msg.software_version.major = 1;
+    msg.endpoint_name = "com.zubax.telega";
+    msg.endpoint_description = "Zubax Myxa";
+    const auto encoded = msg.encode();
+
+    presentation::FrameCompressor<> compressor;
+    presentation::FrameDecompressor<> decompressor;
+    transport::Parser<> parser;
+
+    const auto transfer = [&](transport::BufferedEmitter emitter)
+    {
+        transport::ParserOutput out;
+        while (!emitter.isFinished())
         {
-            assert(false);
-        }
+            out = decompressor.process(parser.processNextByte(emitter.getNextByte()));
         }
+        return out;
+    };
+
+    // Compressible frame
+    REQUIRE(compressor.compress(presentation::StandardFrameTypeCode, encoded.data(), encoded.size()));
+    REQUIRE(compressor.getTypeCode() == presentation::CompressedFrameTypeCode);
+    REQUIRE(compressor.getPayloadData()[0] == presentation::StandardFrameTypeCode);
+    REQUIRE(compressor.getPayloadSize() < (encoded.size() / 4));
+    {
+        const auto out = transfer(compressor.makeEmitter());
+        REQUIRE(out.getReceivedFrame());
+        REQUIRE(out.getReceivedFrame()->type_code == presentation::StandardFrameTypeCode);
+        REQUIRE(std::equal(encoded.begin(), encoded.end(),
+                           out.getReceivedFrame()->payload.begin(), out.getReceivedFrame()->payload.end()));
+        REQUIRE(standard::EndpointInfoMessage::tryDecode(out.getReceivedFrame()->payload.begin(),
+                                                         out.getReceivedFrame()->payload.end())->endpoint_name ==
+                "com.zubax.telega");
     }
 
-    std::cout << "Randomized stream decoder test has finished running." << std::endl;
-    std::cout << "decoder.getOffset()          = " << decoder.getOffset() << std::endl;
-    std::cout << "decoder.getRemainingLength() = " << decoder.getRemainingLength() << std::endl;
+    // Incompressible frames are emitted as-is
+    std::array<std::uint8_t, 100> random{};
+    for (auto& x : random)
+    {
+        x = getRandomByte();
+    }
+    REQUIRE_FALSE(compressor.compress(123, random.data(), random.size()));
+    REQUIRE(compressor.getTypeCode() == 123);
+    REQUIRE(compressor.getPayloadData() == random.data());
+    REQUIRE(compressor.getPayloadSize() == random.size());
+    {
+        const auto out = transfer(compressor.makeEmitter());
+        REQUIRE(out.getReceivedFrame());
+        REQUIRE(out.getReceivedFrame()->type_code == 123);
+        REQUIRE(std::equal(random.begin(), random.end(),
+                           out.getReceivedFrame()->payload.begin(), out.getReceivedFrame()->payload.end()));
+    }
 
-    REQUIRE(decoder.getOffset() == encoder.getOffset());
-    REQUIRE(encoder.getOffset() == vec->size());
-    REQUIRE(decoder.getRemainingLength() == (vec->capacity() - vec->size()));
+    // Frames that do not fit into the buffer after compression are emitted as-is
+    presentation::FrameCompressor<16> small_compressor;
+    REQUIRE_FALSE(small_compressor.compress(presentation::StandardFrameTypeCode, encoded.data(), encoded.size()));
+    REQUIRE(small_compressor.getTypeCode() == presentation::StandardFrameTypeCode);
 
-    std::cout << "Decoder test type tag usage:" << std::endl;
-    std::uint64_t total = 0;
-    for (auto p : stats)
+    // Malformed compressed frames are reported as extraneous data
     {
-        total += p.second;
-        std::cout << int(p.first) << ": " << p.second << std::endl;
+        const auto payload = makeArray(presentation::StandardFrameTypeCode, 0x80, 5, 0);
+        const auto out = transfer(transport::BufferedEmitter(presentation::CompressedFrameTypeCode,
+                                                             payload.data(), payload.size()));
+        REQUIRE_FALSE(out.getReceivedFrame());
+        REQUIRE(out.getExtraneousData());
+        REQUIRE(out.getExtraneousData()->size() == payload.size());
+    }
+    {
+        const auto payload = makeArray(presentation::CompressedFrameTypeCode, 0, 0);    // Nested compression
+        const auto out = transfer(transport::BufferedEmitter(presentation::CompressedFrameTypeCode,
+                                                             payload.data(), payload.size()));
+        REQUIRE(out.getExtraneousData());
     }
-    std::cout << "Total: " << total << std::endl;
 }
 
 
@@ -1098,6 +3034,26 @@ TEST_CASE("EndpointInfoMessage")
         REQUIRE(!m->software_version.image_crc.has_value());
         REQUIRE(!m->software_version.release_build);
         REQUIRE(!m->software_version.dirty_build);
+        REQUIRE(!m->register_schema_hash.has_value());
+    }
+
+    {
+        auto ccm = carefully_crafted_message;
+        // The schema hash is ignored unless the flag is set
+        ccm[22 + standard::MessageHeader::Size] = 0x34;
+        ccm[23 + standard::MessageHeader::Size] = 0x12;
+        REQUIRE(!standard::EndpointInfoMessage::tryDecode(ccm.begin(), ccm.end())->register_schema_hash);
+
+        ccm[20 + standard::MessageHeader::Size] |= 8U;
+        const auto m = standard::EndpointInfoMessage::tryDecode(ccm.begin(), ccm.end());
+        REQUIRE(m);
+        REQUIRE(*m->register_schema_hash == 0x1234);
+        REQUIRE(m->software_version.dirty_build);
+        REQUIRE(m->encode() == ccm);
+
+        auto m3 = msg;
+        m3.register_schema_hash = 0x1234;
+        REQUIRE(m3.encode() == ccm);
     }
 }
 
@@ -1711,6 +3667,125 @@ TEST_CASE("RegisterValueDecoding")
 }
 
 
+TEST_CASE("RegisterValueView")
+{
+    using standard::RegisterValue;
+    using standard::RegisterValueView;
+
+    const auto go = [](auto... values) -> std::optional<RegisterValueView>
+    {
+        static std::vector<std::uint8_t> data;      // The view refers to the data, so it must outlive it
+        data = {std::uint8_t(values)...};
+        return RegisterValueView::tryDecode(data.data(), data.data() + data.size());
+    };
+
+    REQUIRE      (go());        // Deducing empty value as a last resort
+    REQUIRE      (go(0));
+    REQUIRE      (go(0)->is<RegisterValue::Empty>());
+    REQUIRE      (go(0, 1, 2, 3)->is<RegisterValue::Empty>());
+    REQUIRE_FALSE(go(99));                  // Bad type ID
+    REQUIRE      (go(1, 48)->as<RegisterValue::String>() == std::string_view("0"));
+    REQUIRE      (go(1, 48, 0, 49)->as<RegisterValue::String>() == std::string_view("0"));
+    REQUIRE_FALSE(go(1, 48)->as<RegisterValue::U8>());
+    REQUIRE      (go(1, 48)->decode().as<RegisterValue::String>()->operator==("0"));
+
+    {
+        const auto value = go(10, 0x34, 0x12, 0x78, 0x56, 0xFF);    // U16, the last byte is ignored
+        REQUIRE(value->getTypeID() == 10);
+        REQUIRE(value->is<RegisterValue::U16>());
+        const auto elements = value->as<RegisterValue::U16>();
+        REQUIRE(elements->size() == 2);
+        REQUIRE(elements->at(0) == 0x1234);
+        REQUIRE((*elements)[1] == 0x5678);
+        REQUIRE(value->decode() == RegisterValue(RegisterValue::U16{0x1234, 0x5678}));
+    }
+
+    {
+        const auto value = go(3, 0, 1, 2);
+        const auto elements = value->as<RegisterValue::Boolean>();
+        REQUIRE(elements->size() == 3);
+        REQUIRE(!elements->at(0));
+        REQUIRE(elements->at(1));
+        REQUIRE(elements->at(2));
+        REQUIRE(elements->data() == nullptr);
+    }
+
+    {
+        const auto value = go(6, 0xFE, 0xFF);
+        REQUIRE(value->as<RegisterValue::I16>()->at(0) == -2);
+    }
+
+    // In-place access is possible only if the data is aligned
+    {
+        alignas(8) std::array<std::uint8_t, 24> data{};
+        data[0] = 13;                               // F32 with the payload at offset 1
+        data[7] = 12;                               // F64 with the payload at offset 8
+        data[8] = 1;
+        const auto misaligned = RegisterValueView::tryDecode(data.data(), data.data() + 9);
+        const auto aligned = RegisterValueView::tryDecode(data.data() + 7, data.data() + 24);
+        REQUIRE(misaligned->as<RegisterValue::F32>()->size() == 2);
+        REQUIRE(misaligned->as<RegisterValue::F32>()->data() == nullptr);
+        REQUIRE(aligned->as<RegisterValue::F64>()->size() == 2);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        REQUIRE(aligned->as<RegisterValue::F64>()->data() == static_cast<const void*>(data.data() + 8));
+        REQUIRE(aligned->as<RegisterValue::F64>()->data()[0] == aligned->as<RegisterValue::F64>()->at(0));
+#endif
+    }
+
+    // The views must be equivalent to the regular decoder
+    for (int iteration = 0; iteration < 10000; iteration++)
+    {
+        using RegisterData = standard::RegisterDataRequestMessage;
+        const auto encoded = makeRandomRegisterData<RegisterData>().encode();
+        const auto reference = RegisterData::tryDecode(encoded.begin(), encoded.end());
+        const auto view = standard::RegisterDataRequestView::tryDecode(encoded.data(),
+                                                                       encoded.data() + encoded.size());
+        REQUIRE(reference);
+        REQUIRE(view);
+        REQUIRE(view->name == std::string_view(reference->name.c_str(), reference->name.length()));
+        REQUIRE(view->value.getTypeID() == reference->value.index());
+
+        reference->value.visit([&](const auto& ref)
+        {
+            using T = std::decay_t<decltype(ref)>;
+            if constexpr (std::is_same_v<T, RegisterValue::Empty>)
+            {
+                REQUIRE(view->value.is<T>());
+            }
+            else if constexpr (std::is_same_v<T, RegisterValue::String>)
+            {
+                REQUIRE(view->value.as<T>() == std::string_view(ref.c_str(), ref.length()));
+            }
+            else
+            {
+                const auto elements = view->value.as<T>();
+                REQUIRE(elements);
+                REQUIRE(elements->size() == ref.size());
+                for (std::size_t i = 0; i < ref.size(); i++)
+                {
+                    const auto a = elements->at(i);
+                    const auto b = ref[i];
+                    REQUIRE(std::memcmp(&a, &b, sizeof(a)) == 0);         // NaN compare non-equal
+                }
+            }
+        });
+    }
+
+    // Malformed messages are rejected
+    REQUIRE_FALSE(standard::RegisterDataRequestView::tryDecode(nullptr, nullptr));
+    {
+        const auto data = makeArray(std::uint8_t(standard::MessageID::RegisterDataRequest), 0, 5, 'a');
+        REQUIRE_FALSE(standard::RegisterDataRequestView::tryDecode(data.data(), data.data() + data.size()));
+    }
+    {
+        const auto data = makeArray(std::uint8_t(standard::MessageID::RegisterDataRequest), 0, 1, 'a', 9, 1, 2);
+        const auto view = standard::RegisterDataRequestView::tryDecode(data.data(), data.data() + data.size());
+        REQUIRE(view->name == "a");
+        REQUIRE(view->value.is<RegisterValue::U32>());
+        REQUIRE(view->value.as<RegisterValue::U32>()->empty());
+    }
+}
+
 TEST_CASE("RegisterDataResponse")
 {
     using standard::MessageID;
@@ -1797,6 +3872,312 @@ TEST_CASE("RegisterDataResponse")
 }
 
 
+TEST_CASE("RegisterBatchData")
+{
+    using standard::MessageID;
+    using standard::RegisterValue;
+    using standard::RegisterBatchDataRequestMessage;
+    using standard::RegisterBatchDataResponseMessage;
+    using standard::RegisterBatchDataRequestView;
+
+    SECTION("request")
+    {
+        const auto decode = [](const auto& container)
+        {
+            return RegisterBatchDataRequestMessage::tryDecode(container.begin(), container.end());
+        };
+
+        RegisterBatchDataRequestMessage msg;
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0));
+        REQUIRE(decode(msg.encode())->items.empty());
+
+        RegisterBatchDataRequestMessage::Item item;
+        item.name = "ab";
+        REQUIRE(msg.tryAdd(item));
+        item.name = "c";
+        item.value = RegisterValue::U16{0x1234, 0x5678};
+        REQUIRE(msg.tryAdd(item));
+        REQUIRE(msg.getEncodedSize() == 15);
+
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0,
+                                          2, 'a', 'b', 1, 0, 0,                     // read "ab"
+                                          1, 'c', 5, 0, 10, 0x34, 0x12, 0x78, 0x56  // write "c"
+        ));
+
+        const auto decoded = decode(msg.encode());
+        REQUIRE(decoded);
+        REQUIRE(decoded->items.size() == 2);
+        REQUIRE(decoded->items[0].name == "ab");
+        REQUIRE(decoded->items[0].value.is<RegisterValue::Empty>());
+        REQUIRE(decoded->items[1].name == "c");
+        REQUIRE(decoded->items[1].value == item.value);
+        REQUIRE(decoded->encode() == msg.encode());
+
+        // Zero-length value is an empty value
+        REQUIRE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0,
+                                 1, 'a', 0, 0))->items[0].value.is<RegisterValue::Empty>());
+
+        // Malformed messages
+        REQUIRE_FALSE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataResponse), 0)));
+        REQUIRE_FALSE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0, 1, 'a', 0)));
+        REQUIRE_FALSE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0, 1, 'a', 2, 0, 0)));
+        REQUIRE_FALSE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0, 1, 'a', 1, 0, 99)));
+
+        // The size limit is respected
+        RegisterBatchDataRequestMessage big;
+        item.value.emplace<RegisterValue::U8>(RegisterValue::U8::Capacity, 0);
+        while (big.tryAdd(item)) { }
+        REQUIRE(big.items.size() == 3);
+        REQUIRE(big.getEncodedSize() <= RegisterBatchDataRequestMessage::MaxEncodedSize);
+        REQUIRE(big.encode().size() == big.getEncodedSize() + standard::MessageHeader::Size);
+        REQUIRE(decode(big.encode())->items.size() == 3);
+
+        item.value.emplace<RegisterValue::Empty>();
+        big.items.clear();
+        while (big.tryAdd(item)) { }
+        REQUIRE(big.items.size() == RegisterBatchDataRequestMessage::MaxItems);
+    }
+
+    SECTION("view")
+    {
+        const auto encodeValue = [](const RegisterValue& value)
+        {
+            std::vector<std::uint8_t> out;
+            presentation::StreamEncoder encoder(std::back_inserter(out));
+            value.encode(encoder);
+            REQUIRE(out.size() == value.getEncodedSize());
+            return out;
+        };
+
+        for (int iteration = 0; iteration < 1000; iteration++)
+        {
+            RegisterBatchDataRequestMessage msg;
+            while (msg.tryAdd({makeRandomRegisterData<standard::RegisterDataRequestMessage>().name,
+                               makeRandomRegisterData<standard::RegisterDataRequestMessage>().value}))
+            {
+                if (getRandomByte() < 32)
+                {
+                    break;
+                }
+            }
+
+            const auto encoded = msg.encode();
+            const auto view = RegisterBatchDataRequestView::tryDecode(encoded.data(), encoded.data() + encoded.size());
+            REQUIRE(view);
+            REQUIRE(view->size() == msg.items.size());
+
+            std::size_t index = 0;
+            view->forEach([&](const std::string_view name, const standard::RegisterValueView& value)
+            {
+                const auto& reference = msg.items[index++];
+                REQUIRE(name == std::string_view(reference.name.c_str(), reference.name.length()));
+                REQUIRE(value.getTypeID() == reference.value.index());
+                REQUIRE(encodeValue(value.decode()) == encodeValue(reference.value));   // NaN compare non-equal
+            });
+            REQUIRE(index == msg.items.size());
+        }
+
+        const auto bad = makeArray(std::uint8_t(MessageID::RegisterBatchDataRequest), 0, 1, 'a', 2, 0, 0);
+        REQUIRE_FALSE(RegisterBatchDataRequestView::tryDecode(bad.data(), bad.data() + bad.size()));
+    }
+
+    SECTION("response")
+    {
+        const auto decode = [](const auto& container)
+        {
+            return RegisterBatchDataResponseMessage::tryDecode(container.begin(), container.end());
+        };
+
+        RegisterBatchDataResponseMessage msg;
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterBatchDataResponse), 0,
+                                          0, 0, 0, 0, 0, 0, 0, 0));
+        REQUIRE(decode(msg.encode())->items.empty());
+        REQUIRE_FALSE(decode(makeArray(std::uint8_t(MessageID::RegisterBatchDataResponse), 0, 0, 0, 0)));
+
+        msg.timestamp = standard::Timestamp(0xDEAD'BEEF'BADC'0FFEULL);
+        RegisterBatchDataResponseMessage::Item item;
+        item.flags.setMutable(true);
+        item.name = "a";
+        item.value = RegisterValue::I8{-1};
+        REQUIRE(msg.tryAdd(item));
+        item.flags.setPersistent(true);
+        item.name = "bc";
+        item.value.emplace<RegisterValue::String>("x");
+        REQUIRE(msg.tryAdd(item));
+
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterBatchDataResponse), 0,
+                                          0xFE, 0x0F, 0xDC, 0xBA, 0xEF, 0xBE, 0xAD, 0xDE,
+                                          1, 1, 'a', 2, 0, 7, 0xFF,
+                                          3, 2, 'b', 'c', 2, 0, 1, 'x'
+        ));
+
+        const auto decoded = decode(msg.encode());
+        REQUIRE(decoded->timestamp == msg.timestamp);
+        REQUIRE(decoded->items.size() == 2);
+        REQUIRE(decoded->items[0].flags.value == 1);
+        REQUIRE(decoded->items[1].flags.value == 3);
+        REQUIRE(decoded->items[1].name == "bc");
+        REQUIRE(decoded->items[1].value == item.value);
+
+        // Item-by-item encoding produces the same result
+        std::vector<std::uint8_t> streamed;
+        presentation::StreamEncoder encoder(std::back_inserter(streamed));
+        RegisterBatchDataResponseMessage::encodeFixedPart(encoder, msg.timestamp);
+        for (auto& x : msg.items)
+        {
+            RegisterBatchDataResponseMessage::encodeItem(encoder, x);
+        }
+        const auto encoded = msg.encode();
+        REQUIRE(std::equal(streamed.begin(), streamed.end(), encoded.begin(), encoded.end()));
+    }
+}
+
+
+TEST_CASE("RegisterTrace")
+{
+    using standard::MessageID;
+    using standard::Timestamp;
+    using standard::RegisterValue;
+    using standard::RegisterTrace;
+    using standard::RegisterTraceSetupRequestMessage;
+    using standard::RegisterTraceSetupResponseMessage;
+    using standard::RegisterTraceEventMessage;
+    using standard::RegisterTraceScheduler;
+    using Status = RegisterTraceSetupResponseMessage::Status;
+
+    SECTION("setup")
+    {
+        RegisterTraceSetupRequestMessage msg;
+        msg.trace_id = 7;
+        msg.trigger.value = RegisterTrace::Trigger::Periodic;
+        msg.period = RegisterTrace::Period(100000);
+        RegisterTraceSetupRequestMessage::Item item;
+        item.name = "ab";
+        REQUIRE(msg.tryAdd(item));
+        item.name = "c";
+        REQUIRE(msg.tryAdd(item));
+        REQUIRE(msg.getEncodedSize() == 11);
+
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterTraceSetupRequest), 0,
+                                          7, 1, 0xA0, 0x86, 0x01, 0x00,
+                                          2, 'a', 'b',
+                                          1, 'c'));
+
+        const auto encoded = msg.encode();
+        auto decoded = RegisterTraceSetupRequestMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->trace_id == 7);
+        REQUIRE(decoded->trigger.isPeriodic());
+        REQUIRE_FALSE(decoded->trigger.isOnChange());
+        REQUIRE(decoded->period.count() == 100000);
+        REQUIRE(decoded->items.size() == 2);
+        REQUIRE(decoded->items[0].name == "ab");
+        REQUIRE(decoded->items[1].name == "c");
+
+        // Cancellation
+        const auto cancel = makeArray(std::uint8_t(MessageID::RegisterTraceSetupRequest), 0, 7, 0, 0, 0, 0, 0);
+        decoded = RegisterTraceSetupRequestMessage::tryDecode(cancel.begin(), cancel.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->trigger.isCancel());
+        REQUIRE(decoded->items.empty());
+
+        // Malformed
+        const auto short_msg = makeArray(std::uint8_t(MessageID::RegisterTraceSetupRequest), 0, 7, 0, 0, 0, 0);
+        REQUIRE_FALSE(RegisterTraceSetupRequestMessage::tryDecode(short_msg.begin(), short_msg.end()));
+        const auto bad_name = makeArray(std::uint8_t(MessageID::RegisterTraceSetupRequest), 0, 7, 0, 0, 0, 0, 0, 2, 'a');
+        REQUIRE_FALSE(RegisterTraceSetupRequestMessage::tryDecode(bad_name.begin(), bad_name.end()));
+
+        RegisterTraceSetupResponseMessage resp;
+        resp.trace_id = 7;
+        resp.status = Status::TooManyRegisters;
+        resp.period = RegisterTrace::Period(0x12345678);
+        const auto carr = makeArray(std::uint8_t(MessageID::RegisterTraceSetupResponse), 0,
+                                    7, 2, 0x78, 0x56, 0x34, 0x12);
+        REQUIRE(resp.encode() == carr);
+        const auto resp_decoded = RegisterTraceSetupResponseMessage::tryDecode(carr.begin(), carr.end());
+        REQUIRE(resp_decoded);
+        REQUIRE(resp_decoded->trace_id == 7);
+        REQUIRE(resp_decoded->status == Status::TooManyRegisters);
+        REQUIRE(resp_decoded->period.count() == 0x12345678);
+        REQUIRE_FALSE(RegisterTraceSetupResponseMessage::tryDecode(carr.begin(), carr.end() - 1));
+    }
+
+    SECTION("event")
+    {
+        RegisterTraceEventMessage msg;
+        msg.trace_id = 3;
+        msg.sequence_number = 0x01020304;
+        msg.timestamp = Timestamp(0x1122334455667788ULL);
+        RegisterTraceEventMessage::Item item;
+        REQUIRE(msg.tryAdd(item));
+        item.value = RegisterValue::I8{-1};
+        REQUIRE(msg.tryAdd(item));
+        REQUIRE(msg.getEncodedSize() == 13 + 3 + 4);
+
+        REQUIRE(msg.encode() == makeArray(std::uint8_t(MessageID::RegisterTraceEvent), 0,
+                                          3, 0x04, 0x03, 0x02, 0x01,
+                                          0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11,
+                                          1, 0, 0,
+                                          2, 0, 7, 0xFF));
+
+        const auto encoded = msg.encode();
+        const auto decoded = RegisterTraceEventMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->trace_id == 3);
+        REQUIRE(decoded->sequence_number == 0x01020304);
+        REQUIRE(decoded->timestamp.count() == 0x1122334455667788ULL);
+        REQUIRE(decoded->items.size() == 2);
+        REQUIRE(decoded->items[0].value.is<RegisterValue::Empty>());
+        REQUIRE(decoded->items[1].value == item.value);
+        REQUIRE(decoded->encode() == encoded);
+
+        REQUIRE_FALSE(RegisterTraceEventMessage::tryDecode(encoded.begin(), encoded.end() - 1));
+        REQUIRE_FALSE(RegisterTraceEventMessage::tryDecode(encoded.begin(), encoded.begin() + 14));
+    }
+
+    SECTION("scheduler")
+    {
+        using std::chrono::milliseconds;
+
+        RegisterTraceScheduler sch;
+        REQUIRE_FALSE(sch.isActive());
+        REQUIRE_FALSE(sch.poll(Timestamp(0), true));
+
+        RegisterTrace::Trigger trigger;
+        trigger.value = RegisterTrace::Trigger::Periodic;
+        REQUIRE(sch.setUp(trigger, RegisterTrace::Period(0), Timestamp(0)) == Status::BadTrigger);
+        REQUIRE_FALSE(sch.isActive());
+
+        // Periodic, 10 ms
+        REQUIRE(sch.setUp(trigger, RegisterTrace::Period(10000), milliseconds(100)) == Status::Ok);
+        REQUIRE(sch.isActive());
+        REQUIRE(sch.poll(milliseconds(100), false) == 0U);
+        REQUIRE_FALSE(sch.poll(milliseconds(105), false));
+        REQUIRE(sch.poll(milliseconds(111), false) == 1U);
+        REQUIRE(sch.poll(milliseconds(120), false) == 2U);          // No drift: the deadline was 120 ms
+        REQUIRE(sch.poll(milliseconds(175), false) == 3U);          // Fell behind; the missed events are skipped
+        REQUIRE_FALSE(sch.poll(milliseconds(180), false));
+        REQUIRE(sch.poll(milliseconds(185), false) == 4U);
+
+        // On change, rate limited at 10 ms
+        trigger.value = RegisterTrace::Trigger::OnChange;
+        REQUIRE(sch.setUp(trigger, RegisterTrace::Period(10000), milliseconds(200)) == Status::Ok);
+        REQUIRE_FALSE(sch.poll(milliseconds(200), false));
+        REQUIRE(sch.poll(milliseconds(201), true) == 0U);
+        REQUIRE_FALSE(sch.poll(milliseconds(205), true));
+        REQUIRE(sch.poll(milliseconds(211), true) == 1U);
+        REQUIRE_FALSE(sch.poll(milliseconds(300), false));
+        REQUIRE(sch.poll(milliseconds(301), true) == 2U);
+
+        // Cancellation
+        trigger.value = 0;
+        REQUIRE(sch.setUp(trigger, RegisterTrace::Period(10000), milliseconds(400)) == Status::Ok);
+        REQUIRE_FALSE(sch.isActive());
+        REQUIRE_FALSE(sch.poll(milliseconds(500), true));
+    }
+}
+
+
 TEST_CASE("RegisterDiscoveryRequestMessage")
 {
     using standard::MessageID;
@@ -1860,6 +4241,118 @@ TEST_CASE("RegisterDiscoveryResponseMessage")
 }
 
 
+TEST_CASE("RegisterTable")
+{
+    using standard::RegisterValue;
+    using standard::RegisterName;
+    using Handler = int (*)();
+
+    static constexpr auto Table = standard::makeRegisterTable<Handler>({
+        { "uavcan.node_id", RegisterValue::getTypeID<RegisterValue::U8>(),     +[]() { return 1; } },
+        { "motor.kv",       RegisterValue::getTypeID<RegisterValue::F32>(),    +[]() { return 2; } },
+        { "motor.kv=",      RegisterValue::getTypeID<RegisterValue::F32>(),    +[]() { return 3; } },
+        { "name",           RegisterValue::getTypeID<RegisterValue::String>(), +[]() { return 4; } },
+    });
+    static_assert(Table.isValid());
+    static_assert(Table.size() == 4);
+    static_assert(Table.find("motor.kv")->type_id == 13);
+    static_assert(Table.find("motor.kv=") == Table.at(2));
+    static_assert(Table.find("motor") == nullptr);
+    static_assert(Table.at(4) == nullptr);
+
+    static_assert(RegisterValue::getTypeID<RegisterValue::Empty>() == 0);
+    static_assert(RegisterValue::getTypeID<RegisterValue::Unstructured>() == 2);
+    static_assert(RegisterValue::getTypeID<RegisterValue::U8>() == 11);
+
+    // Invalid tables are detected at compile time
+    static_assert(!standard::makeRegisterTable<int>({ {"a", 0, 0}, {"b", 0, 0}, {"a", 0, 0} }).isValid());
+    static_assert(!standard::makeRegisterTable<int>({ {"", 0, 0} }).isValid());
+    static_assert(!standard::makeRegisterTable<int>({ {"a", RegisterValue::NumberOfVariants, 0} }).isValid());
+
+    REQUIRE(Table.find(RegisterName("uavcan.node_id"))->handler() == 1);
+    REQUIRE(Table.find(RegisterName("name"))->handler() == 4);
+    REQUIRE(Table.find(RegisterName("nam")) == nullptr);
+    REQUIRE(Table.find(RegisterName()) == nullptr);
+    REQUIRE(*Table.findIndex(RegisterName("motor.kv")) == 1);
+    REQUIRE(!Table.findIndex(RegisterName("motor.kv<")));
+
+    standard::RegisterDiscoveryRequestMessage request;
+    request.index = 3;
+    REQUIRE(Table.getDiscoveryResponse(request).index == 3);
+    REQUIRE(Table.getDiscoveryResponse(request).name == "name");
+    request.index = 4;
+    REQUIRE(Table.getDiscoveryResponse(request).index == 4);
+    REQUIRE(Table.getDiscoveryResponse(request).name.empty());
+
+    // The schema hash is sensitive to the names and their order; the reference values are shared with Python
+    static_assert(Table.getSchemaHash() == 0xA510);
+    static_assert(standard::makeRegisterTable<int>({ {"a", 0, 0}, {"b", 0, 0} }).getSchemaHash() == 0xFA01);
+    static_assert(standard::makeRegisterTable<int>({ {"b", 0, 0}, {"a", 0, 0} }).getSchemaHash() != 0xFA01);
+    static_assert(standard::makeRegisterTable<int>({ {"ab", 0, 0} }).getSchemaHash() == 0x27B6);
+
+    // Every entry can be found by name
+    std::size_t index = 0;
+    for (auto& e : Table)
+    {
+        REQUIRE(Table.findIndex(e.name) == index++);
+    }
+    REQUIRE(index == Table.size());
+}
+
+TEST_CASE("RegisterIndexedData")
+{
+    using standard::MessageID;
+    using standard::Timestamp;
+    using standard::RegisterValue;
+    using standard::RegisterIndexedDataRequestMessage;
+    using standard::RegisterIndexedDataResponseMessage;
+
+    RegisterIndexedDataRequestMessage req;
+    REQUIRE(req.encode() == makeArray(std::uint8_t(MessageID::RegisterIndexedDataRequest), 0, 0, 0, 0));
+    req.index = 0x1234;
+    req.value = RegisterValue::F32{1.0F};
+    REQUIRE(req.encode() == makeArray(std::uint8_t(MessageID::RegisterIndexedDataRequest), 0,
+                                      0x34, 0x12, 13, 0x00, 0x00, 0x80, 0x3F));
+    {
+        const auto encoded = req.encode();
+        const auto decoded = RegisterIndexedDataRequestMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->index == 0x1234);
+        REQUIRE(decoded->value == req.value);
+        REQUIRE_FALSE(RegisterIndexedDataRequestMessage::tryDecode(encoded.begin(), encoded.begin() + 4));
+    }
+
+    RegisterIndexedDataResponseMessage resp;
+    resp.timestamp = Timestamp(0x0102030405060708ULL);
+    resp.index = 0x1234;
+    resp.flags.setMutable(true);
+    resp.value = RegisterValue::U8{1, 2};
+    REQUIRE(resp.encode() == makeArray(std::uint8_t(MessageID::RegisterIndexedDataResponse), 0,
+                                       0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+                                       0x34, 0x12, 1,
+                                       11, 1, 2));
+    {
+        const auto encoded = resp.encode();
+        const auto decoded = RegisterIndexedDataResponseMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->timestamp == resp.timestamp);
+        REQUIRE(decoded->index == 0x1234);
+        REQUIRE(decoded->flags.isMutable());
+        REQUIRE_FALSE(decoded->flags.isPersistent());
+        REQUIRE(decoded->value == resp.value);
+        REQUIRE(decoded->encode() == encoded);
+        REQUIRE_FALSE(RegisterIndexedDataResponseMessage::tryDecode(encoded.begin(), encoded.begin() + 13));
+        REQUIRE_FALSE(RegisterIndexedDataRequestMessage::tryDecode(encoded.begin(), encoded.end()));
+    }
+
+    // The same exchange addressed by name takes several times more bytes for a typical register
+    standard::RegisterDataRequestMessage by_name;
+    by_name.name = "motor.position_control.kp";
+    by_name.value = req.value;
+    REQUIRE(by_name.encode().size() > (req.encode().size() * 3));
+}
+
+
 TEST_CASE("DeviceManagementCommandRequestMessage")
 {
     using standard::MessageID;
@@ -1972,6 +4465,29 @@ TEST_CASE("BootloaderStatusResponseMessage")
     REQUIRE(decode(msg.encode())->timestamp.count() == 123456);
     REQUIRE(decode(msg.encode())->flags == 0xBADC0FFEEUL);
     REQUIRE(decode(msg.encode())->state == BootloaderState::BootCancelled);
+
+    // Image data window
+    REQUIRE(msg.getImageDataWindow() == 0xEE);
+    msg.setImageDataWindow(16);
+    REQUIRE(msg.flags == 0xBADC0FF10UL);
+    REQUIRE(decode(msg.encode())->getImageDataWindow() == 16);
+
+    // Max image data size; zero is interpreted as the default
+    REQUIRE(msg.getMaxImageDataSize() == 0xFF * 256);
+    msg.setMaxImageDataSize(1792);
+    REQUIRE(msg.flags == 0xBADC00710UL);
+    REQUIRE(decode(msg.encode())->getMaxImageDataSize() == 1792);
+    REQUIRE(decode(msg.encode())->getImageDataWindow() == 16);
+    msg.flags = 0;
+    REQUIRE(msg.getMaxImageDataSize() == 256);
+
+    // Delta upload
+    REQUIRE_FALSE(msg.isDeltaUploadSupported());
+    msg.setDeltaUploadSupported(true);
+    REQUIRE(msg.flags == 0x10000UL);
+    REQUIRE(decode(msg.encode())->isDeltaUploadSupported());
+    msg.setDeltaUploadSupported(false);
+    REQUIRE(msg.flags == 0);
 }
 
 
@@ -2043,4 +4559,292 @@ TEST_CASE("BootloaderImageData")
 {
     bootloaderImageDataTest<standard::BootloaderImageDataRequestMessage>();
     bootloaderImageDataTest<standard::BootloaderImageDataResponseMessage>();
+    bootloaderImageDataTest<standard::BasicBootloaderImageDataRequestMessage<1024>>();
+    bootloaderImageDataTest<standard::BasicBootloaderImageDataResponseMessage<1024>>();
+
+    static_assert(standard::computeMaxBootloaderImageDataSize(0) == 0);
+    static_assert(standard::computeMaxBootloaderImageDataSize(266) == 0);
+    static_assert(standard::computeMaxBootloaderImageDataSize(267) == 256);
+    static_assert(standard::computeMaxBootloaderImageDataSize(1024) == 768);
+    static_assert(standard::computeMaxBootloaderImageDataSize(2048) == 1792);
+    static_assert(standard::computeMaxBootloaderImageDataSize(1024 * 1024) == standard::BootloaderMaxImageDataSize);
+
+    using LargeRequest = standard::BasicBootloaderImageDataRequestMessage<1792>;
+    static_assert(LargeRequest::MaxEncodedSize + standard::MessageHeader::Size <= 2048);
+
+    // Large chunks are rejected by small messages and accepted by large ones
+    LargeRequest large;
+    large.image_offset = 1792;
+    while (large.image_data.size() < 1792)
+    {
+        large.image_data.push_back(getRandomByte());
+    }
+    const auto encoded = large.encode();
+    REQUIRE(encoded.size() == 1792 + 9 + standard::MessageHeader::Size);
+    REQUIRE_FALSE(standard::BootloaderImageDataRequestMessage::tryDecode(encoded.begin(), encoded.end()));
+    const auto decoded = LargeRequest::tryDecode(encoded.begin(), encoded.end());
+    REQUIRE(decoded);
+    REQUIRE(decoded->image_offset == 1792);
+    REQUIRE(decoded->image_data == large.image_data);
+
+    transport::Parser<> parser;
+    transport::ParserOutput out;
+    transport::BufferedEmitter emitter(presentation::StandardFrameTypeCode, encoded.data(), encoded.size());
+    while (!emitter.isFinished())
+    {
+        out = parser.processNextByte(emitter.getNextByte());
+    }
+    REQUIRE(out.getReceivedFrame() != nullptr);
+    REQUIRE(out.getReceivedFrame()->payload.size() == encoded.size());
+}
+
+
+TEST_CASE("BootloaderImageDigest")
+{
+    using standard::MessageID;
+    using standard::BootloaderImageType;
+    using standard::BootloaderImageDigestRequestMessage;
+    using standard::BootloaderImageDigestResponseMessage;
+
+    BootloaderImageDigestRequestMessage rq;
+    rq.image_offset = 0x12345;
+    rq.image_type = BootloaderImageType::CertificateOfAuthenticity;
+    rq.block_size = 1024;
+    rq.block_count = 64;
+    REQUIRE(rq.encode() == makeArray(std::uint8_t(MessageID::BootloaderImageDigestRequest), 0,
+                                     0x45, 0x23, 0x01, 0, 0, 0, 0, 0,
+                                     1,
+                                     0, 4, 0, 0,
+                                     64));
+    {
+        const auto encoded = rq.encode();
+        const auto decoded = BootloaderImageDigestRequestMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->image_offset == 0x12345);
+        REQUIRE(decoded->image_type == BootloaderImageType::CertificateOfAuthenticity);
+        REQUIRE(decoded->block_size == 1024);
+        REQUIRE(decoded->block_count == 64);
+        REQUIRE_FALSE(BootloaderImageDigestRequestMessage::tryDecode(encoded.begin(), encoded.end() - 1));
+    }
+    {
+        auto encoded = rq.encode();
+        encoded.back() = 65;                                    // Too many blocks
+        REQUIRE_FALSE(BootloaderImageDigestRequestMessage::tryDecode(encoded.begin(), encoded.end()));
+    }
+
+    // The digest is the standard CRC-32C
+    REQUIRE(standard::computeBootloaderImageBlockDigest("123456789", 9) == 0xE3069283U);
+    REQUIRE(standard::computeBootloaderImageBlockDigest(nullptr, 0) == 0);
+
+    BootloaderImageDigestResponseMessage rs;
+    rs.image_offset = 512;
+    rs.block_size = 256;
+    {
+        const auto encoded = rs.encode();
+        REQUIRE(encoded.size() == 15);
+        const auto decoded = BootloaderImageDigestResponseMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->digests.empty());
+        REQUIRE_FALSE(decoded->getDigestAt(512));
+    }
+
+    rs.digests.push_back(0xDEADBEEFU);
+    rs.digests.push_back(0x01020304U);
+    {
+        const auto encoded = rs.encode();
+        REQUIRE(std::vector<std::uint8_t>(encoded.begin(), encoded.end()) ==
+                std::vector<std::uint8_t>{std::uint8_t(MessageID::BootloaderImageDigestResponse), 0,
+                                          0, 2, 0, 0, 0, 0, 0, 0,
+                                          0,
+                                          0, 1, 0, 0,
+                                          0xEF, 0xBE, 0xAD, 0xDE,
+                                          4, 3, 2, 1});
+        const auto decoded = BootloaderImageDigestResponseMessage::tryDecode(encoded.begin(), encoded.end());
+        REQUIRE(decoded);
+        REQUIRE(decoded->image_offset == 512);
+        REQUIRE(decoded->block_size == 256);
+        REQUIRE(decoded->digests == rs.digests);
+        REQUIRE(decoded->getDigestAt(512) == 0xDEADBEEFU);
+        REQUIRE(decoded->getDigestAt(768) == 0x01020304U);
+        REQUIRE_FALSE(decoded->getDigestAt(256));
+        REQUIRE_FALSE(decoded->getDigestAt(600));
+        REQUIRE_FALSE(decoded->getDigestAt(1024));
+
+        // The digests must be complete
+        REQUIRE_FALSE(BootloaderImageDigestResponseMessage::tryDecode(encoded.begin(), encoded.end() - 1));
+    }
+
+    while (rs.digests.size() < standard::BootloaderMaxImageDigestsPerMessage)
+    {
+        rs.digests.push_back(std::uint32_t(rs.digests.size()));
+    }
+    {
+        const auto encoded = rs.encode();
+        REQUIRE(encoded.size() == BootloaderImageDigestResponseMessage::MaxEncodedSize + 2);
+        REQUIRE(BootloaderImageDigestResponseMessage::tryDecode(encoded.begin(), encoded.end())->digests.size() == 64);
+    }
+}
+
+
+TEST_CASE("BootloaderImageUploadWindow")
+{
+    using standard::Timestamp;
+    using Window = standard::BootloaderImageUploadWindow<8>;
+    using std::chrono::milliseconds;
+
+    SECTION("stop-and-wait")
+    {
+        Window win(600, 0, milliseconds(100));
+        REQUIRE(win.getWindowSize() == 1);
+        REQUIRE(win.poll(milliseconds(0)) == 0U);
+        REQUIRE_FALSE(win.poll(milliseconds(0)));
+        REQUIRE_FALSE(win.acknowledge(256, true));          // Not sent yet
+        REQUIRE(win.acknowledge(0, true));
+        REQUIRE_FALSE(win.acknowledge(0, true));            // Duplicate
+        REQUIRE(win.poll(milliseconds(1)) == 256U);
+        REQUIRE(win.acknowledge(256, false));               // Mismatch, retransmitted immediately
+        REQUIRE(win.poll(milliseconds(2)) == 256U);
+        REQUIRE_FALSE(win.poll(milliseconds(50)));
+        REQUIRE(win.poll(milliseconds(102)) == 256U);       // Timed out
+        REQUIRE(win.acknowledge(256, true));
+        REQUIRE(win.poll(milliseconds(103)) == 512U);
+        REQUIRE(win.getChunkSize(512) == 88);
+        REQUIRE_FALSE(win.isComplete());
+        REQUIRE(win.acknowledge(512, true));
+        REQUIRE(win.isComplete());
+        REQUIRE_FALSE(win.poll(milliseconds(200)));
+        REQUIRE(win.getRetransmissionCount() == 2);
+        REQUIRE(win.getNumberOfAcknowledgedBytes() == 600);
+    }
+
+    SECTION("aligned")
+    {
+        // The image size is a multiple of the chunk size, so the last chunk is empty
+        Window win(512, 100, milliseconds(100));
+        REQUIRE(win.getWindowSize() == 8);
+        REQUIRE(win.poll(milliseconds(0)) == 0U);
+        REQUIRE(win.poll(milliseconds(0)) == 256U);
+        REQUIRE_FALSE(win.poll(milliseconds(0)));           // The last chunk waits for the previous ones
+        REQUIRE(win.acknowledge(256, true));                // Out-of-order acknowledgement
+        REQUIRE_FALSE(win.poll(milliseconds(0)));
+        REQUIRE(win.acknowledge(0, true));
+        REQUIRE(win.getNumberOfAcknowledgedBytes() == 512);
+        REQUIRE(win.poll(milliseconds(0)) == 512U);
+        REQUIRE(win.getChunkSize(512) == 0);
+        REQUIRE(win.acknowledge(512, true));
+        REQUIRE(win.isComplete());
+    }
+
+    SECTION("large chunks")
+    {
+        // The chunk size does not exceed the image size, and it is always a multiple of 256
+        REQUIRE(Window(100, 4, milliseconds(1), 1024).getNominalChunkSize() == 256);
+        REQUIRE(Window(700, 4, milliseconds(1), 1024).getNominalChunkSize() == 512);
+        REQUIRE(Window(5000, 4, milliseconds(1), 1000).getNominalChunkSize() == 768);
+
+        Window win(2500, 4, milliseconds(100), 1024);
+        REQUIRE(win.getNominalChunkSize() == 1024);
+        REQUIRE(win.poll(milliseconds(0)) == 0U);
+        REQUIRE(win.poll(milliseconds(0)) == 1024U);
+        REQUIRE_FALSE(win.poll(milliseconds(0)));
+        REQUIRE_FALSE(win.acknowledge(256, true));
+        REQUIRE(win.acknowledge(1024, true));
+        REQUIRE(win.acknowledge(0, true));
+        REQUIRE(win.poll(milliseconds(0)) == 2048U);
+        REQUIRE(win.getChunkSize(2048) == 452);
+        REQUIRE(win.acknowledge(2048, true));
+        REQUIRE(win.isComplete());
+    }
+
+    SECTION("delta")
+    {
+        // The first and the last chunks are always sent; the window limits how far ahead the chunks are skipped
+        Window win(10 * 256 + 1, 2, milliseconds(100));
+        std::vector<std::uint64_t> queried;
+        const auto skip = [&](std::uint64_t offset)
+        {
+            queried.push_back(offset);
+            return offset != 5 * 256;
+        };
+        REQUIRE(win.poll(milliseconds(0), skip) == 0U);
+        REQUIRE(queried.empty());
+        REQUIRE_FALSE(win.poll(milliseconds(0), skip));                             // Skipped up to the window
+        REQUIRE(queried == std::vector<std::uint64_t>{256});
+        REQUIRE(win.acknowledge(0, true));
+        REQUIRE(win.getNumberOfAcknowledgedBytes() == 512);
+        REQUIRE(win.poll(milliseconds(0), skip) == 5 * 256U);
+        REQUIRE(queried == std::vector<std::uint64_t>{256, 512, 768, 1024, 1280});
+        REQUIRE_FALSE(win.poll(milliseconds(0), skip));
+        REQUIRE(win.acknowledge(5 * 256, true));
+        REQUIRE(win.getNumberOfAcknowledgedBytes() == 7 * 256);
+        REQUIRE(win.poll(milliseconds(0), skip) == 10 * 256U);
+        REQUIRE(queried.back() == 9 * 256);
+        REQUIRE(win.getChunkSize(10 * 256) == 1);
+        REQUIRE(win.acknowledge(10 * 256, true));
+        REQUIRE(win.isComplete());
+        REQUIRE(win.getNumberOfSkippedChunks() == 8);
+        REQUIRE(win.getRetransmissionCount() == 0);
+    }
+
+    SECTION("lossy")
+    {
+        // Simulated link that loses, corrupts, and reorders responses
+        const std::uint64_t image_size = 100 * 1024 + 17;
+        Window win(image_size, 8, milliseconds(10));
+        std::vector<std::uint8_t> written(image_size / 256 + 1, 0);
+        std::vector<std::uint64_t> responses;
+        Timestamp now{};
+        std::size_t iterations = 0;
+        while (!win.isComplete())
+        {
+            REQUIRE(iterations++ < 100000);
+            while (const auto offset = win.poll(now))
+            {
+                REQUIRE((*offset % 256) == 0);
+                REQUIRE(win.getNumberOfChunksInFlight() <= 8);
+                written.at(std::size_t(*offset / 256))++;
+                if ((getRandomByte() % 8) != 0)
+                {
+                    responses.push_back(*offset);
+                }
+            }
+            std::shuffle(responses.begin(), responses.end(), std::mt19937(getRandomByte()));
+            for (auto offset : responses)
+            {
+                (void) win.acknowledge(offset, (getRandomByte() % 16) != 0);
+            }
+            responses.clear();
+            now += milliseconds(3);
+        }
+        REQUIRE(win.getNumberOfAcknowledgedBytes() == image_size);
+        REQUIRE(win.getRetransmissionCount() > 0);
+        REQUIRE(std::all_of(written.begin(), written.end(), [](auto x) { return x > 0; }));
+        REQUIRE(written.back() > 0);
+    }
+}
+
+
+TEST_CASE("Footprint")
+{
+    using standard::footprint;
+    using standard::EndpointInfoMessage;
+    using standard::RegisterDataRequestMessage;
+    using standard::DeviceManagementCommandRequestMessage;
+
+    constexpr auto info = footprint<EndpointInfoMessage>();
+    static_assert(info.object_size == sizeof(EndpointInfoMessage));
+    static_assert(info.max_encoded_size == 617);
+    static_assert(info.encode_buffer_size >= info.max_encoded_size);
+    static_assert(info.decode_temporary_size > 2 * info.object_size);
+    static_assert(info.getPeakSize() >= info.object_size + info.encode_buffer_size);
+
+    // Fixed-size messages have no size field in the buffer
+    constexpr auto cmd = footprint<DeviceManagementCommandRequestMessage>();
+    static_assert(cmd.max_encoded_size == DeviceManagementCommandRequestMessage::EncodedSize + 2);
+    static_assert(cmd.encode_buffer_size == cmd.max_encoded_size);
+
+    static_assert(standard::checkFootprintBudget<8192, EndpointInfoMessage, RegisterDataRequestMessage>());
+    static_assert(standard::checkFootprintBudget<info.getPeakSize(), EndpointInfoMessage>());
+
+    REQUIRE(footprint<RegisterDataRequestMessage>().object_size >= sizeof(standard::RegisterValue));
 }
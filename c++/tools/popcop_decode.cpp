@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Zubax Robotics
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+ */
+
+/*
+ * Offline decoder of raw link dumps, e.g. produced with "cat /dev/ttyACM0 > dump.bin".
+ * The dump is parsed on all CPU cores; the tool prints the number of occurrences of every frame type
+ * and every standard message.
+ *
+ *      popcop_decode <dump-file> [number-of-threads]
+ */
+
+// The library should be included first in order to ensure that all necessary headers are included in the library itself
+#include <popcop_linux.hpp>
+#include <popcop_host.hpp>
+
+// Tool-only dependencies
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <map>
+
+
+using namespace popcop;
+
+int main(int argc, char** argv)
+{
+    if ((argc < 2) || (argc > 3))
+    {
+        std::cerr << "Usage: " << argv[0] << " <dump-file> [number-of-threads]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const host::MappedFile file(argv[1], MADV_SEQUENTIAL);
+        const std::size_t number_of_threads = (argc > 2) ?
+            std::size_t(std::strtoul(argv[2], nullptr, 10)) :
+            std::size_t(std::max(1U, std::thread::hardware_concurrency()));
+
+        std::map<std::uint8_t, std::size_t> frames;
+        std::map<std::uint16_t, std::size_t> messages;
+        std::size_t malformed = 0;
+        std::size_t extraneous_bytes = 0;
+
+        const auto started_at = std::chrono::steady_clock::now();
+        const std::size_t consumed = host::decodeInParallel(file.data(), file.size(),
+                                                            [&](const transport::ParserOutput& out)
+        {
+            if (auto f = out.getReceivedFrame())
+            {
+                frames[f->type_code]++;
+                if (f->type_code == presentation::StandardFrameTypeCode)
+                {
+                    if (host::decodeStandardMessage(*f, [](const auto&) {}))
+                    {
+                        // The message ID is the first field of every standard message
+                        messages[std::uint16_t(f->payload.at(0) | (f->payload.at(1) << 8U))]++;
+                    }
+                    else
+                    {
+                        malformed++;
+                    }
+                }
+            }
+            else if (auto e = out.getExtraneousData())
+            {
+                extraneous_bytes += e->size();
+            }
+            else
+            {
+                ;   // Nothing to count
+            }
+        }, number_of_threads);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started_at;
+
+        for (auto [type_code, count] : frames)
+        {
+            std::cout << "frame type " << unsigned(type_code) << ": " << count << std::endl;
+        }
+        for (auto [id, count] : messages)
+        {
+            std::cout << "standard message " << id << ": " << count << std::endl;
+        }
+        std::cout << "unknown or malformed standard messages: " << malformed << std::endl;
+        std::cout << "extraneous bytes: " << extraneous_bytes << std::endl;
+        std::cout << "unterminated bytes at the end: " << (file.size() - consumed) << std::endl;
+        std::cout << "decoded " << file.size() << " bytes in " << elapsed.count() << " s using "
+                  << number_of_threads << " threads" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -31,10 +31,11 @@ if sys.version_info[:2] < (3, 5):
 
 
 STANDARD_FRAME_TYPE_CODE = 0xFF
+COMPRESSED_FRAME_TYPE_CODE = 0xFE
 MAX_APPLICATION_SPECIFIC_FRAME_TYPE_CODE = 0x7F
 
 
-from . import transport, standard, physical
+from . import transport, standard, physical, compression
 
 
 __version__ = 0, 1, 0
@@ -0,0 +1,724 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Zubax Robotics
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+ */
+
+/*
+ * Optional native accelerator for popcop.transport, built on top of the C++ implementation.
+ * The module is not a part of the public API; popcop.transport picks it up automatically if it is available
+ * and falls back to the pure Python implementation otherwise. See setup.py for the build instructions.
+ *
+ * The parser state machine replicates the Python implementation exactly rather than wrapping popcop::transport::Parser,
+ * because the Python parser has different semantics: the buffer is unbounded until the end of the chunk,
+ * unescaping is performed only inside a frame, and the data is timestamped by the application.
+ *
+ * On Linux, the module also exposes the epoll-based serial port multiplexer from popcop_linux.hpp, which is used by
+ * the native backend of popcop.physical.serial_multiprocessing.Channel.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <popcop.hpp>
+#ifdef __linux__
+# include <popcop_linux.hpp>
+# include <poll.h>
+#endif
+#include <exception>
+#include <vector>
+#include <new>
+
+
+namespace
+{
+
+using popcop::transport::FrameDelimiter;
+using popcop::transport::EscapeCharacter;
+
+constexpr std::size_t PayloadOverheadNotIncludingDelimiters = 5;
+
+/**
+ * Releases the buffer view when leaving the scope.
+ */
+class BufferViewGuard
+{
+    Py_buffer& view_;
+
+public:
+    explicit BufferViewGuard(Py_buffer& view) : view_(view) { }
+    ~BufferViewGuard() { PyBuffer_Release(&view_); }
+
+    BufferViewGuard(const BufferViewGuard&) = delete;
+    BufferViewGuard& operator=(const BufferViewGuard&) = delete;
+
+    const std::uint8_t* begin() const { return static_cast<const std::uint8_t*>(view_.buf); }
+    const std::uint8_t* end()   const { return begin() + view_.len; }
+};
+
+/*
+ * CRC
+ */
+PyObject* crc32cUpdate(PyObject*, PyObject* args)
+{
+    unsigned long state = 0;
+    Py_buffer view{};
+    if (!PyArg_ParseTuple(args, "ky*", &state, &view))
+    {
+        return nullptr;
+    }
+    BufferViewGuard guard(view);
+
+    // The Python side keeps the raw register value, so the stateless block update function is used directly.
+    const std::uint32_t result = popcop::transport::detail_::updateCRC32C(std::uint32_t(state),
+                                                                          guard.begin(),
+                                                                          std::size_t(view.len));
+    return PyLong_FromUnsignedLong(result);
+}
+
+/*
+ * Encoder
+ */
+PyObject* encode(PyObject*, PyObject* args)
+{
+    unsigned char frame_type_code = 0;
+    Py_buffer view{};
+    if (!PyArg_ParseTuple(args, "by*", &frame_type_code, &view))
+    {
+        return nullptr;
+    }
+    BufferViewGuard guard(view);
+
+    // Worst case: every byte is escaped, plus two delimiters
+    const std::size_t capacity = (std::size_t(view.len) + PayloadOverheadNotIncludingDelimiters) * 2U + 2U;
+    PyObject* const output = PyByteArray_FromStringAndSize(nullptr, Py_ssize_t(capacity));
+    if (output == nullptr)
+    {
+        return nullptr;
+    }
+
+    popcop::transport::BufferedEmitter emitter(frame_type_code, guard.begin(), std::size_t(view.len));
+    const std::size_t size =
+        emitter.emitInto(reinterpret_cast<std::uint8_t*>(PyByteArray_AS_STRING(output)), capacity);
+    assert(emitter.isFinished());
+
+    if (PyByteArray_Resize(output, Py_ssize_t(size)) != 0)
+    {
+        Py_DECREF(output);
+        return nullptr;
+    }
+    return output;
+}
+
+/*
+ * Parser
+ */
+struct ParserCore
+{
+    PyObject_HEAD
+    std::vector<std::uint8_t> buffer;
+    bool unescape_next;
+    PyObject* frame_timestamp;          ///< Null if not inside a frame; this is an owning reference.
+};
+
+bool isReceivedFrameValid(const std::vector<std::uint8_t>& buffer)
+{
+    if (buffer.size() < PayloadOverheadNotIncludingDelimiters)
+    {
+        return false;
+    }
+    popcop::transport::CRCComputer crc;
+    crc.add(buffer.data(), buffer.size());
+    return crc.isResidueCorrect();
+}
+
+/**
+ * Mirrors Parser._finalize(). Appends the output, if any, to the list of events.
+ * Returns false if a Python exception has been raised.
+ */
+bool finalize(ParserCore* const self, const bool known_invalid, PyObject* const events)
+{
+    PyObject* event = nullptr;
+    auto& buf = self->buffer;
+
+    if (!known_invalid && isReceivedFrameValid(buf))
+    {
+        const std::size_t payload_size = buf.size() - PayloadOverheadNotIncludingDelimiters;
+        event = Py_BuildValue("(iy#O)",
+                              int(buf[payload_size]),
+                              reinterpret_cast<const char*>(buf.data()),
+                              Py_ssize_t(payload_size),
+                              self->frame_timestamp);
+    }
+    else if (!buf.empty())
+    {
+        event = PyBytes_FromStringAndSize(reinterpret_cast<const char*>(buf.data()), Py_ssize_t(buf.size()));
+    }
+
+    bool success = true;
+    if (event != nullptr)
+    {
+        success = PyList_Append(events, event) == 0;
+        Py_DECREF(event);
+    }
+    else if (PyErr_Occurred())
+    {
+        success = false;
+    }
+
+    buf.clear();
+    self->unescape_next = false;
+    Py_CLEAR(self->frame_timestamp);
+    return success;
+}
+
+PyObject* parserCoreNew(PyTypeObject* type, PyObject*, PyObject*)
+{
+    auto self = reinterpret_cast<ParserCore*>(type->tp_alloc(type, 0));
+    if (self != nullptr)
+    {
+        new (&self->buffer) std::vector<std::uint8_t>();
+        self->unescape_next = false;
+        self->frame_timestamp = nullptr;
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+void parserCoreDealloc(ParserCore* const self)
+{
+    Py_CLEAR(self->frame_timestamp);
+    self->buffer.~vector();
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+/**
+ * Processes the chunk exactly like a sequence of Parser._parse_byte() calls.
+ * Returns the list of events, where a received frame is represented as a tuple of
+ * (frame type code, payload, timestamp), and extraneous data is represented as bytes.
+ */
+PyObject* parserCoreFeed(ParserCore* const self, PyObject* args)
+{
+    Py_buffer view{};
+    PyObject* timestamp = nullptr;
+    if (!PyArg_ParseTuple(args, "y*O", &view, &timestamp))
+    {
+        return nullptr;
+    }
+    BufferViewGuard guard(view);
+
+    PyObject* const events = PyList_New(0);
+    if (events == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto& buf = self->buffer;
+    const std::uint8_t* ptr = guard.begin();
+    const std::uint8_t* const end = guard.end();
+    while (ptr < end)
+    {
+        // Bulk-copy the runs that require no special handling
+        const bool inside_frame = self->frame_timestamp != nullptr;
+        if (inside_frame && !self->unescape_next)
+        {
+            const std::uint8_t* const run_end = popcop::transport::detail_::findNextSpecialCharacter(ptr, end);
+            buf.insert(buf.end(), ptr, run_end);
+            ptr = run_end;
+        }
+        else if (!inside_frame)
+        {
+            auto run_end = static_cast<const std::uint8_t*>(std::memchr(ptr, FrameDelimiter, std::size_t(end - ptr)));
+            run_end = (run_end == nullptr) ? end : run_end;
+            buf.insert(buf.end(), ptr, run_end);
+            ptr = run_end;
+        }
+        else
+        {
+            ;   // Unescaping the next byte
+        }
+
+        if (ptr >= end)
+        {
+            break;
+        }
+
+        std::uint8_t b = *ptr++;
+
+        // Reception of a frame delimiter UNCONDITIONALLY terminates the current frame
+        if (b == FrameDelimiter)
+        {
+            if (!finalize(self, !inside_frame, events))
+            {
+                Py_DECREF(events);
+                return nullptr;
+            }
+            Py_INCREF(timestamp);
+            self->frame_timestamp = timestamp;
+            continue;
+        }
+
+        // Unescaping is done ONLY if we're inside a frame currently
+        if (inside_frame)
+        {
+            if (b == EscapeCharacter)
+            {
+                self->unescape_next = true;
+                continue;
+            }
+
+            if (self->unescape_next)
+            {
+                self->unescape_next = false;
+                b = std::uint8_t(b ^ 0xFFU);
+            }
+        }
+
+        buf.push_back(b);
+    }
+
+    return events;
+}
+
+/**
+ * Mirrors Parser._finalize(known_invalid=True). Returns the extraneous data as bytes, or None.
+ */
+PyObject* parserCoreAbort(ParserCore* const self, PyObject*)
+{
+    PyObject* const events = PyList_New(0);
+    if (events == nullptr)
+    {
+        return nullptr;
+    }
+
+    PyObject* result = nullptr;
+    if (finalize(self, true, events))
+    {
+        result = (PyList_GET_SIZE(events) > 0) ? PyList_GET_ITEM(events, 0) : Py_None;
+        Py_INCREF(result);
+    }
+
+    Py_DECREF(events);
+    return result;
+}
+
+PyObject* parserCoreGetInsideFrame(ParserCore* const self, void*)
+{
+    return PyBool_FromLong(self->frame_timestamp != nullptr);
+}
+
+PyObject* parserCoreGetBufferSize(ParserCore* const self, void*)
+{
+    return PyLong_FromSize_t(self->buffer.size());
+}
+
+PyObject* parserCoreGetFrameTimestamp(ParserCore* const self, void*)
+{
+    PyObject* const result = (self->frame_timestamp != nullptr) ? self->frame_timestamp : Py_None;
+    Py_INCREF(result);
+    return result;
+}
+
+PyMethodDef ParserCoreMethods[] =
+{
+    {"feed",  reinterpret_cast<PyCFunction>(parserCoreFeed),  METH_VARARGS,
+     "feed(chunk, timestamp) -> list of (frame_type_code, payload, timestamp) tuples and extraneous bytes"},
+    {"abort", reinterpret_cast<PyCFunction>(parserCoreAbort), METH_NOARGS,
+     "abort() -> bytes or None; terminates the current frame and returns its data as extraneous"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef ParserCoreGetSet[] =
+{
+    {const_cast<char*>("inside_frame"),    reinterpret_cast<getter>(parserCoreGetInsideFrame),    nullptr,
+     nullptr, nullptr},
+    {const_cast<char*>("buffer_size"),     reinterpret_cast<getter>(parserCoreGetBufferSize),     nullptr,
+     nullptr, nullptr},
+    {const_cast<char*>("frame_timestamp"), reinterpret_cast<getter>(parserCoreGetFrameTimestamp), nullptr,
+     nullptr, nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+PyTypeObject ParserCoreType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+
+#ifdef __linux__
+/*
+ * Serial multiplexer
+ */
+constexpr std::size_t SerialMultiplexerMaxPayloadSize = 2048;
+
+using Multiplexer = popcop::host::SerialMultiplexer<SerialMultiplexerMaxPayloadSize>;
+
+/**
+ * The parser output is copied because the handler is invoked without the GIL, when no Python objects can be created.
+ */
+struct MultiplexerEvent
+{
+    std::size_t port_index = 0;
+    int frame_type_code = -1;           ///< Negative for extraneous data
+    std::vector<std::uint8_t> data;
+    double timestamp = 0.0;
+};
+
+struct SerialMultiplexerObject
+{
+    PyObject_HEAD
+    std::unique_ptr<Multiplexer> mux;
+    std::mutex mutex;                   ///< Guards the multiplexer and the events; not held while waiting
+    std::vector<MultiplexerEvent> events;
+};
+
+/**
+ * Translates the exception into OSError (or its subclass selected by the error code) or IndexError.
+ * Must be invoked from a catch block, unless the exception is captured while the GIL is released.
+ */
+PyObject* raiseTranslatedException(const std::exception_ptr& failure = std::current_exception())
+{
+    try
+    {
+        std::rethrow_exception(failure);
+    }
+    catch (const std::system_error& ex)
+    {
+        PyObject* const args = Py_BuildValue("(is)", ex.code().value(), ex.what());
+        if (args != nullptr)
+        {
+            PyErr_SetObject(PyExc_OSError, args);
+            Py_DECREF(args);
+        }
+    }
+    catch (const std::out_of_range& ex)
+    {
+        PyErr_SetString(PyExc_IndexError, ex.what());
+    }
+    catch (const std::bad_alloc&)
+    {
+        PyErr_NoMemory();
+    }
+    catch (const std::exception& ex)
+    {
+        PyErr_SetString(PyExc_RuntimeError, ex.what());
+    }
+    return nullptr;
+}
+
+PyObject* serialMultiplexerNew(PyTypeObject* type, PyObject*, PyObject*)
+{
+    auto self = reinterpret_cast<SerialMultiplexerObject*>(type->tp_alloc(type, 0));
+    if (self == nullptr)
+    {
+        return nullptr;
+    }
+    new (&self->mux) std::unique_ptr<Multiplexer>();
+    new (&self->mutex) std::mutex();
+    new (&self->events) std::vector<MultiplexerEvent>();
+
+    try
+    {
+        self->mux = std::make_unique<Multiplexer>([self](std::size_t port_index,
+                                                         const popcop::transport::ParserOutput& out)
+        {
+            // Same time base as time.monotonic() on Linux, which is also CLOCK_MONOTONIC
+            MultiplexerEvent ev;
+            ev.port_index = port_index;
+            ev.timestamp = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (auto f = out.getReceivedFrame())
+            {
+                ev.frame_type_code = f->type_code;
+                ev.data.assign(f->payload.begin(), f->payload.end());
+            }
+            else if (auto e = out.getExtraneousData())
+            {
+                ev.data.assign(e->begin(), e->end());
+            }
+            else
+            {
+                return;
+            }
+            self->events.push_back(std::move(ev));
+        });
+    }
+    catch (...)
+    {
+        Py_DECREF(self);
+        return raiseTranslatedException();
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+void serialMultiplexerDealloc(SerialMultiplexerObject* const self)
+{
+    self->mux.~unique_ptr();            // Closes the ports
+    self->events.~vector();
+    self->mutex.~mutex();
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+PyObject* serialMultiplexerAdd(SerialMultiplexerObject* const self, PyObject* args)
+{
+    const char* path = nullptr;
+    unsigned int baud_rate = 0;
+    if (!PyArg_ParseTuple(args, "sI", &path, &baud_rate))
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        popcop::host::SerialPort port(path, baud_rate);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return PyLong_FromSize_t(self->mux->add(std::move(port)));
+    }
+    catch (...)
+    {
+        return raiseTranslatedException();
+    }
+}
+
+PyObject* serialMultiplexerSend(SerialMultiplexerObject* const self, PyObject* args)
+{
+    Py_ssize_t index = 0;
+    Py_buffer view{};
+    if (!PyArg_ParseTuple(args, "ny*", &index, &view))
+    {
+        return nullptr;
+    }
+    BufferViewGuard guard(view);
+
+    // No exception may escape while the GIL is released, so it is translated afterwards
+    std::exception_ptr failure;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->mux->send(std::size_t(index), guard.begin(), std::size_t(view.len));
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+    }
+    Py_END_ALLOW_THREADS
+
+    if (failure)
+    {
+        return raiseTranslatedException(failure);
+    }
+    Py_RETURN_NONE;
+}
+
+/**
+ * Waits for the events without holding the GIL nor the mutex, so that the other threads can send meanwhile,
+ * then processes them and returns the list of (port_index, event) tuples, where the event is represented
+ * like in ParserCore.feed(). Only one thread may wait at a time.
+ */
+PyObject* serialMultiplexerWait(SerialMultiplexerObject* const self, PyObject* args)
+{
+    double timeout = 0.0;
+    if (!PyArg_ParseTuple(args, "d", &timeout))
+    {
+        return nullptr;
+    }
+    const int timeout_ms = (timeout < 0.0) ? -1 : int(std::min(timeout * 1e3, double(0x7FFFFFFF)));
+
+    std::vector<MultiplexerEvent> events;
+    std::exception_ptr failure;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        ::pollfd pfd{self->mux->getFileDescriptor(), POLLIN, 0};
+        if ((::poll(&pfd, 1, timeout_ms) < 0) && (errno != EINTR))
+        {
+            throw std::system_error(errno, std::generic_category(), "poll");
+        }
+
+        std::lock_guard<std::mutex> lock(self->mutex);
+        (void) self->mux->poll(std::chrono::milliseconds(0));
+        events.swap(self->events);
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+    }
+    Py_END_ALLOW_THREADS
+
+    if (failure)
+    {
+        return raiseTranslatedException(failure);
+    }
+
+    PyObject* const result = PyList_New(Py_ssize_t(events.size()));
+    if (result == nullptr)
+    {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < events.size(); i++)
+    {
+        const auto& ev = events[i];
+        const auto data = reinterpret_cast<const char*>(ev.data.data());
+        const auto size = Py_ssize_t(ev.data.size());
+        PyObject* const item = (ev.frame_type_code >= 0) ?
+            Py_BuildValue("(n(iy#d))", Py_ssize_t(ev.port_index), ev.frame_type_code, data, size, ev.timestamp) :
+            Py_BuildValue("(ny#)", Py_ssize_t(ev.port_index), data, size);
+        if (item == nullptr)
+        {
+            Py_DECREF(result);
+            return nullptr;
+        }
+        PyList_SET_ITEM(result, Py_ssize_t(i), item);
+    }
+    return result;
+}
+
+PyObject* serialMultiplexerIsOpen(SerialMultiplexerObject* const self, PyObject* args)
+{
+    Py_ssize_t index = 0;
+    if (!PyArg_ParseTuple(args, "n", &index))
+    {
+        return nullptr;
+    }
+    try
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return PyBool_FromLong(self->mux->isOpen(std::size_t(index)));
+    }
+    catch (...)
+    {
+        return raiseTranslatedException();
+    }
+}
+
+PyObject* serialMultiplexerGetPendingSize(SerialMultiplexerObject* const self, PyObject* args)
+{
+    Py_ssize_t index = 0;
+    if (!PyArg_ParseTuple(args, "n", &index))
+    {
+        return nullptr;
+    }
+    try
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        return PyLong_FromSize_t(self->mux->getPendingSize(std::size_t(index)));
+    }
+    catch (...)
+    {
+        return raiseTranslatedException();
+    }
+}
+
+PyMethodDef SerialMultiplexerMethods[] =
+{
+    {"add",              reinterpret_cast<PyCFunction>(serialMultiplexerAdd),            METH_VARARGS,
+     "add(path, baud_rate) -> port index; raises OSError if the port cannot be opened"},
+    {"send",             reinterpret_cast<PyCFunction>(serialMultiplexerSend),           METH_VARARGS,
+     "send(port_index, data); never blocks, the data that the driver cannot accept is buffered"},
+    {"wait",             reinterpret_cast<PyCFunction>(serialMultiplexerWait),           METH_VARARGS,
+     "wait(timeout) -> list of (port_index, (frame_type_code, payload, timestamp) or extraneous bytes)"},
+    {"is_open",          reinterpret_cast<PyCFunction>(serialMultiplexerIsOpen),         METH_VARARGS,
+     "is_open(port_index) -> False if the port has failed and has been closed"},
+    {"get_pending_size", reinterpret_cast<PyCFunction>(serialMultiplexerGetPendingSize), METH_VARARGS,
+     "get_pending_size(port_index) -> amount of outgoing data not yet accepted by the driver"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyTypeObject SerialMultiplexerType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+#endif
+
+PyMethodDef ModuleMethods[] =
+{
+    {"crc32c_update", crc32cUpdate, METH_VARARGS,
+     "crc32c_update(state, data) -> new state; the state is the raw register value, not the final CRC"},
+    {"encode",        encode,       METH_VARARGS,
+     "encode(frame_type_code, payload) -> bytearray"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef ModuleDefinition =
+{
+    PyModuleDef_HEAD_INIT,
+    "popcop._native",
+    "Native accelerator for popcop.transport; do not use directly",
+    -1,
+    ModuleMethods,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+}   // namespace
+
+
+PyMODINIT_FUNC PyInit__native()
+{
+    ParserCoreType.tp_name      = "popcop._native.ParserCore";
+    ParserCoreType.tp_basicsize = sizeof(ParserCore);
+    ParserCoreType.tp_flags     = Py_TPFLAGS_DEFAULT;
+    ParserCoreType.tp_doc       = "State machine of popcop.transport.Parser";
+    ParserCoreType.tp_new       = parserCoreNew;
+    ParserCoreType.tp_dealloc   = reinterpret_cast<destructor>(parserCoreDealloc);
+    ParserCoreType.tp_methods   = ParserCoreMethods;
+    ParserCoreType.tp_getset    = ParserCoreGetSet;
+    if (PyType_Ready(&ParserCoreType) < 0)
+    {
+        return nullptr;
+    }
+
+    PyObject* const module = PyModule_Create(&ModuleDefinition);
+    if (module == nullptr)
+    {
+        return nullptr;
+    }
+
+    Py_INCREF(&ParserCoreType);
+    if (PyModule_AddObject(module, "ParserCore", reinterpret_cast<PyObject*>(&ParserCoreType)) < 0)
+    {
+        Py_DECREF(&ParserCoreType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+#ifdef __linux__
+    SerialMultiplexerType.tp_name      = "popcop._native.SerialMultiplexer";
+    SerialMultiplexerType.tp_basicsize = sizeof(SerialMultiplexerObject);
+    SerialMultiplexerType.tp_flags     = Py_TPFLAGS_DEFAULT;
+    SerialMultiplexerType.tp_doc       = "popcop::host::SerialMultiplexer; the ports are closed when it is destroyed";
+    SerialMultiplexerType.tp_new       = serialMultiplexerNew;
+    SerialMultiplexerType.tp_dealloc   = reinterpret_cast<destructor>(serialMultiplexerDealloc);
+    SerialMultiplexerType.tp_methods   = SerialMultiplexerMethods;
+    if ((PyType_Ready(&SerialMultiplexerType) < 0) ||
+        (PyModule_AddIntConstant(module, "SERIAL_MULTIPLEXER_MAX_PAYLOAD_SIZE",
+                                 long(SerialMultiplexerMaxPayloadSize)) < 0))
+    {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    Py_INCREF(&SerialMultiplexerType);
+    if (PyModule_AddObject(module, "SerialMultiplexer", reinterpret_cast<PyObject*>(&SerialMultiplexerType)) < 0)
+    {
+        Py_DECREF(&SerialMultiplexerType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+#endif
+
+    return module;
+}
@@ -0,0 +1,168 @@
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2017-2018 Zubax Robotics
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in
+# the Software without restriction, including without limitation the rights to
+# use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+# the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+#
+
+"""
+Transparent frame payload compression; mirrors the C++ implementation (presentation::compression).
+The compressed data is a sequence of tokens:
+
+    Token                       Meaning
+-----------------------------------------------------------------------------------------------
+    0LLLLLLL                    Literal run: the next L+1 bytes (1 to 128) are copied to the output verbatim.
+    1LLLLLLL, u16 distance      Match: L+4 bytes (4 to 131) are copied from distance bytes back in the output
+                                (1 to 65535); the source may overlap the destination, which encodes runs.
+-----------------------------------------------------------------------------------------------
+
+A compressed frame has the type code COMPRESSED_FRAME_TYPE_CODE; its payload is the type code of the original
+frame followed by the compressed payload. Frames that do not become shorter are sent as-is.
+"""
+
+import typing
+from . import COMPRESSED_FRAME_TYPE_CODE
+from .transport import ReceivedFrame
+
+
+__all__ = ['compress', 'decompress', 'compress_frame', 'decompress_frame']
+
+
+MIN_MATCH_LENGTH = 4
+MAX_MATCH_LENGTH = 0x7F + MIN_MATCH_LENGTH
+MAX_LITERAL_RUN_LENGTH = 0x80
+MAX_INPUT_SIZE = 0xFFFF
+
+_HASH_BITS = 8
+
+
+def compress(data: typing.Union[bytes, bytearray]) -> bytes:
+    """
+    Compresses the data; the output is identical to that of the C++ implementation with the default hash size.
+    """
+    data = bytes(data)
+    if len(data) > MAX_INPUT_SIZE:
+        raise ValueError('Too much data: %r bytes' % len(data))
+
+    def compute_hash(pos):
+        x = int.from_bytes(data[pos:pos + 4], 'little')
+        return ((x * 2654435761) & 0xFFFFFFFF) >> (32 - _HASH_BITS)
+
+    table = [0] * (1 << _HASH_BITS)
+    out = bytearray()
+    literal_start = 0
+
+    def flush_literals(literal_end):
+        nonlocal literal_start
+        while literal_start < literal_end:
+            n = min(MAX_LITERAL_RUN_LENGTH, literal_end - literal_start)
+            out.append(n - 1)
+            out.extend(data[literal_start:literal_start + n])
+            literal_start += n
+
+    ip = 0
+    while ip + MIN_MATCH_LENGTH <= len(data):
+        h = compute_hash(ip)
+        candidate = table[h]
+        table[h] = ip
+        if candidate >= ip or data[candidate:candidate + MIN_MATCH_LENGTH] != data[ip:ip + MIN_MATCH_LENGTH]:
+            ip += 1
+            continue
+
+        length = MIN_MATCH_LENGTH
+        while ip + length < len(data) and length < MAX_MATCH_LENGTH and data[candidate + length] == data[ip + length]:
+            length += 1
+
+        flush_literals(ip)
+        distance = ip - candidate
+        out += bytes([0x80 | (length - MIN_MATCH_LENGTH), distance & 0xFF, distance >> 8])
+
+        for i in range(ip + 1, min(ip + length, len(data) - MIN_MATCH_LENGTH + 1)):
+            table[compute_hash(i)] = i
+
+        ip += length
+        literal_start = ip
+
+    flush_literals(len(data))
+    return bytes(out)
+
+
+def decompress(data: typing.Union[bytes, bytearray], max_size: int=None) -> bytes:
+    """
+    Decompresses the data. Raises ValueError if the data is malformed or the output would exceed max_size.
+    """
+    out = bytearray()
+    ip = 0
+    while ip < len(data):
+        token = data[ip]
+        ip += 1
+        if token & 0x80 == 0:
+            n = token + 1
+            if ip + n > len(data):
+                raise ValueError('Truncated literal run')
+            out += data[ip:ip + n]
+            ip += n
+        else:
+            if ip + 2 > len(data):
+                raise ValueError('Truncated match')
+            n = (token & 0x7F) + MIN_MATCH_LENGTH
+            distance = data[ip] | (data[ip + 1] << 8)
+            ip += 2
+            if distance == 0 or distance > len(out):
+                raise ValueError('Invalid match distance: %r' % distance)
+            for _ in range(n):
+                out.append(out[-distance])      # Byte by byte, because the source may overlap the destination
+
+        if max_size is not None and len(out) > max_size:
+            raise ValueError('Decompressed data is too long')
+
+    return bytes(out)
+
+
+def compress_frame(frame_type_code: int,
+                   payload: typing.Union[bytes, bytearray]) -> typing.Tuple[int, bytes]:
+    """
+    Returns the frame type code and the payload to be passed to popcop.transport.encode(); the frame is left
+    as-is if compression does not make it shorter.
+    """
+    if frame_type_code == COMPRESSED_FRAME_TYPE_CODE:
+        raise ValueError('Compressed frames cannot be nested')
+
+    if len(payload) <= MAX_INPUT_SIZE:
+        compressed = bytes([frame_type_code]) + compress(payload)
+        if len(compressed) < len(payload):
+            return COMPRESSED_FRAME_TYPE_CODE, compressed
+
+    return frame_type_code, bytes(payload)
+
+
+def decompress_frame(frame: ReceivedFrame, max_size: int=None) -> ReceivedFrame:
+    """
+    Decompresses the frame if it is compressed, otherwise returns it as-is.
+    Raises ValueError if the frame is malformed.
+    """
+    if frame.frame_type_code != COMPRESSED_FRAME_TYPE_CODE:
+        return frame
+
+    if len(frame.payload) < 1 or frame.payload[0] == COMPRESSED_FRAME_TYPE_CODE:
+        raise ValueError('Invalid compressed frame: %r' % frame)
+
+    return ReceivedFrame(frame.payload[0], decompress(frame.payload[1:], max_size), frame.timestamp)
@@ -28,7 +28,9 @@ import sys
 import time
 import enum
 import queue
+import struct
 import typing
+import ctypes
 import signal
 import asyncio
 import warnings
@@ -45,6 +47,11 @@ try:
 except ImportError:
     serial = None
 
+try:
+    from .. import _native
+except ImportError:
+    _native = None
+
 __all__ = [
     'Channel',
     'ChannelException',
@@ -62,9 +69,12 @@ except AttributeError:
     RUNNING_ON_WINDOWS = False
 
 # IPC queue size limits
-IPC_RX_QUEUE_SIZE = 32767   # http://stackoverflow.com/questions/5900985/multiprocessing-queue-maxsize-limit-is-32767
-IPC_TX_QUEUE_SIZE = IPC_RX_QUEUE_SIZE
-IPC_LOG_QUEUE_SIZE = IPC_RX_QUEUE_SIZE
+IPC_LOG_QUEUE_SIZE = 32767  # http://stackoverflow.com/questions/5900985/multiprocessing-queue-maxsize-limit-is-32767
+IPC_CONTROL_QUEUE_SIZE = IPC_LOG_QUEUE_SIZE
+
+# Capacity of each of the two shared memory rings that carry the data between the processes, in bytes.
+# Received frames that are too large to fit are passed through the control queue instead.
+IPC_RING_CAPACITY = 4 * 1024 * 1024
 
 # Defined for POPCOP
 DEFAULT_BAUD_RATE = 115200
@@ -88,15 +98,20 @@ MAX_SUCCESSIVE_ERRORS_TO_GIVE_UP = 100
 IO_TIMEOUT = 0.5
 
 # The amount of time given to the worker process to comply with the STOP command before it will be forcibly terminated.
-# Note that the worker may take a long time to process IPC commands (STOP in particular) if there are objects
-# in the TX queue - the command will not be seen by the worker until all of the entities from the queue before it
-# are processed.
+# Note that the worker may take a long time to process IPC commands (STOP in particular) if there is data
+# in the TX ring - the command will not be seen by the worker until all of the data before it is written.
 WORKER_PROCESS_JOIN_TIMEOUT = 3
 
 
-class IPCCommand(enum.Enum):
-    KEEP_ALIVE = 0
-    STOP = 1
+class IPCRecordKind(enum.IntEnum):
+    # From the IO process to the master
+    FRAME = 0               # Received frame; the payload is the frame payload
+    EXTRANEOUS_DATA = 1     # The payload is the extraneous data
+    CONTROL = 2             # The next object should be fetched from the control queue
+    # From the master to the IO process
+    DATA = 3                # The payload is to be written into the port as-is
+    KEEP_ALIVE = 4
+    STOP = 5
 
 
 class IPCNotification(enum.Enum):
@@ -106,6 +121,167 @@ class IPCNotification(enum.Enum):
 _logger = getLogger('popcop.physical.serial_multiprocessing')
 
 
+class _Doorbell:
+    """
+    Wakes up a thread in another process that waits for a condition to become true.
+    The semaphore is touched only if the other side is actually waiting, so the fast path involves no system calls.
+    Only one thread may wait at a time.
+
+    The waiting flag is written and read under the fence lock shared with the ring, which also guards the publication
+    of the ring indexes. Plain shared memory stores are not ordered against later loads, so without the lock the
+    waiter could miss a ring that happened after it had announced its intent to sleep, and the wakeup would be lost.
+    """
+
+    def __init__(self, mp_context, fence):
+        self._semaphore = mp_context.Semaphore(0)
+        self._waiting = mp_context.RawValue(ctypes.c_uint8, 0)
+        self._fence = fence
+
+    def wait_for(self, predicate: typing.Callable, timeout: float):
+        """
+        Returns the first result of the predicate that is not None, or None on timeout.
+        """
+        deadline = time.monotonic() + timeout
+        while True:
+            out = predicate()
+            if out is not None:
+                return out
+
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return None
+
+            # Announcing the intent to sleep, then re-checking to avoid missing a ring that happened in between
+            with self._fence:
+                self._waiting.value = 1
+            out = predicate()
+            if out is None:
+                self._semaphore.acquire(timeout=remaining)
+
+            with self._fence:
+                self._waiting.value = 0
+            if out is not None:
+                return out
+
+    def ring(self):
+        with self._fence:
+            waiting = self._waiting.value
+            self._waiting.value = 0
+        if waiting:
+            self._semaphore.release()
+
+
+class _SharedRing:
+    """
+    Single-producer single-consumer ring of records in shared memory.
+    Each record consists of a fixed-size header followed by an arbitrary payload; records wrap around the end.
+    The read and write indexes are never wrapped, so the ring is empty when they are equal; being 64-bit counters
+    that only grow, they are not subject to the ABA problem.
+    The object should be passed to the IO process as an argument, then it can be used from both sides.
+
+    The data is copied without locking, but the indexes are loaded and stored under a shared lock, which acts as
+    a memory fence: ctypes gives no ordering guarantees, so on weakly ordered hosts (e.g. ARM) the other side could
+    otherwise observe the new index before the data it covers. The lock is held only for a few instructions and is
+    normally uncontended, so it does not involve system calls on the common platforms.
+    """
+
+    HEADER = struct.Struct('<BBxxId')   # Kind, frame type code, payload size, timestamp
+
+    def __init__(self, mp_context, capacity: int):
+        self._capacity = int(capacity)
+        self._storage = mp_context.RawArray(ctypes.c_uint8, self._capacity)
+        self._indexes = mp_context.RawArray(ctypes.c_uint64, 2)                 # Write, read
+        self._fence = mp_context.Lock()
+        self._data_available = _Doorbell(mp_context, self._fence)
+        self._space_available = _Doorbell(mp_context, self._fence)
+        self._memory = None
+
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        state['_memory'] = None                                                 # Memory views cannot be pickled
+        return state
+
+    @property
+    def max_payload_size(self) -> int:
+        return self._capacity - self.HEADER.size
+
+    def _get_memory(self) -> memoryview:
+        if self._memory is None:
+            self._memory = memoryview(self._storage).cast('B')
+
+        return self._memory
+
+    def _copy_in(self, position: int, data):
+        memory, offset = self._get_memory(), position % self._capacity
+        first = min(len(data), self._capacity - offset)
+        memory[offset:offset + first] = data[:first]
+        memory[:len(data) - first] = data[first:]
+
+    def _copy_out(self, position: int, size: int) -> bytes:
+        memory, offset = self._get_memory(), position % self._capacity
+        first = min(size, self._capacity - offset)
+        if first == size:
+            return bytes(memory[offset:offset + size])
+
+        return bytes(memory[offset:]) + bytes(memory[:size - first])
+
+    def try_push(self, kind: int, payload=b'', frame_type_code: int=0, timestamp: float=0.0) -> bool:
+        payload = memoryview(payload).cast('B')
+        if len(payload) > self.max_payload_size:
+            raise ValueError('The record is too large: %r bytes' % len(payload))
+
+        with self._fence:
+            write, read = self._indexes
+        if self._capacity - (write - read) < self.HEADER.size + len(payload):
+            return False
+
+        self._copy_in(write, self.HEADER.pack(kind, frame_type_code, len(payload), timestamp))
+        self._copy_in(write + self.HEADER.size, payload)
+        with self._fence:
+            self._indexes[0] = write + self.HEADER.size + len(payload)         # Publishing after the data is written
+        self._data_available.ring()
+        return True
+
+    def try_pop(self) -> typing.Optional[typing.Tuple[int, int, float, bytes]]:
+        """
+        :return: (kind, frame type code, timestamp, payload), or None if the ring is empty.
+        """
+        with self._fence:
+            write, read = self._indexes
+        if write == read:
+            return None
+
+        kind, frame_type_code, size, timestamp = self.HEADER.unpack(self._copy_out(read, self.HEADER.size))
+        payload = self._copy_out(read + self.HEADER.size, size)
+        with self._fence:
+            self._indexes[1] = read + self.HEADER.size + size                  # Releasing after the data is read
+        self._space_available.ring()
+        return kind, frame_type_code, timestamp, payload
+
+    def push(self, kind: int, payload=b'', frame_type_code: int=0, timestamp: float=0.0, timeout: float=0.0) -> bool:
+        """
+        Blocks until there is enough free space in the ring or until the timeout has expired.
+        """
+        return bool(self._space_available.wait_for(
+            lambda: self.try_push(kind, payload, frame_type_code, timestamp) or None, timeout))
+
+    def pop(self, timeout: float=0.0) -> typing.Optional[typing.Tuple[int, int, float, bytes]]:
+        """
+        Blocks until there is a record in the ring or until the timeout has expired.
+        """
+        return self._data_available.wait_for(self.try_pop, timeout)
+
+
+def _acquire_lock(lock, timeout: float) -> bool:
+    """
+    Zero timeout means non-blocking operation, as opposed to Lock.acquire(), where it means blocking forever.
+    """
+    if timeout > 0:
+        return lock.acquire(timeout=timeout)
+
+    return lock.acquire(blocking=False)
+
+
 def _try_raise_self_process_priority():
     """
     Attempts to raise the priority level of the current process. Tries several methods depending on the platform;
@@ -141,16 +317,21 @@ class IOProcess:
 
     def __init__(self,
                  channel,           # this is serial.Serial; we can't annotate it because PySerial may fail to import
-                 tx_queue:          multiprocessing.Queue,
-                 rx_queue:          multiprocessing.Queue,
+                 tx_ring:           _SharedRing,
+                 rx_ring:           _SharedRing,
+                 control_queue:     multiprocessing.Queue,
                  parent_pid:        int,
                  max_payload_size:  typing.Optional[int],
                  frame_timeout:     typing.Optional[float]):
         self._channel = channel
-        self._tx_queue = tx_queue
-        self._rx_queue = rx_queue
+        self._tx_ring = tx_ring
+        self._rx_ring = rx_ring
+        self._control_queue = control_queue
         self._parent_pid = parent_pid
 
+        # Both the RX thread and the TX loop may report to the master, but the ring allows only one producer.
+        self._rx_ring_lock = threading.Lock()
+
         self._last_master_heartbeat_at = time.monotonic()
         self._should_exit = False
 
@@ -176,65 +357,53 @@ class IOProcess:
 
         return not self._should_exit
 
-    # noinspection PyBroadException
+    def _report_via_control_queue(self, obj):
+        # The marker preserves the ordering of the objects relative to the data in the ring.
+        self._control_queue.put(obj)
+        self._push_rx_record(IPCRecordKind.CONTROL)
+
+    def _push_rx_record(self, kind, payload=b'', frame_type_code=0, timestamp=0.0):
+        # If the master is not keeping up, block until it catches up, like a full queue would.
+        with self._rx_ring_lock:
+            while not self._rx_ring.push(kind, payload, frame_type_code, timestamp, timeout=IO_TIMEOUT):
+                if not self._check_if_should_keep_going():
+                    break
+
     def _parser_callback(self, event):
-        # The event object can be either transport.ReceivedFrame or bytes.
-        # Here we check if it's a standard frame; if so, decode it and report the decoded object rather than raw frame.
+        # The event object can be either transport.ReceivedFrame or bytes. They are passed to the master as raw
+        # records, which is much cheaper than pickling; standard messages are decoded on the receiving side.
         if isinstance(event, transport.ReceivedFrame):
-            if event.frame_type_code == standard.STANDARD_FRAME_TYPE_CODE:
-                try:
-                    parsed_event = standard.decode(event)
-                    if parsed_event is not None:
-                        event = parsed_event
-                except Exception:
-                    # Could not decode - report as is, perhaps the application can make sense of it later.
-                    _logger.warning('Could not parse standard frame: %r', event, exc_info=True)
-
-        # At this point, the event object can be either:
-        #  - transport.ReceivedFrame
-        #  - standard.MessageBase
-        #  - bytes
-        assert isinstance(event, (transport.ReceivedFrame, standard.MessageBase, bytes))
-        self._rx_queue.put(event)
+            if len(event.payload) <= self._rx_ring.max_payload_size:
+                self._push_rx_record(IPCRecordKind.FRAME, event.payload, event.frame_type_code, event.timestamp)
+            else:
+                self._report_via_control_queue(event)
+        else:
+            assert isinstance(event, bytes)
+            view = memoryview(event)
+            step = self._rx_ring.max_payload_size
+            for offset in range(0, len(view), step):
+                self._push_rx_record(IPCRecordKind.EXTRANEOUS_DATA, view[offset:offset + step])
 
     def _tx_loop(self):
-        try:
-            m = self._tx_queue.get(timeout=IO_TIMEOUT)
-        except queue.Empty:
+        record = self._tx_ring.pop(timeout=IO_TIMEOUT)
+        if record is None:
             return
 
-        if isinstance(m, standard.MessageBase):
-            m = standard.encode(m)
-
-        elif isinstance(m, tuple) and len(m) == 2:
-            frame_type_code, payload = m
-            m = transport.encode(int(frame_type_code), payload)
-
-        elif isinstance(m, (bytes, bytearray)):
-            m = m
-
-        elif isinstance(m, str):
-            m = m.encode('utf8')
-
-        elif isinstance(m, IPCCommand):
-            if m == IPCCommand.KEEP_ALIVE:
-                pass
-            elif m == IPCCommand.STOP:
-                self._should_exit = True
-                _logger.info('Master wants us to quit. Yes master.')
-            else:
-                raise ValueError('Unknown IPC command: %r' % m)
-
-            m = bytes()
-
+        kind, _frame_type_code, _timestamp, data = record
+        if kind == IPCRecordKind.DATA:
+            pass
+        elif kind == IPCRecordKind.KEEP_ALIVE:
+            pass
+        elif kind == IPCRecordKind.STOP:
+            self._should_exit = True
+            _logger.info('Master wants us to quit. Yes master.')
         else:
-            raise TypeError("Don't know how to emit object: %r" % m)
+            raise ValueError('Unknown IPC record kind: %r' % kind)
 
         self._last_master_heartbeat_at = time.monotonic()
 
-        assert isinstance(m, (bytes, bytearray))
-        if len(m) > 0:
-            self._channel.write(m)
+        if len(data) > 0:
+            self._channel.write(data)
 
     def _rx_thread_function(self):
         try:
@@ -244,20 +413,20 @@ class IOProcess:
                 self._parser.parse(chunk, time.monotonic())
         except Exception as ex:
             _logger.error('IO process RX thread failure: %s', ex, exc_info=True)
-            self._rx_queue.put(ex)
+            self._report_via_control_queue(ex)
         finally:
             self._should_exit = True
 
     def run(self):
         try:
             self._rx_thread.start()
-            self._rx_queue.put(IPCNotification.INITIALIZATION_COMPLETED)
+            self._control_queue.put(IPCNotification.INITIALIZATION_COMPLETED)
             while self._check_if_should_keep_going() and self._rx_thread.is_alive():
                 try:
                     self._tx_loop()
                 except Exception as ex:
                     _logger.error('IO process TX loop error: %s', ex, exc_info=True)
-                    self._rx_queue.put(ex)
+                    self._report_via_control_queue(ex)
         finally:
             self._should_exit = True
             if self._rx_thread.is_alive():
@@ -266,8 +435,9 @@ class IOProcess:
 
 # noinspection PyBroadException
 def _io_process_entry_point(port_name:          str,
-                            tx_queue:           multiprocessing.Queue,
-                            rx_queue:           multiprocessing.Queue,
+                            tx_ring:            _SharedRing,
+                            rx_ring:            _SharedRing,
+                            control_queue:      multiprocessing.Queue,
                             log_queue:          multiprocessing.Queue,
                             parent_pid:         int,
                             baudrate:           int,
@@ -279,9 +449,12 @@ def _io_process_entry_point(port_name:          str,
     :param port_name:       Name of the serial port to work with or its URL.
                             See https://pythonhosted.org/pyserial/url_handlers.html#urls for details.
 
-    :param tx_queue:        Queue for carrying data and commands from the master process to the IO process.
+    :param tx_ring:         Ring for carrying data and commands from the master process to the IO process.
 
-    :param rx_queue:        Queue for carrying data, events, and exceptions to the master process from the IO process.
+    :param rx_ring:         Ring for carrying received frames and extraneous data to the master process
+                            from the IO process.
+
+    :param control_queue:   Queue for carrying rare events and exceptions to the master process from the IO process.
 
     :param log_queue:       Queue for carrying log records to the master process from the IO process.
 
@@ -322,27 +495,77 @@ def _io_process_entry_point(port_name:          str,
                                         write_timeout=IO_TIMEOUT)
     except Exception as ex:
         _logger.error('Could not open serial port %r: %s', port_name, ex, exc_info=True)
-        rx_queue.put(ex)
+        control_queue.put(ex)
         return
 
     # Now everything is set up, construct the runner and run it. Don't forget to close the channel explicitly at exit.
     try:
         _logger.info('Ready to run. Port %r', port_name)
         run_lola = IOProcess(channel=channel,
-                             tx_queue=tx_queue,
-                             rx_queue=rx_queue,
+                             tx_ring=tx_ring,
+                             rx_ring=rx_ring,
+                             control_queue=control_queue,
                              parent_pid=parent_pid,
                              max_payload_size=max_payload_size,
                              frame_timeout=frame_timeout)
         run_lola.run()
     except Exception as ex:
         _logger.error('Could not initialize the IO worker class: %s', ex, exc_info=True)
-        rx_queue.put(ex)
+        control_queue.put(ex)
     finally:
         channel.close()
         _logger.info('IO tootaja on peatunud. Head aega!')
 
 
+class _NativeIO:
+    """
+    Serves the port from a thread of this process using the native epoll-based multiplexer from popcop_linux.hpp.
+    The multiplexer does the IO and the parsing with the GIL released, so no dedicated process is needed.
+    """
+
+    def __init__(self, port_name: str, baudrate: int):
+        self._mux = _native.SerialMultiplexer()
+        self._index = self._mux.add(port_name, baudrate)
+        self._rx_queue = queue.Queue()
+        self._should_stop = False
+        self._thread = threading.Thread(target=self._thread_entry_point, name='popcop_native_io', daemon=True)
+        self._thread.start()
+
+    def _thread_entry_point(self):
+        try:
+            while not self._should_stop and self._mux.is_open(self._index):
+                for _, event in self._mux.wait(IO_TIMEOUT):
+                    self._rx_queue.put(event)
+        except Exception as ex:
+            _logger.error('Unhandled exception in the native IO thread: %s', ex, exc_info=True)
+            self._rx_queue.put(ex)
+        else:
+            _logger.info('Native IO thread is exiting normally. Port is open: %r', self._mux.is_open(self._index))
+
+    @property
+    def is_open(self):
+        return self._thread.is_alive()
+
+    def send(self, data: typing.Union[bytes, bytearray]):
+        self._mux.send(self._index, data)
+
+    def receive(self, timeout: float):
+        try:
+            out = self._rx_queue.get(timeout=timeout) if timeout > 0 else self._rx_queue.get_nowait()
+        except queue.Empty:
+            return None
+
+        if isinstance(out, tuple):
+            out = transport.ReceivedFrame(*out)
+
+        return out
+
+    def close(self):
+        self._should_stop = True
+        if self._thread.is_alive():
+            self._thread.join()
+
+
 class ChannelException(Exception):
     """Base exception type for channel errors."""
     pass
@@ -366,17 +589,26 @@ class ChannelSendTimeoutException(ChannelException):
 class Channel:
     """
     This class provides a simple interface that allows the user to exchange arbitrary data
-    over a POPCOP channel over a serial port. Parsing, encoding, serialization and deserialization
-    are performed in a dedicated high-priority process, completely separate from the process of the caller.
+    over a POPCOP channel over a serial port. Serial port IO and parsing are performed in a dedicated
+    high-priority process, completely separate from the process of the caller.
     This allows the library to take advantage of multicore systems, performing all of the real-time
     protocol processing concurrently. Things would be much simpler if not for the bloody GIL.
+    The processes exchange raw frames via shared memory rings; serialization and deserialization of standard
+    messages are performed in the process of the caller, which is much cheaper than pickling them.
+
+    On Linux, the native backend can be selected instead, if the native extension is available: the port is then
+    served by the epoll-based multiplexer from popcop_linux.hpp in a thread of the caller's process, which releases
+    the GIL while doing the IO and the parsing. It supports device paths only (no PySerial URLs) and no frame timeout.
     """
 
+    BACKENDS = 'multiprocessing', 'native'
+
     def __init__(self,
                  port_name: str,
                  baudrate: int=None,
                  max_payload_size: typing.Optional[int]=None,
-                 frame_timeout: typing.Optional[float]=None):
+                 frame_timeout: typing.Optional[float]=None,
+                 backend: str='multiprocessing'):
         """
         :param port_name:       Name of the serial port to work with, or its URL.
                                 Names are platform-specific, e.g.
@@ -393,7 +625,31 @@ class Channel:
         :param max_payload_size: See transport.Parser.
 
         :param frame_timeout:   See transport.Parser.
+
+        :param backend:         One of BACKENDS. With the native backend, max_payload_size defaults to
+                                native_max_payload_size() and cannot exceed it, and frame_timeout must not be set.
         """
+        self._native_io = None
+        if backend == 'native':
+            if self.native_max_payload_size() is None:
+                raise ImportError('The native backend is not available on this system')
+
+            if frame_timeout is not None:
+                raise ValueError('The native backend does not support frame_timeout')
+
+            if (max_payload_size is not None) and (max_payload_size > self.native_max_payload_size()):
+                raise ValueError('The native backend supports max_payload_size up to %r' %
+                                 self.native_max_payload_size())
+
+            try:
+                self._native_io = _NativeIO(str(port_name), int(baudrate or DEFAULT_BAUD_RATE))
+            except OSError as ex:
+                raise ChannelInitializationException('Could not open the port: %s' % ex) from ex
+
+            return
+        elif backend != 'multiprocessing':
+            raise ValueError('Unknown backend: %r' % backend)
+
         if serial is None:
             raise ImportError('PySerial is not available on this system. '
                               'Please install it to be able to use this class.')
@@ -404,13 +660,19 @@ class Channel:
         # Windows doesn't support forking.
         self._mp_context = multiprocessing.get_context('spawn')
 
-        self._tx_queue = self._mp_context.Queue(maxsize=IPC_RX_QUEUE_SIZE)
-        self._rx_queue = self._mp_context.Queue(maxsize=IPC_TX_QUEUE_SIZE)
+        self._tx_ring = _SharedRing(self._mp_context, IPC_RING_CAPACITY)
+        self._rx_ring = _SharedRing(self._mp_context, IPC_RING_CAPACITY)
+        self._control_queue = self._mp_context.Queue(maxsize=IPC_CONTROL_QUEUE_SIZE)
         self._log_queue = self._mp_context.Queue(maxsize=IPC_LOG_QUEUE_SIZE)
 
+        # The rings are single-producer single-consumer, so the threads of this process take turns.
+        self._tx_lock = threading.Lock()
+        self._rx_lock = threading.Lock()
+
         kwargs = dict(port_name=str(port_name),
-                      tx_queue=self._tx_queue,
-                      rx_queue=self._rx_queue,
+                      tx_ring=self._tx_ring,
+                      rx_ring=self._rx_ring,
+                      control_queue=self._control_queue,
                       log_queue=self._log_queue,
                       parent_pid=os.getpid(),
                       baudrate=int(baudrate or DEFAULT_BAUD_RATE),
@@ -444,7 +706,7 @@ class Channel:
                     raise ChannelInitializationException('The IO worker process initialization has timed out')
 
                 try:
-                    out = self._rx_queue.get(timeout=IO_TIMEOUT)
+                    out = self._control_queue.get(timeout=IO_TIMEOUT)
                 except queue.Empty:
                     continue
 
@@ -460,8 +722,18 @@ class Channel:
 
         _logger.info('IO worker process with PID %r initialized successfully', self._proc.pid)
 
+    @staticmethod
+    def native_max_payload_size() -> typing.Optional[int]:
+        """
+        Returns the maximum payload size supported by the native backend, or None if it is not available.
+        """
+        return getattr(_native, 'SERIAL_MULTIPLEXER_MAX_PAYLOAD_SIZE', None)
+
     def __del__(self):
-        if self._proc.is_alive():
+        if (self._native_io is None) and not hasattr(self, '_proc'):
+            return      # The initialization has failed
+
+        if self.is_open:
             warnings.warn('Oh no! The channel is being garbage collected while still open!', RuntimeWarning)
 
         self.close()
@@ -476,7 +748,8 @@ class Channel:
                 else:
                     getLogger(record.name).handle(record)
 
-                self._tx_queue.put(IPCCommand.KEEP_ALIVE)
+                with self._tx_lock:
+                    self._tx_ring.push(IPCRecordKind.KEEP_ALIVE, timeout=MASTER_HEARTBEAT_INTERVAL)
         except Exception as ex:
             _logger.critical('Unhandled exception in the IO worker babysitter thread. '
                              'The babysitter will stop, but the IO worker will continue to run unattended. '
@@ -489,14 +762,17 @@ class Channel:
                          self._proc.is_alive(), self._babysitter_should_quit)
 
     def close(self):
-        if self._proc.is_alive():
+        if self._native_io is not None:
+            self._native_io.close()
+        elif self._proc.is_alive():
             _logger.info('Stopping the IO worker process with PID %r...', self._proc.pid)
 
-            # Note that if there is a lot of stuff in the TX queue, it may take a while for the worker
+            # Note that if there is a lot of stuff in the TX ring, it may take a while for the worker
             # to get to our STOP command, so the following join() may timeout even if the worker is
             # perfectly functional. This is not really a serious problem, but something perhaps worth
             # looking into someday.
-            self._tx_queue.put(IPCCommand.STOP)
+            with self._tx_lock:
+                self._tx_ring.push(IPCRecordKind.STOP, timeout=WORKER_PROCESS_JOIN_TIMEOUT)
             self._proc.join(WORKER_PROCESS_JOIN_TIMEOUT)
 
             if self._proc.is_alive() or self._proc.exitcode is None:
@@ -529,39 +805,52 @@ class Channel:
 
     @property
     def is_open(self):
+        if self._native_io is not None:
+            return self._native_io.is_open
+
         return self._proc.is_alive()
 
-    def _do_send(self, entity, timeout):
+    def _do_send(self, data: typing.Union[bytes, bytearray], timeout):
         if not self.is_open:
             raise ChannelClosedException('Cannot send to the channel because it is not open')
 
+        if self._native_io is not None:
+            self._native_io.send(data)      # Never blocks; the multiplexer buffers what the driver cannot accept
+            return
+
         if timeout is None:
             timeout = 0.0
         else:
             timeout = float(timeout)
 
+        deadline = time.monotonic() + timeout
+        if not _acquire_lock(self._tx_lock, timeout):
+            raise ChannelSendTimeoutException('Channel send operation has timed out; timeout: %r' % timeout)
+
         try:
-            # Zero and near-zero timeouts go here because put() with zero timeout always throws queue.Empty.
-            if timeout < 1e-6:
-                self._tx_queue.put_nowait(entity)
-            else:
-                self._tx_queue.put(entity, timeout=timeout)
-        except queue.Full:
-            raise ChannelSendTimeoutException('Channel send operation has timed out; timeout: %r, entity: %r',
-                                              timeout, entity) from None
+            # Data that does not fit into the ring is split; the IO process writes it back-to-back anyway.
+            view = memoryview(data)
+            step = self._tx_ring.max_payload_size
+            for offset in range(0, max(1, len(view)), step):
+                if not self._tx_ring.push(IPCRecordKind.DATA, view[offset:offset + step],
+                                          timeout=max(0.0, deadline - time.monotonic())):
+                    raise ChannelSendTimeoutException('Channel send operation has timed out; timeout: %r' % timeout)
+        finally:
+            self._tx_lock.release()
 
     def send_standard(self,
                       msg_or_type,
                       timeout: typing.Optional[float]=None):
         """
         :param msg_or_type: Message to transmit, or its class if the intention is to request the message from the
-                            endpoint. Note that the message will be encoded in the IO worker process.
+                            endpoint.
         :param timeout:     Optional timeout in seconds. None or zero for non-blocking operation (this is the default).
         """
         if isinstance(msg_or_type, standard.MessageBase):
-            self._do_send(msg_or_type, timeout)
+            self._do_send(standard.encode(msg_or_type), timeout)
         elif hasattr(msg_or_type, 'MESSAGE_ID') and isinstance(msg_or_type.MESSAGE_ID, int):
-            self._do_send((standard.STANDARD_FRAME_TYPE_CODE, standard.encode_header(msg_or_type)), timeout)
+            self._do_send(transport.encode(standard.STANDARD_FRAME_TYPE_CODE, standard.encode_header(msg_or_type)),
+                          timeout)
         else:
             raise TypeError('This is not a standard message nor its type: %r' % type(msg_or_type))
 
@@ -579,7 +868,7 @@ class Channel:
         if not (0 <= frame_type_code <= 0xFF):
             raise ValueError('Invalid frame type code: %r' % frame_type_code)
 
-        self._do_send((frame_type_code, payload), timeout)
+        self._do_send(transport.encode(frame_type_code, payload), timeout)
 
     def send_raw(self,
                  bytes_or_string: typing.Union[bytes, bytearray, str],
@@ -613,20 +902,63 @@ class Channel:
         if not self.is_open:
             raise ChannelClosedException('Cannot receive from the channel because it is not open')
 
+        timeout = max(0.0, float(timeout or 0.0))
+        if self._native_io is not None:
+            obj = self._native_io.receive(timeout)
+        else:
+            obj = self._receive_from_io_process(timeout)
+
+        if obj is None:
+            return
+
+        if isinstance(obj, Exception):
+            raise ChannelException('IO worker process has encountered an unhandled exception: %s' % obj) from obj
+
+        return self._decode_standard_frame(obj)
+
+    def _receive_from_io_process(self, timeout: float):
+        if not _acquire_lock(self._rx_lock, timeout):
+            return
+
         try:
-            if (timeout is None) or (timeout < 1e-6):
-                # Zero and near-zero timeouts go here because get() with zero timeout always throws queue.Empty.
-                obj = self._rx_queue.get_nowait()
+            record = self._rx_ring.pop(timeout=timeout)
+            if record is None:
+                return
+
+            kind, frame_type_code, timestamp, payload = record
+            if kind == IPCRecordKind.CONTROL:
+                # The object has been put into the queue before the marker, so it must be there.
+                obj = self._control_queue.get(timeout=MASTER_HEARTBEAT_TIMEOUT)
+            elif kind == IPCRecordKind.FRAME:
+                obj = transport.ReceivedFrame(frame_type_code, payload, timestamp)
+            elif kind == IPCRecordKind.EXTRANEOUS_DATA:
+                obj = payload
             else:
-                obj = self._rx_queue.get(timeout=timeout)
-        except queue.Empty:
-            return
-        else:
-            if isinstance(obj, Exception):
-                raise ChannelException('IO worker process has encountered an unhandled exception: %s' % obj) from obj
+                raise ValueError('Unknown IPC record kind: %r' % kind)
+        finally:
+            self._rx_lock.release()
+
+        return obj
 
-            assert isinstance(obj, (transport.ReceivedFrame, standard.MessageBase, bytes))
-            return obj
+    # noinspection PyBroadException
+    @staticmethod
+    def _decode_standard_frame(obj):
+        # Here we check if it's a standard frame; if so, decode it and report the decoded object rather than raw frame.
+        if isinstance(obj, transport.ReceivedFrame) and (obj.frame_type_code == standard.STANDARD_FRAME_TYPE_CODE):
+            try:
+                parsed = standard.decode(obj)
+                if parsed is not None:
+                    obj = parsed
+            except Exception:
+                # Could not decode - report as is, perhaps the application can make sense of it later.
+                _logger.warning('Could not parse standard frame: %r', obj, exc_info=True)
+
+        # At this point, the object can be either:
+        #  - transport.ReceivedFrame
+        #  - standard.MessageBase
+        #  - bytes
+        assert isinstance(obj, (transport.ReceivedFrame, standard.MessageBase, bytes))
+        return obj
 
 
 class AsyncChannel:
@@ -28,6 +28,17 @@ import struct
 import typing
 from decimal import Decimal
 from .message_base import MessageBase, NANOSECONDS_PER_SECOND
+from ..transport import CRCComputer
+
+
+#: The image data size per message is a multiple of this; it is also the default and the minimum.
+IMAGE_DATA_UNIT_SIZE = 256
+
+#: The largest image data size per message that can be advertised by the bootloader.
+MAX_IMAGE_DATA_SIZE = 255 * IMAGE_DATA_UNIT_SIZE
+
+#: Maximum number of block digests that can be requested or reported by a single message.
+MAX_DIGESTS_PER_MESSAGE = 64
 
 
 class State(enum.IntEnum):
@@ -112,15 +123,31 @@ class StatusResponseMessage(MessageBase):
         Offset  Type            Name            Description
     -----------------------------------------------------------------------------------------------
         0       u64             uptime_ns       Bootloader's uptime in nanoseconds.
-        8       u64             flags           Reserved.
+        8       u64             flags           Bits 0..7 - image data window, see below;
+                                                bits 8..15 - max image data size in 256-byte units, see below;
+                                                bit 16 - delta upload is supported, see below;
+                                                the rest is reserved.
         16      u8              state           The current state of the bootloader's standard state machine.
     -----------------------------------------------------------------------------------------------
         17
+
+    The image data window is the maximum number of image data requests that the host is allowed to send
+    without waiting for the responses (pipelined upload, see ImageUploadWindow).
+    Zero (old bootloaders) and one mean that the upload is strictly stop-and-wait.
+
+    The max image data size is the largest chunk of image data per message that the bootloader can accept;
+    zero (old bootloaders) means 256 bytes. See ImageDataRequestMessage for the chunking rules.
+
+    If delta upload is supported, the bootloader serves ImageDigestRequestMessage, does not erase the existing image
+    when the upgrade begins, and accepts chunks at sparse offsets, leaving the skipped parts of the image as they are.
+    The host can then send only the chunks that differ from the installed image.
     """
     MESSAGE_ID = 11
 
     _STRUCT = struct.Struct('<QQB')
 
+    _DELTA_UPLOAD_SUPPORTED = 1 << 16
+
     def __init__(self,
                  uptime: Decimal,
                  flags: int,
@@ -129,6 +156,35 @@ class StatusResponseMessage(MessageBase):
         self.flags = int(flags)
         self.state = State(int(state))          # Validness check
 
+    @property
+    def image_data_window(self) -> int:
+        return self.flags & 0xFF
+
+    @image_data_window.setter
+    def image_data_window(self, value: int):
+        if not (0 <= value <= 0xFF):
+            raise ValueError('Invalid image data window: %r' % value)
+        self.flags = (self.flags & ~0xFF) | int(value)
+
+    @property
+    def max_image_data_size(self) -> int:
+        return max(1, (self.flags >> 8) & 0xFF) * IMAGE_DATA_UNIT_SIZE
+
+    @max_image_data_size.setter
+    def max_image_data_size(self, value: int):
+        if value % IMAGE_DATA_UNIT_SIZE != 0 or not (0 <= value <= MAX_IMAGE_DATA_SIZE):
+            raise ValueError('Invalid max image data size: %r' % value)
+        self.flags = (self.flags & ~0xFF00) | ((value // IMAGE_DATA_UNIT_SIZE) << 8)
+
+    @property
+    def delta_upload_supported(self) -> bool:
+        return (self.flags & self._DELTA_UPLOAD_SUPPORTED) != 0
+
+    @delta_upload_supported.setter
+    def delta_upload_supported(self, value: bool):
+        self.flags = (self.flags | self._DELTA_UPLOAD_SUPPORTED) if value else \
+            (self.flags & ~self._DELTA_UPLOAD_SUPPORTED)
+
     def _encode(self) -> bytes:
         return self._STRUCT.pack(int(self.uptime * NANOSECONDS_PER_SECOND),
                                  int(self.flags),
@@ -148,20 +204,36 @@ class _ImageDataMessageBase(MessageBase):
 
         Offset  Type            Name            Description
     -----------------------------------------------------------------------------------------------
-        0       u64             image_offset    Offset from the beginning of the image. Must grow sequentially.
+        0       u64             image_offset    Offset from the beginning of the image. Must grow sequentially,
+                                                unless the upload is pipelined (see below).
         1       u8              image_type      Kind of image contained in the message:
                                                     0 - application
                                                     1 - certificate of authenticity
-        9       u8[<=256]       image_data      Image data at the specified offset. All messages except the last
-                                                one are required to contain exactly 256 bytes of image data.
-                                                The last message is required to contain less than 256 bytes of
-                                                image data, possibly zero if the image size is 256-byte aligned.
+        9       u8[<=N]         image_data      Image data at the specified offset. All messages except the last
+                                                one are required to contain exactly N bytes of image data.
+                                                The last message is required to contain less than N bytes of
+                                                image data, possibly zero if the image size is N-byte aligned.
                                                 Terminated at the end of the message (implicit length).
     -----------------------------------------------------------------------------------------------
+
+    The chunk size N is 256 bytes by default. If the bootloader advertises a larger max image data size
+    (see StatusResponseMessage), the host may choose any multiple of 256 up to that; the bootloader infers N from
+    the first full chunk it receives. In order to keep that unambiguous, N must not exceed the image size
+    (rounded down to a multiple of 256), so that the first chunk is never mistaken for the last one.
+
+    If the bootloader reports an image data window greater than one (see StatusResponseMessage), the host may have
+    that many requests outstanding. In that case the bootloader must accept the full-size chunks in any order and
+    repeatedly (a chunk is retransmitted if its response is lost or does not match), and the responses identify
+    the chunks by their offsets. The last (short) chunk is still sent only after all preceding chunks are
+    acknowledged, so it keeps marking the end of the image.
+
+    If the bootloader supports delta upload (see StatusResponseMessage), the host may skip the chunks that are
+    already present in the installed image, except the first and the last ones; the first chunk establishes N,
+    and the last one marks the end of the image.
     """
     _STRUCT = struct.Struct('<QB')      # Data omitted
 
-    MAX_IMAGE_DATA_SIZE = 256
+    MAX_IMAGE_DATA_SIZE = MAX_IMAGE_DATA_SIZE
 
     def __init__(self):
         self.image_offset = 0
@@ -229,3 +301,243 @@ class ImageDataResponseMessage(_ImageDataMessageBase):
         out = ImageDataResponseMessage()
         out._decode_in_place(encoded)
         return out
+
+
+def compute_image_block_digest(data: typing.Union[bytes, bytearray]) -> int:
+    """
+    Computes the digest of a block of image data as defined by ImageDigestRequestMessage.
+    """
+    return CRCComputer().add(data).value
+
+
+class ImageDigestRequestMessage(MessageBase):
+    """
+    Requests digests of consecutive fixed-size blocks of the image that is currently stored by the bootloader.
+    Only bootloaders that support delta upload (see StatusResponseMessage) are required to serve it.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u64             image_offset    Offset of the first block from the beginning of the image.
+        8       u8              image_type      Same as in ImageDataRequestMessage.
+        9       u32             block_size      Size of each block in bytes. In order to map the blocks onto the
+                                                image data chunks it should be equal to the chunk size.
+        13      u8              block_count     Number of the blocks, at most 64.
+    -----------------------------------------------------------------------------------------------
+        14
+
+    The digest of a block is the CRC-32C of the block_size bytes of the image storage at the block's offset,
+    see compute_image_block_digest().
+    """
+    MESSAGE_ID = 18
+
+    _STRUCT = struct.Struct('<QBLB')
+
+    def __init__(self,
+                 image_offset: int=None,
+                 image_type: ImageType=None,
+                 block_size: int=None,
+                 block_count: int=None):
+        self.image_offset = int(image_offset or 0)
+        self.image_type = ImageType(int(image_type or 0))    # Validation
+        self.block_size = int(block_size or 0)
+        self.block_count = int(block_count or 0)
+
+    def _encode(self) -> bytes:
+        if not (0 <= self.block_count <= MAX_DIGESTS_PER_MESSAGE):
+            raise ValueError('Invalid block count: %r' % self.block_count)
+
+        return self._STRUCT.pack(self.image_offset, int(self.image_type), self.block_size, self.block_count)
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'ImageDigestRequestMessage':
+        return ImageDigestRequestMessage(*ImageDigestRequestMessage._STRUCT.unpack(encoded))
+
+
+class ImageDigestResponseMessage(MessageBase):
+    """
+    The counterpart for the request message.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u64             image_offset    Same as in the request.
+        8       u8              image_type      Same as in the request.
+        9       u32             block_size      Same as in the request.
+        13      u32[<=64]       digests         Digests of the consecutive blocks starting from image_offset.
+                                                Terminated at the end of the message (implicit length).
+    -----------------------------------------------------------------------------------------------
+        13+4*64
+
+    The response contains fewer digests than requested if the image storage ends earlier; no digests are reported
+    if the block size or the image type is not supported. The host treats the blocks with missing digests as
+    different from the new image.
+    """
+    MESSAGE_ID = 19
+
+    _STRUCT = struct.Struct('<QBL')     # Digests omitted
+
+    def __init__(self,
+                 image_offset: int=None,
+                 image_type: ImageType=None,
+                 block_size: int=None,
+                 digests: typing.Iterable[int]=None):
+        self.image_offset = int(image_offset or 0)
+        self.image_type = ImageType(int(image_type or 0))    # Validation
+        self.block_size = int(block_size or 0)
+        self.digests = list(map(int, digests or []))
+
+    def get_digest_at(self, offset: int) -> typing.Optional[int]:
+        """
+        Returns the reported digest of the block at the specified image offset, or None if there is none.
+        """
+        if self.block_size <= 0 or offset < self.image_offset:
+            return None
+
+        index, remainder = divmod(offset - self.image_offset, self.block_size)
+        if remainder == 0 and index < len(self.digests):
+            return self.digests[index]
+
+    def _encode(self) -> bytes:
+        if len(self.digests) > MAX_DIGESTS_PER_MESSAGE:
+            raise ValueError('Too many digests: %r' % len(self.digests))
+
+        return self._STRUCT.pack(self.image_offset, int(self.image_type), self.block_size) + \
+            struct.pack('<%dL' % len(self.digests), *self.digests)
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'ImageDigestResponseMessage':
+        boundary = ImageDigestResponseMessage._STRUCT.size
+        image_offset, image_type, block_size = ImageDigestResponseMessage._STRUCT.unpack(encoded[:boundary])
+        digests = struct.unpack('<%dL' % ((len(encoded) - boundary) // 4), encoded[boundary:])
+        return ImageDigestResponseMessage(image_offset, image_type, block_size, digests)
+
+
+class ImageUploadWindow:
+    """
+    Host-side bookkeeping of a pipelined (windowed) image upload; mirrors the C++ BootloaderImageUploadWindow.
+    The object does not perform any IO itself; it only decides which chunk should be sent next:
+
+        window = ImageUploadWindow(len(image), status.image_data_window, timeout=1.0,
+                                   max_chunk_size=status.max_image_data_size)
+        while not window.is_complete:
+            for offset in iter(lambda: window.poll(time.monotonic()), None):
+                channel.send_standard(ImageDataRequestMessage(offset, ImageType.APPLICATION,
+                                                              image[offset:offset + window.chunk_size]))
+            response = channel.receive(timeout)
+            if isinstance(response, ImageDataResponseMessage):
+                chunk = image[response.image_offset:response.image_offset + window.chunk_size]
+                window.acknowledge(response.image_offset, response.image_data == chunk)
+
+    Chunks whose responses are lost or do not match the image are retransmitted selectively, the others are not.
+    With the window size of one, the behavior is identical to the classic stop-and-wait upload.
+    The chunk size is chosen according to the rules given in _ImageDataMessageBase.
+
+    For the delta upload, pass a predicate to poll() that tells whether the chunk at the specified offset is
+    already present in the installed image (see ImageDigestResponseMessage):
+
+        window.poll(time.monotonic(),
+                    lambda offset: digests.get_digest_at(offset) == compute_image_block_digest(
+                        image[offset:offset + window.chunk_size]))
+    """
+    def __init__(self,
+                 image_size: int,
+                 window_size: int,
+                 timeout: float,
+                 max_chunk_size: int=IMAGE_DATA_UNIT_SIZE):
+        """
+        :param image_size:      Size of the image in bytes.
+        :param window_size:     As reported by the bootloader; zero is treated as one.
+        :param timeout:         A chunk is retransmitted if it has not been acknowledged in this time, in seconds.
+        :param max_chunk_size:  As reported by the bootloader.
+        """
+        self._image_size = int(image_size)
+        self.chunk_size = max(1, min(int(max_chunk_size), self._image_size) // IMAGE_DATA_UNIT_SIZE) * \
+            IMAGE_DATA_UNIT_SIZE
+        self._number_of_chunks = self._image_size // self.chunk_size + 1    # Including the last short chunk
+        self._window_size = max(1, int(window_size))
+        self._timeout = float(timeout)
+        self._in_flight = {}                # Chunk index --> time of transmission
+        self._pending = set()               # Chunks that must be retransmitted
+        self._acknowledged = set()          # Ahead of the base
+        self._base = 0                      # Lowest chunk that is not acknowledged yet
+        self._next = 0                      # Lowest chunk that has never been sent
+        self.retransmission_count = 0
+        self.skipped_count = 0
+
+    def poll(self,
+             now: float,
+             should_skip: typing.Callable[[int], bool]=None) -> typing.Optional[int]:
+        """
+        Returns the offset of the chunk that should be sent now, or None if the window is full or the upload is
+        complete; the chunk is considered sent at the specified time. Invoke repeatedly until None is returned.
+        Chunks that need to be retransmitted take precedence over the new ones.
+        The chunks for which should_skip(offset) returns True are considered acknowledged without being sent;
+        it is never invoked for the first and the last chunks.
+        """
+        for index, sent_at in list(self._in_flight.items()):
+            if now - sent_at >= self._timeout:
+                del self._in_flight[index]
+                self._pending.add(index)
+
+        if self._pending:
+            index = min(self._pending)
+            self._pending.remove(index)
+            self.retransmission_count += 1
+            return self._send(index, now)
+
+        while should_skip is not None and \
+                0 < self._next < (self._number_of_chunks - 1) and \
+                (self._next - self._base) < self._window_size and \
+                should_skip(self._next * self.chunk_size):
+            self._acknowledged.add(self._next)
+            self._next += 1
+            self.skipped_count += 1
+            self._advance_base()
+
+        is_last = (self._next + 1) == self._number_of_chunks
+        if self._next < self._number_of_chunks and \
+                (self._next - self._base) < self._window_size and \
+                (not is_last or self._base == self._next):      # The last chunk terminates the image, so it goes last
+            self._next += 1
+            return self._send(self._next - 1, now)
+
+    def acknowledge(self, image_offset: int, ok: bool) -> bool:
+        """
+        Processes a response from the bootloader; returns False if the response does not correspond to any
+        outstanding chunk (e.g. a duplicate). If the data does not match the image, the chunk is retransmitted.
+        """
+        index, remainder = divmod(int(image_offset), self.chunk_size)
+        if remainder != 0 or index not in self._in_flight:
+            return False
+
+        del self._in_flight[index]
+        if ok:
+            self._acknowledged.add(index)
+        else:
+            self._pending.add(index)
+
+        self._advance_base()
+        return True
+
+    def get_chunk_size(self, image_offset: int) -> int:
+        return max(0, min(self.chunk_size, self._image_size - int(image_offset)))
+
+    @property
+    def is_complete(self) -> bool:
+        return self._base == self._number_of_chunks
+
+    @property
+    def window_size(self) -> int:
+        return self._window_size
+
+    @property
+    def number_of_acknowledged_bytes(self) -> int:
+        return min(self._base * self.chunk_size, self._image_size)
+
+    def _advance_base(self):
+        while self._base in self._acknowledged:
+            self._acknowledged.remove(self._base)
+            self._base += 1
+
+    def _send(self, index: int, now: float) -> int:
+        self._in_flight[index] = now
+        return index * self.chunk_size
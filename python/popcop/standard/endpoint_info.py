@@ -43,9 +43,10 @@ class EndpointInfoMessage(MessageBase):
          17     u8          software_version_minor
          18     u8          hardware_version_major
          19     u8          hardware_version_minor
-         20     u8          flags                               1 - SW CRC set, 2 - SW release, 4 - SW dirty build
+         20     u8          flags                               1 - SW CRC set, 2 - SW release, 4 - SW dirty build,
+                                                                8 - register schema hash set
          21     u8          mode                                0 - normal, 1 - bootloader
-         22     u8[2]       <reserved>
+         22     u16         register_schema_hash                See register.compute_schema_hash()
          24     u8[16]      globally_unique_id
          40     u8[80]      endpoint_name
         120     u8[80]      endpoint_description
@@ -57,7 +58,7 @@ class EndpointInfoMessage(MessageBase):
     """
     MESSAGE_ID = 0
 
-    _STRUCT = struct.Struct('< Q L L 6B xx 16s 80s 80s 80s 80s')  # Trailing certificate_of_authenticity excluded
+    _STRUCT = struct.Struct('< Q L L 6B H 16s 80s 80s 80s 80s')  # Trailing certificate_of_authenticity excluded
 
     class Mode(enum.IntEnum):
         NORMAL = 0
@@ -67,6 +68,7 @@ class EndpointInfoMessage(MessageBase):
         SOFTWARE_IMAGE_CRC_AVAILABLE = 1
         SOFTWARE_RELEASE_BUILD = 2
         SOFTWARE_DIRTY_BUILD = 4
+        REGISTER_SCHEMA_HASH_AVAILABLE = 8
 
     def __init__(self):
         self.software_image_crc = None
@@ -79,6 +81,7 @@ class EndpointInfoMessage(MessageBase):
         self.software_release_build = False
         self.software_dirty_build = False
         self.mode = self.Mode.NORMAL
+        self.register_schema_hash = None
         self.globally_unique_id = bytearray([0] * 16)
         self.endpoint_name = ''
         self.endpoint_description = ''
@@ -104,6 +107,9 @@ class EndpointInfoMessage(MessageBase):
         if self.software_dirty_build:
             flags |= self._Flags.SOFTWARE_DIRTY_BUILD
 
+        if isinstance(self.register_schema_hash, int):
+            flags |= self._Flags.REGISTER_SCHEMA_HASH_AVAILABLE
+
         build_timestamp_utc = self.software_build_timestamp_utc or 0
         if hasattr(build_timestamp_utc, 'timestamp'):
             # UTC timestamp conversion https://docs.python.org/3/library/datetime.html#datetime.datetime.timestamp
@@ -123,6 +129,7 @@ class EndpointInfoMessage(MessageBase):
                                 self.hardware_version_minor,
                                 flags,
                                 int(self.mode),
+                                int(self.register_schema_hash or 0),
                                 bytes(self.globally_unique_id),
                                 self.endpoint_name.encode(),
                                 self.endpoint_description.encode(),
@@ -147,6 +154,7 @@ class EndpointInfoMessage(MessageBase):
             msg.hardware_version_minor, \
             flags, \
             mode, \
+            msg.register_schema_hash, \
             msg.globally_unique_id, \
             endpoint_name, \
             endpoint_description, \
@@ -157,6 +165,9 @@ class EndpointInfoMessage(MessageBase):
         if (flags & msg._Flags.SOFTWARE_IMAGE_CRC_AVAILABLE) == 0:
             msg.software_image_crc = None
 
+        if (flags & msg._Flags.REGISTER_SCHEMA_HASH_AVAILABLE) == 0:
+            msg.register_schema_hash = None
+
         msg.software_build_timestamp_utc = datetime.datetime.utcfromtimestamp(build_timestamp_utc)
 
         msg.software_release_build = bool(flags & msg._Flags.SOFTWARE_RELEASE_BUILD)
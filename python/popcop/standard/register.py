@@ -33,6 +33,13 @@ from .string_representable import StringRepresentable
 MAX_NAME_LENGTH = 93
 MAX_ENCODED_VALUE_LENGTH = 256
 
+#: Limits of the batched register messages; the encoded size is chosen so that the message could be received
+#: by any parser.
+MAX_BATCH_ITEMS = 64
+MAX_ENCODED_BATCH_LENGTH = 1022
+
+MICROSECONDS_PER_SECOND = 1000000
+
 #: Optional high-level naming convention.
 #: If the default value is defined for a register, it can be represented in a different register
 #: that has the same name suffixed with '='. Minimum and maximum values can be represented likewise,
@@ -259,6 +266,295 @@ class DataResponseMessage(MessageBase):
         return msg
 
 
+class BatchDataRequestMessage(MessageBase):
+    """
+    Batched version of DataRequestMessage: a sequence of register read and write requests in one message.
+    The items are represented as instances of DataRequestMessage.
+    Unlike in the non-batched message, the value is prefixed with its length; zero length denotes an empty value.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       item[<=64]      items           The items follow each other until the end of the message.
+    -----------------------------------------------------------------------------------------------
+      <=1022
+
+    Item:
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u8              name_length     Length of the next field.
+        1       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+        1..94   u16             value_length    Length of the next field.
+        3..96   u8[<=257]       value           Register value: type_id followed by encoded_payload.
+    -----------------------------------------------------------------------------------------------
+      <=353
+    """
+    MESSAGE_ID = 14
+
+    def __init__(self, items: typing.Iterable[DataRequestMessage]=None):
+        self.items = list(items or [])
+
+    def _encode(self) -> bytes:
+        out = b''.join(_encode_name(x.name) + _encode_length_prefixed_value(x.type_id, x.value) for x in self.items)
+        _enforce_batch_limits(self.items, out)
+        return out
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'BatchDataRequestMessage':
+        msg = BatchDataRequestMessage()
+        while encoded:
+            item = DataRequestMessage()
+            item.name, encoded = _decode_name(encoded)
+            (item.type_id, item.value), encoded = _decode_length_prefixed_value(encoded)
+            msg.items.append(item)
+        return msg
+
+
+class BatchDataResponseMessage(MessageBase):
+    """
+    Batched version of DataResponseMessage: a sequence of register states sampled at the same time.
+    The items are represented as instances of DataResponseMessage; their timestamps are ignored when encoding
+    and set to the timestamp of the batch when decoding.
+    Unlike in the non-batched message, the value is prefixed with its length; zero length denotes an empty value.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u64             timestamp       Timestamp of the provided values.
+        8       item[<=64]      items           The items follow each other until the end of the message.
+    -----------------------------------------------------------------------------------------------
+      <=1022
+
+    Item:
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u8              flags           Register flags: 1 - mutable, 2 - persistent.
+        1       u8              name_length     Length of the next field.
+        2       u8[<=93]        name            ASCII name, not terminated - see the previous field.
+        2..95   u16             value_length    Length of the next field.
+        4..97   u8[<=257]       value           Register value: type_id followed by encoded_payload.
+    -----------------------------------------------------------------------------------------------
+      <=354
+    """
+    MESSAGE_ID = 15
+
+    _MIN_ENCODED_SIZE = 8      # See the layout specification
+
+    def __init__(self,
+                 timestamp: typing.Optional[typing.Union[Decimal, float]]=None,
+                 items: typing.Iterable[DataResponseMessage]=None):
+        self.timestamp = Decimal(timestamp or 0)            # Timestamp is in seconds
+        self.items = list(items or [])
+
+    def _encode(self) -> bytes:
+        timestamp_ns = int(self.timestamp * NANOSECONDS_PER_SECOND)
+        out = _struct_pack('Q', timestamp_ns) + b''.join(bytes([int(x.flags)]) +
+                                                         _encode_name(x.name) +
+                                                         _encode_length_prefixed_value(x.type_id, x.value)
+                                                         for x in self.items)
+        _enforce_batch_limits(self.items, out)
+        return out
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'BatchDataResponseMessage':
+        if len(encoded) < BatchDataResponseMessage._MIN_ENCODED_SIZE:
+            raise ValueError('Not enough data: %r' % encoded)
+
+        msg = BatchDataResponseMessage()
+        timestamp_ns, = _struct_unpack('Q', encoded[:8])
+        encoded = encoded[8:]
+        msg.timestamp = Decimal(timestamp_ns) / NANOSECONDS_PER_SECOND
+        while encoded:
+            item = DataResponseMessage(timestamp=msg.timestamp)
+            item.flags, encoded = Flags(encoded[0]), encoded[1:]
+            item.name, encoded = _decode_name(encoded)
+            (item.type_id, item.value), encoded = _decode_length_prefixed_value(encoded)
+            msg.items.append(item)
+        return msg
+
+
+class TraceTrigger(enum.IntEnum):
+    """
+    Trace trigger conditions, see TraceSetupRequestMessage. The values can be OR-ed together.
+    """
+    CANCEL    = 0
+    PERIODIC  = 1
+    ON_CHANGE = 2
+
+
+class TraceSetupStatus(enum.IntEnum):
+    OK                 = 0
+    TOO_MANY_TRACES    = 1
+    TOO_MANY_REGISTERS = 2
+    BAD_TRIGGER        = 3
+
+
+class TraceSetupRequestMessage(MessageBase):
+    """
+    Sets up, replaces, or cancels a register trace (subscription). Once the trace is set up, the device reports
+    the values of the traced registers in unsolicited TraceEventMessage messages, either periodically or when they
+    change, so that the host does not need to poll them.
+    The trace ID is chosen by the host; a request with a trace ID that is already in use replaces the old trace.
+    The period is in seconds; in the on-change mode it limits the rate of events (zero means no limit).
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u8              trace_id        Arbitrary host-assigned identifier of the trace.
+        1       u8              trigger         1 - periodic, 2 - on change; zero cancels the trace.
+        2       u32             period          Microseconds.
+        6       item[<=64]      names           Each item is u8 name_length followed by the name.
+    -----------------------------------------------------------------------------------------------
+      <=1022
+    """
+    MESSAGE_ID = 5
+
+    _MIN_ENCODED_SIZE = 6      # See the layout specification
+
+    def __init__(self,
+                 trace_id: int=0,
+                 trigger: int=TraceTrigger.CANCEL,
+                 period: typing.Optional[typing.Union[Decimal, float]]=None,
+                 names: typing.Iterable[str]=None):
+        self.trace_id = int(trace_id)
+        self.trigger = int(trigger)
+        self.period = Decimal(period or 0)                  # Period is in seconds
+        self.names = list(names or [])
+
+    def _encode(self) -> bytes:
+        out = _struct_pack('BBI', self.trace_id, self.trigger, _seconds_to_microseconds(self.period)) + \
+            b''.join(map(_encode_name, self.names))
+        _enforce_batch_limits(self.names, out)
+        return out
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'TraceSetupRequestMessage':
+        if len(encoded) < TraceSetupRequestMessage._MIN_ENCODED_SIZE:
+            raise ValueError('Not enough data: %r' % encoded)
+
+        trace_id, trigger, period_us = _struct_unpack('BBI', encoded[:6])
+        msg = TraceSetupRequestMessage(trace_id=trace_id,
+                                       trigger=trigger,
+                                       period=Decimal(period_us) / MICROSECONDS_PER_SECOND)
+        encoded = encoded[6:]
+        while encoded:
+            name, encoded = _decode_name(encoded)
+            msg.names.append(name)
+        return msg
+
+
+class TraceSetupResponseMessage(MessageBase):
+    """
+    Response to TraceSetupRequestMessage. The device may adjust the requested period; the actual one is reported.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u8              trace_id        Trace ID copied from the request.
+        1       u8              status          Setup status.
+        2       u32             period          Actual period in microseconds.
+    -----------------------------------------------------------------------------------------------
+        6
+    """
+    MESSAGE_ID = 6
+
+    def __init__(self,
+                 trace_id: int=0,
+                 status: TraceSetupStatus=TraceSetupStatus.OK,
+                 period: typing.Optional[typing.Union[Decimal, float]]=None):
+        self.trace_id = int(trace_id)
+        self.status = TraceSetupStatus(int(status))
+        self.period = Decimal(period or 0)                  # Period is in seconds
+
+    def _encode(self) -> bytes:
+        return _struct_pack('BBI', self.trace_id, int(self.status), _seconds_to_microseconds(self.period))
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'TraceSetupResponseMessage':
+        trace_id, status, period_us = _struct_unpack('BBI', encoded)
+        return TraceSetupResponseMessage(trace_id=trace_id,
+                                         status=TraceSetupStatus(status),
+                                         period=Decimal(period_us) / MICROSECONDS_PER_SECOND)
+
+
+class TraceEventMessage(MessageBase):
+    """
+    Unsolicited message that reports the values of the traced registers, see TraceSetupRequestMessage.
+    The values are in the same order as the names in the setup request, so the names are not repeated;
+    they are represented as a list of tuples (type_id, value).
+    The sequence number is incremented by one with every event of the trace (it starts from zero when the trace
+    is set up and wraps around at 2**32), which allows the host to detect lost events; see TraceMonitor.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u8              trace_id        Trace ID from the setup request.
+        1       u32             sequence_number Incremented with every event of the trace.
+        5       u64             timestamp       Timestamp of the provided values.
+        13      item[<=64]      values          Each item is u16 value_length followed by the value.
+    -----------------------------------------------------------------------------------------------
+      <=1022
+    """
+    MESSAGE_ID = 7
+
+    _MIN_ENCODED_SIZE = 13     # See the layout specification
+
+    def __init__(self,
+                 trace_id: int=0,
+                 sequence_number: int=0,
+                 timestamp: typing.Optional[typing.Union[Decimal, float]]=None,
+                 values: typing.Iterable[typing.Tuple[ValueType, _VALUE_TYPE_ANNOTATION]]=None):
+        self.trace_id = int(trace_id)
+        self.sequence_number = int(sequence_number)
+        self.timestamp = Decimal(timestamp or 0)            # Timestamp is in seconds
+        self.values = list(values or [])
+
+    def _encode(self) -> bytes:
+        timestamp_ns = int(self.timestamp * NANOSECONDS_PER_SECOND)
+        out = _struct_pack('BIQ', self.trace_id, self.sequence_number, timestamp_ns) + \
+            b''.join(_encode_length_prefixed_value(type_id, value) for type_id, value in self.values)
+        _enforce_batch_limits(self.values, out)
+        return out
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'TraceEventMessage':
+        if len(encoded) < TraceEventMessage._MIN_ENCODED_SIZE:
+            raise ValueError('Not enough data: %r' % encoded)
+
+        trace_id, sequence_number, timestamp_ns = _struct_unpack('BIQ', encoded[:13])
+        msg = TraceEventMessage(trace_id=trace_id,
+                                sequence_number=sequence_number,
+                                timestamp=Decimal(timestamp_ns) / NANOSECONDS_PER_SECOND)
+        encoded = encoded[13:]
+        while encoded:
+            value, encoded = _decode_length_prefixed_value(encoded)
+            msg.values.append(value)
+        return msg
+
+
+class TraceMonitor:
+    """
+    Host-side helper that tracks the sequence numbers of the received trace events in order to detect lost events.
+    Feed it with every TraceEventMessage obtained from Channel.receive(); the names of the registers are
+    matched with the values using the setup request.
+    """
+    def __init__(self, setup: TraceSetupRequestMessage):
+        self.setup = setup
+        self.num_received = 0
+        self.num_lost = 0
+        self._next_sequence_number = None
+
+    def update(self, event: TraceEventMessage) -> typing.Optional[typing.Dict[str, typing.Tuple[ValueType,
+                                                                                              _VALUE_TYPE_ANNOTATION]]]:
+        """
+        Returns the event values keyed by register name, or None if the event does not belong to this trace.
+        """
+        if event.trace_id != self.setup.trace_id:
+            return None
+
+        if self._next_sequence_number is not None:
+            self.num_lost += (event.sequence_number - self._next_sequence_number) % (2 ** 32)
+
+        self._next_sequence_number = (event.sequence_number + 1) % (2 ** 32)
+        self.num_received += 1
+        return dict(zip(self.setup.names, event.values))
+
+
 class DiscoveryRequestMessage(MessageBase):
     """
     Request of register name by index. Used for discovery purposes only.
@@ -318,6 +614,133 @@ class DiscoveryResponseMessage(MessageBase):
         return DiscoveryResponseMessage(index=index, name=name)
 
 
+class IndexedDataRequestMessage(MessageBase):
+    """
+    Same as DataRequestMessage, but the register is referred to by its index rather than by name, which makes
+    the message much shorter. The indexes are obtained using the discovery messages; see IndexMap.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u16             register_index  Index of the register as reported by the discovery messages.
+        2       u8              type_id         Type of the value contained in this message.
+        3       u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+    -----------------------------------------------------------------------------------------------
+      <=259
+    """
+    MESSAGE_ID = 16
+
+    def __init__(self,
+                 index: int=0,
+                 type_id: ValueType=ValueType.EMPTY,
+                 value: _VALUE_TYPE_ANNOTATION=None):
+        _enforce_serializability(type_id, value)
+        self.index = int(index)
+        self.type_id = ValueType(int(type_id))
+        self.value = value
+
+    def _encode(self) -> bytes:
+        return _struct_pack('H', self.index) + _encode_value(self.type_id, self.value)
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'IndexedDataRequestMessage':
+        if len(encoded) < 3:
+            raise ValueError('Not enough data: %r' % encoded)
+
+        index, = _struct_unpack('H', encoded[:2])
+        type_id, value = _decode_value(encoded[2:])
+        return IndexedDataRequestMessage(index=index, type_id=type_id, value=value)
+
+
+class IndexedDataResponseMessage(MessageBase):
+    """
+    Same as DataResponseMessage, but the register is referred to by its index rather than by name.
+    The value is empty if the index is out of range.
+
+        Offset  Type            Name            Description
+    -----------------------------------------------------------------------------------------------
+        0       u64             timestamp       Timestamp of the provided value.
+        8       u16             register_index  Index of the register copied from the request.
+        10      u8              flags           Register flags: 1 - mutable, 2 - persistent.
+        11      u8              type_id         Type of the value contained in this message.
+        12      u8[<=256]       encoded_payload Array of values whose types are defined by type_id.
+    -----------------------------------------------------------------------------------------------
+      <=268
+    """
+    MESSAGE_ID = 17
+
+    _MIN_ENCODED_SIZE = 12     # See the layout specification
+
+    def __init__(self,
+                 timestamp: typing.Optional[typing.Union[Decimal, float]]=None,
+                 index: int=0,
+                 flags: typing.Optional[typing.Union['Flags', int]]=None,
+                 type_id: ValueType=ValueType.EMPTY,
+                 value: _VALUE_TYPE_ANNOTATION=None):
+        _enforce_serializability(type_id, value)
+        self.timestamp = Decimal(timestamp or 0)            # Timestamp is in seconds
+        self.index = int(index)
+        self.flags = Flags(flags or 0)
+        self.type_id = ValueType(int(type_id))
+        self.value = value
+
+    def _encode(self) -> bytes:
+        timestamp_ns = int(self.timestamp * NANOSECONDS_PER_SECOND)
+        return _struct_pack('QHB', timestamp_ns, self.index, int(self.flags)) + \
+            _encode_value(self.type_id, self.value)
+
+    @staticmethod
+    def _decode(encoded: bytes) -> 'IndexedDataResponseMessage':
+        if len(encoded) < IndexedDataResponseMessage._MIN_ENCODED_SIZE:
+            raise ValueError('Not enough data: %r' % encoded)
+
+        timestamp_ns, index, flags = _struct_unpack('QHB', encoded[:11])
+        type_id, value = _decode_value(encoded[11:])
+        return IndexedDataResponseMessage(timestamp=Decimal(timestamp_ns) / NANOSECONDS_PER_SECOND,
+                                          index=index,
+                                          flags=flags,
+                                          type_id=type_id,
+                                          value=value)
+
+
+def compute_schema_hash(names: typing.Iterable[str]) -> int:
+    """
+    Computes the register schema hash that is reported in the endpoint info message; see IndexMap.
+    The names must be in the order of their indexes.
+    The hash is 32-bit FNV-1a over every name followed by a zero byte, XOR-folded to 16 bits.
+    """
+    state = 0x811C9DC5
+    for n in names:
+        for x in n.encode() + b'\0':
+            state = ((state ^ x) * 0x01000193) & 0xFFFFFFFF
+    return (state >> 16) ^ (state & 0xFFFF)
+
+
+class IndexMap:
+    """
+    Host-side cache of the register name to index mapping obtained via discovery, for use with the indexed messages.
+    The cache is valid only as long as the register schema hash reported by the endpoint matches; see is_valid_for().
+    """
+    def __init__(self, names: typing.Iterable[str]):
+        """
+        :param names: Register names in the order of their indexes, as obtained via DiscoveryRequestMessage.
+        """
+        self.names = list(names)
+        self.schema_hash = compute_schema_hash(self.names)
+        self._indexes = {n: i for i, n in enumerate(self.names)}
+
+    def is_valid_for(self, endpoint_info) -> bool:
+        """
+        Checks the cache against the endpoint info message; endpoints that do not report the hash are never matched.
+        """
+        return endpoint_info.register_schema_hash == self.schema_hash
+
+    def index_of(self, name: str) -> typing.Optional[int]:
+        return self._indexes.get(name)
+
+    def name_of(self, index: int) -> typing.Optional[str]:
+        return self.names[index] if 0 <= index < len(self.names) else None
+
+
 class Flags(StringRepresentable):
     """
     Register flags. The flags describe basic properties of a register.
@@ -335,6 +758,21 @@ class Flags(StringRepresentable):
                (2 if self.persistent else 0)
 
 
+def _seconds_to_microseconds(seconds: Decimal) -> int:
+    out = int(seconds * MICROSECONDS_PER_SECOND)
+    if not (0 <= out < 2 ** 32):
+        raise ValueError('The period is out of range: %r' % seconds)
+    return out
+
+
+def _enforce_batch_limits(items: list, encoded: bytes) -> None:
+    if len(items) > MAX_BATCH_ITEMS:
+        raise ValueError('Too many items in the batch: %r' % len(items))
+
+    if len(encoded) > MAX_ENCODED_BATCH_LENGTH:
+        raise ValueError('The batch is too long to be encoded: %r bytes' % len(encoded))
+
+
 def _enforce_serializability(type_id: ValueType, value: _VALUE_TYPE_ANNOTATION) -> None:
     try:
         _encode_value(type_id, value)
@@ -527,3 +965,31 @@ assert _decode_value(bytes([3, 0, 1, 2, 3]))              == (ValueType.BOOLEAN,
 assert _decode_value(bytes([4]))                          == (ValueType.I64,          [])
 assert _decode_value(bytes([10, 0x12, 0x34]))             == (ValueType.U16,          [0x3412])
 assert _decode_value(bytes([10, 0x12, 0x34, 0x56, 0x78])) == (ValueType.U16,          [0x3412, 0x7856])
+
+
+def _encode_length_prefixed_value(type_id: ValueType, value: _VALUE_TYPE_ANNOTATION) -> bytes:
+    """
+    The value decoder is greedy, so the values in batched messages are prefixed with their length (u16).
+    """
+    encoded = _encode_value(type_id, value)
+    return _struct_pack('H', len(encoded)) + encoded
+
+
+def _decode_length_prefixed_value(encoded: bytes) -> typing.Tuple[typing.Tuple[ValueType, _VALUE_TYPE_ANNOTATION],
+                                                                    bytes]:
+    if len(encoded) < 2:
+        raise ValueError('Data is not long enough: %r' % encoded)
+
+    length, = _struct_unpack('H', encoded[:2])
+    encoded = encoded[2:]
+    if length > len(encoded):
+        raise ValueError('Data is not long enough: expected %r bytes, found %r' % (length, len(encoded)))
+
+    value = _decode_value(encoded[:length]) if length > 0 else (ValueType.EMPTY, None)
+    return value, encoded[length:]
+
+
+assert _encode_length_prefixed_value(ValueType.EMPTY, None)   == bytes([1, 0, 0])
+assert _encode_length_prefixed_value(ValueType.U16, 0x1234)   == bytes([3, 0, 10, 0x34, 0x12])
+assert _decode_length_prefixed_value(bytes([0, 0, 1]))        == ((ValueType.EMPTY, None), bytes([1]))
+assert _decode_length_prefixed_value(bytes([3, 0, 10, 0x34, 0x12, 9])) == ((ValueType.U16, [0x1234]), bytes([9]))
@@ -26,6 +26,11 @@
 import typing
 import time
 
+try:
+    from . import _native
+except ImportError:
+    _native = None
+
 
 __all__ = ['FRAME_DELIMITER', 'ESCAPE_CHARACTER', 'Parser', 'encode', 'ReceivedFrame']
 
@@ -82,8 +87,11 @@ class CRCComputer:
             else:
                 raise ValueError('Invalid value for byte: %r' % b)
         elif isinstance(b, (bytes, bytearray)):
-            for x in b:
-                self.add(x)
+            if _native is not None:
+                self._value = _native.crc32c_update(self._value, b)
+            else:
+                for x in b:
+                    self.add(x)
         else:
             raise TypeError('Cannot compute CRC of %r' % type(b))
 
@@ -158,6 +166,9 @@ class Parser:
         if self._max_payload_size < 1024:
             raise ValueError('Max payload size is too small: %r' % self._max_payload_size)
 
+        # The native core, if available, replaces the byte-level state machine; the behavior is identical.
+        self._core = _native.ParserCore() if _native is not None else None
+
     def _check_if_received_frame_valid(self):
         long_enough = len(self._buffer) >= self.PAYLOAD_OVERHEAD_NOT_INCLUDING_DELIMITERS
         # Note that we compute CRC in one go over the entire dataset.
@@ -225,6 +236,10 @@ class Parser:
 
         timestamp = timestamp if timestamp is not None else time.monotonic()
 
+        if self._core is not None:
+            self._parse_natively(chunk, timestamp)
+            return
+
         for b in chunk:
             self._parse_byte(b, timestamp)
 
@@ -237,6 +252,19 @@ class Parser:
         if should_abort:
             self._finalize(known_invalid=True)
 
+    def _parse_natively(self, chunk: typing.Union[bytes, bytearray], timestamp):
+        for event in self._core.feed(chunk, timestamp):
+            self._callback(ReceivedFrame(*event) if isinstance(event, tuple) else event)
+
+        core = self._core
+        should_abort = ((not core.inside_frame) or
+                        (core.buffer_size > self._max_payload_size) or
+                        (float(timestamp - core.frame_timestamp) > self._frame_timeout))
+        if should_abort:
+            extraneous = core.abort()
+            if extraneous is not None:
+                self._callback(extraneous)
+
     @property
     def callback(self) -> typing.Callable:
         """
@@ -269,6 +297,9 @@ def encode(frame_type_code: int, payload: typing.Union[bytes, bytearray]) -> byt
     if not isinstance(payload, (bytes, bytearray)):
         raise TypeError('Expected bytes or bytearray, got %r' % type(payload))
 
+    if _native is not None:
+        return _native.encode(frame_type_code, payload)
+
     crc = CRCComputer().add(payload).add(frame_type_code).value
 
     output = bytearray()
@@ -150,6 +150,137 @@ class TestParserEncoder(unittest.TestCase):
         self.assertEqual(encode(0x9E, bytes([0x8E])),
                          bytes([0x8E, 0x9E, 0x8E ^ 0xFF, 0x9E, 0x9E ^ 0xFF, 0x91, 0x5C, 0xA9, 0xC0, 0x8E]))
 
+    @unittest.skipIf(popcop.transport._native is None, 'The native accelerator is not available')
+    def test_native(self):
+        import random
+        from unittest.mock import patch
+        from popcop.transport import Parser, CRCComputer, encode
+
+        def pure_python():
+            return patch.object(popcop.transport, '_native', None)
+
+        def run(chunks, use_native):
+            output = []
+
+            def callback(o):
+                if isinstance(o, popcop.transport.ReceivedFrame):
+                    o = o.frame_type_code, o.payload, o.timestamp
+                output.append(o)
+
+            with contextlib.ExitStack() as stack:
+                if not use_native:
+                    stack.enter_context(pure_python())
+                p = Parser(callback=callback, max_payload_size=1024, frame_timeout=10)
+                self.assertEqual(use_native, p._core is not None)
+                for ts, c in chunks:
+                    p.parse(c, ts)
+
+            return output
+
+        rng = random.Random(42)
+        for _ in range(200):
+            payload = bytes(rng.choice([0x8E, 0x9E, 0x00, rng.randrange(256)]) for _ in range(rng.randrange(100)))
+            frame_type_code = rng.randrange(256)
+            encoded = encode(frame_type_code, payload)
+            crc = CRCComputer().add(payload).value
+            with pure_python():
+                self.assertEqual(encoded, encode(frame_type_code, payload))
+                self.assertEqual(crc, CRCComputer().add(payload).value)
+
+        # Valid frames, garbage, timeouts, and overflows, split into random chunks
+        stream = bytearray()
+        for _ in range(300):
+            kind = rng.randrange(4)
+            if kind == 0:
+                stream += bytes(rng.randrange(256) for _ in range(rng.randrange(20)))
+            elif kind == 1:
+                stream += bytes([0x8E]) * rng.randrange(3) + bytes([0x9E]) * rng.randrange(3)
+            else:
+                stream += encode(rng.randrange(256),
+                                 bytes(rng.choice([0x8E, 0x9E, rng.randrange(256)]) for _ in range(rng.randrange(50))))
+        stream += bytes([0x8E]) + bytes(2000) + encode(1, b'after overflow')
+
+        chunks = []
+        ts = 0
+        while stream:
+            n = rng.randrange(1, 64)
+            chunks.append((ts, bytes(stream[:n])))
+            del stream[:n]
+            ts += rng.choice([0, 1, 11])
+
+        native_output = run(chunks, True)
+        self.assertEqual(native_output, run(chunks, False))
+        self.assertGreater(len([x for x in native_output if isinstance(x, tuple)]), 100)
+        self.assertGreater(len([x for x in native_output if isinstance(x, bytes)]), 10)
+        self.assertEqual((1, b'after overflow'), native_output[-1][:2])
+
+
+class TestCompression(unittest.TestCase):
+    def test_codec(self):
+        import random
+        from popcop.compression import compress, decompress
+
+        # Same as in the C++ test
+        self.assertEqual(compress(b'aaaaaaaa'), bytes([0x00, ord('a'), 0x83, 1, 0]))
+        self.assertEqual(compress(b''), b'')
+        self.assertLess(len(compress(bytes(1000))), 30)
+
+        for _ in range(100):
+            data = bytearray()
+            for _ in range(random.randint(0, 30)):
+                mode = random.randint(0, 2)
+                n = random.randint(1, 64)
+                if mode == 0:
+                    data += bytes(random.getrandbits(8) for _ in range(n))
+                elif mode == 1 or len(data) < 300:
+                    data += bytes([len(data) % 256]) * n
+                else:
+                    for _ in range(n):
+                        data.append(data[-300])
+            self.assertEqual(decompress(compress(data)), data)
+
+        self.assertEqual(decompress(bytes([1, 1, 2])), bytes([1, 2]))
+        for malformed in ([2, 1, 2], [0, 1, 0x80, 1], [0, 1, 0x80, 0, 0], [0, 1, 0x80, 2, 0]):
+            with self.assertRaises(ValueError):
+                decompress(bytes(malformed))
+
+        with self.assertRaises(ValueError):
+            decompress(compress(bytes(100)), max_size=99)
+
+    def test_frames(self):
+        import os
+        from popcop import STANDARD_FRAME_TYPE_CODE, COMPRESSED_FRAME_TYPE_CODE
+        from popcop.transport import Parser, encode
+        from popcop.compression import compress_frame, decompress_frame
+        from popcop.standard import decode
+        from popcop.standard.endpoint_info import EndpointInfoMessage
+
+        msg = EndpointInfoMessage()
+        msg.endpoint_name = 'com.zubax.telega'
+        payload = bytes(popcop.standard.encode(msg)[1:-6])
+        type_code, compressed = compress_frame(STANDARD_FRAME_TYPE_CODE, payload)
+        self.assertEqual(type_code, COMPRESSED_FRAME_TYPE_CODE)
+        self.assertEqual(compressed[0], STANDARD_FRAME_TYPE_CODE)
+        self.assertLess(len(compressed), len(payload) // 4)
+
+        frames = []
+        parser = Parser(callback=frames.append, max_payload_size=1024)
+        parser.parse(encode(type_code, compressed), 123)
+        self.assertEqual(len(frames), 1)
+        frame = decompress_frame(frames[0])
+        self.assertEqual(frame.frame_type_code, STANDARD_FRAME_TYPE_CODE)
+        self.assertEqual(frame.payload, payload)
+        self.assertEqual(frame.timestamp, 123)
+        self.assertEqual(decode(frame).endpoint_name, 'com.zubax.telega')
+
+        # Incompressible and uncompressed frames are passed through
+        random_payload = os.urandom(100)
+        self.assertEqual(compress_frame(123, random_payload), (123, random_payload))
+        self.assertIs(decompress_frame(frame), frame)
+
+        with self.assertRaises(ValueError):
+            compress_frame(COMPRESSED_FRAME_TYPE_CODE, payload)
+
 
 class TestStandardMessages(unittest.TestCase):
     def test_endpoint_info(self):
@@ -247,6 +378,14 @@ class TestStandardMessages(unittest.TestCase):
                          popcop.transport.encode(popcop.STANDARD_FRAME_TYPE_CODE,
                                                  carefully_crafted_message))
 
+        # Register schema hash
+        self.assertIsNone(m.register_schema_hash)
+        m.register_schema_hash = 0x1234
+        encoded = m._encode()
+        self.assertEqual(encoded[20:24], bytes([0x0F, 0x00, 0x34, 0x12]))
+        self.assertEqual(popcop.standard.endpoint_info.EndpointInfoMessage._decode(encoded).register_schema_hash,
+                         0x1234)
+
     def test_register_data_request(self):
         from popcop.transport import ReceivedFrame
         from popcop.standard.register import DataRequestMessage, ValueType
@@ -338,6 +477,188 @@ class TestStandardMessages(unittest.TestCase):
         self.assertEqual(msg.value, [100])
         print(msg)
 
+    def test_register_batch_data_request(self):
+        from popcop.transport import ReceivedFrame
+        from popcop.standard.register import BatchDataRequestMessage, DataRequestMessage, ValueType
+        from popcop import STANDARD_FRAME_TYPE_CODE
+
+        self.assertEqual(BatchDataRequestMessage()._encode(), b'')
+
+        encoded = bytes([2, 97, 98, 1, 0, 0,
+                         1, 99, 5, 0, 10, 0x34, 0x12, 0x78, 0x56])
+        msg = BatchDataRequestMessage([DataRequestMessage(name='ab'),
+                                       DataRequestMessage(name='c', type_id=ValueType.U16, value=[0x1234, 0x5678])])
+        self.assertEqual(msg._encode(), encoded)
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, bytes([14, 0]) + encoded, 0))
+        self.assertIsInstance(msg, BatchDataRequestMessage)
+        self.assertEqual(len(msg.items), 2)
+        self.assertEqual(msg.items[0].name, 'ab')
+        self.assertEqual(msg.items[0].type_id, ValueType.EMPTY)
+        self.assertIsNone(msg.items[0].value)
+        self.assertEqual(msg.items[1].name, 'c')
+        self.assertEqual(msg.items[1].type_id, ValueType.U16)
+        self.assertEqual(msg.items[1].value, [0x1234, 0x5678])
+        print(msg)
+
+        with self.assertRaises(ValueError):
+            BatchDataRequestMessage._decode(bytes([1, 99, 5, 0, 10, 0x34]))     # Truncated value
+
+        with self.assertRaises(ValueError):
+            BatchDataRequestMessage([DataRequestMessage(name='a')] * 65)._encode()
+
+    def test_register_batch_data_response(self):
+        from popcop.transport import ReceivedFrame
+        from popcop.standard.register import BatchDataResponseMessage, DataResponseMessage, ValueType
+        from popcop import STANDARD_FRAME_TYPE_CODE
+
+        self.assertEqual(BatchDataResponseMessage()._encode(), bytes(8))
+
+        encoded = (b'\xc0\x68\x8a\x7e\x00\x00\x00\x00'        # Timestamp 2.123 seconds
+                   b'\x01\x01a\x02\x00\x07\xff'
+                   b'\x03\x02bc\x02\x00\x01x')
+        msg = BatchDataResponseMessage(timestamp=Decimal('2.123'),
+                                       items=[DataResponseMessage(flags=1, name='a', type_id=ValueType.I8, value=-1),
+                                              DataResponseMessage(flags=3, name='bc',
+                                                                  type_id=ValueType.STRING, value='x')])
+        self.assertEqual(msg._encode(), encoded)
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, bytes([15, 0]) + encoded, 0))
+        self.assertIsInstance(msg, BatchDataResponseMessage)
+        self.assertEqual(msg.timestamp, Decimal('2.123'))
+        self.assertEqual(len(msg.items), 2)
+        self.assertEqual(msg.items[0].timestamp, Decimal('2.123'))
+        self.assertEqual(msg.items[0].flags.mutable, True)
+        self.assertEqual(msg.items[0].flags.persistent, False)
+        self.assertEqual(msg.items[0].name, 'a')
+        self.assertEqual(msg.items[0].type_id, ValueType.I8)
+        self.assertEqual(msg.items[0].value, [-1])
+        self.assertEqual(msg.items[1].flags.persistent, True)
+        self.assertEqual(msg.items[1].name, 'bc')
+        self.assertEqual(msg.items[1].type_id, ValueType.STRING)
+        self.assertEqual(msg.items[1].value, 'x')
+        print(msg)
+
+        with self.assertRaises(ValueError):
+            BatchDataResponseMessage._decode(bytes(7))
+
+    def test_register_indexed_data(self):
+        from popcop.transport import ReceivedFrame
+        from popcop.standard.register import IndexedDataRequestMessage, IndexedDataResponseMessage, \
+            IndexMap, compute_schema_hash, ValueType
+        from popcop.standard.endpoint_info import EndpointInfoMessage
+        from popcop import STANDARD_FRAME_TYPE_CODE
+
+        self.assertEqual(IndexedDataRequestMessage()._encode(), bytes([0, 0, 0]))
+        self.assertEqual(IndexedDataRequestMessage(index=0x1234, type_id=ValueType.F32, value=1.0)._encode(),
+                         bytes([0x34, 0x12, 13, 0x00, 0x00, 0x80, 0x3F]))
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE,
+                                                   bytes([16, 0, 0x34, 0x12, 13, 0x00, 0x00, 0x80, 0x3F]),
+                                                   0))
+        self.assertIsInstance(msg, IndexedDataRequestMessage)
+        self.assertEqual(msg.index, 0x1234)
+        self.assertEqual(msg.type_id, ValueType.F32)
+        self.assertEqual(msg.value, [1.0])
+
+        encoded = bytes([0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+                         0x34, 0x12, 1,
+                         11, 1, 2])
+        self.assertEqual(IndexedDataResponseMessage(timestamp=Decimal(0x0102030405060708) / 1000000000,
+                                                    index=0x1234, flags=1,
+                                                    type_id=ValueType.U8, value=[1, 2])._encode(),
+                         encoded)
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, bytes([17, 0]) + encoded, 0))
+        self.assertIsInstance(msg, IndexedDataResponseMessage)
+        self.assertEqual(msg.index, 0x1234)
+        self.assertTrue(msg.flags.mutable)
+        self.assertFalse(msg.flags.persistent)
+        self.assertEqual(msg.type_id, ValueType.U8)
+        self.assertEqual(msg.value, [1, 2])
+        print(msg)
+
+        with self.assertRaises(ValueError):
+            IndexedDataResponseMessage._decode(encoded[:11])
+
+        # The reference values are shared with the C++ implementation
+        self.assertEqual(compute_schema_hash([]), 0x1CD9)
+        self.assertEqual(compute_schema_hash(['uavcan.node_id', 'motor.kv', 'motor.kv=', 'name']), 0xA510)
+        self.assertEqual(compute_schema_hash(['a', 'b']), 0xFA01)
+        self.assertEqual(compute_schema_hash(['ab']), 0x27B6)
+
+        index_map = IndexMap(['a', 'b'])
+        self.assertEqual(index_map.index_of('b'), 1)
+        self.assertIsNone(index_map.index_of('c'))
+        self.assertEqual(index_map.name_of(0), 'a')
+        self.assertIsNone(index_map.name_of(2))
+
+        info = EndpointInfoMessage()
+        self.assertFalse(index_map.is_valid_for(info))
+        info.register_schema_hash = 0xFA01
+        self.assertTrue(index_map.is_valid_for(info))
+        info.register_schema_hash = 0xFA02
+        self.assertFalse(index_map.is_valid_for(info))
+
+    def test_register_trace(self):
+        from popcop.transport import ReceivedFrame
+        from popcop.standard.register import TraceSetupRequestMessage, TraceSetupResponseMessage, \
+            TraceEventMessage, TraceMonitor, TraceTrigger, TraceSetupStatus, ValueType
+        from popcop import STANDARD_FRAME_TYPE_CODE
+
+        setup = TraceSetupRequestMessage(trace_id=7, trigger=TraceTrigger.PERIODIC, period=Decimal('0.1'),
+                                         names=['ab', 'c'])
+        self.assertEqual(setup._encode(), bytes([7, 1, 0xA0, 0x86, 0x01, 0x00, 2, 97, 98, 1, 99]))
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, bytes([5, 0]) + setup._encode(), 0))
+        self.assertIsInstance(msg, TraceSetupRequestMessage)
+        self.assertEqual(msg.trace_id, 7)
+        self.assertEqual(msg.trigger, TraceTrigger.PERIODIC)
+        self.assertEqual(msg.period, Decimal('0.1'))
+        self.assertEqual(msg.names, ['ab', 'c'])
+        print(msg)
+
+        with self.assertRaises(ValueError):
+            TraceSetupRequestMessage(period=-1)._encode()
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE,
+                                                   bytes([6, 0, 7, 2, 0x78, 0x56, 0x34, 0x12]),
+                                                   0))
+        self.assertIsInstance(msg, TraceSetupResponseMessage)
+        self.assertEqual(msg.trace_id, 7)
+        self.assertEqual(msg.status, TraceSetupStatus.TOO_MANY_REGISTERS)
+        self.assertEqual(msg.period, Decimal(0x12345678) / 1000000)
+        self.assertEqual(msg._encode(), bytes([7, 2, 0x78, 0x56, 0x34, 0x12]))
+
+        encoded = bytes([3, 0x04, 0x03, 0x02, 0x01,
+                         0xc0, 0x68, 0x8a, 0x7e, 0x00, 0x00, 0x00, 0x00,    # Timestamp 2.123 seconds
+                         1, 0, 0,
+                         2, 0, 7, 0xFF])
+        event = TraceEventMessage(trace_id=3, sequence_number=0x01020304, timestamp=Decimal('2.123'),
+                                  values=[(ValueType.EMPTY, None), (ValueType.I8, -1)])
+        self.assertEqual(event._encode(), encoded)
+
+        msg = popcop.standard.decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, bytes([7, 0]) + encoded, 0))
+        self.assertIsInstance(msg, TraceEventMessage)
+        self.assertEqual(msg.trace_id, 3)
+        self.assertEqual(msg.sequence_number, 0x01020304)
+        self.assertEqual(msg.timestamp, Decimal('2.123'))
+        self.assertEqual(msg.values, [(ValueType.EMPTY, None), (ValueType.I8, [-1])])
+        print(msg)
+
+        with self.assertRaises(ValueError):
+            TraceEventMessage._decode(encoded[:12])
+
+        # Loss detection, including the wrap-around of the sequence number
+        monitor = TraceMonitor(TraceSetupRequestMessage(trace_id=3, names=['a', 'b']))
+        self.assertEqual(monitor.update(msg), {'a': (ValueType.EMPTY, None), 'b': (ValueType.I8, [-1])})
+        for seq in [0x01020305, 0x01020308, 0xFFFFFFFF, 0]:
+            msg.sequence_number = seq
+            self.assertIsNotNone(monitor.update(msg))
+        self.assertIsNone(monitor.update(TraceEventMessage(trace_id=4)))
+        self.assertEqual(monitor.num_received, 5)
+        self.assertEqual(monitor.num_lost, 2 + (0xFFFFFFFF - 0x01020309))
+
     def test_register_discovery_request(self):
         from popcop.transport import ReceivedFrame
         from popcop.standard import encode, decode
@@ -450,6 +771,149 @@ class TestStandardMessages(unittest.TestCase):
         self.assertEqual(msg.flags, 0xBADC0FFEE)
         self.assertEqual(msg.state, State.BOOT_CANCELLED)
 
+        self.assertEqual(msg.image_data_window, 0xEE)
+        msg.image_data_window = 16
+        self.assertEqual(msg.flags, 0xBADC0FF10)
+        self.assertEqual(msg.max_image_data_size, 0xFF * 256)
+        msg.max_image_data_size = 1792
+        self.assertEqual(msg.flags, 0xBADC00710)
+        msg.flags = 0
+        self.assertEqual(msg.max_image_data_size, 256)
+        with self.assertRaises(ValueError):
+            msg.max_image_data_size = 1000
+
+        self.assertFalse(msg.delta_upload_supported)
+        msg.delta_upload_supported = True
+        self.assertEqual(msg.flags, 0x10000)
+        self.assertTrue(msg.delta_upload_supported)
+        msg.delta_upload_supported = False
+        self.assertEqual(msg.flags, 0)
+
+    def test_bootloader_image_upload_window(self):
+        import random
+        from popcop.standard.bootloader import ImageUploadWindow
+
+        # Stop-and-wait
+        win = ImageUploadWindow(600, 0, 0.1)
+        self.assertEqual(win.window_size, 1)
+        self.assertEqual(win.poll(0), 0)
+        self.assertIsNone(win.poll(0))
+        self.assertFalse(win.acknowledge(256, True))
+        self.assertTrue(win.acknowledge(0, True))
+        self.assertFalse(win.acknowledge(0, True))
+        self.assertEqual(win.poll(0.001), 256)
+        self.assertTrue(win.acknowledge(256, False))
+        self.assertEqual(win.poll(0.002), 256)
+        self.assertIsNone(win.poll(0.05))
+        self.assertEqual(win.poll(0.2), 256)
+        self.assertTrue(win.acknowledge(256, True))
+        self.assertEqual(win.poll(0.21), 512)
+        self.assertEqual(win.get_chunk_size(512), 88)
+        self.assertTrue(win.acknowledge(512, True))
+        self.assertTrue(win.is_complete)
+        self.assertEqual(win.retransmission_count, 2)
+
+        # Large chunks; the chunk size does not exceed the image size
+        self.assertEqual(ImageUploadWindow(100, 4, 1, max_chunk_size=1024).chunk_size, 256)
+        self.assertEqual(ImageUploadWindow(700, 4, 1, max_chunk_size=1024).chunk_size, 512)
+        win = ImageUploadWindow(2500, 4, 1, max_chunk_size=1024)
+        self.assertEqual(win.chunk_size, 1024)
+        self.assertEqual([win.poll(0), win.poll(0), win.poll(0)], [0, 1024, None])
+        self.assertTrue(win.acknowledge(1024, True))
+        self.assertTrue(win.acknowledge(0, True))
+        self.assertEqual(win.poll(0), 2048)
+        self.assertEqual(win.get_chunk_size(2048), 452)
+        self.assertTrue(win.acknowledge(2048, True))
+        self.assertTrue(win.is_complete)
+
+        # Delta; the first and the last chunks are always sent, skipping is limited by the window
+        win = ImageUploadWindow(10 * 256 + 1, 2, 1)
+        queried = []
+
+        def skip(offset):
+            queried.append(offset)
+            return offset != 5 * 256
+
+        self.assertEqual(win.poll(0, skip), 0)
+        self.assertIsNone(win.poll(0, skip))
+        self.assertEqual(queried, [256])
+        self.assertTrue(win.acknowledge(0, True))
+        self.assertEqual(win.number_of_acknowledged_bytes, 512)
+        self.assertEqual(win.poll(0, skip), 5 * 256)
+        self.assertEqual(queried, [256, 512, 768, 1024, 1280])
+        self.assertIsNone(win.poll(0, skip))
+        self.assertTrue(win.acknowledge(5 * 256, True))
+        self.assertEqual(win.poll(0, skip), 10 * 256)
+        self.assertEqual(queried[-1], 9 * 256)
+        self.assertTrue(win.acknowledge(10 * 256, True))
+        self.assertTrue(win.is_complete)
+        self.assertEqual(win.skipped_count, 8)
+
+        # Lossy link with reordering; the last chunk is empty because the image size is aligned
+        image_size = 64 * 256
+        win = ImageUploadWindow(image_size, 8, 0.01)
+        sent = set()
+        now = 0.0
+        while not win.is_complete:
+            responses = []
+            for offset in iter(lambda: win.poll(now), None):
+                self.assertLessEqual(len(win._in_flight), 8)
+                sent.add(offset)
+                if random.random() > 0.1:
+                    responses.append(offset)
+            random.shuffle(responses)
+            for offset in responses:
+                win.acknowledge(offset, random.random() > 0.05)
+            now += 0.003
+        self.assertEqual(win.number_of_acknowledged_bytes, image_size)
+        self.assertEqual(sent, set(range(0, image_size + 1, 256)))
+
+    def test_bootloader_image_digest(self):
+        from popcop.transport import ReceivedFrame
+        from popcop.standard import encode, decode
+        from popcop.standard.bootloader import ImageType, ImageDigestRequestMessage, ImageDigestResponseMessage, \
+            compute_image_block_digest
+        from popcop import STANDARD_FRAME_TYPE_CODE
+
+        self.assertEqual(compute_image_block_digest(b'123456789'), 0xE3069283)
+
+        # Encoding a full frame then stripping the delimiters, type code, and CRC.
+        self.assertEqual(encode(ImageDigestRequestMessage(0x12345, ImageType.CERTIFICATE_OF_AUTHENTICITY,
+                                                          1024, 64))[1:-6],
+                         bytes([18, 0,
+                                0x45, 0x23, 0x01, 0, 0, 0, 0, 0,
+                                1,
+                                0, 4, 0, 0,
+                                64]))
+
+        msg = decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE,
+                                   bytes([18, 0, 0x45, 0x23, 0x01, 0, 0, 0, 0, 0, 1, 0, 4, 0, 0, 64]), 0))
+        self.assertIsInstance(msg, ImageDigestRequestMessage)
+        self.assertEqual(msg.image_offset, 0x12345)
+        self.assertEqual(msg.image_type, ImageType.CERTIFICATE_OF_AUTHENTICITY)
+        self.assertEqual(msg.block_size, 1024)
+        self.assertEqual(msg.block_count, 64)
+
+        encoded = bytes([19, 0,
+                         0, 2, 0, 0, 0, 0, 0, 0,
+                         0,
+                         0, 1, 0, 0,
+                         0xEF, 0xBE, 0xAD, 0xDE,
+                         4, 3, 2, 1])
+        self.assertEqual(encode(ImageDigestResponseMessage(512, ImageType.APPLICATION, 256,
+                                                           [0xDEADBEEF, 0x01020304]))[1:-6], encoded)
+
+        msg = decode(ReceivedFrame(STANDARD_FRAME_TYPE_CODE, encoded, 0))
+        self.assertIsInstance(msg, ImageDigestResponseMessage)
+        self.assertEqual(msg.image_offset, 512)
+        self.assertEqual(msg.block_size, 256)
+        self.assertEqual(msg.digests, [0xDEADBEEF, 0x01020304])
+        self.assertEqual(msg.get_digest_at(512), 0xDEADBEEF)
+        self.assertEqual(msg.get_digest_at(768), 0x01020304)
+        self.assertIsNone(msg.get_digest_at(256))
+        self.assertIsNone(msg.get_digest_at(600))
+        self.assertIsNone(msg.get_digest_at(1024))
+
     def test_bootloader_image_data_request(self):
         from popcop.transport import ReceivedFrame
         from popcop.standard import encode, decode
@@ -497,6 +961,47 @@ class TestStandardMessages(unittest.TestCase):
         self.assertEqual(msg.image_data, b'Hello world!')
 
 
+class TestSharedRing(unittest.TestCase):
+    def test(self):
+        import multiprocessing
+        from popcop.physical.serial_multiprocessing import _SharedRing, IPCRecordKind
+
+        ring = _SharedRing(multiprocessing.get_context('spawn'), 100)
+        header_size = _SharedRing.HEADER.size
+        self.assertEqual(ring.max_payload_size, 100 - header_size)
+        self.assertIsNone(ring.try_pop())
+        self.assertIsNone(ring.pop(timeout=0.1))
+
+        with self.assertRaises(ValueError):
+            ring.try_push(IPCRecordKind.DATA, bytes(ring.max_payload_size + 1))
+
+        # Wrapping around the end many times
+        for i in range(50):
+            payload = bytes(range(i, i + 30))
+            self.assertTrue(ring.try_push(IPCRecordKind.FRAME, payload, i, i * 0.5))
+            self.assertTrue(ring.try_push(IPCRecordKind.EXTRANEOUS_DATA, payload[:i % 7]))
+            self.assertFalse(ring.try_push(IPCRecordKind.DATA, bytes(40)))       # No space left
+            self.assertFalse(ring.push(IPCRecordKind.DATA, bytes(40), timeout=0.01))
+            self.assertEqual(ring.try_pop(), (IPCRecordKind.FRAME, i, i * 0.5, payload))
+            self.assertEqual(ring.pop(timeout=1), (IPCRecordKind.EXTRANEOUS_DATA, 0, 0.0, payload[:i % 7]))
+            self.assertIsNone(ring.try_pop())
+
+        # Blocking producer and consumer
+        num_records = 2000
+
+        def producer():
+            for k in range(num_records):
+                self.assertTrue(ring.push(IPCRecordKind.DATA, k.to_bytes(2, 'little') * (k % 20), timeout=10))
+
+        thd = threading.Thread(target=producer, daemon=True)
+        thd.start()
+        for k in range(num_records):
+            self.assertEqual(ring.pop(timeout=10), (IPCRecordKind.DATA, 0, 0.0, k.to_bytes(2, 'little') * (k % 20)))
+
+        thd.join()
+        self.assertIsNone(ring.pop(timeout=0.1))
+
+
 @unittest.skipUnless(serial, 'PySerial is not available. Please install it to test this feature.')
 class TestSerialMultiprocessing(unittest.TestCase):
     """
@@ -690,6 +1195,65 @@ class TestSerialMultiprocessing(unittest.TestCase):
         asyncio.get_event_loop().run_until_complete(run())
 
 
+@unittest.skipIf(popcop.physical.serial_multiprocessing.Channel.native_max_payload_size() is None,
+                 'The native backend is not available')
+class TestSerialNative(unittest.TestCase):
+    """
+    A pseudo terminal stands in for the device; the master side is the device end.
+    """
+
+    def test(self):
+        from popcop.physical.serial_multiprocessing import Channel, ChannelInitializationException
+
+        with self.assertRaises(ChannelInitializationException):
+            Channel('/dev/nonexistent-serial-port', max_payload_size=1024, backend='native')
+
+        with self.assertRaises(ValueError):
+            Channel('/dev/null', max_payload_size=1024, frame_timeout=1.0, backend='native')
+
+        with self.assertRaises(ValueError):
+            Channel('/dev/null', max_payload_size=Channel.native_max_payload_size() + 1, backend='native')
+
+        master, slave = os.openpty()
+        try:
+            # The maximum payload size defaults to that of the native backend
+            with contextlib.closing(Channel(os.ttyname(slave), backend='native')) as channel:
+                self.assertTrue(channel.is_open)
+                self.assertIsNone(channel.receive())
+
+                # Device to host
+                os.write(master, b'Garbage' + popcop.transport.encode(123, b'Hello world!'))
+                r = channel.receive(timeout=1)
+                self.assertEqual(r, b'Garbage')
+                r = channel.receive(timeout=1)
+                self.assertIsInstance(r, popcop.transport.ReceivedFrame)
+                self.assertEqual(r.frame_type_code, 123)
+                self.assertEqual(r.payload, b'Hello world!')
+                self.assertLess(r.timestamp, time.monotonic())
+                self.assertGreater(r.timestamp + 10, time.monotonic())
+
+                # Host to device and back; standard messages are decoded
+                msg = popcop.standard.endpoint_info.EndpointInfoMessage()
+                msg.endpoint_name = 'BOB'
+                channel.send_standard(msg)
+                wire = popcop.standard.encode(msg)
+                received = b''
+                deadline = time.monotonic() + 5
+                while (received != wire) and (time.monotonic() < deadline):
+                    received += os.read(master, 4096)
+
+                self.assertEqual(received, wire)
+                os.write(master, received)
+                r = channel.receive(timeout=1)
+                self.assertIsInstance(r, popcop.standard.endpoint_info.EndpointInfoMessage)
+                self.assertEqual(str(r), str(msg))
+
+            self.assertFalse(channel.is_open)
+        finally:
+            os.close(master)
+            os.close(slave)
+
+
 if __name__ == '__main__':
     # Use PYTHONASYNCIODEBUG=1 env var to debug asyncio related stuff
     logging.basicConfig(stream=sys.stderr,
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2017-2018 Zubax Robotics
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in
+# the Software without restriction, including without limitation the rights to
+# use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+# the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+#
+# The native accelerator is optional; if it cannot be compiled, the pure Python implementation is used.
+# Build it in-place for development as follows:
+#
+#   ./setup.py build_ext --inplace
+#
+# The C++ implementation and Senoval are expected in the same locations as in the C++ test build;
+# the location of Senoval can be overridden with the environment variable SENOVAL_INCLUDE_DIR.
+#
+
+import os
+from setuptools import setup, Extension, find_packages
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+CXX_DIR = os.path.join(HERE, '..', 'c++')
+SENOVAL_DIR = os.environ.get('SENOVAL_INCLUDE_DIR', os.path.join(CXX_DIR, 'test', 'senoval'))
+
+native = Extension('popcop._native',
+                   sources=['popcop/_native.cpp'],
+                   include_dirs=[CXX_DIR, SENOVAL_DIR],
+                   extra_compile_args=['/std:c++17'] if os.name == 'nt' else ['-std=c++17', '-O2'],
+                   language='c++',
+                   optional=True)
+
+setup(name='popcop',
+      version='0.1.0',
+      description='Point-to-Point Control Protocol',
+      author='Pavel Kirienko',
+      author_email='pavel.kirienko@zubax.com',
+      license='MIT',
+      packages=find_packages(exclude=['*_test']),
+      ext_modules=[native],
+      python_requires='>=3.5')